@@ -88,6 +88,12 @@
 // (maximum ms is 255*TIMEBASE_MS_PER_COUNT)
 #define  TIMEBASE_WARMUP_ms            400
 
+// FAST_BOOT: minimum time the drivers stay off before startup so the bootstrap
+// capacitors are charged. Warmup ends as soon as this and the supply checks are met.
+// Cold is a power-on or brown-out reset, warm is any other reset or a stop/restart.
+#define  TIMEBASE_BOOTSTRAP_COLD_ms    50
+#define  TIMEBASE_BOOTSTRAP_WARM_ms    20
+
 // number of milliseconds between each motor supply voltage check
 // (maximum ms is 255*TIMEBASE_MS_PER_COUNT)
 #define  TIMEBASE_SUPPLY_ms            50
@@ -115,6 +121,17 @@
 
 #define  BEMF_LIMIT                 ((255L*BEMF_R2*MINIMUM_BEMF_VOLTAGE)/(VDD_SUPPLY*(BEMF_R1+BEMF_R2)))
 
+//////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////// Motor supply voltage sense ////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+// The BEMF reference on RA3/AN3 is the motor supply through the same R1/R2 divider
+// followed by a 1:2 divider to put it at the BEMF midpoint.
+#define  SUPPLY_REF_DIVIDER         2L
+
+// 10-bit ADC count for a motor supply voltage given as 10 times the actual value
+#define  SUPPLY_COUNTS(v)           (((v)*BEMF_R2*1023L)/(VDD_SUPPLY*(BEMF_R1+BEMF_R2)*SUPPLY_REF_DIVIDER))
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////// Driver Board Configuration //////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -273,6 +290,19 @@
 //  read AN8 for speed control
 #define  ADCON0_SPEED         0b00100001
 
+//  read AN3 for the motor supply
+#define  ADCON0_SUPPLY        0b00001101
+
+//  read the fixed voltage reference to measure Vdd
+#define  ADCON0_FVR           0b01111101
+//  FVR on, 1.024V to the ADC
+#define  FVRCON_INIT          0b10000001
+#define  FVR_mV               1024L
+// lowest Vdd, in 10 times the actual volts, at which the motor may start
+#define  VDD_MIN              45L
+// the FVR count rises as Vdd falls
+#define  VDD_MIN_FVR_COUNT    ((FVR_mV*1023L)/(VDD_MIN*100L))
+
 // initialize in speed control mode
 #define  ADCON0_INIT          ADCON0_SPEED   
 
@@ -105,7 +105,7 @@ void SpeedManager(void)
    static unsigned int srsum = 0;
    static unsigned int sravg = 0;
    
-	//if(!supply_is_valid) return;           // exit if motor supply out of range
+	if(!supply_is_valid) return;           // exit if motor supply out of range
 	if(!TMR0_duty_flag) return;            // hold off for 10 ms
 
 	TMR0_duty_flag=0;
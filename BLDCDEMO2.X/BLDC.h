@@ -151,6 +151,8 @@
 #define TIMEBASE_WARMUP_COUNT             (TIMEBASE_WARMUP_ms/TIMEBASE_MS_PER_COUNT)
 #define TIMEBASE_SUPPLY_COUNT             (TIMEBASE_SUPPLY_ms/TIMEBASE_MS_PER_COUNT)
 #define TIMEBASE_STALLCHECK_COUNT         (TIMEBASE_STALLCHECK_ms/TIMEBASE_MS_PER_COUNT)
+#define TIMEBASE_BOOTSTRAP_COLD_COUNT     (TIMEBASE_BOOTSTRAP_COLD_ms/TIMEBASE_MS_PER_COUNT)
+#define TIMEBASE_BOOTSTRAP_WARM_COUNT     (TIMEBASE_BOOTSTRAP_WARM_ms/TIMEBASE_MS_PER_COUNT)
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // TIMER1 based
@@ -209,6 +211,10 @@ void ControlSlowStart(void);
 void GetCCPVal(unsigned char speed);
 unsigned char FindTableIndex(unsigned int duty_cycle);
 unsigned long GetRPM(void);
+void SupplyManager(void);
+unsigned int SupplyCompensate(unsigned int duty);
+void BootInit(void);
+bit BootQualified(void);
 
 /////////////////////////////////////////////////////////////////////////////
 // Unions and structures
@@ -269,3 +275,21 @@ typedef union {
 #ifdef EBM_MOTOR
    #include "EBM_Motor.h"
 #endif
+
+/////////////////////////////////////////////////////////////////////////////
+// Options
+/////////////////////////////////////////////////////////////////////////////
+// I2C_QUEUE - the MSSP runs the interrupt driven I2C queue (I2CQueue.c)
+//             and is serviced from the motor ISR after the motor events.
+//             Used by F1937_Combined_Main.c with I2CDevices.c. The host
+//             tests in test/ build both with gcc against a bus model.
+// THERMAL_DERATE - limit the speed request along the derating curve in
+//             ThermalManager.h using the MCP9800 board temperature.
+//             Requires I2C_QUEUE. Adds ThermalManager.c to the build.
+//             test/thermal_sim.c runs it against a thermal plant model.
+// FAST_BOOT - end the warmup as soon as Vdd, the motor supply and the
+//             bootstrap charge time are qualified instead of waiting the
+//             full TIMEBASE_WARMUP_ms. See BootQualified() in SupplyManager.c.
+//             test/boot_sim.c measures the startup latency with and without it.
+//             The slow start that follows is not shortened: it aligns the
+//             rotor, and test/ramp_sim.c loses starts with less dwell.
@@ -56,6 +56,9 @@
 #include "BLDC.h"
 #include "EBM_Motor.h"
 #include "1937_DRIVER.h"
+#ifdef I2C_QUEUE
+#include "I2CQueue.h"
+#endif
 
 /************************************************************************
 * variable definitions                                                  *
@@ -79,8 +82,10 @@ extern doublebyte zc;
 extern doublebyte comm_after_zc;
 extern char tach_timer;
 extern char comm_state;
+extern unsigned char ramp_shift;
 
 int CommOffset;
+bit zc_seen;
 
 /************************************************************************
 *                                                                       *
@@ -106,10 +111,16 @@ int CommOffset;
 //       commutation period for future commutations. Commutation computations are performed in the    //
 //       next commutation state when there is more time because blanking and zero cross are not       //
 //       performed.                                                                                   //
+//                                                                                                    //
+//    In I2C_QUEUE builds the MSSP shares this vector. Motor events are always serviced first and     //
+//    the motor state machine is skipped when only the MSSP is requesting service.                    //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 void __interrupt() ISR(void) {
    char ctemp;
          
+#ifdef I2C_QUEUE
+   if(TMR1IF || CxIF)
+#endif
    switch (isr_state)
    {
       case zero_detect:
@@ -136,6 +147,7 @@ void __interrupt() ISR(void) {
                TMR1ON = 1;
             }
             TP2 = 0;  // Diagnostic
+            zc_seen = 1;
             TMR1IF = 0;
             isr_state = commutate;
             break;
@@ -185,6 +197,19 @@ void __interrupt() ISR(void) {
                //   missed in which case we need to commutate and try again.
                if (startup_complete_flag)
                   while(CxOUT) if (TMR1IF) break;  
+               else if (CxOUT)
+               {
+                  // while ramping a comparator already past the crossing means the rotor
+                  // crossed during blanking, ahead of the drive; take the crossing as now
+                  do{
+                     zc.bytes.high = TMR1H;
+                     zc.bytes.low = TMR1L;
+                  }
+                  while (zc.bytes.high != TMR1H);
+                  zc_seen = 1;
+                  TMR1IF = 0;
+                  break;
+               }
                ctemp = CMxCON0;   // reading control register clears mis-match flops
                CxIF = 0;
                CxIE = 1;
@@ -230,7 +255,8 @@ void __interrupt() ISR(void) {
                temp = zc_error;
                if(temp & 0x8000) temp = ~temp+1;  // absolute value
                // stop forced commutation if zero cross detected within middle half of comm period
-               if (temp < (-expected_zc.word>>1))
+               // while ramping only a zero cross seen in this period counts as lock
+               if ((temp < (-expected_zc.word>>1)) && (zc_seen || startup_complete_flag))
                {
                  startup_complete_flag = 1;
                  TMR0_stall_timer = TIMEBASE_STALL_COUNT;
@@ -241,11 +267,32 @@ void __interrupt() ISR(void) {
                  TP0 = 1;  // Diagnostic
                }
                
-               // Systems ramp up at the maximum rate determined by the difference
-               // between the zero cross event (which usually happens immediately after blanking)
-               // and the middle of the expected commutation time.
-
-               TMR1_comm_time.word -= (zc_error>>ERROR_SCALE);       // accumulate error
+               if(startup_complete_flag)
+               {
+                  TMR1_comm_time.word -= (zc_error>>ERROR_SCALE);       // accumulate error
+               }
+               else
+               {
+                  // Open-loop ramp: step the commutation period by 1/2^ramp_shift.
+                  // A zero cross earlier than expected means the rotor is ahead of the
+                  // drive so the step grows and the period shortens. A late or missed
+                  // zero cross means the rotor is falling behind so the step shrinks
+                  // and the period lengthens, to no more than RAMP_COMM_TIME_MAX.
+                  if(zc_seen && (zc_error & 0x8000))
+                  {
+                     if(ramp_shift > RAMP_INCR_MIN) ramp_shift--;
+                     // TMR1_comm_time is the negative period so adding shortens it
+                     if((unsigned int)(-TMR1_comm_time.word) > MIN_COMM_TIME)
+                        TMR1_comm_time.word += ((unsigned int)(-TMR1_comm_time.word) >> ramp_shift);
+                  }
+                  else
+                  {
+                     if(ramp_shift < RAMP_INCR_MAX) ramp_shift++;
+                     if((unsigned int)(-TMR1_comm_time.word) < RAMP_COMM_TIME_MAX)
+                        TMR1_comm_time.word -= ((unsigned int)(-TMR1_comm_time.word) >> RAMP_BACKOFF);
+                  }
+               }
+               zc_seen = 0;
                comm_after_zc.word = TMR1_comm_time.word + FIXED_ADVANCE_COUNT;
                
                // setup for commutation
@@ -276,5 +323,10 @@ void __interrupt() ISR(void) {
          break;
    }/* end switch */
 
+#ifdef I2C_QUEUE
+   // the I2C state machine only needs to start the next bus event here
+   if((SSPIF && SSPIE) || (BCLIF && BCLIE)) I2CQ_ISR();
+#endif
+
 }/* end ISR */
 
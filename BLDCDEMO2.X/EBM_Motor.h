@@ -31,7 +31,8 @@
 // TIMEBASE_SLOW_STEP - The time to dwell at each single step commutation during pre-
 //             start. Some motors have very high inertia to overcome. The slow step
 //             time should be only large enough to allow the motor to reach and stabilize
-//             at each slow start commutation.
+//             at each slow start commutation. test/ramp_sim.c loses starts on the
+//             larger fans below 10 (100 ms) or with fewer than 3 SLOW_STEPS.
 //
 // TIMEBASE_DUTY_RAMP - At startup the applied motor voltage is set to the minimum.
 //            The applied voltage starts to ramp up after commutation lock is detected 
@@ -68,6 +69,7 @@
 //             then this number is probably too large.
 //
 // HIGH_INERTIA - Define this variable for systems with slow response times.
+//             The open-loop ramp step is then never larger than RAMP_INCR.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -132,6 +134,27 @@
 #define MED_STARTUP_DUTYCYCLE       ((MED_STARTUP_DRIVE_PCT*MAX_DUTY_CYCLE*4L)/100L) //65
 #define HI_STARTUP_DUTYCYCLE        ((HI_STARTUP_DRIVE_PCT*MAX_DUTY_CYCLE*4L)/100L)
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Motor supply voltage, in 10 times the actual volts
+// The startup duty cycle tier is chosen from the measured supply:
+//    below SUPPLY_LOW_TIER             -> LOW_STARTUP_DUTYCYCLE
+//    SUPPLY_LOW_TIER to SUPPLY_HI_TIER -> MED_STARTUP_DUTYCYCLE
+//    above SUPPLY_HI_TIER              -> HI_STARTUP_DUTYCYCLE
+// Once running the duty cycle is scaled by SUPPLY_NOMINAL/measured supply so the
+// applied motor voltage, and therefore the speed, does not follow supply sag.
+#define SUPPLY_NOMINAL           120L
+#define SUPPLY_LOW_TIER          105L
+#define SUPPLY_HI_TIER           135L
+
+// motor will not run outside this range
+#define SUPPLY_MIN               80L
+#define SUPPLY_MAX               160L
+// supply must be this far inside the range before it is valid again
+#define SUPPLY_HYSTERESIS        5L
+
+// Number of samples in the supply average = 2^SUPPLY_AVG_FACTOR
+#define SUPPLY_AVG_FACTOR        2
+
 // maximum sequential startup events before stop
 #define MAX_STARTUP_EVENTS       2
 
@@ -149,6 +172,22 @@
 // Example: >>6 = 1/64 = .0156 = 1.56% step. This minimizes the 1/X effect of a fixed step.                                         
 #define RAMP_INCR                6
 
+// The ramp step adapts while the rotor is not yet locked. A zero cross that arrives
+// early increases the step one shift at a time and shortens the period, a late or missed
+// zero cross decreases the step and lengthens the period by 1/2^RAMP_BACKOFF, up to
+// RAMP_COMM_TIME_MAX, so a heavy rotor that fell behind can catch up.
+// test/ramp_sim sweeps these against rotor inertia on a motor model; confirm the time
+// to lock on the target motor (TP0 low) before changing them.
+#ifdef HIGH_INERTIA
+#define RAMP_INCR_MIN            RAMP_INCR
+#define RAMP_INCR_MAX            (RAMP_INCR+3)
+#else
+#define RAMP_INCR_MIN            (RAMP_INCR-2)
+#define RAMP_INCR_MAX            (RAMP_INCR+2)
+#endif
+#define RAMP_BACKOFF             5
+#define RAMP_COMM_TIME_MAX       (3*TMR1_START_COUNT/2)
+
 // blanking count in microseconds
 #define BLANKING_COUNT_us		   100L 
 
@@ -108,11 +108,13 @@
 
 #include "GenericTypeDefs.h"
 #include "lcd.h"
-#include "rtcc.h"
 #include "input.h"
-#include "i2c.h"
-#include "mcp9800.h"
 #include "mchp_support.h"
+#include "I2CQueue.h"
+#include "I2CDevices.h"
+#ifdef THERMAL_DERATE
+#include "ThermalManager.h"
+#endif
 
 void SpeedManager(int);
 
@@ -132,6 +134,7 @@ unsigned char TMR0_startup_timer;
 unsigned char TMR0_stall_timer;
 unsigned char TMR0_warmup_timer;
 unsigned char TMR0_duty_timer;
+unsigned char TMR0_supply_timer;
 unsigned char TMR0_stallcheck_timer;
 unsigned char TMR0_button_held_timer;
 volatile unsigned char TMR0_temperature_timer;
@@ -142,8 +145,11 @@ bit TMR0_warmup_flag;
 bit TMR0_slow_start_flag;
 bit TMR0_stall_flag;
 bit TMR0_duty_flag;
+bit TMR0_supply_flag;
 bit TMR0_button_flag;
 bit TMR0_temperature_flag;
+bit TMR0_rtcc_flag;
+bit TMR0_thermal_flag;
 bit warmup_complete_flag;
 bit startup_complete_flag;
 bit slow_start_complete_flag;
@@ -159,6 +165,7 @@ doublebyte expected_zc;
 doublebyte zc;
 doublebyte comm_after_zc;
 unsigned char ramped_speed;
+unsigned char ramp_shift;
 
 char startup_dutycycle;// = MED_STARTUP_DUTYCYCLE;
 unsigned int startup_rpm;// = (0xFFFF - COMM_TIME_INIT + 1);
@@ -187,13 +194,13 @@ void main(void)
     int pot_value;
     event_t btn_event;
     char time_set;
-    time_t t;
+    unsigned long t;
     mode_t display_mode;
     mode_t_incr time_incr_mode;
 
 	InitSystem();
 	
-    i2c_init();
+    I2CQ_Init();
     lcd_init();	
     rtcc_init();
     mcp9800_init();
@@ -210,7 +217,7 @@ void main(void)
 		if(stop_flag)
 		{
 			InitSystem();
-			i2c_init();
+			I2CQ_Init();
 			lcd_init();
 		}	 
 		TimeBaseManager();
@@ -218,9 +225,17 @@ void main(void)
 		ControlSlowStart();
 		ControlStartUp();
 		StallControl();
+		SupplyManager();
 
         // handle the other tasks
-        i2c_handler();
+        // I2C requests complete in the background, this only polls the MSSP
+        // until the motor startup enables interrupts
+        I2CQ_Service();
+        rtcc_handler();
+#ifdef THERMAL_DERATE
+        // derate before the speed request is applied
+        ThermalManager();
+#endif
         
         btn_event = input_event();
    	    pot_value = input_pot();
@@ -240,7 +255,7 @@ void main(void)
 		            	    // and make the first time adjustment immediately
 		            	    TMR0_button_held_timer++;
 		            	    // read the current time into t and strip off seconds
-							time(&t);
+							t = rtcc_get_seconds();
 							t = t - (t % 60);
 							time_incr_mode = INCR_MINUTES;
 		            	}
@@ -316,15 +331,13 @@ void main(void)
 	        	    		break;
 	        	    }
 			  		// show the current setting
-					rtcc_set(&t);
+					rtcc_set(t);
 				}
 			}
 		}
 		else // we are not setting the time
         {
             SpeedManager(pot_value); // use the pot to control the motor speed
-            // update the time
-            rtcc_handler();
         }
             	 
         switch(display_mode)
@@ -340,6 +353,7 @@ void main(void)
 	                // display temperature every .5 sec
 	                if(--TMR0_temperature_timer == 0)
 	                {
+                   		// returns the last reading and queues the next one
                    		if(display_temp(mcp9800_get_temp()))
                    		    // if display was not inhibited by WA permission then
                    		    // next display will be 500 ms from now
@@ -394,6 +408,10 @@ void InitSystem(void) {
 
    // Setup internal oscillator frequency
    OSCCON = OSCCON_INIT;
+
+#ifdef FAST_BOOT
+   BootInit();
+#endif
    
    //OPTION=OPTION_INIT;   
 
@@ -443,6 +461,7 @@ void InitSystem(void) {
    TMR0_warmup_timer = TIMEBASE_WARMUP_COUNT;
    TMR0_slow_start_timer = TIMEBASE_SLOW_STEP;
    TMR0_duty_timer = TIMEBASE_DUTY_RAMP;
+   TMR0_supply_timer = TIMEBASE_SUPPLY_COUNT;
    TMR0_stallcheck_timer = TIMEBASE_STALLCHECK_COUNT;
    TMR0_stall_timer = TIMEBASE_STALL_COUNT;
    timebase_10ms = TIMEBASE_LOAD_10ms;
@@ -524,6 +543,9 @@ void InitDriver(void)
    comm_state=2;
    Commutate();
 
+   // open-loop ramp step, adapted by the ISR until lock
+   ramp_shift = RAMP_INCR;
+
    startup_in_progress = 1;
    init_complete_flag = 1;   
 }
@@ -584,10 +606,15 @@ void TimeBaseManager(void)
       //    timer which permits one increment/decrement of the duty cycle
       //    register every N mS (set by the TIMEBASE_DUTY_RAMP constant).
       TMR0_duty_flag = 1;
+
+      // TMR0 motor supply check update
+      TMR0_supply_flag = 1;
       
       // Measure the time the pushbutton is held
       TMR0_button_flag = 1;
       TMR0_temperature_flag = 1;
+      TMR0_rtcc_flag = 1;
+      TMR0_thermal_flag = 1;
    }
 }
 
@@ -624,6 +651,10 @@ void WarmUpControl(void)
    if(TMR0_warmup_timer) 
    {
       TMR0_warmup_timer--;
+#ifdef FAST_BOOT
+      // end the warmup early once the supplies are qualified by measurement
+      if(BootQualified()) TMR0_warmup_timer = 0;
+#endif
    }
    else
    {
@@ -817,11 +848,16 @@ unsigned char FindTableIndex(unsigned int duty_cycle)
 
 // This function accepts an 8-bit value as an index for a lookup table.
 // The table sets a 10-bit value into the CCPR registers
+// Once running, the duty cycle is scaled by nominal/actual supply voltage.
 void GetCCPVal(unsigned char speed)
 {     
-     CCPR1L = (CCP_Values[speed] >> 2);
-     DC1B0  = CCP_Values[speed] & 0x01;
-     DC1B1  = (CCP_Values[speed] >> 1) & 0x01;
+     unsigned int duty;
+
+     duty = CCP_Values[speed];
+     if(startup_complete_flag) duty = SupplyCompensate(duty);
+     CCPR1L = (duty >> 2);
+     DC1B0  = duty & 0x01;
+     DC1B1  = (duty >> 1) & 0x01;
 }
 
 
@@ -1006,19 +1042,21 @@ char display_int(int t)
 
 void display_time(void)
 {
-    time_t t;
-    struct tm *d;
+    unsigned long t;
+    unsigned char minutes;
+    unsigned char hours;
     BCD_TYPE bcd;
     
-    time(&t);
-    d = gmtime(&t);
+    t = rtcc_get_seconds();
+    minutes = (t / 60) % 60;
+    hours = t / 3600;
     
-    bcd.digit0= d->tm_min % 10;
-    bcd.digit1= d->tm_min / 10;
+    bcd.digit0= minutes % 10;
+    bcd.digit1= minutes / 10;
     
-    if(d->tm_hour > 11)
+    if(hours > 11)
     {
-        d->tm_hour -= 12;
+        hours -= 12;
         AMPS = 0;
     }    
     else
@@ -1026,10 +1064,10 @@ void display_time(void)
         AMPS = 1;  // AM indicator
     }
     
-    if(d->tm_hour == 0) d->tm_hour = 12;
+    if(hours == 0) hours = 12;
     
-    bcd.digit2= d->tm_hour % 10;
-    bcd.digit3= d->tm_hour/10;
+    bcd.digit2= hours % 10;
+    bcd.digit3= hours/10;
 
     if(lcd_display_digits(bcd))
     {
@@ -121,6 +121,7 @@ unsigned char TMR0_startup_timer;
 unsigned char TMR0_stall_timer;
 unsigned char TMR0_warmup_timer;
 unsigned char TMR0_duty_timer;
+unsigned char TMR0_supply_timer;
 unsigned char timebase_10ms;
 
 bit TMR0_startup_flag;
@@ -128,6 +129,7 @@ bit TMR0_warmup_flag;
 bit TMR0_slow_start_flag;
 bit TMR0_stall_flag;
 bit TMR0_duty_flag;
+bit TMR0_supply_flag;
 bit warmup_complete_flag;
 bit startup_complete_flag;
 bit slow_start_complete_flag;
@@ -143,6 +145,7 @@ doublebyte expected_zc;
 doublebyte zc;
 doublebyte comm_after_zc;
 unsigned char ramped_speed;
+unsigned char ramp_shift;
 
 char startup_dutycycle = MED_STARTUP_DUTYCYCLE;
 unsigned int startup_rpm = (0xFFFF - COMM_TIME_INIT + 1);
@@ -166,6 +169,7 @@ void main(void)
       ControlSlowStart();
       ControlStartUp();
       StallControl();
+      SupplyManager();
       //SpeedManager();
       
 
@@ -199,6 +203,10 @@ void InitSystem(void) {
 
    // Setup internal oscillator frequency
    OSCCON = OSCCON_INIT;
+
+#ifdef FAST_BOOT
+   BootInit();
+#endif
    
    //OPTION=OPTION_INIT;   
 
@@ -232,6 +240,7 @@ void InitSystem(void) {
    TMR0_warmup_timer = TIMEBASE_WARMUP_COUNT;
    TMR0_slow_start_timer = TIMEBASE_SLOW_STEP;
    TMR0_duty_timer = TIMEBASE_DUTY_RAMP;
+   TMR0_supply_timer = TIMEBASE_SUPPLY_COUNT;
    TMR0_stall_timer = TIMEBASE_STALL_COUNT;
    timebase_10ms = TIMEBASE_LOAD_10ms;
    
@@ -307,6 +316,9 @@ void InitDriver(void)
    comm_state=1;
    Commutate();
 
+   // open-loop ramp step, adapted by the ISR until lock
+   ramp_shift = RAMP_INCR;
+
    startup_in_progress = 1;
    init_complete_flag = 1;   
 }
@@ -367,6 +379,9 @@ void TimeBaseManager(void)
       //    timer which permits one increment/decrement of the duty cycle
       //    register every N mS (set by the TIMEBASE_DUTY_RAMP constant).
       TMR0_duty_flag = 1;
+
+      // TMR0 motor supply check update
+      TMR0_supply_flag = 1;
       
    }
 }
@@ -404,6 +419,10 @@ void WarmUpControl(void)
    if(TMR0_warmup_timer) 
    {
       TMR0_warmup_timer--;
+#ifdef FAST_BOOT
+      // end the warmup early once the supplies are qualified by measurement
+      if(BootQualified()) TMR0_warmup_timer = 0;
+#endif
    }
    else
    {
@@ -603,9 +622,14 @@ unsigned char FindTableIndex(unsigned int duty_cycle)
 
 // This function accepts an 8-bit value as an index for a lookup table.
 // The table sets a 10-bit value into the CCPR registers
+// Once running, the duty cycle is scaled by nominal/actual supply voltage.
 void GetCCPVal(unsigned char speed)
 {     
-     CCPR1L = (CCP_Values[speed] >> 2);
-     DC1B0  = (CCP_Values[speed] & 0x01)?1:0;
-     DC1B1  = ((CCP_Values[speed] >> 1) & 0x01)?1:0;
+     unsigned int duty;
+
+     duty = CCP_Values[speed];
+     if(startup_complete_flag) duty = SupplyCompensate(duty);
+     CCPR1L = (duty >> 2);
+     DC1B0  = (duty & 0x01)?1:0;
+     DC1B1  = ((duty >> 1) & 0x01)?1:0;
 }
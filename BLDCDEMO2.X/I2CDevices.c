@@ -0,0 +1,292 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : I2CDevices.c                               *
+*                                                                       *
+*     Other Files Required : BLDC.h, I2CQueue.h, I2CDevices.h           *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Cached temperature and time of day for the combined demo.                                          //
+// Each device has at most one transaction in the queue. The completion callbacks run in interrupt    //
+// context, so they only copy the result into the cache and clear the pending flag. Anything that     //
+// needs a new transaction is flagged and then submitted from the main loop.                          //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <xc.h>
+#include "BLDC.h"
+#include "I2CQueue.h"
+#include "I2CDevices.h"
+
+extern bit TMR0_rtcc_flag;
+
+/************************************************************************
+* variable definitions                                                  *
+*************************************************************************/
+
+static unsigned char temp_buffer[2];
+static volatile int temp_cache;               // degrees C * 10
+static volatile bit temp_valid;
+static volatile bit temp_pending;
+
+static unsigned char rtcc_read_buffer[RTCC_READ_LENGTH];
+static unsigned char rtcc_write_buffer[RTCC_READ_LENGTH];
+static volatile unsigned long rtcc_cache;     // seconds since midnight
+static volatile bit rtcc_read_pending;
+static volatile bit rtcc_write_pending;
+static volatile bit rtcc_start_needed;
+static bit rtcc_dirty;
+static unsigned char rtcc_poll_timer;
+
+static unsigned char FromBCD(unsigned char bcd)
+{
+   return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+static unsigned char ToBCD(unsigned char value)
+{
+   return ((value / 10) << 4) | (value % 10);
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       mcp9800_init                                     *
+*                                                                       *
+*      Description:    queue the MCP9800 configuration write            *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*************************************************************************/
+
+void mcp9800_init(void)
+{
+   static unsigned char config = MCP9800_CONFIG_INIT;
+   I2CTransaction t;
+
+   t.address = MCP9800_ADDRESS;
+   t.reg = MCP9800_REG_CONFIG;
+   t.length = 1;
+   t.read = 0;
+   t.data = &config;
+   t.done = 0;
+   I2CQ_Submit(&t);
+
+   temp_valid = 0;
+   temp_pending = 0;
+}
+
+static void TempDone(unsigned char status)
+{
+   int raw;
+
+   if(status == I2CQ_OK)
+   {
+      // 12-bit two's complement, 1/16 degree per count
+      raw = (signed char)temp_buffer[0] * 16 + (temp_buffer[1] >> 4);
+      // counts * 10 / 16 = degrees C * 10
+      temp_cache = (raw * 5) >> 3;
+      temp_valid = 1;
+   }
+   temp_pending = 0;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       mcp9800_get_temp                                 *
+*                                                                       *
+*      Description:    return the cached temperature                    *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   temperature in degrees C * 10                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  A new read is queued when none is outstanding so the next call       *
+*  returns a fresh value. The first call after init returns 0 until     *
+*  mcp9800_temp_valid() is set.                                         *
+*                                                                       *
+*************************************************************************/
+
+int mcp9800_get_temp(void)
+{
+   I2CTransaction t;
+   int result;
+
+   if(!temp_pending)
+   {
+      t.address = MCP9800_ADDRESS;
+      t.reg = MCP9800_REG_TEMP;
+      t.length = 2;
+      t.read = 1;
+      t.data = temp_buffer;
+      t.done = TempDone;
+      if(I2CQ_Submit(&t)) temp_pending = 1;
+   }
+
+   SSPIE = 0;
+   result = temp_cache;
+   SSPIE = 1;
+   return result;
+}
+
+bit mcp9800_temp_valid(void)
+{
+   return temp_valid;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       rtcc_init                                        *
+*                                                                       *
+*      Description:    clear the time cache and poll the RTCC           *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  The first read also tells whether the oscillator is running. If the  *
+*  ST bit is clear rtcc_handler() writes it back with ST set.           *
+*                                                                       *
+*************************************************************************/
+
+void rtcc_init(void)
+{
+   rtcc_cache = 0;
+   rtcc_read_pending = 0;
+   rtcc_write_pending = 0;
+   rtcc_start_needed = 0;
+   rtcc_dirty = 0;
+   rtcc_poll_timer = 1;
+}
+
+static void RtccReadDone(unsigned char status)
+{
+   // a read that was already queued when the time was set returns the old time
+   if(status == I2CQ_OK && !rtcc_dirty && !rtcc_write_pending)
+   {
+      if(!(rtcc_read_buffer[0] & RTCC_ST)) rtcc_start_needed = 1;
+      rtcc_cache = FromBCD(rtcc_read_buffer[2] & 0x3F) * 3600L
+                 + FromBCD(rtcc_read_buffer[1] & 0x7F) * 60
+                 + FromBCD(rtcc_read_buffer[0] & 0x7F);
+   }
+   rtcc_read_pending = 0;
+}
+
+static void RtccWriteDone(unsigned char status)
+{
+   if(status != I2CQ_OK) rtcc_dirty = 1;      // try again
+   rtcc_write_pending = 0;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       rtcc_handler                                     *
+*                                                                       *
+*      Description:    queue RTCC reads and writes                      *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called every main loop. Pending time writes go first, then a read    *
+*  is queued every RTCC_POLL_COUNT TimeBaseManager ticks.               *
+*                                                                       *
+*************************************************************************/
+
+void rtcc_handler(void)
+{
+   I2CTransaction t;
+   unsigned long seconds;
+
+   t.address = RTCC_ADDRESS;
+   t.reg = RTCC_REG_SECONDS;
+   t.length = RTCC_READ_LENGTH;
+
+   if((rtcc_dirty || rtcc_start_needed) && !rtcc_write_pending)
+   {
+      // the cache holds the time that was set or, when only the oscillator
+      // has to be started, the time that was last read
+      seconds = rtcc_get_seconds();
+      rtcc_write_buffer[0] = ToBCD(seconds % 60) | RTCC_ST;
+      rtcc_write_buffer[1] = ToBCD((seconds / 60) % 60);
+      rtcc_write_buffer[2] = ToBCD(seconds / 3600);
+      t.read = 0;
+      t.data = rtcc_write_buffer;
+      t.done = RtccWriteDone;
+      if(I2CQ_Submit(&t))
+      {
+         rtcc_write_pending = 1;
+         rtcc_dirty = 0;
+         rtcc_start_needed = 0;
+      }
+   }
+
+   if(!TMR0_rtcc_flag) return;
+   TMR0_rtcc_flag = 0;
+   if(--rtcc_poll_timer) return;
+   rtcc_poll_timer = RTCC_POLL_COUNT;
+
+   if(rtcc_read_pending) return;
+   t.read = 1;
+   t.data = rtcc_read_buffer;
+   t.done = RtccReadDone;
+   if(I2CQ_Submit(&t)) rtcc_read_pending = 1;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       rtcc_get_seconds                                 *
+*                                                                       *
+*      Description:    return the cached time of day                    *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   seconds since midnight                           *
+*                                                                       *
+*************************************************************************/
+
+unsigned long rtcc_get_seconds(void)
+{
+   unsigned long result;
+
+   SSPIE = 0;
+   result = rtcc_cache;
+   SSPIE = 1;
+   return result;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       rtcc_set                                         *
+*                                                                       *
+*      Description:    set the time of day                              *
+*                                                                       *
+*      Parameters:     t - seconds since midnight, wraps at 24 hours    *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  The cache is updated at once so the display follows the setting.     *
+*  The RTCC write is queued by the next rtcc_handler() call, once any   *
+*  earlier write has completed.                                         *
+*                                                                       *
+*************************************************************************/
+
+void rtcc_set(unsigned long t)
+{
+   t %= SECONDS_PER_DAY;
+
+   SSPIE = 0;
+   rtcc_cache = t;
+   SSPIE = 1;
+
+   rtcc_dirty = 1;
+}
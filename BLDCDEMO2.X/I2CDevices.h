@@ -0,0 +1,54 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : I2CDevices.h                               *
+*                                                                       *
+*     Other Files Required : I2CDevices.c, I2CQueue.h                   *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// MCP9800 temperature sensor and MCP79410 RTCC on the I2C transaction queue.                         //
+// Reads are issued in the background and the results are cached. The get functions only return       //
+// the last cached value and never wait on the bus.                                                   //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+
+#ifndef I2CDEVICES_H
+#define I2CDEVICES_H
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// MCP9800 temperature sensor
+#define  MCP9800_ADDRESS            0x48
+#define  MCP9800_REG_TEMP           0x00
+#define  MCP9800_REG_CONFIG         0x01
+// 12-bit resolution, continuous conversion
+#define  MCP9800_CONFIG_INIT        0x60
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// MCP79410 RTCC, 24 hour mode
+#define  RTCC_ADDRESS               0x6F
+#define  RTCC_REG_SECONDS           0x00
+#define  RTCC_ST                    0x80      // oscillator start bit in the seconds register
+#define  RTCC_READ_LENGTH           3         // seconds, minutes, hours
+
+// RTCC poll interval in 10 ms TimeBaseManager counts
+#define  RTCC_POLL_COUNT            25
+
+#define  SECONDS_PER_DAY            86400L
+
+void mcp9800_init(void);
+int mcp9800_get_temp(void);
+bit mcp9800_temp_valid(void);
+
+void rtcc_init(void);
+void rtcc_handler(void);
+unsigned long rtcc_get_seconds(void);
+void rtcc_set(unsigned long t);
+
+#endif
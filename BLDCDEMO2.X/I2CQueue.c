@@ -0,0 +1,312 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : I2CQueue.c                                 *
+*                                                                       *
+*     Other Files Required : BLDC.h, I2CQueue.h                         *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// MSSP I2C master engine. Requests are queued with I2CQ_Submit() and run one at a time by            //
+// I2CQ_ISR(), which advances the bus state machine one step per SSPIF interrupt.                     //
+// The queue has a single producer (main loop) and a single consumer (I2CQ_ISR), so head is only      //
+// written by I2CQ_Submit() and tail only by the state machine.                                       //
+//                                                                                                    //
+// Interrupts are only enabled by the motor startup code. Until then I2CQ_Service() polls SSPIF from  //
+// the main loop so the same state machine runs before the motor is started.                          //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <xc.h>
+#include "BLDC.h"
+#include "I2CQueue.h"
+
+/************************************************************************
+* variable definitions                                                  *
+*************************************************************************/
+
+static I2CTransaction i2c_queue[I2CQ_DEPTH];
+static volatile unsigned char i2c_head;       // next free entry, written by I2CQ_Submit()
+static volatile unsigned char i2c_tail;       // active entry, written by the state machine
+static unsigned char i2c_index;               // data byte count of the active entry
+static unsigned char i2c_status;              // completion status of the active entry
+
+static enum {
+   i2c_idle,
+   i2c_address,
+   i2c_register,
+   i2c_write,
+   i2c_restart,
+   i2c_read_address,
+   i2c_receive,
+   i2c_ack,
+   i2c_stop
+} i2c_state;
+
+/************************************************************************
+*                                                                       *
+*      Function:       I2CQ_Init                                        *
+*                                                                       *
+*      Description:    initialize MSSP as I2C master and empty queue    *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called after InitSystem() which leaves RC3/RC4 as outputs. Entries   *
+*  still in the queue from before a restart are completed with          *
+*  I2CQ_ABORTED so their owners can issue them again.                   *
+*                                                                       *
+*************************************************************************/
+
+void I2CQ_Init(void)
+{
+   I2CTransaction *t;
+
+   SSPIE = 0;
+   BCLIE = 0;
+   SSPEN = 0;
+
+   while(i2c_tail != i2c_head)
+   {
+      t = &i2c_queue[i2c_tail];
+      if(t->done) t->done(I2CQ_ABORTED);
+      i2c_tail = (i2c_tail + 1) & I2CQ_MASK;
+   }
+   i2c_state = i2c_idle;
+
+   // SCL and SDA must be inputs for the MSSP to drive them
+   TRISC3 = 1;
+   TRISC4 = 1;
+
+   SSPADD = SSPADD_INIT;
+   SSPSTAT = SSPSTAT_INIT;
+   SSPCON2 = 0;
+   SSPCON1 = SSPCON1_INIT;
+
+   SSPIF = 0;
+   BCLIF = 0;
+   SSPIE = 1;
+   BCLIE = 1;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       I2CQ_Submit                                      *
+*                                                                       *
+*      Description:    queue a register read or write                   *
+*                                                                       *
+*      Parameters:     t - transaction, copied into the queue           *
+*      Return value:   1 if queued, 0 if the queue is full              *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  The transaction descriptor is copied but the data buffer is not.     *
+*  The buffer must stay valid until the done callback has been called.  *
+*                                                                       *
+*************************************************************************/
+
+bit I2CQ_Submit(const I2CTransaction *t)
+{
+   unsigned char next;
+
+   next = (i2c_head + 1) & I2CQ_MASK;
+   if(next == i2c_tail) return 0;            // full
+
+   i2c_queue[i2c_head] = *t;
+
+   // hold off the state machine while head and state are updated
+   SSPIE = 0;
+   BCLIE = 0;
+   i2c_head = next;
+   if(i2c_state == i2c_idle)
+   {
+      i2c_status = I2CQ_OK;
+      i2c_state = i2c_address;
+      SEN = 1;
+   }
+   SSPIE = 1;
+   BCLIE = 1;
+   return 1;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       I2CQ_Busy                                        *
+*                                                                       *
+*      Description:    report whether any transaction is outstanding    *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   1 if a transaction is queued or in progress      *
+*                                                                       *
+*************************************************************************/
+
+bit I2CQ_Busy(void)
+{
+   return (i2c_state != i2c_idle);
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       I2CQ_Service                                     *
+*                                                                       *
+*      Description:    run the state machine while interrupts are off   *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called every main loop. When GIE is set the ISR does the work and    *
+*  this returns immediately.                                            *
+*                                                                       *
+*************************************************************************/
+
+void I2CQ_Service(void)
+{
+   if(GIE && PEIE) return;
+   if(SSPIF || BCLIF) I2CQ_ISR();
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       I2CQ_ISR                                         *
+*                                                                       *
+*      Description:    advance the bus state machine one step           *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Each state issues exactly one bus event and returns. The next        *
+*  SSPIF brings execution back here when that event has finished.       *
+*  A NACK ends the transaction with a STOP. A bus collision leaves the  *
+*  bus to the other master so no STOP is issued.                        *
+*                                                                       *
+*************************************************************************/
+
+void I2CQ_ISR(void)
+{
+   I2CTransaction *t;
+
+   t = &i2c_queue[i2c_tail];
+
+   if(BCLIF)
+   {
+      BCLIF = 0;
+      SSPIF = 0;
+      // a collision with no transaction of ours on the bus retires nothing
+      if(i2c_state == i2c_idle) return;
+      i2c_status = I2CQ_COLLISION;
+   }
+   else
+   {
+      if(!SSPIF) return;
+      SSPIF = 0;
+
+      switch(i2c_state)
+      {
+         case i2c_address:
+            // START complete
+            i2c_index = 0;
+            SSPBUF = t->address << 1;
+            i2c_state = i2c_register;
+            return;
+
+         case i2c_register:
+            // address acknowledged, send the register pointer
+            if(ACKSTAT) break;
+            SSPBUF = t->reg;
+            i2c_state = i2c_write;
+            return;
+
+         case i2c_write:
+            // register pointer or data byte acknowledged
+            if(ACKSTAT) break;
+            if(t->read)
+            {
+               RSEN = 1;
+               i2c_state = i2c_restart;
+               return;
+            }
+            if(i2c_index < t->length)
+            {
+               SSPBUF = t->data[i2c_index++];
+               return;
+            }
+            PEN = 1;
+            i2c_state = i2c_stop;
+            return;
+
+         case i2c_restart:
+            // repeated START complete, turn the bus around
+            SSPBUF = (t->address << 1) | 1;
+            i2c_state = i2c_read_address;
+            return;
+
+         case i2c_read_address:
+            if(ACKSTAT) break;
+            RCEN = 1;
+            i2c_state = i2c_receive;
+            return;
+
+         case i2c_receive:
+            t->data[i2c_index++] = SSPBUF;
+            // NACK the last byte so the slave releases SDA for the STOP
+            ACKDT = (i2c_index >= t->length);
+            ACKEN = 1;
+            i2c_state = i2c_ack;
+            return;
+
+         case i2c_ack:
+            if(i2c_index < t->length)
+            {
+               RCEN = 1;
+               i2c_state = i2c_receive;
+               return;
+            }
+            PEN = 1;
+            i2c_state = i2c_stop;
+            return;
+
+         case i2c_stop:
+            // STOP complete
+            break;
+
+         case i2c_idle:
+         default:
+            return;
+      }
+
+      if(i2c_state != i2c_stop)
+      {
+         // slave did not acknowledge
+         i2c_status = I2CQ_NACK;
+         PEN = 1;
+         i2c_state = i2c_stop;
+         return;
+      }
+   }
+
+   // STOP complete or bus lost: retire the active entry and start the next one
+   if(t->done) t->done(i2c_status);
+   i2c_tail = (i2c_tail + 1) & I2CQ_MASK;
+
+   i2c_status = I2CQ_OK;
+   if(i2c_tail != i2c_head)
+   {
+      i2c_state = i2c_address;
+      SEN = 1;
+   }
+   else
+   {
+      i2c_state = i2c_idle;
+   }
+}
@@ -0,0 +1,67 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : I2CQueue.h                                 *
+*                                                                       *
+*     Other Files Required : I2CQueue.c                                 *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Interrupt driven MSSP I2C master with a small transaction queue.                                   //
+//                                                                                                    //
+// Each transaction is a register access: START, address+W, register pointer, then either the         //
+// write data or a repeated START, address+R and the read data, then STOP. Every bus event is one     //
+// SSPIF interrupt so the main loop never waits on the bus. When the transaction completes the        //
+// owner's callback is called with the completion status. Callbacks run in interrupt context          //
+// (or from I2CQ_Service() while interrupts are off) and must only copy results into a cache.         //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+
+#ifndef I2CQUEUE_H
+#define I2CQUEUE_H
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// I2C clock rate in Hz
+#define  I2C_BAUD                   100000L
+#define  SSPADD_INIT                ((FOSC/(4L*I2C_BAUD))-1L)
+
+// MSSP in I2C master mode, SSPEN set
+#define  SSPCON1_INIT               0b00101000
+// slew rate control disabled for 100 kHz
+#define  SSPSTAT_INIT               0b10000000
+
+// queue size, must be a power of 2. One entry is kept free so DEPTH-1 can be pending.
+#define  I2CQ_DEPTH                 4
+#define  I2CQ_MASK                  (I2CQ_DEPTH-1)
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// completion status passed to the callback
+#define  I2CQ_OK                    0
+#define  I2CQ_NACK                  1
+#define  I2CQ_COLLISION             2
+#define  I2CQ_ABORTED               3
+
+typedef void (*I2CCallback)(unsigned char status);
+
+typedef struct {
+   unsigned char address;           // 7-bit slave address
+   unsigned char reg;               // register pointer sent after the address
+   unsigned char length;            // number of data bytes to read or write
+   unsigned char read;              // 1 = read length bytes, 0 = write length bytes
+   unsigned char *data;             // buffer owned by the requester
+   I2CCallback done;                // completion callback, may be 0
+} I2CTransaction;
+
+void I2CQ_Init(void);
+bit I2CQ_Submit(const I2CTransaction *t);
+bit I2CQ_Busy(void);
+void I2CQ_Service(void);
+void I2CQ_ISR(void);
+
+#endif
@@ -73,6 +73,10 @@ extern bit run_flag;
 extern bit TMR0_duty_flag;
 extern char TMR0_duty_timer;
 extern unsigned char ramped_speed;
+#ifdef THERMAL_DERATE
+extern unsigned char thermal_ceiling;
+extern bit thermal_trip;
+#endif
 
 /************************************************************************
 *                                                                       *
@@ -99,10 +103,11 @@ extern unsigned char ramped_speed;
 void SpeedManager(int speed)
 {
    unsigned char speedrequest;
+   unsigned char target;
    static unsigned int srsum = 0;
    static unsigned int sravg = 0;
    
-	//if(!supply_is_valid) return;           // exit if motor supply out of range
+	if(!supply_is_valid) return;           // exit if motor supply out of range
 	if(!TMR0_duty_flag) return;            // hold off for 10 ms
 
 	TMR0_duty_flag=0;
@@ -129,15 +134,25 @@ void SpeedManager(int speed)
    	return;
    }
    // stop-run hysterisis: don't start until above high threshold
+#ifdef THERMAL_DERATE
+   // an over temperature trip holds off the restart until the board cools
+   if(sravg > REQUEST_ON && !thermal_trip) run_flag = 1;
+#else
    if(sravg > REQUEST_ON) run_flag = 1;
+#endif
    
 	if(!startup_complete_flag) return;     // do not start to accelerate until startup is complete
    
 	// ramp up or down to the requested speed setting
 	// NOTE: if the speedrequest-average sample size is sufficently large then this
 	//       ramping function can be eliminated.
-	if(sravg > ramped_speed) ramped_speed++;
-	if(sravg < ramped_speed) ramped_speed--;
+   target = sravg;
+#ifdef THERMAL_DERATE
+   // never ramp above the thermal derating ceiling
+   if(target > thermal_ceiling) target = thermal_ceiling;
+#endif
+	if(target > ramped_speed) ramped_speed++;
+	if(target < ramped_speed) ramped_speed--;
 	
    // set the motor voltage PWM by accessing values in a table
    // indexed by the global variable ramped_speed
@@ -0,0 +1,268 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : SupplyManager.c                            *
+*                                                                       *
+*     Other Files Required : BLDC.h                                     *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+//   The motor supply is sampled on the BEMF reference input every TIMEBASE_SUPPLY_ms.                //
+//   The averaged reading is used three ways:                                                         //
+//      supply_is_valid gates the speed request so the motor does not start or run outside the range  //
+//      the startup duty cycle tier is picked before the drivers are initialized                      //
+//      the running duty cycle is scaled by nominal/actual supply in GetCCPVal()                      //
+//                                                                                                    //
+//   With FAST_BOOT the warmup ends as soon as the supplies are qualified by measurement. A cold      //
+//   boot also checks Vdd against the FVR. A warm boot trusts the last Vdd check and only waits for   //
+//   the shorter bootstrap charge time.                                                               //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <xc.h>
+#include "BLDC.h"
+#include "EBM_Motor.h"
+#include "1937_DRIVER.h"
+
+extern bit stop_flag;
+extern bit run_flag;
+extern bit warmup_complete_flag;
+extern bit TMR0_supply_flag;
+extern unsigned char TMR0_supply_timer;
+extern char startup_dutycycle;
+
+#define SUPPLY_NOMINAL_COUNT     SUPPLY_COUNTS(SUPPLY_NOMINAL)
+#define SUPPLY_LOW_TIER_COUNT    SUPPLY_COUNTS(SUPPLY_LOW_TIER)
+#define SUPPLY_HI_TIER_COUNT     SUPPLY_COUNTS(SUPPLY_HI_TIER)
+#define SUPPLY_MIN_COUNT         SUPPLY_COUNTS(SUPPLY_MIN)
+#define SUPPLY_MAX_COUNT         SUPPLY_COUNTS(SUPPLY_MAX)
+#define SUPPLY_HYST_COUNT        SUPPLY_COUNTS(SUPPLY_HYSTERESIS)
+
+// duty cycle scale is nominal/actual with 8 fractional bits
+#define SUPPLY_SCALE_ONE         256
+#define SUPPLY_SCALE_MIN         ((SUPPLY_NOMINAL*256L)/SUPPLY_MAX)
+#define SUPPLY_SCALE_MAX         ((SUPPLY_NOMINAL*256L)/SUPPLY_MIN)
+
+// 10-bit duty cycle at 100%
+#define MAX_DUTY_COUNT           (MAX_DUTY_CYCLE*4)
+
+/************************************************************************
+* variable definitions                                                  *
+*************************************************************************/
+
+bit supply_is_valid;
+unsigned int supply_avg;                       // averaged 10-bit ADC count
+unsigned int supply_scale = SUPPLY_SCALE_ONE;  // nominal/actual, 8 fractional bits
+
+static unsigned int supply_sum;
+static bit supply_primed;
+
+#ifdef FAST_BOOT
+bit warm_boot;                                 // supplies were qualified since the last cold reset
+static bit boot_checked;
+static unsigned char bootstrap_timer;
+#endif
+
+/************************************************************************
+*                                                                       *
+*      Function:       ReadSupply                                       *
+*                                                                       *
+*      Description:    convert the motor supply sense input             *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   10-bit ADC count                                 *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  The ADC is returned to the speed control input when done.            *
+*                                                                       *
+*************************************************************************/
+
+static unsigned int ReadSupply(void)
+{
+   unsigned int result;
+
+   ADCON0 = ADCON0_SUPPLY;
+   _delay((ACQUISITION_TIME_us*FOSC)/4000000L);
+   GODONE = 1;
+   while(GODONE == 1);
+   // result is left justified
+   result = ((unsigned int)ADRESH << 2) | (ADRESL >> 6);
+   ADCON0 = ADCON0_SPEED;
+   return result;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       SupplyManager                                    *
+*                                                                       *
+*      Description:    measure the motor supply                         *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called every main loop. The TMR0_supply_flag limits execution to     *
+*  every 10 ms and TIMEBASE_SUPPLY_COUNT sets the sample interval.      *
+*  The startup tier is only changed before the drivers are initialized  *
+*  so it stays fixed for the whole startup.                             *
+*                                                                       *
+*************************************************************************/
+
+void SupplyManager(void)
+{
+   unsigned int sample;
+
+   if(!TMR0_supply_flag) return;         // hold off for 10 ms
+   TMR0_supply_flag = 0;
+   if(--TMR0_supply_timer) return;       // wait until timer times out
+   TMR0_supply_timer = TIMEBASE_SUPPLY_COUNT;
+
+   sample = ReadSupply();
+
+   // running average, started at the first sample
+   if(!supply_primed)
+   {
+      supply_sum = sample << SUPPLY_AVG_FACTOR;
+      supply_avg = sample;
+      supply_primed = 1;
+   }
+   supply_sum -= supply_avg;
+   supply_sum += sample;
+   supply_avg = supply_sum >> SUPPLY_AVG_FACTOR;
+
+   // valid window with hysteresis
+   if(supply_is_valid)
+   {
+      if(supply_avg < SUPPLY_MIN_COUNT || supply_avg > SUPPLY_MAX_COUNT)
+      {
+         supply_is_valid = 0;
+         if(run_flag) stop_flag = 1;     // stop rather than run out of range
+         run_flag = 0;
+      }
+   }
+   else
+   {
+      if(supply_avg > (SUPPLY_MIN_COUNT + SUPPLY_HYST_COUNT) &&
+         supply_avg < (SUPPLY_MAX_COUNT - SUPPLY_HYST_COUNT))
+         supply_is_valid = 1;
+   }
+   if(!supply_is_valid) return;
+
+   // feed forward scale for GetCCPVal()
+   supply_scale = (unsigned int)(((unsigned long)SUPPLY_NOMINAL_COUNT << 8) / supply_avg);
+   if(supply_scale < SUPPLY_SCALE_MIN) supply_scale = SUPPLY_SCALE_MIN;
+   if(supply_scale > SUPPLY_SCALE_MAX) supply_scale = SUPPLY_SCALE_MAX;
+
+   // startup tier
+   if(!warmup_complete_flag)
+   {
+      if(supply_avg < SUPPLY_LOW_TIER_COUNT)
+         startup_dutycycle = LOW_STARTUP_DUTYCYCLE;
+      else if(supply_avg > SUPPLY_HI_TIER_COUNT)
+         startup_dutycycle = HI_STARTUP_DUTYCYCLE;
+      else
+         startup_dutycycle = MED_STARTUP_DUTYCYCLE;
+   }
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       SupplyCompensate                                 *
+*                                                                       *
+*      Description:    scale a duty cycle by nominal/actual supply      *
+*                                                                       *
+*      Parameters:     duty - 10-bit duty cycle from the speed table    *
+*      Return value:   scaled 10-bit duty cycle, limited to 100%        *
+*                                                                       *
+*************************************************************************/
+
+unsigned int SupplyCompensate(unsigned int duty)
+{
+   unsigned long scaled;
+
+   scaled = ((unsigned long)duty * supply_scale) >> 8;
+   if(scaled > MAX_DUTY_COUNT) scaled = MAX_DUTY_COUNT;
+   return (unsigned int)scaled;
+}
+
+#ifdef FAST_BOOT
+/************************************************************************
+*                                                                       *
+*      Function:       BootInit                                         *
+*                                                                       *
+*      Description:    classify the boot and start the bootstrap timer  *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called from InitSystem(). The reset cause is read only on the first  *
+*  call after a reset. Power-on and brown-out resets are cold boots.    *
+*  Any later call is a stop/restart and stays warm once qualified.      *
+*                                                                       *
+*************************************************************************/
+
+void BootInit(void)
+{
+   if(!boot_checked)
+   {
+      boot_checked = 1;
+      warm_boot = (nPOR && nBOR);
+      nPOR = 1;
+      nBOR = 1;
+   }
+   FVRCON = FVRCON_INIT;
+   bootstrap_timer = warm_boot ? TIMEBASE_BOOTSTRAP_WARM_COUNT : TIMEBASE_BOOTSTRAP_COLD_COUNT;
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       BootQualified                                    *
+*                                                                       *
+*      Description:    report whether the warmup can end                *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   1 when the supplies and drivers are ready        *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called every 10 ms by WarmUpControl() while the warmup timer runs.   *
+*  The ADC is returned to the speed control input when done.            *
+*                                                                       *
+*************************************************************************/
+
+bit BootQualified(void)
+{
+   unsigned int fvr;
+
+   if(bootstrap_timer)
+   {
+      bootstrap_timer--;
+      return 0;
+   }
+   if(!supply_is_valid) return 0;
+
+   if(!warm_boot)
+   {
+      if(!FVRRDY) return 0;
+      // Vdd is the ADC reference so a low Vdd reads the FVR high
+      ADCON0 = ADCON0_FVR;
+      _delay((ACQUISITION_TIME_us*FOSC)/4000000L);
+      GODONE = 1;
+      while(GODONE == 1);
+      fvr = ((unsigned int)ADRESH << 2) | (ADRESL >> 6);
+      ADCON0 = ADCON0_SPEED;
+      if(fvr > VDD_MIN_FVR_COUNT) return 0;
+      warm_boot = 1;
+   }
+   return 1;
+}
+#endif
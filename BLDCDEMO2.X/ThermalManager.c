@@ -0,0 +1,141 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : ThermalManager.c                           *
+*                                                                       *
+*     Other Files Required : BLDC.h, I2CDevices.h, ThermalManager.h     *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Board temperature is sampled from the MCP9800 cache, filtered, and converted to a ceiling on the   //
+// 8-bit speed request. SpeedManager() ramps toward the lower of the speed request and the ceiling,   //
+// so a hot board runs at the highest speed the derating curve allows instead of tripping.            //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <xc.h>
+#include "BLDC.h"
+#include "I2CQueue.h"
+#include "I2CDevices.h"
+#include "ThermalManager.h"
+
+extern bit TMR0_thermal_flag;
+extern bit stop_flag;
+extern bit run_flag;
+
+/************************************************************************
+* variable definitions                                                  *
+*************************************************************************/
+
+unsigned char thermal_ceiling = MAX_SPEED_REQUEST;   // read by SpeedManager()
+bit thermal_trip;                                    // motor held off while set
+int thermal_filtered;                                // degrees C * 10
+
+static int thermal_sum;
+static bit thermal_primed;
+static unsigned char thermal_timer = THERMAL_SAMPLE_COUNT;
+
+/************************************************************************
+*                                                                       *
+*      Function:       DerateCeiling                                    *
+*                                                                       *
+*      Description:    speed ceiling on the derating curve              *
+*                                                                       *
+*      Parameters:     t - temperature in degrees C * 10                *
+*      Return value:   8-bit speed ceiling                              *
+*                                                                       *
+*************************************************************************/
+
+static unsigned char DerateCeiling(int t)
+{
+   if(t <= THERMAL_START_TEMP) return MAX_SPEED_REQUEST;
+   if(t >= THERMAL_FULL_TEMP) return THERMAL_MIN_SPEED;
+   return MAX_SPEED_REQUEST - (unsigned char)(((long)(t - THERMAL_START_TEMP) * THERMAL_SLOPE) >> 8);
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       ThermalManager                                   *
+*                                                                       *
+*      Description:    update the speed ceiling from board temperature  *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:                                                    *
+*                                                                       *
+*      Note:                                                            *
+*                                                                       *
+*  Called every main loop. The TMR0_thermal_flag limits execution to    *
+*  every 10 ms and THERMAL_SAMPLE_COUNT sets the sample interval.       *
+*  No derating is applied until the first valid temperature arrives.    *
+*                                                                       *
+*************************************************************************/
+
+void ThermalManager(void)
+{
+   int t;
+   unsigned char ceiling;
+
+   if(!TMR0_thermal_flag) return;        // hold off for 10 ms
+   TMR0_thermal_flag = 0;
+   if(--thermal_timer) return;
+   thermal_timer = THERMAL_SAMPLE_COUNT;
+
+   // returns the last reading and queues the next one
+   t = mcp9800_get_temp();
+   if(!mcp9800_temp_valid()) return;
+
+   // first order low pass filter, started at the first reading
+   if(!thermal_primed)
+   {
+      thermal_sum = t << THERMAL_FILTER_SHIFT;
+      thermal_primed = 1;
+   }
+   thermal_sum += t - (thermal_sum >> THERMAL_FILTER_SHIFT);
+   thermal_filtered = thermal_sum >> THERMAL_FILTER_SHIFT;
+
+   // over temperature: stop and hold off restart until cooled by the hysteresis
+   if(thermal_filtered >= THERMAL_TRIP_TEMP)
+   {
+      if(run_flag) stop_flag = 1;
+      thermal_trip = 1;
+   }
+   else if(thermal_filtered < (THERMAL_TRIP_TEMP - THERMAL_HYSTERESIS))
+   {
+      thermal_trip = 0;
+   }
+
+   // lower the ceiling at once, raise it only when cooled by the hysteresis
+   ceiling = DerateCeiling(thermal_filtered);
+   if(ceiling < thermal_ceiling)
+   {
+      thermal_ceiling = ceiling;
+   }
+   else
+   {
+      ceiling = DerateCeiling(thermal_filtered + THERMAL_HYSTERESIS);
+      if(ceiling > thermal_ceiling) thermal_ceiling = ceiling;
+   }
+}
+
+/************************************************************************
+*                                                                       *
+*      Function:       ThermalDerate                                    *
+*                                                                       *
+*      Description:    report the present derating                      *
+*                                                                       *
+*      Parameters:                                                      *
+*      Return value:   speed ceiling as a percentage of full speed,     *
+*                      0 while tripped                                  *
+*                                                                       *
+*************************************************************************/
+
+unsigned char ThermalDerate(void)
+{
+   if(thermal_trip) return 0;
+   return (unsigned char)(((unsigned int)thermal_ceiling * 100) / MAX_SPEED_REQUEST);
+}
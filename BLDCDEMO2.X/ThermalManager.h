@@ -0,0 +1,60 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : ThermalManager.h                           *
+*                                                                       *
+*     Other Files Required : ThermalManager.c                           *
+*     Tools Used: MPLAB X  : 5.x                                        *
+*                 Compiler : XC8 2.00                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Thermal derating curve. All temperatures are in degrees C * 10 as returned by mcp9800_get_temp().  //
+//                                                                                                    //
+//   speed ceiling                                                                                    //
+//   255 |-----------\                                                                                //
+//       |            \                                                                               //
+//       |             \                                                                              //
+//   MIN |              \---------|                                                                   //
+//       |                        |  stop                                                             //
+//       +-----------+-----+------+------> filtered temperature                                       //
+//                 START  FULL   TRIP                                                                 //
+//                                                                                                    //
+// Between START and FULL the ceiling falls linearly from MAX_SPEED_REQUEST to THERMAL_MIN_SPEED.     //
+// The ceiling is lowered as soon as the temperature rises but is only raised again once the          //
+// temperature has fallen THERMAL_HYSTERESIS below the point that set it. Above TRIP the motor is     //
+// stopped and may not restart until the temperature has fallen THERMAL_HYSTERESIS below TRIP.        //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+
+#ifndef THERMALMANAGER_H
+#define THERMALMANAGER_H
+
+// derating curve
+#define  THERMAL_START_TEMP         600       // 60.0 C, full speed below this
+#define  THERMAL_FULL_TEMP          850       // 85.0 C, ceiling reaches THERMAL_MIN_SPEED
+#define  THERMAL_TRIP_TEMP          950       // 95.0 C, motor is stopped
+#define  THERMAL_MIN_SPEED          96        // 8-bit speed ceiling at THERMAL_FULL_TEMP
+#define  THERMAL_HYSTERESIS         30        // 3.0 C
+
+// speed ceiling reduction per degree C * 10, scaled by 256
+#define  THERMAL_SLOPE              (((MAX_SPEED_REQUEST-THERMAL_MIN_SPEED)*256L)/(THERMAL_FULL_TEMP-THERMAL_START_TEMP))
+
+// temperature sample interval in 10 ms TimeBaseManager counts
+#define  THERMAL_SAMPLE_COUNT       50
+
+// first order filter, time constant = 2^THERMAL_FILTER_SHIFT samples
+#define  THERMAL_FILTER_SHIFT       3
+
+#if (THERMAL_FULL_TEMP <= THERMAL_START_TEMP) || (THERMAL_TRIP_TEMP <= THERMAL_FULL_TEMP)
+   #error "Thermal derating temperatures must be in increasing order"
+#endif
+
+void ThermalManager(void);
+unsigned char ThermalDerate(void);
+
+#endif
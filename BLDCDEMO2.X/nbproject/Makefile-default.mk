@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=ADCSpeedManager.c BLDC_Interrupts_Plain.c Config.c DirectDrivers.c F1937_Main.c LinearSpeedProfile_16K.c
+SOURCEFILES_QUOTED_IF_SPACED=ADCSpeedManager.c BLDC_Interrupts_Plain.c Config.c DirectDrivers.c F1937_Main.c LinearSpeedProfile_16K.c SupplyManager.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/ADCSpeedManager.p1 ${OBJECTDIR}/BLDC_Interrupts_Plain.p1 ${OBJECTDIR}/Config.p1 ${OBJECTDIR}/DirectDrivers.p1 ${OBJECTDIR}/F1937_Main.p1 ${OBJECTDIR}/LinearSpeedProfile_16K.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/ADCSpeedManager.p1.d ${OBJECTDIR}/BLDC_Interrupts_Plain.p1.d ${OBJECTDIR}/Config.p1.d ${OBJECTDIR}/DirectDrivers.p1.d ${OBJECTDIR}/F1937_Main.p1.d ${OBJECTDIR}/LinearSpeedProfile_16K.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/ADCSpeedManager.p1 ${OBJECTDIR}/BLDC_Interrupts_Plain.p1 ${OBJECTDIR}/Config.p1 ${OBJECTDIR}/DirectDrivers.p1 ${OBJECTDIR}/F1937_Main.p1 ${OBJECTDIR}/LinearSpeedProfile_16K.p1 ${OBJECTDIR}/SupplyManager.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/ADCSpeedManager.p1.d ${OBJECTDIR}/BLDC_Interrupts_Plain.p1.d ${OBJECTDIR}/Config.p1.d ${OBJECTDIR}/DirectDrivers.p1.d ${OBJECTDIR}/F1937_Main.p1.d ${OBJECTDIR}/LinearSpeedProfile_16K.p1.d ${OBJECTDIR}/SupplyManager.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/ADCSpeedManager.p1 ${OBJECTDIR}/BLDC_Interrupts_Plain.p1 ${OBJECTDIR}/Config.p1 ${OBJECTDIR}/DirectDrivers.p1 ${OBJECTDIR}/F1937_Main.p1 ${OBJECTDIR}/LinearSpeedProfile_16K.p1
+OBJECTFILES=${OBJECTDIR}/ADCSpeedManager.p1 ${OBJECTDIR}/BLDC_Interrupts_Plain.p1 ${OBJECTDIR}/Config.p1 ${OBJECTDIR}/DirectDrivers.p1 ${OBJECTDIR}/F1937_Main.p1 ${OBJECTDIR}/LinearSpeedProfile_16K.p1 ${OBJECTDIR}/SupplyManager.p1
 
 # Source Files
-SOURCEFILES=ADCSpeedManager.c BLDC_Interrupts_Plain.c Config.c DirectDrivers.c F1937_Main.c LinearSpeedProfile_16K.c
+SOURCEFILES=ADCSpeedManager.c BLDC_Interrupts_Plain.c Config.c DirectDrivers.c F1937_Main.c LinearSpeedProfile_16K.c SupplyManager.c
 
 
 CFLAGS=
@@ -134,6 +134,13 @@ ${OBJECTDIR}/LinearSpeedProfile_16K.p1: LinearSpeedProfile_16K.c  nbproject/Make
 	@${RM} ${OBJECTDIR}/LinearSpeedProfile_16K.p1 
 	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/LinearSpeedProfile_16K.p1 LinearSpeedProfile_16K.c 
 	@${FIXDEPS} ${OBJECTDIR}/LinearSpeedProfile_16K.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+${OBJECTDIR}/SupplyManager.p1: SupplyManager.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/SupplyManager.p1.d 
+	@${RM} ${OBJECTDIR}/SupplyManager.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/SupplyManager.p1 SupplyManager.c 
+	@${FIXDEPS} ${OBJECTDIR}/SupplyManager.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 	
 else
 ${OBJECTDIR}/ADCSpeedManager.p1: ADCSpeedManager.c  nbproject/Makefile-${CND_CONF}.mk
@@ -178,6 +185,13 @@ ${OBJECTDIR}/LinearSpeedProfile_16K.p1: LinearSpeedProfile_16K.c  nbproject/Make
 	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/LinearSpeedProfile_16K.p1 LinearSpeedProfile_16K.c 
 	@${FIXDEPS} ${OBJECTDIR}/LinearSpeedProfile_16K.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/SupplyManager.p1: SupplyManager.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/SupplyManager.p1.d 
+	@${RM} ${OBJECTDIR}/SupplyManager.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/SupplyManager.p1 SupplyManager.c 
+	@${FIXDEPS} ${OBJECTDIR}/SupplyManager.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -0,0 +1,324 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/boot_sim.c                            *
+*                                                                       *
+*     Other Files Required : F1937_Main.c, SupplyManager.c,             *
+*                            ADCSpeedManager.c, DirectDrivers.c,        *
+*                            LinearSpeedProfile_16K.c                   *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Startup latency of the F1937 demo with and without FAST_BOOT.                                      //
+//                                                                                                    //
+// The Makefile builds this file twice: boot_sim_fixed without FAST_BOOT and boot_sim with it. Each   //
+// pass of the simulated main loop makes the calls main() in F1937_Main.c makes, plus SpeedManager()  //
+// from ADCSpeedManager.c the way the combined demo does, since nothing else sets run_flag. Timer 0    //
+// overflows every TIMEBASE_MS_PER_TICK and the ADC converts the analog inputs below when the         //
+// firmware polls GO_nDONE:                                                                           //
+//                                                                                                    //
+//    Vdd(t) = VDD - (VDD - VDD_RESET) * exp(-t/tau_dd)      logic supply, ADC reference              //
+//    Vm(t)  = VM * (1 - exp(-(t + t_pre)/tau_m))            motor supply behind the bulk capacitor   //
+//    FVR    = 1.024 V, speed pot at full scale                                                       //
+//                                                                                                    //
+// Time starts at the first instruction after reset. Two points are measured:                         //
+//                                                                                                    //
+//    drive   InitDriver() ran: warmup over, bridge driven at the first commutation                   //
+//    spin    slow start done: GIE set and the open loop ramp handed to the ISR                       //
+//                                                                                                    //
+// The ramp from spin to BEMF lock runs in the ISR against the motor and is not modelled; it is the   //
+// same with and without FAST_BOOT. boot_sim runs boot_sim_fixed for the reference figures and checks //
+// each scenario's limits, including that the drivers never start on an unqualified supply.           //
+//                                                                                                    //
+// FAST_BOOT shortens the wait to drive. The three step slow start from drive to spin aligns the      //
+// rotor and is kept as it is: ramp_sim loses starts with a shorter dwell or fewer steps. The cut is  //
+// therefore checked on the time to drive, and the slow start is checked to be unchanged.             //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#define  _POSIX_C_SOURCE            200809L   // popen()
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xc.h"
+#include "../BLDC.h"
+#include "../EBM_Motor.h"
+#include "../1937_DRIVER.h"
+
+// the Makefile renames the firmware's main()
+#undef   main
+
+#define  LOOP_US                    40L       // main loop pass
+#define  RUN_US                     3000000L  // give up after
+#define  STOP_AFTER_US              200000L   // restart scenarios stop this long after spin
+
+// registers
+volatile _Bool GIE, PEIE;
+volatile unsigned char OSCCON, OPTION_REG, TMR0, T1CON, T2CON, PR2, TMR1H, TMR1L;
+volatile _Bool TMR0IF, TMR1IF, TMR1IE, TMR1ON, nPOR, nBOR;
+volatile unsigned char ADCON0, ADRESH, ADRESL, FVRCON;
+volatile _Bool FVRRDY;
+volatile unsigned char CCP1CON, CCPR1L, PSTR1CON, CM1CON0, CM1CON1;
+volatile _Bool DC1B0, DC1B1, STR1A, STR1B, STR1C;
+volatile _Bool C1IE, C1IF, MC1OUT;
+volatile unsigned char TRISA, TRISB, TRISC;
+volatile _Bool ANSA0, ANSA1, ANSA3, ANSA5, ANSB3;
+volatile _Bool LATC0, LATC1, LATC5, LATB6, LATB7;
+
+// owned by the motor ISR, which is not built here
+enum {high_res_setup,zero_detect,commutate}isr_state;
+
+// F1937_Main.c, SupplyManager.c and ADCSpeedManager.c
+extern bit stop_flag;
+extern bit init_complete_flag;
+extern bit supply_is_valid;
+void InitSystem(void);
+void TimeBaseManager(void);
+void WarmUpControl(void);
+void ControlSlowStart(void);
+void ControlStartUp(void);
+void StallControl(void);
+void SpeedManager(void);
+
+typedef struct {
+   const char *name;
+   double vdd;                      // V settled logic supply
+   double vdd_reset;                // V at the first instruction
+   double tau_dd;                   // ms
+   double vm;                       // V settled motor supply
+   double tau_m;                    // ms bulk capacitor charge
+   double pre_ms;                   // motor supply charge time before the first instruction
+   unsigned char warm;              // reset with nPOR and nBOR still set
+   unsigned char restart;           // measure a stop/restart after the first spin
+   // limits for FAST_BOOT, ms
+   unsigned int drive_max;
+   unsigned int spin_max;
+   unsigned char cut_pct;           // least cut in time to drive against boot_sim_fixed
+} Scenario;
+
+static const Scenario scenarios[] = {
+   //  name                               Vdd  reset  tau    Vm    tau   pre  warm restart  drive  spin cut%
+   {"cold power-up, stiff supply",        5.0,  4.8,   1,  12.0,   10,    0,   0,   0,       100,  450,  80},
+   {"cold power-up, large bulk cap",      5.0,  4.8,   1,  12.0,  120,    0,   0,   0,       400,  750,  20},
+   {"cold power-up, slow Vdd",            5.0,  3.0,  60,  12.0,   10,    0,   0,   0,       110,  460,  80},
+   {"cold power-up, Vdd low",             4.3,  4.3,   1,  12.0,   10,    0,   0,   0,       500,  850,   0},
+   {"watchdog reset, supplies up",        5.0,  5.0,   1,  12.0,   10,  500,   1,   0,       100,  450,  80},
+   {"stop and restart",                   5.0,  4.8,   1,  12.0,   10,    0,   0,   1,        60,  410,  90},
+};
+
+typedef struct {
+   long drive_us;                   // -1 if not reached
+   long spin_us;
+   double vm_drive;                 // V motor supply when the drivers started
+   double vdd_drive;
+   unsigned long supply_samples;
+} Result;
+
+static const Scenario *scenario;
+static long now;                    // us since the first instruction
+static unsigned long adc_supply;
+
+/************************************************************************
+* analog model                                                          *
+*************************************************************************/
+
+static double Vdd(void)
+{
+   return scenario->vdd - (scenario->vdd - scenario->vdd_reset) * exp(-now / (1000.0 * scenario->tau_dd));
+}
+
+static double Vm(void)
+{
+   return scenario->vm * (1.0 - exp(-(now + 1000.0 * scenario->pre_ms) / (1000.0 * scenario->tau_m)));
+}
+
+// ADC referenced to Vdd, left justified
+unsigned char *host_adc_go(void)
+{
+   static unsigned char go;
+   double volts;
+   long count;
+
+   if(go)
+   {
+      go = 0;
+      if(ADCON0 == ADCON0_SUPPLY)
+      {
+         volts = Vm() * BEMF_R2 / ((BEMF_R1 + BEMF_R2) * SUPPLY_REF_DIVIDER);
+         adc_supply++;
+      }
+      else if(ADCON0 == ADCON0_FVR)
+         volts = (FVRCON & 0x80) ? FVR_mV / 1000.0 : 0;
+      else
+         volts = Vdd();                   // speed pot at full scale
+      count = (long)(1023.0 * volts / Vdd() + 0.5);
+      if(count > 1023) count = 1023;
+      ADRESH = count >> 2;
+      ADRESL = (count & 3) << 6;
+   }
+   return &go;
+}
+
+/************************************************************************
+* scenario run                                                          *
+*************************************************************************/
+
+static Result Simulate(const Scenario *s)
+{
+   Result r = {-1, -1, 0, 0, 0};
+   long next_tick = TIMEBASE_MS_PER_TICK * 1000L;
+   long start = 0;
+   long stop_at = -1;
+   unsigned char was_driven = 0, was_spinning = 0;
+
+   scenario = s;
+   now = 0;
+   nPOR = s->warm;
+   nBOR = s->warm;
+   stop_flag = 1;
+
+   for(; now < RUN_US; now += LOOP_US)
+   {
+      if(now >= next_tick)
+      {
+         TMR0IF = 1;
+         next_tick += TIMEBASE_MS_PER_TICK * 1000L;
+      }
+      FVRRDY = (FVRCON & 0x80) != 0;
+      if(now == stop_at) stop_flag = 1;
+
+      // main()
+      if(stop_flag) InitSystem();
+      TimeBaseManager();
+      WarmUpControl();
+      ControlSlowStart();
+      ControlStartUp();
+      StallControl();
+      SupplyManager();
+      SpeedManager();
+
+      if(init_complete_flag && !was_driven)
+      {
+         r.drive_us = now - start;
+         r.vm_drive = Vm();
+         r.vdd_drive = Vdd();
+      }
+      was_driven = init_complete_flag;
+      if(GIE && !was_spinning)
+      {
+         r.spin_us = now - start;
+         if(!s->restart || stop_at >= 0) break;
+         // time the restart from the stop
+         stop_at = now + STOP_AFTER_US;
+         start = stop_at;
+         r.drive_us = r.spin_us = -1;
+      }
+      was_spinning = GIE;
+   }
+   r.supply_samples = adc_supply;
+   return r;
+}
+
+// the firmware keeps its state in statics, so every run gets a fresh process
+static Result Run(const Scenario *s)
+{
+   int fd[2];
+   Result r = {-1, -1, 0, 0, 0};
+
+   if(pipe(fd) || fflush(stdout)) exit(EXIT_FAILURE);
+   if(fork() == 0)
+   {
+      r = Simulate(s);
+      if(write(fd[1], &r, sizeof r) != sizeof r) _exit(EXIT_FAILURE);
+      _exit(EXIT_SUCCESS);
+   }
+   if(read(fd[0], &r, sizeof r) != sizeof r) r.drive_us = r.spin_us = -1;
+   wait(0);
+   close(fd[0]);
+   close(fd[1]);
+   return r;
+}
+
+#ifndef FAST_BOOT
+
+// boot_sim_fixed <n> prints the reference figures for scenario n
+int main(int argc, char **argv)
+{
+   unsigned int n;
+   Result r;
+
+   if(argc != 2 || (n = atoi(argv[1])) >= sizeof scenarios / sizeof scenarios[0]) return EXIT_FAILURE;
+   r = Run(&scenarios[n]);
+   printf("%ld %ld\n", r.drive_us, r.spin_us);
+   return EXIT_SUCCESS;
+}
+
+#else
+
+static int failures;
+
+static void Check(int ok, const char *what)
+{
+   printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+   if(!ok) failures++;
+}
+
+static int Reference(unsigned int n, Result *r)
+{
+   char command[32];
+   FILE *p;
+   int ok;
+
+   snprintf(command, sizeof command, "./boot_sim_fixed %u", n);
+   if(!(p = popen(command, "r"))) return 0;
+   ok = fscanf(p, "%ld %ld", &r->drive_us, &r->spin_us) == 2;
+   return (pclose(p) == 0) && ok;
+}
+
+static void Scenario_Run(unsigned int n)
+{
+   const Scenario *s = &scenarios[n];
+   Result f, x = {-1, -1, 0, 0, 0};
+   double cut, spin_cut;
+   int have_ref;
+
+   f = Run(s);
+   have_ref = Reference(n, &x);
+   cut = (have_ref && x.drive_us > 0 && f.drive_us >= 0) ? 100.0 * (x.drive_us - f.drive_us) / x.drive_us : 0;
+   spin_cut = (have_ref && x.spin_us > 0 && f.spin_us >= 0) ? 100.0 * (x.spin_us - f.spin_us) / x.spin_us : 0;
+
+   printf("  %s: Vdd %.1f V from %.1f V, Vm %.0f V tau %.0f ms\n", s->name, s->vdd, s->vdd_reset, s->vm, s->tau_m);
+   printf("    %-10s drive %4ld ms  spin %4ld ms\n", "fixed", x.drive_us / 1000, x.spin_us / 1000);
+   printf("    %-10s drive %4ld ms  spin %4ld ms  cut %3.0f%% to drive, %3.0f%% to spin  Vm %4.1f V  Vdd %.2f V at drive\n",
+          "FAST_BOOT", f.drive_us / 1000, f.spin_us / 1000, cut, spin_cut, f.vm_drive, f.vdd_drive);
+
+   Check(have_ref && x.spin_us > 0, "reference build reaches spin");
+   Check(f.drive_us >= 0 && f.drive_us <= s->drive_max * 1000L, "time to drive within limit");
+   Check(f.spin_us >= 0 && f.spin_us <= s->spin_max * 1000L, "time to spin within limit");
+   Check(cut >= s->cut_pct, "cut in time to drive against the fixed warmup within limit");
+   // the slow start dwell starts on the next count, so it may move by one either way
+   Check(labs((f.spin_us - f.drive_us) - (x.spin_us - x.drive_us)) <= TIMEBASE_MS_PER_COUNT * 2000L,
+         "slow start alignment unchanged");
+   Check(f.vm_drive * 10 > SUPPLY_MIN, "drivers start on a valid motor supply");
+   Check(f.drive_us >= TIMEBASE_WARMUP_ms * 1000L || f.vdd_drive * 10 >= VDD_MIN, "early start only above VDD_MIN");
+}
+
+int main(void)
+{
+   unsigned int n;
+
+   alarm(60);
+   printf("startup latency, fixed %ld ms warmup against FAST_BOOT\n", (long)TIMEBASE_WARMUP_ms);
+   for(n = 0; n < sizeof scenarios / sizeof scenarios[0]; n++) Scenario_Run(n);
+
+   printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+   return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif
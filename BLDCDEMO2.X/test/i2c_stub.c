@@ -0,0 +1,468 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/i2c_stub.c                            *
+*                                                                       *
+*     Other Files Required : i2c_stub.h, xc.h, I2CQueue.c               *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// MSSP master, bus and slave models for the host tests. See i2c_stub.h.                              //
+//                                                                                                    //
+// The MCP9800 returns its temperature register at the resolution set in its configuration register,  //
+// 9 bits after power-up. The MCP79410 counts seconds, minutes and hours in BCD while its ST bit is   //
+// set and auto-increments the register pointer. A slave that is not present leaves the address byte //
+// unacknowledged.                                                                                    //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <stdio.h>
+#include <math.h>
+#include "xc.h"
+#include "i2c_stub.h"
+#include "../BLDC.h"
+#include "../I2CQueue.h"
+#include "../I2CDevices.h"
+
+// the register model behind xc.h
+volatile _Bool GIE, PEIE;
+volatile _Bool SSPIE, SSPIF, BCLIE, BCLIF;
+volatile unsigned int SSPBUF = SSPBUF_IDLE;
+volatile unsigned char SSPADD, SSPSTAT, SSPCON1, SSPCON2;
+volatile _Bool SSPEN;
+volatile _Bool SEN, RSEN, PEN, RCEN, ACKEN, ACKDT, ACKSTAT;
+volatile _Bool TRISC3, TRISC4;
+
+#define  FOSC_MHZ                   32
+#define  SSPCON1_SSPEN              0x20
+#define  ISR_HISTORY                64
+
+unsigned long stub_now;
+StubStats stub_stats;
+unsigned int stub_isr_delay_us;
+unsigned int stub_stretch_us;
+unsigned int stub_mainloop_us = 100;
+
+unsigned char stub_mcp9800_present;
+double stub_mcp9800_temp;
+unsigned char stub_rtcc_present;
+
+static enum {
+   ev_none,
+   ev_start,
+   ev_restart,
+   ev_stop,
+   ev_transmit,
+   ev_receive,
+   ev_ack
+} active;
+static unsigned long active_end;
+static unsigned char tx_byte;
+
+// bus and addressed slave
+static enum {
+   bus_idle,                        // no START issued
+   bus_address,                     // START done, address byte next
+   bus_write,                       // writing to the slave
+   bus_read,                        // slave transmitting, master receives
+   bus_read_acked,                  // read byte acknowledged, slave keeps SDA
+   bus_read_nacked,                 // last byte NACKed, only STOP or repeated START
+   bus_released                     // NACK or address not acknowledged
+} bus;
+static unsigned char slave;         // addressed slave, 0 = none
+static unsigned char pointer_next;  // next written byte is the register pointer
+static unsigned char pointer;
+static unsigned char read_index;    // byte within a multi byte register
+static unsigned char rx_byte;
+static unsigned long transfer_start;
+
+static unsigned char mcp9800_config;
+static unsigned char rtcc_reg[3];   // seconds with ST, minutes, hours, BCD
+static unsigned long rtcc_us;
+
+static unsigned long isr_pending_since;
+static unsigned char isr_pending;
+static unsigned long isr_history[ISR_HISTORY];
+static unsigned char isr_history_count;
+static unsigned char isr_history_next;
+
+/************************************************************************
+* helpers                                                               *
+*************************************************************************/
+
+void stub_error(const char *what)
+{
+   if(stub_stats.errors < 10)
+      printf("    ERROR at %lu us: %s\n", stub_now, what);
+   stub_stats.errors++;
+}
+
+static unsigned char FromBCD(unsigned char bcd)
+{
+   return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+static unsigned char ToBCD(unsigned char value)
+{
+   return ((value / 10) << 4) | (value % 10);
+}
+
+static unsigned int BitTime(void)
+{
+   return ((SSPADD + 1) * 4) / FOSC_MHZ;
+}
+
+/************************************************************************
+* slaves                                                                *
+*************************************************************************/
+
+static unsigned char SlaveAck(unsigned char address)
+{
+   if(address == MCP9800_ADDRESS && stub_mcp9800_present) return address;
+   if(address == RTCC_ADDRESS && stub_rtcc_present) return address;
+   return 0;
+}
+
+static void SlaveWrite(unsigned char value)
+{
+   if(pointer_next)
+   {
+      pointer = value;
+      pointer_next = 0;
+      read_index = 0;
+      return;
+   }
+   if(slave == MCP9800_ADDRESS)
+   {
+      if(pointer == 1) mcp9800_config = value;
+      return;
+   }
+   if(pointer < 3)
+   {
+      rtcc_reg[pointer] = value;
+      if(pointer == 0) rtcc_us = 0;
+   }
+   pointer++;
+}
+
+static unsigned char SlaveRead(void)
+{
+   int counts;
+   unsigned char resolution;
+
+   if(slave == MCP9800_ADDRESS)
+   {
+      if(pointer == 1) return mcp9800_config;
+      if(pointer != 0) return 0;
+      // 1/16 degree counts, low bits cleared below the configured resolution
+      counts = (int)floor(stub_mcp9800_temp * 16.0);
+      resolution = 9 + ((mcp9800_config >> 5) & 3);
+      counts &= ~((1 << (12 - resolution)) - 1);
+      counts <<= 4;
+      return (read_index++ & 1) ? (unsigned char)counts : (unsigned char)(counts >> 8);
+   }
+   if(pointer < 3) return rtcc_reg[pointer++];
+   pointer++;
+   return 0;
+}
+
+static void RtccAdvance(unsigned long us)
+{
+   unsigned long s;
+
+   if(!(rtcc_reg[0] & 0x80)) return;
+   rtcc_us += us;
+   if(rtcc_us < 1000000L) return;
+   s = (stub_rtcc_seconds() + rtcc_us / 1000000L) % 86400L;
+   rtcc_us %= 1000000L;
+   rtcc_reg[0] = ToBCD(s % 60) | 0x80;
+   rtcc_reg[1] = ToBCD((s / 60) % 60);
+   rtcc_reg[2] = ToBCD(s / 3600);
+}
+
+void stub_rtcc_power_up(unsigned long seconds, unsigned char running)
+{
+   rtcc_reg[0] = ToBCD(seconds % 60) | (running ? 0x80 : 0);
+   rtcc_reg[1] = ToBCD((seconds / 60) % 60);
+   rtcc_reg[2] = ToBCD(seconds / 3600);
+   rtcc_us = 0;
+}
+
+unsigned long stub_rtcc_seconds(void)
+{
+   return FromBCD(rtcc_reg[2] & 0x3F) * 3600L
+        + FromBCD(rtcc_reg[1] & 0x7F) * 60
+        + FromBCD(rtcc_reg[0] & 0x7F);
+}
+
+unsigned char stub_rtcc_running(void)
+{
+   return (rtcc_reg[0] & 0x80) != 0;
+}
+
+/************************************************************************
+* MSSP                                                                  *
+*************************************************************************/
+
+static void Begin(int event, unsigned long length)
+{
+   if(!(SSPCON1 & SSPCON1_SSPEN)) stub_error("bus action with the MSSP disabled");
+   if(active != ev_none)
+   {
+      stub_error("bus action issued while another is in progress (WCOL)");
+      return;
+   }
+   active = event;
+   active_end = stub_now + length;
+}
+
+static unsigned char Latch(void)
+{
+   unsigned char actions = 0;
+   unsigned int bit = BitTime();
+
+   if(SEN && active != ev_start)
+   {
+      actions++;
+      if(bus != bus_idle) stub_error("START while the bus is owned");
+      transfer_start = stub_now;
+      Begin(ev_start, bit);
+   }
+   if(RSEN && active != ev_restart)
+   {
+      actions++;
+      if(bus == bus_idle || bus == bus_read_acked) stub_error("repeated START in the wrong bus state");
+      Begin(ev_restart, bit);
+   }
+   if(PEN && active != ev_stop)
+   {
+      actions++;
+      if(bus == bus_idle) stub_error("STOP without START");
+      if(bus == bus_read_acked) stub_error("STOP after an acknowledged read byte, slave holds SDA");
+      Begin(ev_stop, bit);
+   }
+   if(RCEN && active != ev_receive)
+   {
+      actions++;
+      if(bus != bus_read) stub_error("receive enabled in the wrong bus state");
+      Begin(ev_receive, 8 * bit + stub_stretch_us);
+   }
+   if(ACKEN && active != ev_ack)
+   {
+      actions++;
+      Begin(ev_ack, bit);
+   }
+   if(SSPBUF < SSPBUF_IDLE)
+   {
+      actions++;
+      tx_byte = (unsigned char)SSPBUF;
+      SSPBUF = SSPBUF_IDLE | tx_byte;
+      if(bus != bus_address && bus != bus_write) stub_error("byte written in the wrong bus state");
+      Begin(ev_transmit, 9 * bit + stub_stretch_us);
+   }
+   return actions;
+}
+
+static void Complete(void)
+{
+   switch(active)
+   {
+      case ev_start:
+         SEN = 0;
+         bus = bus_address;
+         slave = 0;
+         stub_stats.transfers++;
+         break;
+
+      case ev_restart:
+         RSEN = 0;
+         bus = bus_address;
+         break;
+
+      case ev_stop:
+         PEN = 0;
+         bus = bus_idle;
+         slave = 0;
+         stub_stats.busy_us += stub_now - transfer_start;
+         break;
+
+      case ev_transmit:
+         stub_stats.bytes++;
+         if(bus == bus_address)
+         {
+            slave = SlaveAck(tx_byte >> 1);
+            ACKSTAT = !slave;
+            if(!slave) bus = bus_released;
+            else if(tx_byte & 1)
+            {
+               bus = bus_read;
+               read_index = 0;
+            }
+            else
+            {
+               bus = bus_write;
+               pointer_next = 1;
+            }
+         }
+         else
+         {
+            SlaveWrite(tx_byte);
+            ACKSTAT = 0;
+         }
+         break;
+
+      case ev_receive:
+         RCEN = 0;
+         stub_stats.bytes++;
+         rx_byte = SlaveRead();
+         SSPBUF = SSPBUF_IDLE | rx_byte;
+         bus = bus_read_acked;
+         break;
+
+      case ev_ack:
+         ACKEN = 0;
+         if(bus != bus_read_acked) stub_error("ACK sequence without a received byte");
+         bus = ACKDT ? bus_read_nacked : bus_read;
+         break;
+
+      default:
+         return;
+   }
+   active = ev_none;
+   stub_stats.events++;
+   SSPIF = 1;
+}
+
+/************************************************************************
+* scheduler                                                             *
+*************************************************************************/
+
+void stub_reset(void)
+{
+   StubStats empty = {0};
+
+   stub_stats = empty;
+   stub_stats.isr_min_gap_us = 0xFFFFFFFFUL;
+   stub_now = 0;
+   active = ev_none;
+   bus = bus_idle;
+   slave = 0;
+   GIE = PEIE = 0;
+   SSPIE = SSPIF = BCLIE = BCLIF = 0;
+   SEN = RSEN = PEN = RCEN = ACKEN = ACKDT = ACKSTAT = 0;
+   SSPBUF = SSPBUF_IDLE;
+   SSPCON1 = 0;
+   stub_isr_delay_us = 0;
+   stub_stretch_us = 0;
+   stub_mainloop_us = 100;
+   stub_mcp9800_present = 1;
+   stub_mcp9800_temp = 25.0;
+   mcp9800_config = 0;
+   stub_rtcc_present = 1;
+   stub_rtcc_power_up(0, 1);
+   isr_pending = 0;
+   isr_history_count = 0;
+   isr_history_next = 0;
+}
+
+void stub_call(StubHook firmware)
+{
+   firmware();
+   Latch();
+}
+
+static void ServiceIsr(void)
+{
+   unsigned char actions;
+   unsigned char n;
+   unsigned char in_window;
+   unsigned long last;
+
+   if(isr_history_count)
+   {
+      last = isr_history[(isr_history_next + ISR_HISTORY - 1) % ISR_HISTORY];
+      if(stub_now - last < stub_stats.isr_min_gap_us) stub_stats.isr_min_gap_us = stub_now - last;
+   }
+   isr_history[isr_history_next] = stub_now;
+   isr_history_next = (isr_history_next + 1) % ISR_HISTORY;
+   if(isr_history_count < ISR_HISTORY) isr_history_count++;
+   in_window = 0;
+   for(n = 0; n < isr_history_count; n++)
+      if(stub_now - isr_history[n] < 1000) in_window++;
+   if(in_window > stub_stats.isr_max_per_ms) stub_stats.isr_max_per_ms = in_window;
+
+   if(stub_now - isr_pending_since > stub_stats.isr_wait_max)
+      stub_stats.isr_wait_max = stub_now - isr_pending_since;
+   stub_stats.isr_calls++;
+
+   I2CQ_ISR();
+   actions = Latch();
+   if(!actions) stub_stats.isr_idle_calls++;
+   if(actions > stub_stats.isr_max_actions) stub_stats.isr_max_actions = actions;
+}
+
+void stub_collision(void)
+{
+   // the other master wins: the MSSP abandons its event and goes idle
+   SEN = RSEN = PEN = RCEN = ACKEN = 0;
+   active = ev_none;
+   bus = bus_idle;
+   slave = 0;
+   BCLIF = 1;
+}
+
+void stub_run(unsigned long us, StubHook mainloop)
+{
+   unsigned long end = stub_now + us;
+   unsigned long next_mainloop = stub_now;
+
+   while(stub_now < end)
+   {
+      stub_now++;
+      RtccAdvance(1);
+      if(active != ev_none && stub_now >= active_end) Complete();
+
+      if(GIE && PEIE && ((SSPIF && SSPIE) || (BCLIF && BCLIE)))
+      {
+         if(!isr_pending)
+         {
+            isr_pending = 1;
+            isr_pending_since = stub_now;
+         }
+         if(stub_now - isr_pending_since >= stub_isr_delay_us)
+         {
+            isr_pending = 0;
+            ServiceIsr();
+         }
+      }
+      else
+      {
+         isr_pending = 0;
+      }
+
+      if(mainloop && stub_now >= next_mainloop)
+      {
+         next_mainloop = stub_now + stub_mainloop_us;
+         stub_stats.mainloop_calls++;
+         stub_call(mainloop);
+      }
+   }
+}
+
+/************************************************************************
+*                                                                       *
+*  Moves time on without stepping the bus, for long runs where the      *
+*  firmware only uses the bus now and then. The bus must be idle.       *
+*                                                                       *
+*************************************************************************/
+
+void stub_skip(unsigned long us)
+{
+   if(active != ev_none || SSPIF || BCLIF || I2CQ_Busy()) stub_error("time skipped with the bus busy");
+   stub_now += us;
+   RtccAdvance(us);
+}
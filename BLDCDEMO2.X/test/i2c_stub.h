@@ -0,0 +1,69 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/i2c_stub.h                            *
+*                                                                       *
+*     Other Files Required : i2c_stub.c, xc.h                           *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Host model of the MSSP in I2C master mode with an MCP9800 and an MCP79410 on the bus.              //
+//                                                                                                    //
+// Time advances in 1 us steps. Each bus event (START, byte, ACK, STOP) takes its 100 kHz bus time,   //
+// then SSPIF is raised and I2CQ_ISR() is called once the configured service delay has passed, the    //
+// way the motor ISR reaches the MSSP after the motor events. After every firmware call the stub      //
+// picks up the bus action the firmware issued and checks it against the bus protocol.                //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#ifndef I2C_STUB_H
+#define I2C_STUB_H
+
+typedef void (*StubHook)(void);
+
+typedef struct {
+   unsigned long isr_calls;         // I2CQ_ISR() entries
+   unsigned long isr_idle_calls;    // entries with nothing to do
+   unsigned char isr_max_actions;   // most bus actions issued by one entry, must be 1
+   unsigned long isr_wait_max;      // longest SSPIF to I2CQ_ISR() time in us
+   unsigned long events;            // completed bus events
+   unsigned long bytes;             // bytes on the bus, address bytes included
+   unsigned long transfers;         // START to STOP sequences
+   unsigned long busy_us;           // time from START to the end of STOP
+   unsigned long errors;            // protocol or driver errors
+   unsigned long isr_min_gap_us;    // closest two I2CQ_ISR() entries
+   unsigned char isr_max_per_ms;    // most I2CQ_ISR() entries in one 1 ms window
+   unsigned long mainloop_calls;
+} StubStats;
+
+extern unsigned long stub_now;       // us since stub_reset()
+extern StubStats stub_stats;
+
+// configuration, set before stub_run()
+extern unsigned int stub_isr_delay_us;     // SSPIF to I2CQ_ISR() time
+extern unsigned int stub_stretch_us;       // clock stretching added to every byte
+extern unsigned int stub_mainloop_us;      // main loop period
+
+// MCP9800 at 0x48
+extern unsigned char stub_mcp9800_present;
+extern double stub_mcp9800_temp;           // degrees C
+
+// MCP79410 at 0x6F
+extern unsigned char stub_rtcc_present;
+
+void stub_reset(void);
+void stub_run(unsigned long us, StubHook mainloop);
+void stub_skip(unsigned long us);
+void stub_call(StubHook firmware);
+void stub_collision(void);
+void stub_error(const char *what);
+
+void stub_rtcc_power_up(unsigned long seconds, unsigned char running);
+unsigned long stub_rtcc_seconds(void);
+unsigned char stub_rtcc_running(void);
+
+#endif
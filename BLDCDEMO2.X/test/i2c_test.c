@@ -0,0 +1,323 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/i2c_test.c                            *
+*                                                                       *
+*     Other Files Required : i2c_stub.c, I2CQueue.c, I2CDevices.c       *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Host test of the I2C transaction queue and the MCP9800/MCP79410 drivers against i2c_stub.c.       //
+//                                                                                                    //
+// The functional cases cover the temperature conversion, RTCC oscillator start, time setting, an    //
+// absent slave, bus collisions during and between transactions, a full queue, restart aborts and    //
+// the polled mode used before the motor enables interrupts.                                          //
+//                                                                                                    //
+// The load case keeps the queue full of two byte reads for one second at each SSPIF service delay   //
+// and reports throughput, bus occupancy, request latency and how densely I2CQ_ISR() is entered.      //
+// Each entry must issue exactly one bus action and retire at most one transaction, so the motor ISR  //
+// pays a bounded cost per SSPIF and the main loop never waits on the bus. A main loop call that      //
+// spun on the bus would never return here and the alarm stops the run.                              //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "xc.h"
+#include "i2c_stub.h"
+#include "../BLDC.h"
+#include "../I2CQueue.h"
+#include "../I2CDevices.h"
+
+#define  LOAD_US                    1000000L
+#define  LOAD_READ_LENGTH           2
+// START, address, register, repeated START, address, 2 x (byte, ACK), STOP
+#define  LOAD_EVENTS                10
+#define  LOAD_BIT_TIMES             (1 + 9 + 9 + 1 + 9 + 2 * (8 + 1) + 1)
+
+bit TMR0_rtcc_flag;
+
+static int failures;
+static unsigned long tick_10ms;
+static int temperature;
+
+static unsigned char load_buffer[I2CQ_DEPTH][LOAD_READ_LENGTH];
+static unsigned char load_slot;
+static unsigned long load_submitted[I2CQ_DEPTH];
+static unsigned char load_head, load_tail;
+static unsigned long load_done;
+static unsigned long load_latency_max;
+static unsigned long load_last_isr;
+static unsigned char load_double_retire;
+static unsigned long load_status[4];
+
+static void Check(int ok, const char *what)
+{
+   printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+   if(!ok) failures++;
+}
+
+static void Start(unsigned char interrupts)
+{
+   stub_reset();
+   I2CQ_Init();
+   GIE = interrupts;
+   PEIE = interrupts;
+   tick_10ms = 0;
+}
+
+/************************************************************************
+* main loop models                                                      *
+*************************************************************************/
+
+// the combined demo's I2C users: RTCC every loop, temperature every 100 ms
+static void DevicesMainloop(void)
+{
+   I2CQ_Service();
+   if(stub_now / 10000 != tick_10ms)
+   {
+      tick_10ms = stub_now / 10000;
+      TMR0_rtcc_flag = 1;
+      if(tick_10ms % 10 == 0) temperature = mcp9800_get_temp();
+   }
+   rtcc_handler();
+}
+
+static void DevicesInit(void)
+{
+   mcp9800_init();
+   rtcc_init();
+}
+
+static void LoadDone(unsigned char status)
+{
+   unsigned long latency;
+
+   if(status < 4) load_status[status]++;
+   if(stub_stats.isr_calls == load_last_isr && GIE) load_double_retire = 1;
+   load_last_isr = stub_stats.isr_calls;
+
+   latency = stub_now - load_submitted[load_tail];
+   load_tail = (load_tail + 1) % I2CQ_DEPTH;
+   if(latency > load_latency_max) load_latency_max = latency;
+   load_done++;
+}
+
+// keeps the queue full of temperature reads
+static void LoadMainloop(void)
+{
+   I2CTransaction t;
+
+   I2CQ_Service();
+   t.address = MCP9800_ADDRESS;
+   t.reg = MCP9800_REG_TEMP;
+   t.length = LOAD_READ_LENGTH;
+   t.read = 1;
+   t.done = LoadDone;
+   for(;;)
+   {
+      t.data = load_buffer[load_slot];
+      if(!I2CQ_Submit(&t)) break;
+      load_slot = (load_slot + 1) % I2CQ_DEPTH;
+      load_submitted[load_head] = stub_now;
+      load_head = (load_head + 1) % I2CQ_DEPTH;
+   }
+}
+
+static void LoadReset(void)
+{
+   unsigned char n;
+
+   load_slot = load_head = load_tail = 0;
+   load_done = 0;
+   load_latency_max = 0;
+   load_last_isr = 0xFFFFFFFFUL;
+   load_double_retire = 0;
+   for(n = 0; n < 4; n++) load_status[n] = 0;
+}
+
+/************************************************************************
+* functional cases                                                      *
+*************************************************************************/
+
+static void TestBaud(void)
+{
+   printf("bus clock\n");
+   Start(1);
+   Check(SSPADD == 79, "SSPADD_INIT gives 100 kHz at 32 MHz");
+}
+
+static void TestTemperature(void)
+{
+   printf("MCP9800 temperature\n");
+   Start(1);
+   stub_call(DevicesInit);
+   stub_mcp9800_temp = 23.9375;
+   stub_run(300000L, DevicesMainloop);
+   Check(mcp9800_temp_valid(), "reading valid after 300 ms");
+   // 12-bit reading 383/16 C; the power-up 9-bit resolution would give 235
+   Check(temperature == 239, "23.94 C reads 239 at the configured 12-bit resolution");
+
+   stub_mcp9800_temp = -10.5;
+   stub_run(300000L, DevicesMainloop);
+   Check(temperature == -105, "-10.5 C reads -105");
+   Check(stub_stats.errors == 0, "no bus protocol errors");
+}
+
+static void TestRtcc(void)
+{
+   unsigned long s;
+
+   printf("MCP79410 time keeping\n");
+   Start(1);
+   stub_rtcc_power_up(12 * 3600L + 34 * 60 + 56, 0);
+   stub_call(DevicesInit);
+   stub_run(600000L, DevicesMainloop);
+   Check(stub_rtcc_running(), "stopped oscillator is started");
+   Check(stub_rtcc_seconds() == 45296L, "time kept while starting the oscillator");
+
+   stub_run(3000000L, DevicesMainloop);
+   s = rtcc_get_seconds();
+   Check(s >= 45298L && s <= 45299L, "cache follows the running clock within one poll");
+
+   rtcc_set(23 * 3600L + 59 * 60 + 58);
+   Check(rtcc_get_seconds() == 86398L, "cache updated at once by rtcc_set()");
+   stub_run(100000L, DevicesMainloop);
+   Check(stub_rtcc_seconds() == 86398L, "set time written to the RTCC");
+   stub_run(3000000L, DevicesMainloop);
+   s = rtcc_get_seconds();
+   Check(s <= 1, "time of day wraps at midnight");
+   Check(stub_stats.errors == 0, "no bus protocol errors");
+}
+
+static void TestAbsentSlave(void)
+{
+   printf("absent MCP9800\n");
+   Start(1);
+   stub_mcp9800_present = 0;
+   stub_rtcc_power_up(100, 1);
+   stub_call(DevicesInit);
+   stub_run(1000000L, DevicesMainloop);
+   Check(!mcp9800_temp_valid(), "NACKed reads leave the temperature invalid");
+   Check(rtcc_get_seconds() >= 100, "RTCC traffic continues behind the NACKs");
+   Check(stub_stats.errors == 0, "NACK ends with STOP, no protocol errors");
+}
+
+static void TestCollision(void)
+{
+   printf("bus collision\n");
+   Start(1);
+   LoadReset();
+   stub_call(LoadMainloop);
+   stub_run(150, 0);
+   stub_collision();
+   stub_run(10000L, LoadMainloop);
+   Check(load_status[I2CQ_COLLISION] == 1, "transfer on the bus retired with I2CQ_COLLISION");
+   Check(load_status[I2CQ_OK] >= 15, "queue continues with the next entry");
+   Check(stub_stats.errors == 0, "no protocol errors after the collision");
+
+   stub_run(1000000L, 0);
+   Check(!I2CQ_Busy(), "queue drains");
+   LoadReset();
+   stub_collision();
+   stub_run(1000, 0);
+   Check(load_done == 0, "collision while idle retires nothing");
+   Check(!I2CQ_Busy(), "queue stays idle");
+   stub_call(LoadMainloop);
+   stub_run(5000L, 0);
+   Check(load_status[I2CQ_OK] == I2CQ_DEPTH - 1 && load_done == I2CQ_DEPTH - 1, "next submissions complete normally");
+   Check(stub_stats.errors == 0, "no protocol errors");
+}
+
+static void TestQueue(void)
+{
+   unsigned char accepted;
+   I2CTransaction t = {MCP9800_ADDRESS, MCP9800_REG_TEMP, LOAD_READ_LENGTH, 1, 0, LoadDone};
+
+   printf("queue limits\n");
+   Start(0);
+   LoadReset();
+   for(accepted = 0; accepted < I2CQ_DEPTH; accepted++)
+   {
+      t.data = load_buffer[accepted];
+      load_submitted[load_head] = stub_now;
+      load_head = (load_head + 1) % I2CQ_DEPTH;
+      if(!I2CQ_Submit(&t)) break;
+   }
+   Check(accepted == I2CQ_DEPTH - 1, "I2CQ_DEPTH-1 entries accepted, then refused");
+   I2CQ_Init();
+   Check(load_status[I2CQ_ABORTED] == I2CQ_DEPTH - 1, "I2CQ_Init() aborts every queued entry");
+   Check(!I2CQ_Busy(), "queue idle after the restart");
+}
+
+static void TestPolled(void)
+{
+   printf("polled before interrupts are enabled\n");
+   Start(0);
+   LoadReset();
+   stub_run(100000L, LoadMainloop);
+   Check(load_status[I2CQ_OK] > 50, "I2CQ_Service() runs the queue from the main loop");
+   Check(stub_stats.isr_calls == 0, "no interrupt entries while GIE is clear");
+   Check(stub_stats.errors == 0, "no protocol errors");
+}
+
+/************************************************************************
+* load                                                                  *
+*************************************************************************/
+
+static void TestLoad(void)
+{
+   static const unsigned int delays[] = {0, 8, 16, 32, 64};
+   unsigned char n;
+   unsigned long per_transfer;
+   unsigned long bus_us;
+   double rate;
+
+   printf("load: queue kept full of %d byte reads for 1 s\n", LOAD_READ_LENGTH);
+   printf("  delay  transfers/s  bytes/s  us/transfer  bus busy  ISR/transfer  ISR gap min  ISR/ms max  latency max\n");
+   for(n = 0; n < sizeof delays / sizeof delays[0]; n++)
+   {
+      Start(1);
+      stub_isr_delay_us = delays[n];
+      LoadReset();
+      stub_run(LOAD_US, LoadMainloop);
+
+      rate = load_done * 1e6 / LOAD_US;
+      per_transfer = LOAD_US / (load_done ? load_done : 1);
+      bus_us = LOAD_BIT_TIMES * 10L + LOAD_EVENTS * delays[n];
+      printf("  %3u us %10.0f %9.0f %9lu us %8.1f %% %11.2f %9lu us %10u %9lu us\n",
+             delays[n], rate, stub_stats.bytes * 1e6 / LOAD_US, per_transfer,
+             100.0 * stub_stats.busy_us / LOAD_US,
+             (double)stub_stats.isr_calls / (load_done ? load_done : 1),
+             stub_stats.isr_min_gap_us, stub_stats.isr_max_per_ms, load_latency_max);
+
+      Check(stub_stats.errors == 0 && load_status[I2CQ_OK] == load_done, "every transfer completes without protocol errors");
+      Check(stub_stats.isr_max_actions == 1 && stub_stats.isr_idle_calls == 0, "each I2CQ_ISR() entry issues exactly one bus action");
+      Check(!load_double_retire, "each I2CQ_ISR() entry retires at most one transfer");
+      Check(per_transfer <= bus_us + bus_us / 50, "transfer time within 2% of bus time plus service delay");
+      Check(load_latency_max <= (I2CQ_DEPTH - 1) * (bus_us + bus_us / 50) + stub_mainloop_us, "request latency bounded by the queue depth");
+   }
+}
+
+int main(void)
+{
+   // a driver call that waited on the bus would never return
+   alarm(60);
+
+   TestBaud();
+   TestTemperature();
+   TestRtcc();
+   TestAbsentSlave();
+   TestCollision();
+   TestQueue();
+   TestPolled();
+   TestLoad();
+
+   printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+   return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,417 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/ramp_sim.c                            *
+*                                                                       *
+*     Other Files Required : F1937_Main.c, BLDC_Interrupts_Plain.c,     *
+*                            SupplyManager.c, ADCSpeedManager.c,        *
+*                            DirectDrivers.c, LinearSpeedProfile_16K.c  *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Open loop startup ramp of the F1937 demo against motors of low and high inertia.                   //
+//                                                                                                    //
+// The main loop runs as in boot_sim, and the motor ISR runs unchanged against a rotor model. Timer1  //
+// and the comparator are read through xc.h's HOST_MOTOR hooks, so the ISR's blanking and flyback     //
+// waits take simulated time. The Makefile builds this file twice: ramp_sim as the demo ships, and    //
+// ramp_sim_high with HIGH_INERTIA.                                                                   //
+//                                                                                                    //
+// The rotor is a sinusoidal BEMF motor driven six-step from the PWM duty cycle:                      //
+//                                                                                                    //
+//    s_x = sin(p*theta - x*120deg), e_x = KE * w * s_x      phase BEMF, x = U, V, W                  //
+//    I   = (d*Vm - (e_high - e_low)) / 2R                   drive current, inductance left out       //
+//    J dw/dt = KE * I * (s_high - s_low) - T_fric - FAN * w^2                                        //
+//                                                                                                    //
+// The comparator sees the floating phase's BEMF with CMP_HYST of hysteresis, and is held past the    //
+// crossing for L*I/Vm after each commutation while the flyback current decays. It raises C1IF on     //
+// the edge to the past-crossing level, so a crossing that is over before the ISR enables the         //
+// interrupt is missed as it would be on the part.                                                    //
+//                                                                                                    //
+// Every inertia is started from SIM_ANGLES rotor positions. A start counts when the ISR takes lock   //
+// and the rotor still turns at the commutation rate HOLD_US later. Reported per inertia: starts,     //
+// time from spin (GIE set) to lock as mean, standard deviation and worst, and restarts after a       //
+// failed startup. Each build checks the inertias it is meant for.                                    //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#define  _POSIX_C_SOURCE            200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xc.h"
+#include "../BLDC.h"
+#include "../EBM_Motor.h"
+#include "../1937_DRIVER.h"
+
+// the Makefile renames the firmware's main()
+#undef   main
+
+#define  LOOP_US                    40.0      // main loop pass
+#define  STEP_US                    2.0       // rotor model step
+#define  POLL_US                    0.5       // one Timer1 or comparator read
+#define  RUN_US                     8000000.0 // give up after
+#define  HOLD_US                    500000.0  // after lock, the rotor must still follow
+#define  SYNC_US                    200000.0  // over the last part of the hold
+
+// motor
+#define  MOTOR_VM                   12.0      // V
+#define  MOTOR_R                    1.0       // ohm per phase
+#define  MOTOR_L                    0.5e-3    // H per phase, flyback only
+#define  MOTOR_KE                   0.007     // V peak phase BEMF per mechanical rad/s
+#define  MOTOR_FRICTION             0.002     // Nm
+#define  MOTOR_FAN                  1.0e-7    // Nm per (rad/s)^2
+#define  CMP_HYST                   0.05      // V at the motor terminal
+#define  POLE_PAIRS                 (NUM_POLES/2)
+#define  SPEED_POT                  0.5       // of full scale
+
+#define  SIM_ANGLES                 6
+#define  PI                         3.14159265358979
+
+// registers
+volatile _Bool GIE, PEIE;
+volatile unsigned char OSCCON, OPTION_REG, TMR0, T1CON, T2CON, PR2;
+volatile _Bool TMR0IF, TMR1IF, TMR1IE, TMR1ON, nPOR, nBOR;
+volatile unsigned char ADCON0, ADRESH, ADRESL, FVRCON;
+volatile _Bool FVRRDY;
+volatile unsigned char CCP1CON, CCPR1L, PSTR1CON, CM1CON0, CM1CON1;
+volatile _Bool DC1B0, DC1B1, STR1A, STR1B, STR1C;
+volatile _Bool C1IE, C1IF;
+volatile unsigned char TRISA, TRISB, TRISC;
+volatile _Bool ANSA0, ANSA1, ANSA3, ANSA5, ANSB3;
+volatile _Bool LATC0, LATC1, LATC5, LATB6, LATB7;
+
+// F1937_Main.c, SupplyManager.c, ADCSpeedManager.c and BLDC_Interrupts_Plain.c
+extern bit stop_flag;
+extern bit init_complete_flag;
+extern bit startup_complete_flag;
+extern unsigned char comm_state;
+void InitSystem(void);
+void TimeBaseManager(void);
+void WarmUpControl(void);
+void ControlSlowStart(void);
+void ControlStartUp(void);
+void StallControl(void);
+void SupplyManager(void);
+void SpeedManager(void);
+void ISR(void);
+
+typedef struct {
+   const char *name;
+   double j;                        // kg m^2 rotor and load
+   // limits, for the build the inertia is meant for; none if starts_min is 0
+   unsigned char high;              // checked in ramp_sim_high, else in ramp_sim
+   unsigned char starts_min;        // of SIM_ANGLES
+   unsigned int lock_max;           // ms worst spin to lock
+} Scenario;
+
+static const Scenario scenarios[] = {
+   //  name                    J       high  starts  lock
+   {"bare rotor",              2e-6,    0,     6,     100},
+   {"small fan",               5e-6,    0,     6,     150},
+   {"medium fan",              1e-5,    0,     6,     500},
+   {"large fan",               2e-5,    1,     5,    5000},
+   // the start rate is too fast to pull in and the BEMF too weak to see below it
+   {"blower wheel",            5e-5,    1,     0,       0},
+};
+
+typedef struct {
+   long lock_us;                    // spin to lock, -1 if never
+   int follows;                     // rotor at the commutation rate HOLD_US after lock
+   int restarts;
+} Result;
+
+// rotor and comparator
+static double now;                  // us since reset
+static double theta, omega;         // rad, rad/s mechanical
+static double inertia;
+static double current;
+static double flyback_until;
+static unsigned char cmp_past, cmp_out;
+static unsigned char last_state;
+static unsigned long commutations;
+
+// Timer1
+static unsigned char tmr1h, tmr1l, tmr1l_read;
+static double tmr1_frac;
+
+// high, low and floating phase of each comm_state, and whether the floating BEMF falls
+static const unsigned char drive[7][4] = {
+   {0, 0, 0, 0}, {0, 1, 2, 1}, {0, 2, 1, 0}, {1, 2, 0, 1}, {1, 0, 2, 0}, {2, 0, 1, 1}, {2, 1, 0, 0},
+};
+
+/************************************************************************
+* motor model                                                           *
+*************************************************************************/
+
+static double Shape(unsigned char phase)
+{
+   return sin(POLE_PAIRS * theta - phase * 2.0 * PI / 3.0);
+}
+
+static double Duty(void)
+{
+   if((CCP1CON & 0x0C) != 0x0C) return 0;
+   return (((unsigned int)CCPR1L << 2) | (DC1B1 << 1) | DC1B0) / (4.0 * (PR2 + 1));
+}
+
+static void Step(double us)
+{
+   const unsigned char *d = drive[comm_state <= 6 ? comm_state : 0];
+   double dt = us * 1e-6;
+   double k, torque, load, e;
+   unsigned long count;
+
+   if(comm_state != last_state)
+   {
+      flyback_until = now + 1e6 * MOTOR_L * current / MOTOR_VM;
+      commutations++;
+      last_state = comm_state;
+   }
+
+   // drive
+   current = 0;
+   torque = 0;
+   if(comm_state >= 1 && comm_state <= 6)
+   {
+      k = Shape(d[0]) - Shape(d[1]);
+      current = (Duty() * MOTOR_VM - MOTOR_KE * omega * k) / (2 * MOTOR_R);
+      torque = MOTOR_KE * current * k;
+   }
+   load = MOTOR_FAN * omega * fabs(omega);
+   if(omega > 0) load += MOTOR_FRICTION;
+   else if(omega < 0) load -= MOTOR_FRICTION;
+   else if(fabs(torque) <= MOTOR_FRICTION) load = torque;
+   else load = torque > 0 ? MOTOR_FRICTION : -MOTOR_FRICTION;
+   omega += (torque - load) / inertia * dt;
+   theta += omega * dt;
+   now += us;
+
+   // comparator on the floating phase
+   e = MOTOR_KE * omega * Shape(d[2]);
+   if(d[3] ? e < -CMP_HYST : e > CMP_HYST) cmp_past = 1;
+   else if(d[3] ? e > CMP_HYST : e < -CMP_HYST) cmp_past = 0;
+   if((cmp_past || now < flyback_until) && !cmp_out) C1IF = 1;
+   cmp_out = cmp_past || now < flyback_until;
+
+   // Timer1 at TMR1_COUNTS_PER_us
+   if(TMR1ON)
+   {
+      tmr1_frac += us * TMR1_COUNTS_PER_us;
+      count = ((unsigned long)tmr1h << 8 | tmr1l) + (unsigned long)tmr1_frac;
+      tmr1_frac -= (unsigned long)tmr1_frac;
+      if(count > 0xFFFF) TMR1IF = 1;
+      tmr1h = (count >> 8) & 0xFF;
+      tmr1l = count & 0xFF;
+   }
+}
+
+// the main loop pass, with the ISR taken between rotor steps
+static void Run_To(double end)
+{
+   while(now < end)
+   {
+      Step(STEP_US);
+      if(GIE && PEIE && ((TMR1IF && TMR1IE) || (C1IF && C1IE))) ISR();
+   }
+}
+
+unsigned char *host_tmr1h(void)
+{
+   Step(POLL_US);
+   return &tmr1h;
+}
+
+unsigned char *host_tmr1l(void)
+{
+   Step(POLL_US);
+   tmr1l_read = tmr1l;
+   return &tmr1l;
+}
+
+// only read right after TMR1L += x with Timer1 stopped
+_Bool host_carry(void)
+{
+   return tmr1l < tmr1l_read;
+}
+
+_Bool host_mc1out(void)
+{
+   Step(POLL_US);
+   return cmp_out;
+}
+
+// ADC referenced to a 5 V Vdd, left justified
+unsigned char *host_adc_go(void)
+{
+   static unsigned char go;
+   double volts;
+   long count;
+
+   if(go)
+   {
+      go = 0;
+      if(ADCON0 == ADCON0_SUPPLY)
+         volts = MOTOR_VM * BEMF_R2 / ((BEMF_R1 + BEMF_R2) * SUPPLY_REF_DIVIDER);
+      else if(ADCON0 == ADCON0_FVR)
+         volts = (FVRCON & 0x80) ? FVR_mV / 1000.0 : 0;
+      else
+         volts = 5.0 * SPEED_POT;
+      count = (long)(1023.0 * volts / 5.0 + 0.5);
+      if(count > 1023) count = 1023;
+      ADRESH = count >> 2;
+      ADRESL = (count & 3) << 6;
+   }
+   return &go;
+}
+
+/************************************************************************
+* scenario run                                                          *
+*************************************************************************/
+
+static Result Simulate(const Scenario *s, double angle)
+{
+   Result r = {-1, 0, 0};
+   double next_tick = TIMEBASE_MS_PER_TICK * 1000.0;
+   double spin = -1, lock = -1;
+   double sync_theta = 0;
+   unsigned long sync_comms = 0;
+   double sectors;
+   unsigned char was_spinning = 0;
+
+   inertia = s->j;
+   theta = angle / POLE_PAIRS;
+   nPOR = 0;
+   nBOR = 0;
+   stop_flag = 1;
+
+   while(now < RUN_US)
+   {
+      if(now >= next_tick)
+      {
+         TMR0IF = 1;
+         next_tick += TIMEBASE_MS_PER_TICK * 1000.0;
+      }
+      FVRRDY = (FVRCON & 0x80) != 0;
+
+      // main()
+      if(stop_flag)
+      {
+         if(spin >= 0 && lock < 0) r.restarts++;
+         InitSystem();
+      }
+      TimeBaseManager();
+      WarmUpControl();
+      ControlSlowStart();
+      ControlStartUp();
+      StallControl();
+      SupplyManager();
+      SpeedManager();
+      Run_To(now + LOOP_US);
+
+      if(GIE && !was_spinning && spin < 0) spin = now;
+      was_spinning = GIE;
+      if(startup_complete_flag && lock < 0)
+      {
+         lock = now;
+         r.lock_us = (long)(lock - spin);
+      }
+      if(!startup_complete_flag) lock = -1;
+      if(lock >= 0 && now >= lock + HOLD_US - SYNC_US && !sync_comms)
+      {
+         sync_theta = theta;
+         sync_comms = commutations;
+      }
+      if(lock >= 0 && now >= lock + HOLD_US)
+      {
+         // the drive turns one sector per commutation
+         sectors = (theta - sync_theta) * POLE_PAIRS / (PI / 3);
+         r.follows = fabs(sectors - (commutations - sync_comms)) <= 0.05 * sectors + 2;
+         break;
+      }
+   }
+   if(lock < 0) r.lock_us = -1;
+   return r;
+}
+
+// the firmware keeps its state in statics, so every run gets a fresh process
+static Result Run(const Scenario *s, double angle)
+{
+   int fd[2];
+   Result r = {-1, 0, 0};
+
+   if(pipe(fd) || fflush(stdout)) exit(EXIT_FAILURE);
+   if(fork() == 0)
+   {
+      r = Simulate(s, angle);
+      if(write(fd[1], &r, sizeof r) != sizeof r) _exit(EXIT_FAILURE);
+      _exit(EXIT_SUCCESS);
+   }
+   if(read(fd[0], &r, sizeof r) != sizeof r) r.lock_us = -1;
+   wait(0);
+   close(fd[0]);
+   close(fd[1]);
+   return r;
+}
+
+static int failures;
+
+static void Check(int ok, const char *what)
+{
+   printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+   if(!ok) failures++;
+}
+
+static void Scenario_Run(const Scenario *s)
+{
+   Result r;
+   unsigned int n, starts = 0, restarts = 0;
+   double sum = 0, sum2 = 0, worst = 0, ms, mean, sd;
+#ifdef HIGH_INERTIA
+   int checked = s->high && s->starts_min;
+#else
+   int checked = !s->high && s->starts_min;
+#endif
+
+   for(n = 0; n < SIM_ANGLES; n++)
+   {
+      r = Run(s, 2 * PI * (n + 0.25) / SIM_ANGLES);
+      restarts += r.restarts;
+      if(r.lock_us < 0 || !r.follows) continue;
+      starts++;
+      ms = r.lock_us / 1000.0;
+      sum += ms;
+      sum2 += ms * ms;
+      if(ms > worst) worst = ms;
+   }
+   mean = starts ? sum / starts : 0;
+   sd = starts ? sqrt(fabs(sum2 / starts - mean * mean)) : 0;
+
+   printf("  %s: J %.0e kg m^2\n", s->name, s->j);
+   printf("    started %u/%u  spin to lock %4.0f ms sd %4.0f worst %4.0f  restarts %u\n",
+          starts, SIM_ANGLES, mean, sd, worst, restarts);
+   if(!checked) return;
+   Check(starts >= s->starts_min, "starts lock and the rotor follows");
+   Check(worst <= s->lock_max, "time to lock within limit");
+}
+
+int main(void)
+{
+   unsigned int n;
+
+   alarm(300);
+#ifdef HIGH_INERTIA
+   printf("open loop ramp, HIGH_INERTIA: shifts %d to %d, %d rotor positions\n", RAMP_INCR_MIN, RAMP_INCR_MAX, SIM_ANGLES);
+#else
+   printf("open loop ramp: shifts %d to %d, %d rotor positions\n", RAMP_INCR_MIN, RAMP_INCR_MAX, SIM_ANGLES);
+#endif
+   for(n = 0; n < sizeof scenarios / sizeof scenarios[0]; n++) Scenario_Run(&scenarios[n]);
+
+   printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+   return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/thermal_sim.c                         *
+*                                                                       *
+*     Other Files Required : i2c_stub.c, I2CQueue.c, I2CDevices.c,      *
+*                            ThermalManager.c, SpeedManager.c           *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Closed loop check of the thermal derating against a first order plant.                             //
+//                                                                                                    //
+// ThermalManager() and SpeedManager() run unchanged every 10 ms, reading the board temperature       //
+// through the I2C queue from the MCP9800 model. The board heats with the motor's loss and cools to   //
+// ambient through the heatsink:                                                                      //
+//                                                                                                    //
+//    C dT/dt = P(speed) - (T - Tambient) / R                                                         //
+//    P(speed) = P_IDLE + P_FULL * (speed/255)^3          fan load, loss rises with the cube          //
+//                                                                                                    //
+// The sensor sits on the board behind its own lag. A trip stops the motor the way the stop_flag      //
+// restart does; a new start takes STARTUP_MS before SpeedManager() ramps again.                      //
+//                                                                                                    //
+// Each scenario reports the peak board temperature, trips, the time spent derated, the sustained     //
+// speed over the last part of the run and the ceiling ripple once settled, against its limits.       //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "xc.h"
+#include "i2c_stub.h"
+#include "../BLDC.h"
+#include "../I2CQueue.h"
+#include "../I2CDevices.h"
+#include "../ThermalManager.h"
+
+// plant
+#define  PLANT_R                    5.0       // C/W heatsink to ambient
+#define  PLANT_C                    40.0      // J/C board and heatsink
+#define  PLANT_P_IDLE               0.3       // W with the motor stopped
+#define  PLANT_P_FULL               6.0       // W motor loss at full speed
+#define  SENSOR_TAU                 10.0      // s sensor lag behind the board
+
+#define  TICK_US                    10000L    // TimeBaseManager count
+#define  STARTUP_MS                 1500      // open loop start before the speed ramp
+#define  STARTUP_SPEED              40        // ramped_speed when the start completes
+
+// called from SpeedManager.c, the rest of the combined demo's globals
+bit supply_is_valid = 1;
+bit stop_flag;
+bit startup_complete_flag;
+bit run_flag;
+bit TMR0_duty_flag;
+char TMR0_duty_timer = TIMEBASE_DUTY_RAMP;
+unsigned char ramped_speed;
+bit TMR0_thermal_flag;
+bit TMR0_rtcc_flag;
+
+extern unsigned char thermal_ceiling;
+extern bit thermal_trip;
+extern int thermal_filtered;
+
+void SpeedManager(int speed);
+
+#define  STEPS                      3
+
+typedef struct {
+   const char *name;
+   double ambient[STEPS];           // C, from at[n] seconds on
+   unsigned int at[STEPS];
+   unsigned int run_s;
+   // limits
+   double peak_max;                 // C board temperature
+   unsigned char trips_min;
+   unsigned char trips_max;
+   unsigned char sustained_min;     // 8-bit speed averaged over the last quarter
+   unsigned char ripple_max;        // ceiling counts over the last quarter
+} Scenario;
+
+static const Scenario scenarios[] = {
+   //  name                            ambient C         from s          run   peak   trips  speed ripple
+   {"cool room",                     {25, 25, 25}, {0,    0,    0}, 3600,  70.0, 0, 0, 250,  0},
+   {"warm enclosure",                {40, 40, 40}, {0,    0,    0}, 3600,  80.0, 0, 0, 200,  4},
+   {"hot enclosure",                 {55, 55, 55}, {0,    0,    0}, 3600,  85.0, 0, 0, 150,  4},
+   {"hot spell at the trip edge",    {40, 90, 90}, {0,  900,  900}, 5400,  95.0, 0, 0,  96,  8},
+   {"enclosure overheats and cools", {40, 97, 40}, {0,  900, 2400}, 5400, 105.0, 1, 1, 200,  4},
+};
+
+static int failures;
+static double board;
+static double sensor;
+static unsigned char motor_on;
+static unsigned long start_done;
+static unsigned char duty_index;
+static unsigned char hard_trip_only;
+
+/************************************************************************
+* firmware environment                                                  *
+*************************************************************************/
+
+void GetCCPVal(unsigned char speed)
+{
+   duty_index = speed;
+}
+
+// stop_flag restart: InitSystem() clears the motor state
+static void Mainloop(void)
+{
+   if(stop_flag)
+   {
+      stop_flag = 0;
+      run_flag = 0;
+      startup_complete_flag = 0;
+      ramped_speed = 0;
+      motor_on = 0;
+   }
+   if(run_flag && !motor_on)
+   {
+      motor_on = 1;
+      start_done = stub_now + STARTUP_MS * 1000L;
+   }
+   if(motor_on && !startup_complete_flag && stub_now >= start_done)
+   {
+      ramped_speed = STARTUP_SPEED;
+      startup_complete_flag = 1;
+   }
+
+   TMR0_thermal_flag = 1;
+   TMR0_duty_flag = 1;
+   ThermalManager();
+   if(hard_trip_only) thermal_ceiling = MAX_SPEED_REQUEST;
+   // speed pot at full scale
+   SpeedManager(1023);
+}
+
+static void Init(void)
+{
+   mcp9800_init();
+}
+
+/************************************************************************
+* scenario run                                                          *
+*************************************************************************/
+
+typedef struct {
+   double peak;                     // C board temperature
+   double filtered;                 // C at the end of the run
+   unsigned char trips;
+   double derated;                  // fraction of the run below full ceiling
+   unsigned char sustained;         // mean speed over the last quarter
+   double mean;                     // mean speed over the whole run
+   unsigned char ceiling_min, ceiling_max;
+   unsigned long errors;
+} Result;
+
+static void Check(int ok, const char *what)
+{
+   printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+   if(!ok) failures++;
+}
+
+static Result Simulate(const Scenario *s)
+{
+   unsigned long ticks = s->run_s * (MILLISECONDS_PER_SEC / TIMEBASE_MS_PER_COUNT);
+   unsigned long settled = ticks - ticks / 4;
+   unsigned long tick;
+   unsigned long derated = 0;
+   double speed_sum = 0, settled_sum = 0;
+   unsigned char was_tripped = 0;
+   double ambient, power, speed;
+   double dt = TICK_US / 1e6;
+   unsigned long start_us;
+   unsigned char n;
+   Result r = {0};
+
+   r.ceiling_min = 255;
+   stub_reset();
+   I2CQ_Init();
+   GIE = PEIE = 1;
+   stub_call(Init);
+
+   ambient = s->ambient[0];
+   board = sensor = ambient;
+   stop_flag = 1;
+   motor_on = 0;
+
+   for(tick = 0; tick < ticks; tick++)
+   {
+      for(n = 0; n < STEPS; n++)
+         if(tick * dt >= s->at[n]) ambient = s->ambient[n];
+
+      stub_mcp9800_temp = sensor;
+      start_us = stub_now;
+      stub_call(Mainloop);
+      while(I2CQ_Busy()) stub_run(10, 0);
+      stub_skip(TICK_US - (stub_now - start_us));
+
+      speed = (motor_on && startup_complete_flag) ? ramped_speed : (motor_on ? STARTUP_SPEED : 0);
+      power = PLANT_P_IDLE + PLANT_P_FULL * (speed / 255.0) * (speed / 255.0) * (speed / 255.0);
+      board += dt * (power - (board - ambient) / PLANT_R) / PLANT_C;
+      sensor += dt * (board - sensor) / SENSOR_TAU;
+      if(board > r.peak) r.peak = board;
+
+      if(thermal_trip && !was_tripped) r.trips++;
+      was_tripped = thermal_trip;
+      if(thermal_ceiling < MAX_SPEED_REQUEST) derated++;
+      speed_sum += speed;
+      if(tick >= settled)
+      {
+         settled_sum += speed;
+         if(thermal_ceiling < r.ceiling_min) r.ceiling_min = thermal_ceiling;
+         if(thermal_ceiling > r.ceiling_max) r.ceiling_max = thermal_ceiling;
+      }
+   }
+
+   r.filtered = thermal_filtered / 10.0;
+   r.derated = (double)derated / ticks;
+   r.sustained = (unsigned char)(settled_sum / (ticks - settled));
+   r.mean = speed_sum / ticks;
+   r.errors = stub_stats.errors;
+   return r;
+}
+
+// ThermalManager() and SpeedManager() keep their state in statics, so
+// every run gets a fresh process
+static Result Run(const Scenario *s, unsigned char trip_only)
+{
+   int fd[2];
+   Result r = {0};
+
+   if(pipe(fd) || fflush(stdout)) exit(EXIT_FAILURE);
+   if(fork() == 0)
+   {
+      hard_trip_only = trip_only;
+      r = Simulate(s);
+      if(write(fd[1], &r, sizeof r) != sizeof r) _exit(EXIT_FAILURE);
+      _exit(EXIT_SUCCESS);
+   }
+   if(read(fd[0], &r, sizeof r) != sizeof r) r.errors = 1;
+   wait(0);
+   close(fd[0]);
+   close(fd[1]);
+   return r;
+}
+
+static void Scenario_Run(const Scenario *s)
+{
+   Result d, t;
+   unsigned char n;
+
+   d = Run(s, 0);
+   t = Run(s, 1);
+
+   printf("  %s: ambient %.0f C", s->name, s->ambient[0]);
+   for(n = 1; n < STEPS; n++)
+      if(s->ambient[n] != s->ambient[n - 1]) printf(", %.0f C at %u s", s->ambient[n], s->at[n]);
+   printf(", %u s\n", s->run_s);
+   printf("    %-10s peak %5.1f C  trips %u  mean speed %3.0f  sustained %3u  derated %3.0f%%  ceiling %u..%u\n",
+          "derating", d.peak, d.trips, d.mean, d.sustained, 100.0 * d.derated, d.ceiling_min, d.ceiling_max);
+   printf("    %-10s peak %5.1f C  trips %u  mean speed %3.0f  sustained %3u\n",
+          "trip only", t.peak, t.trips, t.mean, t.sustained);
+
+   Check(d.peak <= s->peak_max, "peak board temperature within limit");
+   Check(d.trips >= s->trips_min && d.trips <= s->trips_max, "trip count within limit");
+   Check(d.sustained >= s->sustained_min, "sustained speed within limit");
+   Check((unsigned char)(d.ceiling_max - d.ceiling_min) <= s->ripple_max, "settled ceiling ripple within limit");
+   Check(d.trips <= t.trips && d.peak <= t.peak + 0.1, "no more trips and no hotter than trip only");
+   Check(d.errors == 0 && t.errors == 0, "no I2C errors");
+}
+
+int main(void)
+{
+   unsigned char n;
+
+   alarm(120);
+   printf("thermal derating against a first order plant: R %.0f C/W, C %.0f J/C, %.1f..%.1f W\n",
+          PLANT_R, PLANT_C, PLANT_P_IDLE, PLANT_P_IDLE + PLANT_P_FULL);
+   for(n = 0; n < sizeof scenarios / sizeof scenarios[0]; n++) Scenario_Run(&scenarios[n]);
+
+   printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+   return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/************************************************************************
+*                                                                       *
+*     Project              : 3-Phase Brushless Motor Control            *
+*                                                                       *
+*     Filename             : test/xc.h                                  *
+*                                                                       *
+*     Other Files Required : i2c_stub.c                                 *
+*     Tools Used: gcc                                                   *
+*                                                                       *
+*************************************************************************
+*
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                                    //
+// Host stand-in for the XC8 device header. Found ahead of the compiler's own xc.h by the test        //
+// Makefile so the firmware sources compile unchanged with gcc.                                       //
+//                                                                                                    //
+// Only the registers and bits the host-built sources touch are modelled. They are plain variables;   //
+// i2c_stub.c watches them between firmware calls and plays the part of the MSSP. SSPBUF is wider     //
+// than the real register so the stub can tell a firmware write (value below 0x100) from the byte it  //
+// left there itself (SSPBUF_IDLE set).                                                               //
+//                                                                                                    //
+// GO_nDONE goes through host_adc_go() so a conversion completes when the firmware polls for it. The  //
+// test that builds the ADC users provides the function and the analog inputs behind it.             //
+//                                                                                                    //
+// With HOST_MOTOR the motor ISR is built too: TMR1H/TMR1L, CARRY and MC1OUT then go through the      //
+// motor model's host_tmr1h() and friends, so time passes while the ISR polls Timer1 and the          //
+// comparator.                                                                                        //
+//                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+*******************************************************************************************************/
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#ifdef HOST_INT16
+// XC8's int is 16 bits and the motor ISR's Timer1 arithmetic wraps there; only for firmware built
+// apart from the test's own source, whose library headers need the host's int
+#define  int                        short
+#endif
+
+#define  __bit                      _Bool
+#define  __interrupt(...)
+#define  NOP()
+#define  CLRWDT()
+#define  _delay(cycles)
+
+#define  SSPBUF_IDLE                0x100
+
+// interrupt control
+extern volatile _Bool GIE, PEIE;
+extern volatile _Bool SSPIE, SSPIF, BCLIE, BCLIF;
+
+// MSSP
+extern volatile unsigned int SSPBUF;
+extern volatile unsigned char SSPADD, SSPSTAT, SSPCON1, SSPCON2;
+extern volatile _Bool SSPEN;
+extern volatile _Bool SEN, RSEN, PEN, RCEN, ACKEN, ACKDT, ACKSTAT;
+
+// I2C pins
+extern volatile _Bool TRISC3, TRISC4;
+
+// oscillator, reset and timers
+extern volatile unsigned char OSCCON, OPTION_REG, TMR0, T1CON, T2CON, PR2;
+extern volatile _Bool TMR0IF, TMR1IF, TMR1IE, TMR1ON, nPOR, nBOR;
+#ifdef HOST_MOTOR
+unsigned char *host_tmr1h(void);
+unsigned char *host_tmr1l(void);
+_Bool host_carry(void);
+#define  TMR1H                      (*host_tmr1h())
+#define  TMR1L                      (*host_tmr1l())
+#define  CARRY                      host_carry()
+#else
+extern volatile unsigned char TMR1H, TMR1L;
+#endif
+
+// ADC and FVR
+unsigned char *host_adc_go(void);
+#define  GO_nDONE                   (*host_adc_go())
+extern volatile unsigned char ADCON0, ADRESH, ADRESL, FVRCON;
+extern volatile _Bool FVRRDY;
+
+// PWM, comparator and drive pins
+extern volatile unsigned char CCP1CON, CCPR1L, PSTR1CON, CM1CON0, CM1CON1;
+extern volatile _Bool DC1B0, DC1B1, STR1A, STR1B, STR1C;
+extern volatile _Bool C1IE, C1IF;
+#ifdef HOST_MOTOR
+_Bool host_mc1out(void);
+#define  MC1OUT                     host_mc1out()
+#else
+extern volatile _Bool MC1OUT;
+#endif
+extern volatile unsigned char TRISA, TRISB, TRISC;
+extern volatile _Bool ANSA0, ANSA1, ANSA3, ANSA5, ANSB3;
+extern volatile _Bool LATC0, LATC1, LATC5, LATB6, LATB7;
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * File:   arbiter.c
+ */
+
+
+#include <xc.h>
+#include "motor.h"
+#include "arbiter.h"
+#include "mtouch.h"
+
+#define ADC_FREE        0
+#define ADC_CURRENT     1
+#define ADC_TOUCH       2
+
+#define TOUCH_COLLECT   0   // mainloop's turn: collect the result, pick the next scan
+#define TOUCH_SCAN      1   // a scan is wanted
+#define TOUCH_CONVERT   2   // the scan's conversion is running
+
+volatile unsigned int arbiter_touch_result;
+static volatile unsigned char adc_owner = ADC_FREE;
+static volatile unsigned char current_timer = ARB_CURRENT_TICKS;
+static volatile unsigned char ticks;        // counts arbiter_serv() calls, to tell the tick
+static unsigned char touch_state = TOUCH_COLLECT;
+#ifdef ARB_MEASURE
+volatile arbiter_measure_t arbiter_measure;
+#endif
+
+// no PWM edge from the ringing before the scan's precharge to its hold,
+// for a check at TMR4 = now; the edges are at 0 and at the duty match
+static unsigned char pwm_quiet(unsigned char now) {
+    unsigned char from = now + (ARB_PWM_HOLD - ARB_PWM_SCAN - ARB_PWM_BLANK);
+    if ((unsigned char) (0 - from) <= ARB_PWM_SCAN + ARB_PWM_BLANK) return 0;
+    if ((unsigned char) (CCPR1L - from) <= ARB_PWM_SCAN + ARB_PWM_BLANK) return 0;
+    return 1;
+}
+
+/*
+ * Called from the TMR2 interrupt after motor_serv().
+ */
+void arbiter_serv(void) {
+    // the conversion started in the last tick is done
+    if (adc_owner == ADC_CURRENT) {
+        overload_protect(ADRES);
+        adc_owner = ADC_FREE;
+    } else if (adc_owner == ADC_TOUCH) {
+        arbiter_touch_result = ADRES;
+        // back to the current setup, the channel acquires until the next sample
+        ADCON1 = ADCON1_CURRENT;
+        ADCON0 = ADCON0_CURRENT;
+        adc_owner = ADC_FREE;
+    }
+
+    ticks++;
+    if (--current_timer == 0) {
+        current_timer = ARB_CURRENT_TICKS;
+        ADGO = 1;
+        adc_owner = ADC_CURRENT;
+    }
+}
+
+/*
+ * Called every main loop before MTOUCH_Service_Mainloop(). The packet
+ * arithmetic and the scan slot run here instead of in the interrupt.
+ * The motor check runs with interrupts on and holds for this tick and
+ * the next, so a tick may come before the slot; the wait for a PWM
+ * window and the scan run with interrupts off.
+ */
+void arbiter_mainloop(void) {
+    unsigned char tick, running, t4;
+#ifdef ARB_MEASURE
+    unsigned char t4_end, late;
+#endif
+
+    if (touch_state == TOUCH_CONVERT) {
+        if (adc_owner == ADC_TOUCH) return;
+        touch_state = TOUCH_COLLECT;
+    }
+    if (touch_state == TOUCH_COLLECT) {
+        if (!MTOUCH_Sensor_Acq_Collect()) return;
+        touch_state = TOUCH_SCAN;
+    }
+
+    tick = ticks;
+    if (!motor_quiet()) return;
+    running = motor_running();
+
+    GIE = 0;
+    // a scan in this tick is collected in the next, before the current sample
+    if ((unsigned char) (ticks - tick) > 1 || adc_owner != ADC_FREE || current_timer < 2) {
+        GIE = 1;
+        return;
+    }
+    // each PWM edge rules out ARB_PWM_SCAN + ARB_PWM_BLANK counts, so the
+    // wait for a window is short; a match ends it, so only the scan can
+    // delay a tick
+    do {
+        if (TMR2IF) {
+            GIE = 1;
+            return;
+        }
+        t4 = TMR4;
+    } while (running && !pwm_quiet(t4));
+    ADCON1 = ADCON1_TOUCH;
+    MTOUCH_Sensor_Acq_Scan();
+    adc_owner = ADC_TOUCH;
+#ifdef ARB_MEASURE
+    // the scan returns with the conversion started, 10 cycles after the hold
+    t4_end = TMR4;
+    late = TMR2IF;
+#endif
+    GIE = 1;
+    touch_state = TOUCH_CONVERT;
+
+#ifdef ARB_MEASURE
+    t4 = t4_end - t4;
+    if (t4 > arbiter_measure.scan_tmr4) arbiter_measure.scan_tmr4 = t4;
+    // a match came in the slot, its interrupt waited for it
+    if (late) arbiter_measure.late++;
+#endif
+}
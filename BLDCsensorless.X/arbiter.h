@@ -0,0 +1,64 @@
+/*
+ * File:   arbiter.h
+ *
+ * TMR2 and the ADC are shared by the motor and the touch key.
+ * TMR2 is the motor tick. Each tick runs motor_serv() first, then
+ * arbiter_serv(), which takes the motor current every ARB_CURRENT_TICKS
+ * ticks, always on time, and collects the conversion of the last slot.
+ * The mTouch scan runs in arbiter_mainloop() with interrupts off, only
+ * while the ADC is free and the motor is quiet: past the commutation
+ * blanking, not close to the next commutation, and away from both PWM
+ * edges up to the ADC hold. A match that comes during the slot is served
+ * at its end, so a slot can delay a motor tick but never loses one.
+ *
+ * The scan does not fit in the interrupt: motor_serv() alone takes up
+ * to 93 cycles without a commutation, and a tick with the scan in it
+ * would come to about 400. The tick is lengthened from the original
+ * 33 us, which the original interrupt overran on every tick anyway (221
+ * cycles on average, counted on the XC8 build in a simulator), to 63 us,
+ * enough for the interrupt and a share of the CPU for the mainloop.
+ */
+
+#ifndef ARBITER_H
+#define	ARBITER_H
+
+// motor tick: Fosc/4, TMR2 1:4, PR2 = MOTOR_TICK_PR2; 252 cycles, not
+// the 256 of the PWM period, so the slots drift across the PWM edges. At
+// 0x3F they would stay at one phase, and a duty with an edge there would
+// never get a scan.
+#define MOTOR_TICK_PR2      0x3E
+#define MOTOR_TICK_CYCLES   ((MOTOR_TICK_PR2+1)*4)
+
+// ADC setups, written for each slot
+#define ADCON0_CURRENT      0b00010001      // AN4, ADC on
+#define ADCON1_CURRENT      0b11010011      // right justified, Fosc/16, FVR reference
+#define ADCON1_TOUCH        0b11010000      // right justified, Fosc/16, Vdd reference for CVD
+
+#define ARB_CURRENT_TICKS   4               // motor current sample interval in ticks
+// ARB_PWM_HOLD is an estimate, not yet measured on the board. Build with
+// ARB_MEASURE defined to have arbiter_mainloop() keep the worst scan slot
+// it has seen in arbiter_measure, and read it in the debugger after a
+// run at full speed with the key in use.
+#define ARB_PWM_BLANK       16              // TMR4 counts (0.25 us) of ringing after a PWM edge
+#define ARB_PWM_HOLD        110             // TMR4 counts from the PWM check to the scan's ADC hold, estimate
+#define ARB_PWM_SCAN        33              // TMR4 counts from the scan's precharge to its hold, from its listing
+
+#if ARB_CURRENT_TICKS < 3
+#error ARB_CURRENT_TICKS must leave a tick between current samples for a scan
+#endif
+
+extern volatile unsigned int arbiter_touch_result;
+
+#ifdef ARB_MEASURE
+typedef struct {
+    unsigned char scan_tmr4;    // worst TMR4 counts from the PWM check to the scan's return, compare ARB_PWM_HOLD + 10
+    unsigned char late;         // slots a TMR2 match came in, its interrupt waited for the slot
+} arbiter_measure_t;
+
+extern volatile arbiter_measure_t arbiter_measure;
+#endif
+
+void arbiter_serv(void);
+void arbiter_mainloop(void);
+
+#endif	/* ARBITER_H */
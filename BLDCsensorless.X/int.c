@@ -8,21 +8,19 @@
 
 #include <xc.h>
 #include "motor.h"
+#include "arbiter.h"
 #define THRH_VOLT 0x300
-void overload_protect(void);
 void __interrupt() ISR(void){
     //LATC4 = 1;
-    overload_protect();
     if(TMR2IF){
         TMR2IF = 0;
         motor_serv();
+        arbiter_serv();
     }
    // LATC4 = 0;
 }
-void overload_protect(void){
-    ADGO = 1;
-    while(ADGO);
-    unsigned int volt = ADRESH<<8||ADRESL;
+// called by arbiter_serv() with each motor current sample
+void overload_protect(unsigned int volt){
     if(volt>THRH_VOLT){
         close_motor();
     }
@@ -27,6 +27,8 @@
 #include <xc.h>
 #include "ain.h"
 #include "motor.h"
+#include "arbiter.h"
+#include "mtouch.h"
 #include <pic16f1936.h>
 inline void TMR2_init(void);
 inline void PWM_init(void);
@@ -34,6 +36,7 @@ inline void PORT_init(void);
 inline void CMP1_init(void);
 inline void ADC_init(void);
 void OSCILLATOR_init(void);
+static void touch_control(void);
 void main(void) {
     OSCILLATOR_init();
     GIE = 1;
@@ -43,10 +46,25 @@ void main(void) {
     CMP1_init();
     ADC_init();
     TMR2_init();
+    MTOUCH_Initialize();
     start_motor();
     while(1){
+        arbiter_mainloop();
+        if(MTOUCH_Service_Mainloop()) touch_control();
     }
 }
+// each press of the touch key stops or restarts the fan
+static void touch_control(void){
+    static unsigned char fan_on = 1;
+    static unsigned char was_pressed = 0;
+    unsigned char pressed = MTOUCH_Button_isPressed(Button0);
+    if(pressed && !was_pressed){
+        fan_on = !fan_on;
+        if(fan_on) start_motor();
+        else stop_motor();
+    }
+    was_pressed = pressed;
+}
 inline void ADC_init(void){
     FVRCON = 0b11000011;
     ADCON1 = 0b11010011;
@@ -74,7 +92,7 @@ inline void TMR2_init(void)
     // T2CKPS 1:4; T2OUTPS 1:1; TMR2ON off; 
     T2CON = 0x10;
     // T2PR 125; 
-    PR2 = 0x20;
+    PR2 = MOTOR_TICK_PR2;
     // TMR2 0; 
     TMR2 = 0x00;
     // Clearing IF flag before enabling the interrupt.
@@ -23,6 +23,7 @@ static unsigned int time_count = 0;
 static unsigned char bemf_filter = 0;
 static char zerocross = 0;
 static char flag_start = 0;
+static char flag_stop = 0;
 static unsigned long phase_delay_filter = 0;
 static unsigned int phase_delay = 0;
 static unsigned long phase_delay_counter = 0;
@@ -43,6 +44,12 @@ static const unsigned char cBEMF_FILTER[64] = {0x00, 0x02, 0x04, 0x06, 0x08, 0x0
 #define SLOWSTART_TIME 0x6E0
 void motor_serv(void) {
     //static unsigned int force_count = MAX_Commtime;
+    if (flag_stop) {
+        flag_stop = 0;
+        flag_start = 0;
+        close_motor();
+        return;
+    }
     if (commustate == COMM_OFF) {
         if (flag_start == 1) {
             commustate = COMM_STEP1;
@@ -80,6 +87,24 @@ void start_motor(void) {
     flag_start = 1;
 }
 
+// the drive is switched off in the next tick
+void stop_motor(void) {
+    flag_stop = 1;
+}
+
+unsigned char motor_running(void) {
+    return (unsigned char) (commustate != COMM_OFF);
+}
+
+// no commutation transient in this tick or the next
+unsigned char motor_quiet(void) {
+    if (commustate == COMM_OFF) return 1;
+    if (time_count < MOTOR_BLANK_TICKS) return 0;
+    if (time_count > MAX_Commtime - MOTOR_GUARD_TICKS) return 0;
+    if (zerocross && phase_delay_counter < MOTOR_GUARD_TICKS) return 0;
+    return 1;
+}
+
 unsigned char bemf_zerocross(void) {
     return (unsigned char) C1OUT;
 }
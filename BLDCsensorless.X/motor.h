@@ -32,8 +32,14 @@
 #define	XC_HEADER_TEMPLATE_H
 
 #include <xc.h> // include processor files - each processor file is guarded.  
-#define MAX_Commtime  (unsigned int)2000
+// forced commutation after ~110 ms without a zero cross: 2000 ticks of
+// the original interrupt, which ran ~221 cycles a tick, in 63 us ticks
+#define MAX_Commtime  (unsigned int)1752
 #define FILTER_DELAY 6 
+// touch scans are held off for MOTOR_BLANK_TICKS after a commutation
+// and for MOTOR_GUARD_TICKS before the next one
+#define MOTOR_BLANK_TICKS 4
+#define MOTOR_GUARD_TICKS 2
 extern void UHoff();
 extern void UHon();
 extern void ULoff();
@@ -66,6 +72,10 @@ void state_drive(CommuState state);
 void set_cmp(CommuState state);
 void close_motor(void);
 void start_motor(void);
+void stop_motor(void);
+unsigned char motor_running(void);
+unsigned char motor_quiet(void);
+void overload_protect(unsigned int volt);
 static void PhaseDelayFilter(void);
 // TODO Insert appropriate #include <>
 
@@ -0,0 +1,28 @@
+/*
+ * File:   mtouch_board.h
+ *
+ * mTouch pin table for this board, read by mtouch_sensor_scan.h.
+ * The fan key is on RB5/AN13. The scans are taken in the slots handed
+ * out by arbiter_mainloop(), see arbiter.h.
+ */
+
+#ifndef MTOUCH_BOARD_H
+#define	MTOUCH_BOARD_H
+
+#include "arbiter.h"
+
+    #define MTOUCH_S0_CHANNEL                   0xD
+    #define MTOUCH_S0_LAT                       LATB
+    #define MTOUCH_S0_TRIS                      TRISB
+    #define MTOUCH_S0_ANSEL                     ANSELB
+    #define MTOUCH_S0_WPU                       WPUB
+    #define MTOUCH_S0_PIN                       5
+    #define MTOUCH_S0_GUARD                     MTOUCH_GUARD_NONE
+
+    // result kept by arbiter_serv() when the scan's conversion is done
+    #define MTOUCH_SCAN_RESULT()                arbiter_touch_result
+
+    // about 2000 scans/s with the motor running, see test/arbiter_sim.c
+    #define MTOUCH_SENSOR_SHARED_SCAN_CYCLES    2000UL
+
+#endif	/* MTOUCH_BOARD_H */
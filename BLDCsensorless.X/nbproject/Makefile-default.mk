@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=mcc_generated_files/pin_manager.c mcc_generated_files/mcc.c mosfet.c motor.c main.c int.c
+SOURCEFILES_QUOTED_IF_SPACED=mcc_generated_files/pin_manager.c mcc_generated_files/mcc.c mosfet.c motor.c main.c int.c ../mtouch.X/mcc_generated_files/mtouch/mtouch.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c arbiter.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mosfet.p1 ${OBJECTDIR}/motor.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/int.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d ${OBJECTDIR}/mcc_generated_files/mcc.p1.d ${OBJECTDIR}/mosfet.p1.d ${OBJECTDIR}/motor.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/int.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mosfet.p1 ${OBJECTDIR}/motor.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/int.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 ${OBJECTDIR}/arbiter.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d ${OBJECTDIR}/mcc_generated_files/mcc.p1.d ${OBJECTDIR}/mosfet.p1.d ${OBJECTDIR}/motor.p1.d ${OBJECTDIR}/main.p1.d ${OBJECTDIR}/int.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1.d ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1.d ${OBJECTDIR}/arbiter.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mosfet.p1 ${OBJECTDIR}/motor.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/int.p1
+OBJECTFILES=${OBJECTDIR}/mcc_generated_files/pin_manager.p1 ${OBJECTDIR}/mcc_generated_files/mcc.p1 ${OBJECTDIR}/mosfet.p1 ${OBJECTDIR}/motor.p1 ${OBJECTDIR}/main.p1 ${OBJECTDIR}/int.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 ${OBJECTDIR}/arbiter.p1
 
 # Source Files
-SOURCEFILES=mcc_generated_files/pin_manager.c mcc_generated_files/mcc.c mosfet.c motor.c main.c int.c
+SOURCEFILES=mcc_generated_files/pin_manager.c mcc_generated_files/mcc.c mosfet.c motor.c main.c int.c ../mtouch.X/mcc_generated_files/mtouch/mtouch.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c arbiter.c
 
 
 CFLAGS=
@@ -97,87 +97,199 @@ ${OBJECTDIR}/mcc_generated_files/pin_manager.p1: mcc_generated_files/pin_manager
 	@${MKDIR} "${OBJECTDIR}/mcc_generated_files" 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 mcc_generated_files/pin_manager.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 mcc_generated_files/pin_manager.c 
 	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/mcc_generated_files/mcc.p1: mcc_generated_files/mcc.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/mcc_generated_files" 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/mcc.p1.d 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/mcc.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mcc.p1 mcc_generated_files/mcc.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mcc.p1 mcc_generated_files/mcc.c 
 	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mcc.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/mosfet.p1: mosfet.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/mosfet.p1.d 
 	@${RM} ${OBJECTDIR}/mosfet.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mosfet.p1 mosfet.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mosfet.p1 mosfet.c 
 	@${FIXDEPS} ${OBJECTDIR}/mosfet.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/motor.p1: motor.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/motor.p1.d 
 	@${RM} ${OBJECTDIR}/motor.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/motor.p1 motor.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/motor.p1 motor.c 
 	@${FIXDEPS} ${OBJECTDIR}/motor.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/main.p1: main.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.p1.d 
 	@${RM} ${OBJECTDIR}/main.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/main.p1 main.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/main.p1 main.c 
 	@${FIXDEPS} ${OBJECTDIR}/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/int.p1: int.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/int.p1.d 
 	@${RM} ${OBJECTDIR}/int.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/int.p1 int.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/int.p1 int.c 
 	@${FIXDEPS} ${OBJECTDIR}/int.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/arbiter.p1: arbiter.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/arbiter.p1.d 
+	@${RM} ${OBJECTDIR}/arbiter.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/arbiter.p1 arbiter.c 
+	@${FIXDEPS} ${OBJECTDIR}/arbiter.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 else
 ${OBJECTDIR}/mcc_generated_files/pin_manager.p1: mcc_generated_files/pin_manager.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/mcc_generated_files" 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 mcc_generated_files/pin_manager.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/pin_manager.p1 mcc_generated_files/pin_manager.c 
 	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/pin_manager.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/mcc_generated_files/mcc.p1: mcc_generated_files/mcc.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}/mcc_generated_files" 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/mcc.p1.d 
 	@${RM} ${OBJECTDIR}/mcc_generated_files/mcc.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mcc.p1 mcc_generated_files/mcc.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mcc.p1 mcc_generated_files/mcc.c 
 	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mcc.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/mosfet.p1: mosfet.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/mosfet.p1.d 
 	@${RM} ${OBJECTDIR}/mosfet.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mosfet.p1 mosfet.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mosfet.p1 mosfet.c 
 	@${FIXDEPS} ${OBJECTDIR}/mosfet.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/motor.p1: motor.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/motor.p1.d 
 	@${RM} ${OBJECTDIR}/motor.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/motor.p1 motor.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/motor.p1 motor.c 
 	@${FIXDEPS} ${OBJECTDIR}/motor.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/main.p1: main.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/main.p1.d 
 	@${RM} ${OBJECTDIR}/main.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/main.p1 main.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/main.p1 main.c 
 	@${FIXDEPS} ${OBJECTDIR}/main.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/int.p1: int.c  nbproject/Makefile-${CND_CONF}.mk
 	@${MKDIR} "${OBJECTDIR}" 
 	@${RM} ${OBJECTDIR}/int.p1.d 
 	@${RM} ${OBJECTDIR}/int.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/int.p1 int.c 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/int.p1 int.c 
 	@${FIXDEPS} ${OBJECTDIR}/int.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_sensor_scan.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_sensor_scan.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_button.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_button.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_slider.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_slider.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_gesture.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_gesture.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1: ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}/mcc_generated_files/mtouch" 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1.d 
+	@${RM} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1 ../mtouch.X/mcc_generated_files/mtouch/mtouch_proximity.c 
+	@${FIXDEPS} ${OBJECTDIR}/mcc_generated_files/mtouch/mtouch_proximity.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/arbiter.p1: arbiter.c  nbproject/Makefile-${CND_CONF}.mk
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/arbiter.p1.d 
+	@${RM} ${OBJECTDIR}/arbiter.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -fno-short-double -fno-short-float -O0 -fasmfile -maddrqual=ignore -DMTOUCH_SENSORS=1 -DMTOUCH_BUTTONS=1 -DMTOUCH_SENSOR_SHARED -DMTOUCH_SENSOR_BOARD -I"." -I"mcc_generated_files" -I"../mtouch.X/mcc_generated_files/mtouch" -xassembler-with-cpp -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx032 -Wl,--data-init -mno-keep-startup -mno-osccal -mno-resetbits -mno-save-resetbits -mno-download -mno-stackcall $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto     -o ${OBJECTDIR}/arbiter.p1 arbiter.c 
+	@${FIXDEPS} ${OBJECTDIR}/arbiter.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 endif
 
 # ------------------------------------------------------------------------------------
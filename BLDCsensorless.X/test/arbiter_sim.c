@@ -0,0 +1,521 @@
+/*
+ * The fan's touch key sharing TMR2 and the ADC with the motor, against
+ * ../../mtouch.X/test/touch_model.c.
+ *
+ * int.c's interrupt runs at every TMR2 match of the motor tick and calls
+ * motor_serv() and arbiter_serv() as on the board; main.c's loop of
+ * arbiter_mainloop() and MTOUCH_Service_Mainloop() gets the CPU the
+ * interrupt leaves, and no interrupt runs in the scan slot it takes with
+ * GIE off. The library is built as BLDCsensorless.X builds it: one key,
+ * MTOUCH_SENSOR_SHARED and mtouch_board.h, with ARB_MEASURE on. The loop
+ * counts presses instead of stopping the fan, so every tap lands on a
+ * running motor.
+ *
+ * Time is instruction cycles at Fosc/4, 4 MHz. The interrupt and the
+ * slot are charged the cycles below per call, in the order they run, so
+ * TMR2 and TMR4 read as they would. The motor's and int.c's are XC8
+ * cycles: the original BLDCsensorless hex run in mtouch.X/test's
+ * pic16_sim.py, worst call of each path. The scan routine's are counted
+ * from its listing in mtouch_sensor_scan.c. The arbiter's and the
+ * library's C are hand counts of what XC8 makes of them, bank selects
+ * and calls included. Host instructions per call from insn_count.c on
+ * this program, times the 3.3 XC8 cycles per host instruction
+ * motor_serv() shows, come to about 1.5 times these; with those the
+ * motor keeps every match, but the key gets under 100 scans/s and
+ * misses the taps. ARB_MEASURE on the board tells which is nearer.
+ *
+ * The rotor turns at a fixed speed: C1OUT rises SIM_ZC_TICKS after each
+ * commutation. TMR4 runs free with period 256 and the drive switches at
+ * TMR4 0 and at CCPR1L. A touch conversion is hit by SIM_HIT counts of
+ * either sign when a PWM edge falls within SIM_RING_CYCLES before its
+ * precharge or between the precharge and the hold, or when it starts
+ * within SIM_COMM_RING_CYCLES of a commutation; that is what the
+ * arbiter's windows are there to avoid.
+ *
+ * For each PWM duty the key is tapped SIM_TAPS times and the program
+ * reports:
+ *      interrupt       the longest interrupt without and with a
+ *                      commutation, against the tick, the longest a
+ *                      match waited for a slot, and matches lost
+ *      slots           scans per second, the arbiter_measure span from
+ *                      the PWM check against ARB_PWM_HOLD, and slots a
+ *                      match came in
+ *      current         samples taken off the ARB_CURRENT_TICKS schedule
+ *      touch           taps seen, false presses, press latency and
+ *                      conversions the motor hit
+ * It fails on an interrupt without a commutation longer than the tick,
+ * a match lost outside a commutation, a scan hold later than the PWM
+ * check allowed for, a current sample off schedule, a missed tap, a false
+ * press or a conversion hit by the motor. A commutation takes about four
+ * ticks and loses the matches in it, as it did before the touch key.
+ *
+ * With "count" the 50% duty runs in this process to the end of the first
+ * tap and calls Sim_Count() shortly before it, where insn_count.c starts
+ * counting, for the host instructions to check the costs below against.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "motor.h"
+#include "arbiter.h"
+#include "mtouch.h"
+#include "touch_model.h"
+
+#define SIM_TICK_CYCLES         MOTOR_TICK_CYCLES
+#define SIM_ENTRY_CYCLES        5           /* latency to the vector */
+#define SIM_ISR_CYCLES          22          /* int.c's own, with the context save */
+#define SIM_EXIT_CYCLES         2           /* retfie */
+#define SIM_MOTOR_CYCLES        93          /* motor_serv() without a commutation */
+#define SIM_COMMUTATE_CYCLES    998         /* motor_serv() with one */
+#define SIM_ARBITER_CYCLES      46          /* arbiter_serv(), worst path */
+#define SIM_CHECK_CYCLES        72          /* arbiter_mainloop()'s checks before the wait */
+#define SIM_PWM_WAIT_CYCLES     30          /* ... a turn of its wait for a PWM window */
+#define SIM_SLOT_CYCLES         8           /* ... from the window to the scan */
+#define SIM_ACQ_SCAN_CYCLES     34          /* MTOUCH_Sensor_Acq_Scan() up to the scan routine */
+#define SIM_SLOT_END_CYCLES     13          /* ... from its return to GIE on */
+#define SIM_MAINLOOP_CYCLES     120         /* a pass of the loop, mean */
+#define SIM_SCAN_CYCLES         48          /* the scan routine, call to return */
+#define SIM_SCAN_PRECHARGE      5           /* ... to ADCON0 on the sensor */
+#define SIM_SCAN_HOLD           38          /* ... to GO, the hold */
+
+#define SIM_ZC_TICKS            20          /* commutation to zero cross, about 6000 rpm on 4 poles */
+#define SIM_RING_CYCLES         16          /* ringing after a PWM edge */
+#define SIM_COMM_RING_CYCLES    400         /* the supply settling after a commutation */
+#define SIM_HIT                 60          /* counts a disturbed conversion is off by */
+#define SIM_CURRENT             0x100       /* motor current reading, below THRH_VOLT */
+
+#define SIM_TAPS                6
+#define SIM_FIRST_MS            3000        /* the baseline settles first */
+#define SIM_TAP_MS              500
+#define SIM_TOUCH_MS            200
+#define SIM_TOUCH_PF            1.0
+#define SIM_COUNT_MS            100         /* idle before the counted tap */
+
+extern CommuState commustate;
+void ISR(void);
+void __real_motor_serv(void);
+unsigned char __real_motor_quiet(void);
+void __real_arbiter_serv(void);
+void __real_MTOUCH_Sensor_Acq_Scan(void);
+void __real_MTOUCH_CVD_ScanA_0(void);
+void __real_MTOUCH_CVD_ScanB_0(void);
+
+typedef struct
+{
+    const char*     name;
+    uint8_t         duty;
+} condition_t;
+
+typedef struct
+{
+    uint32_t        isr_max;            /* cycles, entry to return, without a commutation */
+    uint32_t        isr_comm_max;       /* ... with one */
+    uint32_t        wait_max;           /* cycles, match to entry, not behind a commutation */
+    uint64_t        isr_cycles;
+    uint32_t        ticks;
+    uint32_t        lost;               /* outside a commutation */
+    uint32_t        lost_comm;
+    uint32_t        scans;
+    uint32_t        hit;
+    uint32_t        off_schedule;
+    uint32_t        currents;
+    arbiter_measure_t measure;
+    uint32_t        presses;
+    uint32_t        false_presses;
+    double          press_ms;
+    double          press_max_ms;
+} sim_t;
+
+static const condition_t conditions[] =
+{
+    {   "duty 12%",     0x20 },
+    {   "duty 50%",     0x80 },
+    {   "duty 81%",     0xD0 },
+};
+
+/* PIC16F1936 registers xc.h declares and touch_model.c does not */
+volatile uint8_t        LATB, TRISB, ANSELB, WPUB;
+volatile uint8_t        LATC0, LATC1, LATC4, LATC5;
+volatile _Bool          STR1A, STR1B, STR1C;
+volatile _Bool          C1POL, C1NCH1, C1NCH0;
+volatile uint8_t        CCPR1L;
+
+static sim_t            sim;
+static _Bool            tmr2if;
+static uint64_t         tmr2_next = SIM_TICK_CYCLES;
+static uint64_t         tmr2_flagged;       /* the match that set TMR2IF */
+static _Bool            adgo;
+static _Bool            adc_touch;          /* the last conversion was a touch scan */
+static int              adc_hit;
+static uint32_t         motor_ticks;        /* since the last commutation */
+static uint64_t         commutated = UINT64_MAX / 2;
+static uint32_t         last_current;       /* the tick of the last current sample */
+static bool             commutating;
+static uint64_t         commutation_end;    /* the return of the last interrupt with one */
+static bool             slot_end;           /* the slot's scan is done, its end still to be charged */
+static bool             pressed;
+
+static void Sim_Busy(uint32_t cycles);
+
+
+/*
+ * =======================================================================
+ * Registers that move with time
+ * =======================================================================
+ */
+uint8_t Sim_TMR2(void)
+{
+    return (uint8_t)((Model_Cycles() % SIM_TICK_CYCLES) / 4);
+}
+
+/* The slot reads TMR4 with GIE off only while it waits for a PWM window */
+uint8_t Sim_TMR4(void)
+{
+    uint8_t t4 = (uint8_t)Model_Cycles();
+
+    if(!GIE && !slot_end)
+        Model_Advance(SIM_PWM_WAIT_CYCLES);
+    return t4;
+}
+
+volatile _Bool* Sim_TMR2IF(void)
+{
+    uint64_t now = Model_Cycles();
+
+    while(tmr2_next <= now)
+    {
+        if(tmr2if)
+            sim.lost++;
+        else
+            tmr2_flagged = tmr2_next;
+        tmr2if = 1;
+        tmr2_next += SIM_TICK_CYCLES;
+    }
+    return &tmr2if;
+}
+
+volatile _Bool* Sim_ADGO(void)
+{
+    return &adgo;
+}
+
+uint16_t Sim_ADRES(void)
+{
+    int result;
+
+    if(!adc_touch)
+        return SIM_CURRENT;
+    result = (int)Model_Scan_Result() + adc_hit;
+    return (uint16_t)(result < 0 ? 0 : result > 1023 ? 1023 : result);
+}
+
+_Bool Sim_C1OUT(void)
+{
+    return commustate != COMM_OFF && motor_ticks >= SIM_ZC_TICKS;
+}
+
+
+/*
+ * =======================================================================
+ * Interrupt, charged as it runs
+ * =======================================================================
+ */
+void __wrap_motor_serv(void)
+{
+    CommuState  before = commustate;
+
+    motor_ticks++;
+    __real_motor_serv();
+    if(commustate != before)
+    {
+        motor_ticks = 0;
+        commutated = Model_Cycles();
+        commutating = true;
+        Model_Advance(SIM_COMMUTATE_CYCLES);
+    }
+    else
+        Model_Advance(SIM_MOTOR_CYCLES);
+}
+
+void __wrap_arbiter_serv(void)
+{
+    Model_Advance(SIM_ARBITER_CYCLES);
+    __real_arbiter_serv();
+    if(adgo)
+    {
+        adgo = 0;
+        adc_touch = false;
+        if(sim.currents && sim.ticks - last_current != ARB_CURRENT_TICKS)
+            sim.off_schedule++;
+        sim.currents++;
+        last_current = sim.ticks;
+    }
+}
+
+/* Only arbiter_mainloop() asks, so its checks are charged here, interrupts on */
+unsigned char __wrap_motor_quiet(void)
+{
+    Sim_Busy(SIM_CHECK_CYCLES);
+    return __real_motor_quiet();
+}
+
+void __wrap_MTOUCH_Sensor_Acq_Scan(void)
+{
+    Model_Advance(SIM_SLOT_CYCLES + SIM_ACQ_SCAN_CYCLES);
+    __real_MTOUCH_Sensor_Acq_Scan();
+    slot_end = true;
+}
+
+/* Any PWM edge from a to b, while the drive is on */
+static bool Sim_PWM_Edge(uint64_t a, uint64_t b)
+{
+    uint64_t    period;
+
+    if(commustate == COMM_OFF)
+        return false;
+    for(period = a & ~(uint64_t)0xFF; period <= b; period += 0x100)
+    {
+        if(period >= a)
+            return true;
+        if(period + CCPR1L >= a && period + CCPR1L <= b)
+            return true;
+    }
+    return false;
+}
+
+static void Sim_Scan(void (*scan)(void))
+{
+    uint64_t    start = Model_Cycles();
+    bool        hit;
+
+    hit  = Sim_PWM_Edge(start + SIM_SCAN_PRECHARGE - SIM_RING_CYCLES, start + SIM_SCAN_HOLD);
+    hit |= start - commutated < SIM_COMM_RING_CYCLES;
+    Model_Advance(SIM_SCAN_HOLD);
+    scan();
+    Model_Advance(SIM_SCAN_CYCLES - SIM_SCAN_HOLD);
+    adc_touch = true;
+    adc_hit = hit ? ((rand() & 1) ? SIM_HIT : -SIM_HIT) : 0;
+    sim.scans++;
+    if(hit)
+        sim.hit++;
+}
+
+void __wrap_MTOUCH_CVD_ScanA_0(void)
+{
+    Sim_Scan(__real_MTOUCH_CVD_ScanA_0);
+}
+
+void __wrap_MTOUCH_CVD_ScanB_0(void)
+{
+    Sim_Scan(__real_MTOUCH_CVD_ScanB_0);
+}
+
+static void Sim_Interrupt(void)
+{
+    uint64_t    start = Model_Cycles();
+    uint32_t    wait = (uint32_t)(start - tmr2_flagged);
+    uint32_t    lost = sim.lost;
+    uint32_t    length;
+
+    commutating = false;
+    sim.ticks++;
+    Model_Advance(SIM_ENTRY_CYCLES + SIM_ISR_CYCLES);
+    ISR();
+    Model_Advance(SIM_EXIT_CYCLES);
+    length = (uint32_t)(Model_Cycles() - start);
+    sim.isr_cycles += length;
+    if(tmr2_flagged > commutation_end && wait > sim.wait_max)
+        sim.wait_max = wait;
+    Sim_TMR2IF();
+    if(commutating)
+    {
+        commutation_end = Model_Cycles();
+        sim.lost_comm += sim.lost - lost;
+        sim.lost = lost;
+        if(length > sim.isr_comm_max)
+            sim.isr_comm_max = length;
+    }
+    else if(length > sim.isr_max)
+        sim.isr_max = length;
+}
+
+/* The mainloop's own cycles, with every interrupt that comes due in them */
+static void Sim_Busy(uint32_t cycles)
+{
+    uint64_t    step;
+
+    for(;;)
+    {
+        if(*Sim_TMR2IF())
+        {
+            Sim_Interrupt();
+            continue;
+        }
+        if(cycles == 0)
+            return;
+        step = tmr2_next - Model_Cycles();
+        if(step > cycles)
+            step = cycles;
+        Model_Advance((uint32_t)step);
+        cycles -= (uint32_t)step;
+    }
+}
+
+
+/*
+ * =======================================================================
+ * Mainloop
+ * =======================================================================
+ */
+static void Sim_Mainloop(void)
+{
+    bool    now;
+    double  since;
+
+    arbiter_mainloop();
+    if(slot_end)
+    {
+        /* arbiter_measure has been read, GIE is on as this ends */
+        Model_Advance(SIM_SLOT_END_CYCLES);
+        slot_end = false;
+    }
+    MTOUCH_Service_Mainloop();
+    now = MTOUCH_Button_isPressed(Button0);
+    if(now && !pressed)
+    {
+        if(Model_Finger(0) > 0.0)
+        {
+            since = Model_Time_ms() - SIM_FIRST_MS;
+            while(since >= SIM_TAP_MS)
+                since -= SIM_TAP_MS;
+            sim.presses++;
+            sim.press_ms += since;
+            if(since > sim.press_max_ms)
+                sim.press_max_ms = since;
+        }
+        else
+            sim.false_presses++;
+    }
+    pressed = now;
+    Sim_Busy(SIM_MAINLOOP_CYCLES);
+}
+
+void __attribute__((noinline)) Sim_Count(void)
+{
+    __asm__ volatile("");
+}
+
+static void Sim_Simulate(const condition_t* c, bool count)
+{
+    static const model_env_t env = { 1.0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    model_touch_t   touch[SIM_TAPS];
+    uint64_t        until = (uint64_t)(SIM_FIRST_MS + SIM_TAPS * SIM_TAP_MS) * MODEL_CYCLES_PER_MS;
+    uint8_t         i;
+
+    for(i = 0; i < SIM_TAPS; i++)
+    {
+        touch[i].sensor    = 0;
+        touch[i].start_ms  = SIM_FIRST_MS + i * SIM_TAP_MS;
+        touch[i].length_ms = SIM_TOUCH_MS;
+        touch[i].delta_pf  = SIM_TOUCH_PF;
+    }
+    Model_Reset(&env, touch, SIM_TAPS, 12345);
+    srand(12345);
+    CCPR1L = c->duty;
+    INTCONbits.GIE  = 1;
+    INTCONbits.PEIE = 1;
+    GIE             = 1;
+    MTOUCH_Initialize();
+    start_motor();
+    if(count)
+    {
+        while(Model_Time_ms() < SIM_FIRST_MS - SIM_COUNT_MS)
+            Sim_Mainloop();
+        Sim_Count();
+        until = (uint64_t)(SIM_FIRST_MS + SIM_TOUCH_MS) * MODEL_CYCLES_PER_MS;
+    }
+    while(Model_Cycles() < until)
+        Sim_Mainloop();
+    sim.measure = arbiter_measure;
+}
+
+/* The library keeps its state in statics, so every condition gets a fresh process */
+static sim_t Sim_Run(const condition_t* c)
+{
+    int     fd[2];
+    sim_t   s;
+
+    memset(&s, 0, sizeof(s));
+    s.isr_max = UINT32_MAX;
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        Sim_Simulate(c, false);
+        if(write(fd[1], &sim, sizeof(sim)) != sizeof(sim))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &s, sizeof(s)) != sizeof(s))
+        s.isr_max = UINT32_MAX;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return s;
+}
+
+static int failures;
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Sim_Condition(const condition_t* c)
+{
+    sim_t   s = Sim_Run(c);
+    double  run_s = (SIM_TAPS * SIM_TAP_MS + SIM_FIRST_MS) / 1000.0;
+
+    printf("  %s:\n", c->name);
+    printf("    interrupt up to %lu cycles (%.1f us) of the %u cycle tick, %lu with a commutation, %.1f%% of the CPU\n",
+           (unsigned long)s.isr_max, s.isr_max / 4.0, (unsigned)SIM_TICK_CYCLES, (unsigned long)s.isr_comm_max,
+           s.isr_cycles * 100.0 / (run_s * MODEL_CYCLES_PER_MS * 1000.0));
+    printf("    a match waited up to %lu cycles, %lu lost, %lu lost in commutations\n",
+           (unsigned long)s.wait_max, (unsigned long)s.lost, (unsigned long)s.lost_comm);
+    printf("    %.0f scans/s, PWM check to scan return up to %u of %u TMR4 counts, %u slots delayed a match\n",
+           s.scans / run_s, (unsigned)s.measure.scan_tmr4, (unsigned)(ARB_PWM_HOLD + SIM_SCAN_CYCLES - SIM_SCAN_HOLD),
+           (unsigned)s.measure.late);
+    printf("    %lu current samples, %lu off schedule\n", (unsigned long)s.currents, (unsigned long)s.off_schedule);
+    printf("    %lu of %u taps, %lu false, press %.1f ms mean %.1f ms worst, %lu conversions hit\n",
+           (unsigned long)s.presses, (unsigned)SIM_TAPS, (unsigned long)s.false_presses,
+           s.presses ? s.press_ms / s.presses : 0.0, s.press_max_ms, (unsigned long)s.hit);
+
+    Check(s.isr_max <= SIM_TICK_CYCLES, "interrupt inside the tick");
+    Check(s.lost == 0, "no match lost outside a commutation");
+    Check(s.measure.scan_tmr4 <= ARB_PWM_HOLD + SIM_SCAN_CYCLES - SIM_SCAN_HOLD, "scan hold where the PWM check put it");
+    Check(s.currents > 0 && s.off_schedule == 0, "current samples on schedule");
+    Check(s.presses == SIM_TAPS && s.false_presses == 0 && s.hit == 0, "every tap and nothing else");
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t n;
+
+    if(argc > 1 && strcmp(argv[1], "count") == 0)
+    {
+        Sim_Simulate(&conditions[1], true);
+        return EXIT_SUCCESS;
+    }
+    alarm(120);
+    printf("Fan touch key on the motor tick: %u cycle tick, sample every %u ticks\n",
+           (unsigned)SIM_TICK_CYCLES, (unsigned)ARB_CURRENT_TICKS);
+    for(n = 0; n < sizeof(conditions) / sizeof(conditions[0]); n++)
+        Sim_Condition(&conditions[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
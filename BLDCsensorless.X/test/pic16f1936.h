@@ -0,0 +1,4 @@
+/*
+ * Host stand-in for the XC8 PIC16F1936 header; the registers are in xc.h.
+ */
+#include <xc.h>
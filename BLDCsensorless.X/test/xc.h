@@ -0,0 +1,77 @@
+/*
+ * Host stand-in for the XC8 device header, PIC16F1936.
+ *
+ * The test Makefile puts this directory first on the include path, so
+ * the motor, the arbiter and the shared mTouch sources compile unchanged
+ * with gcc, with ../../mtouch.X/test/touch_model.c as the touch key.
+ * Only the registers those sources touch are modelled, as plain
+ * variables, except for the ones that move with time: TMR2, TMR2IF,
+ * TMR4, C1OUT, ADGO and ADRES go through arbiter_sim.c, which keeps the
+ * instruction cycle count while the interrupt runs.
+ */
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+
+#define __XC8_VERSION               2000
+#define __interrupt(...)
+#define NOP()
+#define CLRWDT()
+#define SLEEP()                     Model_Sleep()
+#define _delay(cycles)
+
+void Model_Sleep(void);
+uint16_t Model_Scan_Result(void);
+
+/* as touch_model.c has them for the PIC16F1703 */
+extern volatile uint8_t LATA, LATC, TRISA, TRISC, ANSELA, ANSELC, WPUA, WPUC;
+extern volatile uint8_t ADCON0, ADCON1, ADCON2, WDTCON;
+
+typedef struct
+{
+    unsigned GIE:1;
+    unsigned PEIE:1;
+    unsigned TMR0IE:1;
+    unsigned TMR0IF:1;
+} INTCONbits_t;
+extern volatile INTCONbits_t INTCONbits;
+extern volatile uint8_t GIE;
+
+typedef struct
+{
+    unsigned T2CKPS:2;
+    unsigned TMR2ON:1;
+    unsigned T2OUTPS:4;
+} T2CONbits_t;
+extern volatile T2CONbits_t T2CONbits;
+
+/* the touch key on RB5 */
+extern volatile uint8_t LATB, TRISB, ANSELB, WPUB;
+
+/* gate drive: high sides on port C, low sides steered by the ECCP */
+extern volatile uint8_t LATC0, LATC1, LATC4, LATC5;     /* not _Bool: motor.c toggles LATC4 with ~ */
+extern volatile _Bool STR1A, STR1B, STR1C;
+
+/* BEMF comparator */
+extern volatile _Bool C1POL, C1NCH1, C1NCH0;
+
+/* PWM duty against TMR4 */
+extern volatile uint8_t CCPR1L;
+
+/* moving with time, see arbiter_sim.c */
+uint8_t             Sim_TMR2(void);
+uint8_t             Sim_TMR4(void);
+volatile _Bool*     Sim_TMR2IF(void);
+volatile _Bool*     Sim_ADGO(void);
+uint16_t            Sim_ADRES(void);
+_Bool               Sim_C1OUT(void);
+
+#define TMR2                        Sim_TMR2()
+#define TMR4                        Sim_TMR4()
+#define TMR2IF                      (*Sim_TMR2IF())
+#define ADGO                        (*Sim_ADGO())
+#define ADRES                       Sim_ADRES()
+#define C1OUT                       Sim_C1OUT()
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * File:   bam.c
+ */
+
+
+#include <xc.h>
+#include "bam.h"
+
+// TMR1 is reloaded by adding, so the interrupt latency is not lost
+#define RELOAD(k)       ((unsigned int) (0 - ((unsigned long) BAM_LSB_CYCLES << (k)) + BAM_STOP_CYCLES))
+
+static const unsigned int reload[8] = {
+    RELOAD(0), RELOAD(1), RELOAD(2), RELOAD(3),
+    RELOAD(4), RELOAD(5), RELOAD(6), RELOAD(7)
+};
+
+// channel order follows the animations: RA0 RA1 RC0 RC1 RC2 RC4 RA4 RA5
+static const unsigned char chan_a[BAM_CHANNELS] = {0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x10, 0x20};
+static const unsigned char chan_c[BAM_CHANNELS] = {0x00, 0x00, 0x01, 0x02, 0x04, 0x10, 0x00, 0x00};
+
+// two sets of plane masks, bam_set() writes the one not shown
+static unsigned char plane_a[2][BAM_BITS];
+static unsigned char plane_c[2][BAM_BITS];
+static volatile unsigned char bam_active;
+static volatile unsigned char bam_pending;
+static unsigned char bam_plane;
+static unsigned char bam_shift = 8 - BAM_BITS;
+
+void bam_init(void) {
+    unsigned char p;
+
+    for (p = 0; p < BAM_BITS; p++) {
+        plane_a[0][p] = 0;
+        plane_c[0][p] = 0;
+    }
+    bam_active = 0;
+    bam_pending = 0;
+    bam_plane = 0;
+
+    T1CON = 0b00000001;     // Fosc/4, 1:1, on
+    TMR1IF = 0;
+    TMR1IE = 1;
+    PEIE = 1;
+}
+
+/*
+ * Called from the TMR1 interrupt at the start of each plane. New levels
+ * are taken only at plane 0, so a refresh never mixes two settings.
+ */
+void bam_serv(void) {
+    unsigned char p = bam_plane;
+    unsigned char a, c;
+
+    TMR1ON = 0;
+    TMR1 += reload[p];
+    TMR1ON = 1;
+
+    if (p == 0 && bam_pending) {
+        bam_active ^= 1;
+        bam_pending = 0;
+    }
+    a = (unsigned char) ((LATA & ~BAM_LATA_MASK) | plane_a[bam_active][p]);
+    c = (unsigned char) ((LATC & ~BAM_LATC_MASK) | plane_c[bam_active][p]);
+    LATA = a;
+    LATC = c;
+
+    if (++p == BAM_BITS) p = 0;
+    bam_plane = p;
+}
+
+/*
+ * Set the brightness of all channels, 0 off to 255 full on. With fewer
+ * than 8 BAM_BITS the low bits are dropped. Shown from the next refresh.
+ */
+void bam_set(const unsigned char *level) {
+    unsigned char ch, p, v, next;
+    unsigned char *pa, *pc;
+
+    // no swap while the next set is written
+    bam_pending = 0;
+    next = bam_active ^ 1;
+    pa = plane_a[next];
+    pc = plane_c[next];
+
+    for (p = 0; p < BAM_BITS; p++) {
+        pa[p] = 0;
+        pc[p] = 0;
+    }
+    for (ch = 0; ch < BAM_CHANNELS; ch++) {
+        v = level[ch] >> bam_shift;
+        for (p = 0; p < BAM_BITS; p++) {
+            if (v & 1) {
+                pa[p] |= chan_a[ch];
+                pc[p] |= chan_c[ch];
+            }
+            v >>= 1;
+        }
+    }
+    bam_pending = 1;
+}
+
+/*
+ * Scale the levels of the following bam_set() calls down by 2^shift.
+ */
+void bam_dim(unsigned char shift) {
+    bam_shift = (unsigned char) (8 - BAM_BITS + shift);
+}
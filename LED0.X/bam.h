@@ -0,0 +1,39 @@
+/*
+ * File:   bam.h
+ *
+ * Binary code modulation of the eight LEDs from the TMR1 interrupt.
+ * A refresh is BAM_BITS bit planes, plane k lasts BAM_LSB_CYCLES << k.
+ * Each plane writes precomputed LATA and LATC masks, so the interrupt
+ * cost does not depend on the number of LEDs.
+ *
+ * With BAM_LSB_CYCLES 256 at Fosc/4 = 8 MHz:
+ *   BAM_BITS 8: refresh 8.2 ms (122 Hz)
+ *   BAM_BITS 7: refresh 4.1 ms (245 Hz)
+ *   BAM_BITS 6: refresh 2.0 ms (496 Hz)
+ * bam_serv() takes about 45 cycles with the interrupt entry and exit,
+ * once per plane: 8 interrupts per refresh, under 1% of the CPU at 8
+ * bits. The shortest plane has room for it and a TMR2 tick behind it.
+ */
+
+#ifndef BAM_H
+#define	BAM_H
+
+#define BAM_CHANNELS        8
+#define BAM_BITS            8       // 6 to 8
+#define BAM_LSB_CYCLES      256     // instruction cycles of plane 0
+#define BAM_STOP_CYCLES     6       // TMR1 stopped while it is reloaded
+
+// LEDs on RA0 RA1 RA4 RA5 and RC0 RC1 RC2 RC4
+#define BAM_LATA_MASK       0x33
+#define BAM_LATC_MASK       0x17
+
+#if BAM_BITS < 6 || BAM_BITS > 8
+#error BAM_BITS must be 6 to 8
+#endif
+
+void bam_init(void);
+void bam_serv(void);
+void bam_set(const unsigned char *level);
+void bam_dim(unsigned char shift);
+
+#endif	/* BAM_H */
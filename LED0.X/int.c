@@ -1,23 +1,23 @@
 #include <xc.h>
-extern int timebase;
-extern int times;
-extern int waitOK;
+#include "bam.h"
+#include "sequencer.h"
+#include "swtimer.h"
+#include "supply.h"
 void __interrupt() isr(void)
 {
+    // first, a late plane shows as a brightness error
+    if(TMR1IF){
+        TMR1IF = 0;
+        bam_serv();
+    }
     if(ADIF){
         ADIF = 0;
+        supply_adc();
     }
-    static int n = 0;
-    if(T0IF){
-        if(n<times){
-            n++;
-            T0IF = 0;
-            T0IE = 1;
-            TMR0 = timebase;
-        }
-        else{
-            n = 0;
-            waitOK = 1;
-        }
+    if(TMR2IF){
+        TMR2IF = 0;
+        seq_tick();
+        swtimer_tick();
+        supply_tick();
     }
 }
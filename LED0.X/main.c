@@ -27,25 +27,70 @@
 
 // #pragma config statements should precede project file includes.
 // Use project enums instead of #define for ON and OFF.
-int waitOK = 0;
-int timebase;
-int times;
-#define ADCMAX 0x3F
-#define VTHR 137
+#include "sequencer.h"
+#include "swtimer.h"
+#include "supply.h"
+
+#define MODE_OFF 0
+#define MODE_FILL 1
+#define MODE_CHASE 2
+
+#define KEY_SAMPLE_MS 30
+
+#define FULL 255
+#define TAIL 24
+
+// RC3 high: fill up and empty again
+static const seq_frame_t fill[] = {
+    {{FULL, FULL, 0, 0, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{FULL, FULL, FULL, FULL, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{FULL, FULL, FULL, FULL, FULL, FULL, 0, 0}, SEQ_MS(250)},
+    {{FULL, FULL, FULL, FULL, FULL, FULL, FULL, FULL}, SEQ_MS(250)},
+    {{FULL, FULL, FULL, FULL, FULL, FULL, 0, 0}, SEQ_MS(250)},
+    {{FULL, FULL, FULL, FULL, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{FULL, FULL, 0, 0, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{0, 0, 0, 0, 0, 0, 0, 0}, SEQ_MS(2000)},
+    {{0}, 0}
+};
+
+// RC3 low: one pair at a time, the last pair left dim
+static const seq_frame_t chase[] = {
+    {{FULL, FULL, 0, 0, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{TAIL, TAIL, FULL, FULL, 0, 0, 0, 0}, SEQ_MS(250)},
+    {{0, 0, TAIL, TAIL, FULL, FULL, 0, 0}, SEQ_MS(250)},
+    {{0, 0, 0, 0, TAIL, TAIL, FULL, FULL}, SEQ_MS(250)},
+    {{0, 0, 0, 0, 0, 0, TAIL, TAIL}, SEQ_MS(250)},
+    {{0, 0, 0, 0, 0, 0, 0, 0}, SEQ_MS(1750)},
+    {{0}, 0}
+};
+
+// after each pattern on a critical battery
+static const seq_frame_t rest[] = {
+    {{0, 0, 0, 0, 0, 0, 0, 0}, SEQ_MS(2500)},
+    {{0, 0, 0, 0, 0, 0, 0, 0}, SEQ_MS(2500)},
+    {{0, 0, 0, 0, 0, 0, 0, 0}, SEQ_MS(2500)},
+    {{0}, 0}
+};
+
 void wdt_init(void);
-unsigned int getadc();
-void wait(int ms);
-unsigned int vadc;
+
+// RC3 counts once it reads the same on two samples in a row
+static swtimer_t key_timer;
+static unsigned char key;
+static void key_sample(void){
+    static unsigned char last;
+    unsigned char now = RC3;
+    if(now == last) key = now;
+    last = now;
+}
+
 void main(void) {
+    unsigned char mode;
+    unsigned char last_mode = MODE_OFF;
+    unsigned char level;
+
+    OSCCON = 0b01110000;    // 8 MHz HFINTOSC, 4x PLL from the config word
     wdt_init();
-    GIE = 1;
-    //ADC INIT
-    ADON = 1;
-    ADFM = 1;
-    ADCON1bits.ADCS = 0b110;
-    ADCON0bits.CHS = 0x2;
-    ADPREF0 = 0;
-    ADPREF1 = 0;
     //PORT INIT
     TRISA = 0x0;
     TRISC = 0x0;
@@ -55,87 +100,35 @@ void main(void) {
     LATC = 0x0;
     ANSA2 =1;
     ANSC3 = 0;
+    bam_init();
+    seq_init();
+    supply_init();
+    swtimer_init(&key_timer, key_sample);
+    swtimer_start(&key_timer, 0, SWT_MS(KEY_SAMPLE_MS));
+    key = RC3;
+    GIE = 1;
     while(1){
-       // LATC0 =0;
-        vadc = getadc();
-   //     voltage = VREF * vadc/ ADCMAX;
-        if(vadc <= VTHR){
-      //      LATC0 = 1;
-            if(RC3){
-                LATA0 = 1;
-                LATA1 = 1;
-                wait(250);
-                LATC1 = 1;
-                LATC0 = 1;
-                wait(250);
-                LATC2 = 1;
-                LATC4 = 1;
-                wait(250);
-                LATA4 = 1;
-                LATA5 = 1;
-                wait(250);
-                LATA5 = 0;
-                LATA4 = 0;
-                wait(250);
-                LATC2 = 0;
-                LATC4 = 0;
-                wait(250);
-                LATC1 = 0;
-                LATC0 = 0;
-                wait(250);
-                LATA0 = 0;
-                LATA1 = 0;
-                wait(2000);
-            }
-            else{
-                LATA0 = 1;
-                LATA1 = 1;
-                wait(250);
-                LATA0 = 0;
-                LATA1 = 0;
-                LATC1 = 1;
-                LATC0 = 1;
-                wait(250);
-                LATC1 = 0;
-                LATC0 = 0;
-                LATC2 = 1;
-                LATC4 = 1;
-                wait(250);
-                LATC2 = 0;
-                LATC4 = 0;
-                LATA4 = 1;
-                LATA5 = 1;
-                wait(250);
-                LATA5 = 0;
-                LATA4 = 0;
-                wait(2000);
-            }
+        swtimer_service();
+        supply_service();
+        if(!supply_sense_low()) mode = MODE_OFF;
+        else if(key) mode = MODE_FILL;
+        else mode = MODE_CHASE;
+
+        // a new mode cuts the pattern short
+        if(mode != last_mode){
+            seq_stop();
+            last_mode = mode;
         }
-        else{
-            wait(2000);
+        // half the brightness a level down, from the next frame
+        level = supply_level();
+        bam_dim(level);
+        if(mode != MODE_OFF && seq_idle()){
+            seq_queue(mode == MODE_FILL ? fill : chase);
+            if(level == SUPPLY_CRITICAL) seq_queue(rest);
         }
+        seq_service();
     }
 }
 void wdt_init(void){
     
 } 
-unsigned int getadc(){
-    ADGO = 1;
-    while(ADGO);
-    return (unsigned int)((ADRESH<<8)|ADRESL );
-}
-
-void wait(int ms){
-    waitOK = 0;
-    T0CS = 0;
-    PSA = 1;
-    T0IF = 0;
-    T0IE = 1;
-    timebase = 0xAA;
-    times = ms;
-    TMR0 = timebase;
-    while(!waitOK);
-}
-
-
-
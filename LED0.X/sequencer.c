@@ -0,0 +1,105 @@
+/*
+ * File:   sequencer.c
+ */
+
+
+#include <xc.h>
+#include "sequencer.h"
+
+static const unsigned char seq_off[SEQ_LEDS];
+
+static const seq_frame_t *frame;                    // frame being shown
+static unsigned char frame_ticks;
+static volatile unsigned char seq_busy;             // frame is valid
+static volatile unsigned char seq_due;              // frame not yet given to bam_set()
+
+// written by the main loop at head, read by the tick at tail
+static const seq_frame_t *queue[SEQ_QUEUE_SIZE];
+static volatile unsigned char queue_head;
+static volatile unsigned char queue_tail;
+
+void seq_init(void) {
+    queue_head = 0;
+    queue_tail = 0;
+    seq_busy = 0;
+    seq_due = 0;
+    bam_set(seq_off);
+
+    PR2 = 124;
+    T2CON = 0b01001111;     // 1:10 postscale, on, 1:64 prescale
+    TMR2IF = 0;
+    TMR2IE = 1;
+    PEIE = 1;
+}
+
+/*
+ * Called from the TMR2 interrupt every SEQ_TICK_MS.
+ */
+void seq_tick(void) {
+    if (seq_busy) {
+        if (--frame_ticks) return;
+        frame++;
+        if (frame->ticks) {
+            frame_ticks = frame->ticks;
+            seq_due = 1;
+            return;
+        }
+        seq_busy = 0;
+    }
+
+    // the next pattern starts in the tick the last one ended
+    if (queue_head == queue_tail) return;
+    frame = queue[queue_tail];
+    queue_tail = (queue_tail + 1) & (SEQ_QUEUE_SIZE - 1);
+    if (!frame->ticks) return;
+    frame_ticks = frame->ticks;
+    seq_due = 1;
+    seq_busy = 1;
+}
+
+/*
+ * Called every main loop. The plane masks are worked out here rather
+ * than in the tick, so the BAM interrupt is never held off for long.
+ */
+void seq_service(void) {
+    const seq_frame_t *f;
+
+    if (!seq_due) return;
+    TMR2IE = 0;
+    f = frame;
+    seq_due = 0;
+    TMR2IE = 1;
+    bam_set(f->level);
+}
+
+/*
+ * Queue a pattern behind the ones already queued. Returns 0 if the
+ * queue is full.
+ */
+unsigned char seq_queue(const seq_frame_t *pattern) {
+    unsigned char next = (queue_head + 1) & (SEQ_QUEUE_SIZE - 1);
+
+    if (next == queue_tail) return 0;
+    queue[queue_head] = pattern;
+    queue_head = next;
+    return 1;
+}
+
+/*
+ * Drop the queue and the pattern being shown, and turn the LEDs off.
+ */
+void seq_stop(void) {
+    TMR2IE = 0;
+    queue_tail = queue_head;
+    seq_busy = 0;
+    seq_due = 0;
+    TMR2IE = 1;
+    bam_set(seq_off);
+}
+
+/*
+ * Nothing shown and nothing queued.
+ */
+unsigned char seq_idle(void) {
+    return (unsigned char) (!seq_busy && queue_head == queue_tail);
+}
@@ -0,0 +1,35 @@
+/*
+ * File:   sequencer.h
+ *
+ * LED pattern sequencer. A pattern is a table of frames, each frame is
+ * a brightness for every LED and how many ticks to show it. The TMR2
+ * tick steps the frames. seq_service() in the main loop hands a new
+ * frame to the BAM engine, which shows it from its next refresh.
+ */
+
+#ifndef SEQUENCER_H
+#define	SEQUENCER_H
+
+#include "bam.h"
+
+// tick: Fosc/4 = 8 MHz, TMR2 1:64, PR2 124, postscale 1:10
+#define SEQ_TICK_MS         10
+#define SEQ_MS(ms)          ((ms)/SEQ_TICK_MS)
+
+#define SEQ_LEDS            BAM_CHANNELS
+
+#define SEQ_QUEUE_SIZE      4       // patterns waiting, power of 2
+
+typedef struct {
+    unsigned char level[SEQ_LEDS];  // 0 off to 255 full on, in bam.c channel order
+    unsigned char ticks;            // frame length, 0 ends the pattern
+} seq_frame_t;
+
+void seq_init(void);
+void seq_tick(void);
+void seq_service(void);
+unsigned char seq_queue(const seq_frame_t *pattern);
+void seq_stop(void);
+unsigned char seq_idle(void);
+
+#endif	/* SEQUENCER_H */
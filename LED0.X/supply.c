@@ -0,0 +1,144 @@
+/*
+ * File:   supply.c
+ */
+
+
+#include <xc.h>
+#include "supply.h"
+
+#define SENSE_CHANNEL       0x02        // AN2
+#define FVR_CHANNEL         0x1F        // FVR buffer 1
+#define FVR_MV              1024UL
+
+// mV = FVR_MV * 1023 * 4 / FVR count with 2 extra bits
+#define FVR_SCALE           (FVR_MV * 1023 * 4)
+#define MAX_MV              5500        // above the part's Vdd range, keeps the filter in 16 bits
+
+// taken by the ADC interrupt
+static unsigned int sense_sum;
+static unsigned int fvr_sum;
+static unsigned char samples;
+static volatile unsigned char on_fvr;
+
+// a full block, left alone by the interrupt until supply_service() takes it
+static volatile unsigned char block_ready;
+static unsigned int block_sense;
+static unsigned int block_fvr;
+
+static unsigned char sense_low;
+static unsigned char level = SUPPLY_NORMAL;
+static unsigned int mv_sum;
+static unsigned int mv;
+static unsigned char primed;
+
+void supply_init(void) {
+    FVRCON = 0b10000001;        // FVR on, ADC buffer 1.024 V
+    while (!FVRRDY);
+
+    ADFM = 1;
+    ADCON1bits.ADCS = 0b110;    // Fosc/64
+    ADPREF0 = 0;                // Vdd reference for both channels
+    ADPREF1 = 0;
+    ADCON0bits.CHS = SENSE_CHANNEL;
+    ADON = 1;
+    on_fvr = 0;
+    samples = 0;
+    sense_sum = 0;
+    fvr_sum = 0;
+    block_ready = 0;
+
+    ADIF = 0;
+    ADIE = 1;
+    PEIE = 1;
+}
+
+/*
+ * Called from the TMR2 interrupt. The channel was selected by the last
+ * conversion, so it has had a whole tick to acquire.
+ */
+void supply_tick(void) {
+    if (!ADGO) ADGO = 1;
+}
+
+/*
+ * Called from the ADC interrupt.
+ */
+void supply_adc(void) {
+    unsigned int r = (unsigned int) ((ADRESH << 8) | ADRESL);
+
+    if (!on_fvr) {
+        sense_sum += r;
+        ADCON0bits.CHS = FVR_CHANNEL;
+        on_fvr = 1;
+        return;
+    }
+    fvr_sum += r;
+    ADCON0bits.CHS = SENSE_CHANNEL;
+    on_fvr = 0;
+
+    if (++samples < SUPPLY_OVERSAMPLE) return;
+    // a block the main loop has not taken yet is overwritten by the next one
+    if (!block_ready) {
+        block_sense = sense_sum;
+        block_fvr = fvr_sum;
+        block_ready = 1;
+    }
+    samples = 0;
+    sense_sum = 0;
+    fvr_sum = 0;
+}
+
+/*
+ * Called every main loop. Works on a block every 320 ms.
+ */
+void supply_service(void) {
+    unsigned int sense;
+    unsigned int fvr;
+    unsigned long now_mv;
+
+    if (!block_ready) return;
+    sense = block_sense >> SUPPLY_OVERSAMPLE_SHIFT;
+    fvr = block_fvr >> (SUPPLY_OVERSAMPLE_SHIFT - 2);
+    block_ready = 0;
+
+    // AN2 with hysteresis
+    if (sense <= SUPPLY_SENSE_THR) sense_low = 1;
+    else if (sense > SUPPLY_SENSE_THR + SUPPLY_SENSE_HYST) sense_low = 0;
+
+    // battery, first order low pass started at the first block
+    if (!fvr) return;
+    now_mv = FVR_SCALE / fvr;
+    if (now_mv > MAX_MV) now_mv = MAX_MV;
+    if (!primed) {
+        mv_sum = (unsigned int) now_mv << SUPPLY_FILTER_SHIFT;
+        primed = 1;
+    }
+    mv_sum += (unsigned int) now_mv - (mv_sum >> SUPPLY_FILTER_SHIFT);
+    mv = mv_sum >> SUPPLY_FILTER_SHIFT;
+
+    // down at once, up only past the hysteresis
+    if (mv < SUPPLY_CRITICAL_MV) {
+        level = SUPPLY_CRITICAL;
+    } else if (mv < SUPPLY_LOW_MV) {
+        if (level == SUPPLY_NORMAL || mv >= SUPPLY_CRITICAL_MV + SUPPLY_HYST_MV) level = SUPPLY_LOW;
+    } else if (mv >= SUPPLY_LOW_MV + SUPPLY_HYST_MV) {
+        level = SUPPLY_NORMAL;
+    } else if (level == SUPPLY_CRITICAL && mv >= SUPPLY_CRITICAL_MV + SUPPLY_HYST_MV) {
+        level = SUPPLY_LOW;
+    }
+}
+
+/*
+ * AN2 at or below SUPPLY_SENSE_THR, the condition the patterns run in.
+ */
+unsigned char supply_sense_low(void) {
+    return sense_low;
+}
+
+unsigned char supply_level(void) {
+    return level;
+}
+
+unsigned int supply_mv(void) {
+    return mv;
+}
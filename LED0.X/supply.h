@@ -0,0 +1,42 @@
+/*
+ * File:   supply.h
+ *
+ * Background ADC for the LED board. Every TMR2 tick starts one
+ * conversion, the ADC interrupt takes the result and selects the other
+ * channel, so each channel gets SUPPLY_OVERSAMPLE samples in
+ * 2 * SUPPLY_OVERSAMPLE ticks (320 ms) without the main loop waiting:
+ *  - AN2 against Vdd, averaged and compared with SUPPLY_SENSE_THR as
+ *    the old VTHR check was, with SUPPLY_SENSE_HYST on the way back up
+ *  - the 1.024 V FVR against Vdd, giving the battery (Vdd) in mV to 2
+ *    extra bits, then low pass filtered
+ * The battery falls through SUPPLY_LOW_MV and SUPPLY_CRITICAL_MV to
+ * the lower power levels, and comes back up only SUPPLY_HYST_MV above.
+ */
+
+#ifndef SUPPLY_H
+#define	SUPPLY_H
+
+#define SUPPLY_OVERSAMPLE_SHIFT 4
+#define SUPPLY_OVERSAMPLE       (1 << SUPPLY_OVERSAMPLE_SHIFT)
+#define SUPPLY_FILTER_SHIFT     2       // battery filter, in blocks
+
+#define SUPPLY_SENSE_THR        137     // AN2 count, animate at or below
+#define SUPPLY_SENSE_HYST       8
+
+#define SUPPLY_LOW_MV           2700
+#define SUPPLY_CRITICAL_MV      2400
+#define SUPPLY_HYST_MV          100
+
+#define SUPPLY_NORMAL           0
+#define SUPPLY_LOW              1       // LEDs dimmed
+#define SUPPLY_CRITICAL         2       // LEDs dimmed further, long rest between patterns
+
+void supply_init(void);
+void supply_tick(void);
+void supply_adc(void);
+void supply_service(void);
+unsigned char supply_sense_low(void);
+unsigned char supply_level(void);
+unsigned int supply_mv(void);
+
+#endif	/* SUPPLY_H */
@@ -0,0 +1,138 @@
+/*
+ * File:   swtimer.c
+ */
+
+
+#include <xc.h>
+#include "swtimer.h"
+
+#define SLOT_MASK       (SWT_SLOTS - 1)
+#define LEVEL1_TICKS    (1u << SWT_SLOT_BITS)
+#define LEVEL2_TICKS    (1u << (2 * SWT_SLOT_BITS))
+#define WHEEL_TICKS     (1u << (3 * SWT_SLOT_BITS))
+
+#if 3 * SWT_SLOT_BITS > 15
+#error SWT_SLOT_BITS too large for a 16-bit tick count
+#endif
+
+static swtimer_t *wheel[3][SWT_SLOTS];
+static unsigned int swt_now;                // next tick to run
+static volatile unsigned char swt_ticks;    // counted by the interrupt
+static unsigned char swt_done;              // run by swtimer_service()
+
+static void link(swtimer_t **head, swtimer_t *t) {
+    t->next = *head;
+    if (t->next) t->next->pprev = &t->next;
+    *head = t;
+    t->pprev = head;
+}
+
+static void unlink(swtimer_t *t) {
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    t->pprev = 0;
+}
+
+/*
+ * Level 0 holds the timers due in the next SWT_SLOTS ticks, one slot a
+ * tick. Levels 1 and 2 hold SWT_SLOTS times as many ticks a slot.
+ */
+static void insert(swtimer_t *t) {
+    unsigned int e = t->expires;
+    unsigned int delta = e - swt_now;
+
+    if ((int) delta < 0) {
+        link(&wheel[0][swt_now & SLOT_MASK], t);
+    } else if (delta < LEVEL1_TICKS) {
+        link(&wheel[0][e & SLOT_MASK], t);
+    } else if (delta < LEVEL2_TICKS) {
+        link(&wheel[1][(e >> SWT_SLOT_BITS) & SLOT_MASK], t);
+    } else {
+        // beyond the wheel: park in the last slot in range, it comes back here
+        if (delta >= WHEEL_TICKS) e = swt_now + WHEEL_TICKS - 1;
+        link(&wheel[2][(e >> (2 * SWT_SLOT_BITS)) & SLOT_MASK], t);
+    }
+}
+
+// move a slot's timers down a level, they are all due within its span
+static void cascade(unsigned char level, unsigned char index) {
+    swtimer_t *t;
+
+    while ((t = wheel[level][index]) != 0) {
+        unlink(t);
+        insert(t);
+    }
+}
+
+static void run_tick(void) {
+    unsigned char index = swt_now & SLOT_MASK;
+    unsigned char upper;
+    swtimer_t *work;
+    swtimer_t *t;
+
+    if (!index) {
+        upper = (swt_now >> SWT_SLOT_BITS) & SLOT_MASK;
+        if (!upper) cascade(2, (swt_now >> (2 * SWT_SLOT_BITS)) & SLOT_MASK);
+        cascade(1, upper);
+    }
+    swt_now++;
+
+    // take the slot off the wheel first, a periodic timer may come back to it
+    work = wheel[0][index];
+    wheel[0][index] = 0;
+    if (work) work->pprev = &work;
+    while ((t = work) != 0) {
+        unlink(t);
+        if (t->period) {
+            t->expires += t->period;
+            insert(t);
+        }
+        t->callback();
+    }
+}
+
+void swtimer_init(swtimer_t *t, void (*callback)(void)) {
+    t->next = 0;
+    t->pprev = 0;
+    t->period = 0;
+    t->callback = callback;
+}
+
+/*
+ * The callback runs between delay and delay + 1 ticks from now, then
+ * every period ticks if period is not 0. A running timer is restarted.
+ */
+void swtimer_start(swtimer_t *t, unsigned int delay, unsigned int period) {
+    if (t->pprev) unlink(t);
+    if (delay > SWT_MAX_TICKS) delay = SWT_MAX_TICKS;
+    if (period > SWT_MAX_TICKS) period = SWT_MAX_TICKS;
+    t->expires = swt_now + delay;
+    t->period = period;
+    insert(t);
+}
+
+void swtimer_stop(swtimer_t *t) {
+    if (t->pprev) unlink(t);
+}
+
+unsigned char swtimer_active(swtimer_t *t) {
+    return (unsigned char) (t->pprev != 0);
+}
+
+/*
+ * Called from the hardware tick interrupt every SWT_TICK_MS.
+ */
+void swtimer_tick(void) {
+    swt_ticks++;
+}
+
+/*
+ * Called every main loop. Catches up on all ticks counted since the
+ * last call, up to 255 of them.
+ */
+void swtimer_service(void) {
+    while (swt_done != swt_ticks) {
+        swt_done++;
+        run_tick();
+    }
+}
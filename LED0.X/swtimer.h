@@ -0,0 +1,42 @@
+/*
+ * File:   swtimer.h
+ *
+ * Software timers on one hardware tick. Any number of one-shot and
+ * periodic timers, each a swtimer_t owned by the caller. They sit in a
+ * three level timing wheel of SWT_SLOTS slots a level, so start, stop
+ * and expiry do not depend on how many timers run. A timer further out
+ * than one level waits in the level above and moves down as the wheel
+ * turns.
+ *
+ * The interrupt only counts ticks in swtimer_tick(). swtimer_service()
+ * turns the wheel and calls the callbacks from the main loop, so they
+ * may start and stop timers, their own included. Start and stop only
+ * from the main loop.
+ */
+
+#ifndef SWTIMER_H
+#define	SWTIMER_H
+
+#define SWT_TICK_MS         10      // period of the swtimer_tick() calls
+#define SWT_MS(ms)          ((ms)/SWT_TICK_MS)
+
+#define SWT_SLOT_BITS       3
+#define SWT_SLOTS           (1 << SWT_SLOT_BITS)
+#define SWT_MAX_TICKS       0x7FFF  // longest delay or period
+
+typedef struct swtimer {
+    struct swtimer *next;
+    struct swtimer **pprev;         // link that points here, 0 when stopped
+    unsigned int expires;           // tick count it is due at
+    unsigned int period;            // 0 for one-shot
+    void (*callback)(void);
+} swtimer_t;
+
+void swtimer_init(swtimer_t *t, void (*callback)(void));
+void swtimer_start(swtimer_t *t, unsigned int delay, unsigned int period);
+void swtimer_stop(swtimer_t *t);
+unsigned char swtimer_active(swtimer_t *t);
+void swtimer_tick(void);
+void swtimer_service(void);
+
+#endif	/* SWTIMER_H */
@@ -43,7 +43,6 @@
 
 #include "mcc_generated_files/mcc.h"
 
-extern mtouch_sensor_t mtouch_sensor[MTOUCH_SENSORS];
 /*
                          Main application
  */
@@ -69,16 +68,15 @@ void main(void)
 
     while (1)
     {
-        
-     MTOUCH_Service_Mainloop();
-        
+        // Add your application code
+        if(MTOUCH_Service_Mainloop())
+        {
             if(MTOUCH_Button_isPressed(Button0))
                 LED_SetHigh();
             else
                 LED_SetLow();
-         
-        // Add your application code
-}
+        }
+    }
 }
 /**
  End of File
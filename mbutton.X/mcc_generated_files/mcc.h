@@ -52,7 +52,7 @@
 #include <stdbool.h>
 #include "interrupt_manager.h"
 #include "tmr2.h"
-#include "mtouch/mtouch.h"
+#include "mtouch.h"
 
 #define _XTAL_FREQ  16000000
 
@@ -1,79 +0,0 @@
-/*
-    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
-
-    You may use this software, and any derivatives created by any person or
-    entity by or on your behalf, exclusively with Microchip's products.
-    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
-    ownership and intellectual property rights in the accompanying software and
-    in all derivatives hereto.
-
-    This software and any accompanying information is for suggestion only. It
-    does not modify Microchip's standard warranty for its products.  You agree
-    that you are solely responsible for testing the software and determining
-    its suitability.  Microchip has no obligation to modify, test, certify, or
-    support the software.
-
-    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
-    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
-    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
-    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
-    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
-
-    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
-    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
-    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
-    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
-    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
-    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
-    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
-    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
-    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
-    THIS SOFTWARE.
-
-    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
-    THESE TERMS.
-*/
-
-#include <xc.h>
-#include <stdint.h>
-
-#include "mtouch.h"
-#include "../mcc.h"
-
-/*
- * =======================================================================
- * MTOUCH_Init()
- * =======================================================================
- *  Root initialization routine for all enabled mTouch library modules.
- */
-void MTOUCH_Initialize(void)
-{   
-    MTOUCH_Sensor_InitializeAll();
-        MTOUCH_Button_InitializeAll();
-    MTOUCH_Sensor_Sampled_ResetAll();
-    MTOUCH_Sensor_Scan_Initialize();
-}
-
-/*
- * =======================================================================
- * MTOUCH_Service_Mainloop()
- * =======================================================================
- *  Root mainloop service routine for all enabled mTouch library modules.
- */
-bool MTOUCH_Service_Mainloop(void)
-{
-    MTOUCH_Sensor_SampleAll();           
-    MTOUCH_Button_ServiceAll();             /* Execute state machine for all buttons w/scanned sensors */
-    MTOUCH_Sensor_Sampled_ResetAll();  
-    return true;
-}
-
-/*
- * =======================================================================
- * MTOUCH_Tick
- * =======================================================================
- */
-void MTOUCH_Tick(void)
-{
-    MTOUCH_Button_Tick();
-}
@@ -48,6 +48,10 @@ A PARTICULAR PURPOSE.
  */
 void main(void)
 {
+#if MTOUCH_GESTURE
+    mtouch_gesture_event_t gesture;
+#endif
+
     // initialize the device
     SYSTEM_Initialize();
 
@@ -69,13 +73,29 @@ void main(void)
     while (1)
     {
         // Add your application code
+#if MTOUCH_GESTURE
+        MTOUCH_Service_Mainloop();
+
+        // Tap toggles the LED, long-press turns it off
+        while(MTOUCH_Gesture_Get(&gesture))
+        {
+            if(gesture.type == MTOUCH_GESTURE_tap)
+                LED_Toggle();
+            else if(gesture.type == MTOUCH_GESTURE_longPress)
+                LED_SetLow();
+        }
+#else
         if(MTOUCH_Service_Mainloop())
         {
             if(MTOUCH_Button_isPressed(Button0))
                 LED_SetHigh();
             else
                 LED_SetLow();
-         }
+        }
+#endif
+
+        // Sleeps between the slow background scans once the keys are idle
+        MTOUCH_LowPower_Sleep();
 
     }
 }
@@ -54,6 +54,7 @@ void SYSTEM_Initialize(void)
     OSCILLATOR_Initialize();
     WDT_Initialize();
     TMR2_Initialize();
+    TMR0_Initialize();
     MTOUCH_Initialize();
 }
 
@@ -52,6 +52,7 @@
 #include <stdbool.h>
 #include "interrupt_manager.h"
 #include "tmr2.h"
+#include "tmr0.h"
 #include "mtouch/mtouch.h"
 
 #define _XTAL_FREQ  32000000
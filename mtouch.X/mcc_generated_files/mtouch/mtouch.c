@@ -38,7 +38,26 @@
 #include <stdint.h>
 
 #include "mtouch.h"
-#include "../mcc.h"
+#include "mcc.h"
+
+#if MTOUCH_GESTURE
+#define MTOUCH_TICK_CYCLES_PER_MS       ((uint16_t)(_XTAL_FREQ/4000))
+
+static uint32_t                 tick_cycles;           /* instruction cycles not yet counted as a ms */
+#endif
+
+#ifdef MTOUCH_LOWPOWER
+#define MTOUCH_LOWPOWER_SLEEP_CYCLES    ((uint32_t)(_XTAL_FREQ/4000)*MTOUCH_LOWPOWER_SLEEP_MS)
+
+static void MTOUCH_LowPower_Update(void);
+
+static bool                     lowpower_active;
+static bool                     lowpower_slept;         /* since the last low-power round */
+static bool                     lowpower_measuring;
+static uint16_t                 lowpower_idle;
+static uint8_t                  lowpower_rounds;
+static mtouch_lowpower_stats_t  lowpower_stats;
+#endif
 
 /*
  * =======================================================================
@@ -50,6 +69,10 @@ void MTOUCH_Initialize(void)
 {   
     MTOUCH_Sensor_InitializeAll();
     MTOUCH_Button_InitializeAll();
+    MTOUCH_Slider_InitializeAll();
+    MTOUCH_Gesture_Initialize();
+    MTOUCH_Proximity_Initialize();
+    MTOUCH_Telemetry_Initialize();
     MTOUCH_Sensor_Sampled_ResetAll();
     MTOUCH_Sensor_Scan_Initialize();
 }
@@ -59,14 +82,26 @@ void MTOUCH_Initialize(void)
  * MTOUCH_Service_Mainloop()
  * =======================================================================
  *  Root mainloop service routine for all enabled mTouch library modules.
+ *  Does not wait for the acquisition. Returns true when a new sample of
+ *  every enabled sensor has been processed.
  */
 bool MTOUCH_Service_Mainloop(void)
 {
+#ifdef MTOUCH_LOWPOWER
+    if(lowpower_active && !lowpower_slept && MTOUCH_Sensor_isIdle())
+        return false;                       /* the next low-power round waits for MTOUCH_LowPower_Sleep() */
+#endif
     if(MTOUCH_Sensor_SampleAll() == false)     
         return false;           
     MTOUCH_Button_ServiceAll();             /* Execute state machine for all buttons w/scanned sensors */
+    MTOUCH_Slider_ServiceAll();             /* Decode slider positions from the button deviations */
+    MTOUCH_Proximity_Service();             /* Long integration of the proximity sensor */
+    MTOUCH_Telemetry_Service();             /* Queue this round's records for the TX interrupt */
     MTOUCH_Sensor_Sampled_ResetAll();  
     MTOUCH_Tick();
+#ifdef MTOUCH_LOWPOWER
+    MTOUCH_LowPower_Update();
+#endif
     return true;
 }
 
@@ -77,5 +112,136 @@ bool MTOUCH_Service_Mainloop(void)
  */
 void MTOUCH_Tick(void)
 {
+#if MTOUCH_GESTURE
+    uint16_t elapsed_ms = 0;
+#endif
+
     MTOUCH_Button_Tick();
+
+#if MTOUCH_GESTURE
+    /* Rounds run back to back, so the round length is the time base;
+     * only the gesture timeouts count in ms */
+    tick_cycles += MTOUCH_Sensor_RoundCycles_Get();
+    while(tick_cycles >= MTOUCH_TICK_CYCLES_PER_MS)
+    {
+        tick_cycles -= MTOUCH_TICK_CYCLES_PER_MS;
+        elapsed_ms++;
+    }
+    MTOUCH_Gesture_Tick(elapsed_ms);
+#endif
+}
+
+#ifdef MTOUCH_LOWPOWER
+/*
+ * =======================================================================
+ * MTOUCH_LowPower_Update
+ * =======================================================================
+ *  Called after every processed round. Switches between full-rate and
+ *  low-power scanning and keeps the instrumentation counters.
+ */
+static void MTOUCH_LowPower_Update(void)
+{
+    enum mtouch_button_names    button;
+    bool                        touched = false;
+    bool                        pressed = false;
+
+    MTOUCH_BUTTON_FOREACH(button)
+    {
+        if(MTOUCH_Button_isPressed(button))
+            pressed = true;
+        if(MTOUCH_Button_isInitialized(button) && MTOUCH_Button_Deviation_Get(button) > MTOUCH_LOWPOWER_WAKE_THRESHOLD)
+            touched = true;
+    }
+    if(MTOUCH_Proximity_isNear())
+        touched = true;                     /* a hand approaching wakes the keys before they are touched */
+
+    if(lowpower_active)
+    {
+        lowpower_slept = false;
+        lowpower_stats.scan_cycles += MTOUCH_Sensor_RoundCycles_Get();
+        if(touched || pressed)
+        {
+            lowpower_active = false;
+            MTOUCH_Sensor_LowPower_Set(false);
+            lowpower_idle = 0;
+            lowpower_rounds = 0;
+            lowpower_measuring = true;
+            lowpower_stats.wakeups++;
+        }
+        return;
+    }
+
+    if(lowpower_measuring)
+    {
+        if(lowpower_rounds < UINT8_MAX)
+            lowpower_rounds++;
+        if(pressed)
+        {
+            lowpower_stats.wake_latency = lowpower_rounds;
+            lowpower_measuring = false;
+        }
+    }
+
+    if(touched || pressed)
+    {
+        lowpower_idle = 0;
+    }
+    else if(++lowpower_idle >= MTOUCH_LOWPOWER_IDLE_ROUNDS)
+    {
+        lowpower_active = true;
+        lowpower_slept = false;
+        lowpower_measuring = false;
+        MTOUCH_Sensor_LowPower_Set(true);
+    }
+}
+
+/*
+ * =======================================================================
+ * MTOUCH_LowPower_Sleep
+ * =======================================================================
+ *  Sleeps one watchdog period when in low-power mode and no round is
+ *  running or waiting to be processed. Returns at once otherwise, and
+ *  while telemetry is still going out; the next low-power round is only
+ *  started once the device has slept, so the stream cannot keep it awake.
+ */
+void MTOUCH_LowPower_Sleep(void)
+{
+    if(!lowpower_active || !MTOUCH_Sensor_isIdle() || MTOUCH_Telemetry_isBusy())
+        return;
+
+    ADCON0 = (uint8_t)0;                            /* ADC off, the next round sets it up again */
+    WDTCON = MTOUCH_LOWPOWER_WDTCON;
+    CLRWDT();
+    SLEEP();
+    NOP();
+    WDT_Initialize();                               /* software watchdog off again */
+    lowpower_stats.sleeps++;
+    lowpower_slept = true;
+    MTOUCH_Gesture_Tick((uint16_t)MTOUCH_LOWPOWER_SLEEP_MS);
+}
+
+bool MTOUCH_LowPower_isActive(void)
+{
+    return lowpower_active;
+}
+
+const mtouch_lowpower_stats_t* MTOUCH_LowPower_Stats_Get(void)
+{
+    return &lowpower_stats;
+}
+
+/*
+ *  Low-power scan duty cycle in 1/1000. Sleep time is taken as the
+ *  nominal watchdog period. Worked in units of 1024 cycles so the sum
+ *  does not overflow; the counters themselves wrap after many hours.
+ */
+uint16_t MTOUCH_LowPower_DutyCycle_Get(void)
+{
+    uint32_t scan  = lowpower_stats.scan_cycles >> 10;
+    uint32_t total = lowpower_stats.sleeps * (MTOUCH_LOWPOWER_SLEEP_CYCLES >> 10) + scan;
+
+    if(total == (uint32_t)0)
+        return 0;
+    return (uint16_t)((scan * 1000) / total);
 }
+#endif
@@ -40,6 +40,10 @@
 #include <stdbool.h>
 #include "mtouch_sensor.h"
 #include "mtouch_button.h"
+#include "mtouch_slider.h"
+#include "mtouch_gesture.h"
+#include "mtouch_proximity.h"
+#include "mtouch_telemetry.h"
 
 #if (__XC8_VERSION < 1420)
     #error  Please update XC8 compiler to version 1.42 or higher. 
@@ -54,6 +58,53 @@
     bool    MTOUCH_Service_Mainloop         (void);
     void    MTOUCH_Tick                     (void);
 
+/*
+ * =======================================================================
+ * mTouch Library :: Low Power Mode
+ * =======================================================================
+ * After MTOUCH_LOWPOWER_IDLE_ROUNDS rounds without a button deviation
+ * above MTOUCH_LOWPOWER_WAKE_THRESHOLD the library scans one short round
+ * per watchdog period and sleeps in between. A deviation above the wake
+ * threshold, or proximity reporting near, returns it to full-rate
+ * scanning.
+ *
+ * Build with MTOUCH_LOWPOWER defined to turn it on; without it the
+ * keys are always scanned at full rate and the calls below fold away.
+ * Call MTOUCH_LowPower_Sleep() at the end of the application mainloop.
+ * It only sleeps while the library is in low-power mode and idle, and
+ * no telemetry is still going out.
+ * The watchdog must be software controlled (WDTE = SWDTEN).
+ */
+    #define MTOUCH_LOWPOWER_WAKE_THRESHOLD  (mtouch_button_deviation_t)50
+#if MTOUCH_SENSOR_SEQUENTIAL
+    #define MTOUCH_LOWPOWER_IDLE_ROUNDS     (uint16_t)(1000*MTOUCH_SENSORS)    /* a round is one sensor's packet */
+#else
+    #define MTOUCH_LOWPOWER_IDLE_ROUNDS     (uint16_t)1000
+#endif
+    #define MTOUCH_LOWPOWER_WDTCON          (uint8_t)( 0x07<<1 | 0x1 )      /* WDTPS 1:4096 (128 ms), SWDTEN on */
+    #define MTOUCH_LOWPOWER_SLEEP_MS        (uint32_t)128
+
+    typedef struct
+    {
+        uint32_t    sleeps;             /* watchdog wake-ups */
+        uint32_t    scan_cycles;        /* instruction cycles scanning in low-power mode */
+        uint16_t    wakeups;            /* promotions to full-rate scanning */
+        uint8_t     wake_latency;       /* full-rate rounds from the last promotion to a press */
+    } mtouch_lowpower_stats_t;
+
+#ifdef MTOUCH_LOWPOWER
+    void                            MTOUCH_LowPower_Sleep           (void);
+    bool                            MTOUCH_LowPower_isActive        (void);
+    const mtouch_lowpower_stats_t*  MTOUCH_LowPower_Stats_Get       (void);
+    uint16_t                        MTOUCH_LowPower_DutyCycle_Get   (void);
+#else
+    /* Low power off in this build, the calls fold away; there are no stats */
+    #define MTOUCH_LowPower_Sleep()
+    #define MTOUCH_LowPower_isActive()      (false)
+    #define MTOUCH_LowPower_Stats_Get()     ((const mtouch_lowpower_stats_t*)0)
+    #define MTOUCH_LowPower_DutyCycle_Get() ((uint16_t)0)
+#endif
+
 /*
  * =======================================================================
  * mTouch Library :: State API
@@ -73,6 +124,22 @@
  *
  *          Use the appropriate API in your application:
  *          bool MTOUCH_Button_isPressed     (enum mtouch_button_names    button);
+ *
+ *  Sliders and wheels are polled the same way:
+ *          bool                     MTOUCH_Slider_isActive    (enum mtouch_slider_names slider);
+ *          mtouch_slider_position_t MTOUCH_Slider_Position_Get(enum mtouch_slider_names slider);
+ *
+ *  The gesture layer owns the two button callbacks. Taps, long-presses
+ *  and swipes are read from its event queue instead:
+ *          bool MTOUCH_Gesture_Get          (mtouch_gesture_event_t* event);
+ *
+ *  Proximity reports a graded level before the touch and a near flag:
+ *          mtouch_proximity_level_t MTOUCH_Proximity_Level_Get(void);
+ *          bool                     MTOUCH_Proximity_isNear   (void);
+ *
+ *  Builds with MTOUCH_TELEMETRY defined stream every button's raw
+ *  sample, baseline, deviation, noise and state to the TX pin, see
+ *  mtouch_telemetry.h for the record format.
  */
 
  /*
@@ -36,7 +36,6 @@
 #include <xc.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <string.h>
 
 #include "mtouch.h"
 #include "mtouch_button.h"
@@ -56,32 +55,124 @@ enum mtouch_button_state
  */
     typedef struct
     {
-        const enum mtouch_button_names          name;
-        const enum mtouch_sensor_names          sensor;
               enum mtouch_button_state          state;
+#if !MTOUCH_BUTTON_COMPACT
               mtouch_button_reading_t           reading;
+#endif
               mtouch_button_baseline_t          baseline;
+#if !MTOUCH_BUTTON_COMPACT
               mtouch_button_deviation_t         deviation;
+#endif
               mtouch_button_statecounter_t      counter;
+#if !MTOUCH_BUTTON_COMPACT
               mtouch_button_baselinecounter_t   baseline_count;
               mtouch_button_deviation_t         threshold;
               mtouch_button_scaling_t           scaling;
+#endif
     } mtouch_button_t;
 
-    const  mtouch_button_t mtouch_button_init[MTOUCH_BUTTONS] =
+    /* Fixed part of the configuration, kept in program memory */
+    typedef struct
     {
-        /* Button0 */
-        {   Button0, 
-            Sensor_AN5,
-            MTOUCH_BUTTON_STATE_initializing,
-            0,0,0,0,0, /* non-const variables */
-            (mtouch_button_deviation_t)MTOUCH_BUTTON_THRESHOLD_Button0, /* threshold */
-            (mtouch_button_scaling_t)MTOUCH_BUTTON_SCALING_Button0 /* scaling */
+        const enum mtouch_sensor_names          sensor;
+        const mtouch_button_deviation_t         threshold;
+        const mtouch_button_scaling_t           scaling;
+    } mtouch_button_config_t;
+
+    #define MTOUCH_BUTTON_CONFIG(n, sensor_name)                                \
+        {   sensor_name,                                                        \
+            (mtouch_button_deviation_t)MTOUCH_BUTTON_THRESHOLD_Button##n,       \
+            (mtouch_button_scaling_t)MTOUCH_BUTTON_SCALING_Button##n            \
         }
+
+    const  mtouch_button_config_t mtouch_button_config[MTOUCH_BUTTONS] =
+    {
+        MTOUCH_BUTTON_CONFIG(0, MTOUCH_BUTTON_SENSOR_Button0)
+#if MTOUCH_BUTTONS > 1
+       ,MTOUCH_BUTTON_CONFIG(1, MTOUCH_BUTTON_SENSOR_Button1)
+#endif
+#if MTOUCH_BUTTONS > 2
+       ,MTOUCH_BUTTON_CONFIG(2, MTOUCH_BUTTON_SENSOR_Button2)
+#endif
+#if MTOUCH_BUTTONS > 3
+       ,MTOUCH_BUTTON_CONFIG(3, MTOUCH_BUTTON_SENSOR_Button3)
+#endif
+#if MTOUCH_BUTTONS > 4
+       ,MTOUCH_BUTTON_CONFIG(4, MTOUCH_BUTTON_SENSOR_Button4)
+#endif
+#if MTOUCH_BUTTONS > 5
+       ,MTOUCH_BUTTON_CONFIG(5, MTOUCH_BUTTON_SENSOR_Button5)
+#endif
+#if MTOUCH_BUTTONS > 6
+       ,MTOUCH_BUTTON_CONFIG(6, MTOUCH_BUTTON_SENSOR_Button6)
+#endif
+#if MTOUCH_BUTTONS > 7
+       ,MTOUCH_BUTTON_CONFIG(7, MTOUCH_BUTTON_SENSOR_Button7)
+#endif
+#if MTOUCH_BUTTONS > 8
+       ,MTOUCH_BUTTON_CONFIG(8, MTOUCH_BUTTON_SENSOR_Button8)
+#endif
+#if MTOUCH_BUTTONS > 9
+       ,MTOUCH_BUTTON_CONFIG(9, MTOUCH_BUTTON_SENSOR_Button9)
+#endif
+#if MTOUCH_BUTTONS > 10
+       ,MTOUCH_BUTTON_CONFIG(10, MTOUCH_BUTTON_SENSOR_Button10)
+#endif
+#if MTOUCH_BUTTONS > 11
+       ,MTOUCH_BUTTON_CONFIG(11, MTOUCH_BUTTON_SENSOR_Button11)
+#endif
+#if MTOUCH_BUTTONS > 12
+       ,MTOUCH_BUTTON_CONFIG(12, MTOUCH_BUTTON_SENSOR_Button12)
+#endif
+#if MTOUCH_BUTTONS > 13
+       ,MTOUCH_BUTTON_CONFIG(13, MTOUCH_BUTTON_SENSOR_Button13)
+#endif
+#if MTOUCH_BUTTONS > 14
+       ,MTOUCH_BUTTON_CONFIG(14, MTOUCH_BUTTON_SENSOR_Button14)
+#endif
+#if MTOUCH_BUTTONS > 15
+       ,MTOUCH_BUTTON_CONFIG(15, MTOUCH_BUTTON_SENSOR_Button15)
+#endif
     };
     
     static mtouch_button_t mtouch_button[MTOUCH_BUTTONS];
 
+#if MTOUCH_BUTTONS == 1
+    #define Button_Name(button)     Button0
+#else
+    #define Button_Name(button)     ((enum mtouch_button_names)((button) - mtouch_button))
+#endif
+    #define Button_Sensor(button)   (mtouch_button_config[Button_Name(button)].sensor)
+
+#if MTOUCH_BUTTON_COMPACT
+    /* Shared by all buttons, see MTOUCH_BUTTON_COMPACT */
+    static mtouch_button_deviation_t        button_deviation;       /* the last one worked out, of the button being serviced */
+    static mtouch_button_baselinecounter_t  button_baseline_count;
+
+    #define Button_Reading(button)          MTOUCH_Sensor_RawSample_Get(Button_Sensor(button))
+    #define Button_Deviation(button)        button_deviation
+    #define Button_BaselineCount(button)    button_baseline_count
+    #define Button_Threshold(button)        (mtouch_button_config[Button_Name(button)].threshold)
+    #define Button_Scaling(button)          (mtouch_button_config[Button_Name(button)].scaling)
+#else
+    #define Button_Reading(button)          ((button)->reading)
+    #define Button_Deviation(button)        ((button)->deviation)
+    #define Button_BaselineCount(button)    ((button)->baseline_count)
+    #define Button_Threshold(button)        ((button)->threshold)
+    #define Button_Scaling(button)          ((button)->scaling)
+#endif
+
+#if MTOUCH_SLIDERS > 0
+    /* Buttons under an active slider, see MTOUCH_Button_Baseline_Hold */
+    static mtouch_buttonmask_t  baseline_hold;
+#endif
+
+#if MTOUCH_BUTTON_RECOVERY
+    /* Baseline drift of the released buttons in the current ServiceAll pass */
+    static int32_t  baseline_drift;
+    static uint8_t  baseline_drift_count;
+#endif
+
 /*
  * =======================================================================
  *  Local Functions
@@ -89,11 +180,20 @@ enum mtouch_button_state
  */
 static void                     Button_Service              (enum mtouch_button_names name);  
 static void                     Button_Deviation_Update     (mtouch_button_t* button);
+#if !MTOUCH_BUTTON_COMPACT
 static void                     Button_Reading_Update       (mtouch_button_t* button);
+#endif
 static void                     Button_Baseline_Initialize  (mtouch_button_t* button);
-static void                     Button_Baseline_Update      (mtouch_button_t* button);
+static int32_t                  Button_Baseline_Update      (mtouch_button_t* button);
+static void                     Button_Baseline_Reset       (mtouch_button_t* button);
+#if MTOUCH_BUTTON_RECOVERY
+static void                     Button_Baseline_Negative    (mtouch_button_t* button);
+static void                     Button_Baseline_Drift       (void);
+#endif
 static mtouch_button_reading_t  Button_Baseline_Get_helper  (enum mtouch_button_names button);
+#if MTOUCH_BUTTON_RECOVERY && !MTOUCH_BUTTON_COMPACT
 static void                     Button_Tick_helper          (mtouch_button_t* button);
+#endif
 static void                     Button_DefaultCallback      (enum mtouch_button_names button);
 
 static void                     Button_State_Initializing   (mtouch_button_t* button);
@@ -113,7 +213,7 @@ static void (*callback_notPressed)(enum mtouch_button_names) = Button_DefaultCal
  * =======================================================================
  */
 typedef void (*button_statemachine_state_t)(mtouch_button_t*);
-button_statemachine_state_t Button_StateMachine[] = 
+const button_statemachine_state_t Button_StateMachine[] = 
 {
     Button_State_Initializing,
     Button_State_NotPressed,
@@ -133,19 +233,21 @@ void MTOUCH_Button_Initialize(enum mtouch_button_names name)
     button->state           = MTOUCH_BUTTON_STATE_initializing;
     button->baseline        = (mtouch_button_baseline_t)0;
     button->counter         = (mtouch_button_statecounter_t)0;
-    button->baseline_count  = (mtouch_button_baselinecounter_t)0;
+    Button_BaselineCount(button) = (mtouch_button_baselinecounter_t)0;
     
-    MTOUCH_Sensor_Calibrate(button->sensor);
+    MTOUCH_Sensor_Calibrate(mtouch_button_config[name].sensor);
 }
 
 void MTOUCH_Button_InitializeAll(void)
 {
     enum mtouch_button_names button;
     
-    memcpy(mtouch_button,mtouch_button_init,sizeof(mtouch_button_init));
-    
-    for (button = 0; button < MTOUCH_BUTTONS; button++)
+    MTOUCH_BUTTON_FOREACH(button)
     {
+#if !MTOUCH_BUTTON_COMPACT
+        mtouch_button[button].threshold = mtouch_button_config[button].threshold;
+        mtouch_button[button].scaling   = mtouch_button_config[button].scaling;
+#endif
         MTOUCH_Button_Initialize(button);
     }
 }
@@ -159,24 +261,35 @@ void MTOUCH_Button_InitializeAll(void)
  void MTOUCH_Button_ServiceAll(void)
 {
     enum mtouch_button_names button; 
-    for (button = 0; button < MTOUCH_BUTTONS; button++)
+
+#if MTOUCH_BUTTON_RECOVERY
+    baseline_drift       = 0;
+    baseline_drift_count = 0;
+#endif
+    MTOUCH_BUTTON_FOREACH(button)
     {  
         Button_Service(button);
     }
+#if MTOUCH_BUTTON_RECOVERY
+    Button_Baseline_Drift();
+#endif
 }
  
 static void Button_Service(enum mtouch_button_names name)
 {
     mtouch_button_t* button = &mtouch_button[name];
+    enum mtouch_sensor_names sensor = mtouch_button_config[name].sensor;
     
-    if (MTOUCH_Sensor_wasSampled(button->sensor) && MTOUCH_Sensor_isCalibrated(button->sensor))
+    if (MTOUCH_Sensor_wasSampled(sensor) && MTOUCH_Sensor_isCalibrated(sensor))
     {
+#if !MTOUCH_BUTTON_COMPACT
         Button_Reading_Update(button);
+#endif
         Button_Deviation_Update(button);
 
         if (button->state >= BUTTON_STATEMACHINE_COUNT)
         {
-            MTOUCH_Button_Initialize(button->name);
+            MTOUCH_Button_Initialize(name);
         }
         Button_StateMachine[button->state](button);
     }
@@ -196,29 +309,39 @@ static void Button_State_Initializing(mtouch_button_t* button)
     (button->counter)++;
     if ((button->counter) >= (mtouch_button_statecounter_t)MTOUCH_BUTTON_BASELINE_INIT)
     {
+#if !MTOUCH_BUTTON_COMPACT
         button->reading = (mtouch_button_reading_t)((button->baseline)>>MTOUCH_BUTTON_BASELINE_GAIN);
+#endif
         button->state   = MTOUCH_BUTTON_STATE_notPressed;
         button->counter = (mtouch_button_statecounter_t)0;
     }
 }
 static void Button_State_NotPressed(mtouch_button_t* button)
 {
-    /* Negative Capacitance check */
-    if ((button->deviation) < (mtouch_button_deviation_t)MTOUCH_BUTTON_NEGATIVETHRESHOLD)
+#if MTOUCH_BUTTON_RECOVERY
+    baseline_drift_count++;
+#endif
+
+    /* Negative Capacitance check: follow the reading down quickly */
+    if (Button_Deviation(button) < (mtouch_button_deviation_t)MTOUCH_BUTTON_NEGATIVETHRESHOLD)
     {
+#if MTOUCH_BUTTON_RECOVERY
+        Button_Baseline_Negative(button);
+#endif
         (button->counter)++;
         if ((button->counter) > (mtouch_button_statecounter_t)MTOUCH_BUTTON_NEGATIVEDEVIATION)
         {
             button->counter = (mtouch_button_statecounter_t)0;
-            MTOUCH_Button_Initialize(button->name);
+            Button_Baseline_Reset(button);
         }
+        return;
     }
     /* Threshold check */
-    else if ((button->deviation) > (button->threshold))
+    else if (Button_Deviation(button) > Button_Threshold(button))
     {
         button->state   = MTOUCH_BUTTON_STATE_pressed;
         button->counter = (mtouch_button_statecounter_t)0;
-        callback_pressed(button->name);
+        callback_pressed(Button_Name(button));
     }
     else
     {
@@ -226,32 +349,51 @@ static void Button_State_NotPressed(mtouch_button_t* button)
         button->counter = (mtouch_button_statecounter_t)0;
     }
     
-    /* Baseline Update check */
-    (button->baseline_count)++;
-    if ((button->baseline_count) > MTOUCH_BUTTON_BASELINE_RATE)
+#if MTOUCH_SLIDERS > 0
+    if (baseline_hold & ((mtouch_buttonmask_t)0x01 << Button_Name(button)))
     {
-        button->baseline_count = (mtouch_button_baselinecounter_t)0;
+        return;
+    }
+#endif
+    /* Baseline Update check: slow positive tracking */
+    Button_BaselineCount(button)++;
+    if (Button_BaselineCount(button) > MTOUCH_BUTTON_BASELINE_RATE)
+    {
+        Button_BaselineCount(button) = (mtouch_button_baselinecounter_t)0;
+#if MTOUCH_BUTTON_RECOVERY
+        baseline_drift += Button_Baseline_Update(button);
+#else
         Button_Baseline_Update(button);
+#endif
     }
 }
 static void Button_State_Pressed(mtouch_button_t* button)
 {
-    /* Timeout check */
+#if MTOUCH_BUTTON_RECOVERY
+#if MTOUCH_BUTTON_COMPACT
+    (button->counter)++;                /* no tick, the button's own packets */
+#endif
+    /* Timeout check: take the stuck reading as the new baseline */
     if ((button->counter) >= MTOUCH_BUTTON_PRESSTIMEOUT)
     {
-        MTOUCH_Button_Initialize(button->name);
-        callback_notPressed(button->name);
+        Button_Baseline_Reset(button);
+        button->state   = MTOUCH_BUTTON_STATE_notPressed;
+        button->counter = (mtouch_button_statecounter_t)0;
+        callback_notPressed(Button_Name(button));
+        return;
     }
+#endif
     
     /* Threshold check */
-    else if ((button->deviation) < (mtouch_button_deviation_t)((button->threshold) >> 1))
+    if (Button_Deviation(button) < (mtouch_button_deviation_t)(Button_Threshold(button) >> 1))
     {
         button->state   = MTOUCH_BUTTON_STATE_notPressed;
         button->counter = (mtouch_button_statecounter_t)0;
-        callback_notPressed(button->name);
+        callback_notPressed(Button_Name(button));
     }
 }
 
+#if MTOUCH_BUTTON_RECOVERY && !MTOUCH_BUTTON_COMPACT
 /*
  * =======================================================================
  *  MTOUCH_Button_Tick
@@ -259,7 +401,11 @@ static void Button_State_Pressed(mtouch_button_t* button)
  */
 void MTOUCH_Button_Tick(void)
 {
-    Button_Tick_helper(&mtouch_button[0]);
+    enum mtouch_button_names button;
+    MTOUCH_BUTTON_FOREACH(button)
+    {
+        Button_Tick_helper(&mtouch_button[button]);
+    }
 }
 static void Button_Tick_helper(mtouch_button_t* button)
 {
@@ -273,6 +419,7 @@ static void Button_Tick_helper(mtouch_button_t* button)
         }
     }
 }
+#endif
 
 /*
  * =======================================================================
@@ -280,43 +427,55 @@ static void Button_Tick_helper(mtouch_button_t* button)
  * =======================================================================
  */
 
+enum mtouch_sensor_names MTOUCH_Button_Sensor_Get(enum mtouch_button_names name)
+{
+    if(MTOUCH_BUTTON_ISVALID(name))
+        return mtouch_button_config[name].sensor;
+    else
+        return (enum mtouch_sensor_names)0;
+}
+
 mtouch_button_threshold_t MTOUCH_Button_Threshold_Get(enum mtouch_button_names name)
 {
-    if(name < MTOUCH_BUTTONS)
-        return mtouch_button[name].threshold;
+    if(MTOUCH_BUTTON_ISVALID(name))
+        return Button_Threshold(&mtouch_button[name]);
     else
         return (mtouch_button_threshold_t)0;
 }
 
+#if !MTOUCH_BUTTON_COMPACT
 void MTOUCH_Button_Threshold_Set(enum mtouch_button_names name,mtouch_button_threshold_t threshold)
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
     {
         if(threshold >= MTOUCH_BUTTON_THRESHOLD_MIN && threshold <= MTOUCH_BUTTON_THRESHOLD_MAX)
             mtouch_button[name].threshold = threshold;
     }
 }
+#endif
 
 mtouch_button_scaling_t MTOUCH_Button_Scaling_Get(enum mtouch_button_names name)
 {
-    if(name < MTOUCH_BUTTONS)
-        return mtouch_button[name].scaling;
+    if(MTOUCH_BUTTON_ISVALID(name))
+        return Button_Scaling(&mtouch_button[name]);
     else
         return (mtouch_button_scaling_t)0;
 }
 
+#if !MTOUCH_BUTTON_COMPACT
 void MTOUCH_Button_Scaling_Set(enum mtouch_button_names name,mtouch_button_scaling_t scaling)
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
     {
         if(scaling <= MTOUCH_BUTTON_SCALING_MAX)
             mtouch_button[name].scaling = scaling;
     }
 }
+#endif
 
 bool MTOUCH_Button_isPressed(enum mtouch_button_names name)
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
         return (mtouch_button[name].state == MTOUCH_BUTTON_STATE_pressed) ? true : false;
     else
         return false;
@@ -324,7 +483,7 @@ bool MTOUCH_Button_isPressed(enum mtouch_button_names name)
 
 bool MTOUCH_Button_isInitialized(enum mtouch_button_names name)
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
         return (mtouch_button[name].state == MTOUCH_BUTTON_STATE_initializing) ? false : true;
     else
         return false;
@@ -332,8 +491,15 @@ bool MTOUCH_Button_isInitialized(enum mtouch_button_names name)
 
 mtouch_button_deviation_t MTOUCH_Button_Deviation_Get(enum mtouch_button_names name) /* Global */
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
+#if MTOUCH_BUTTON_COMPACT
+    {
+        Button_Deviation_Update(&mtouch_button[name]);
+        return button_deviation;
+    }
+#else
         return mtouch_button[name].deviation;
+#endif
     else
         return (mtouch_button_deviation_t)0;
 }
@@ -342,10 +508,10 @@ static void Button_Deviation_Update(mtouch_button_t* button)
 {
     int32_t deviation;
     
-    deviation = (int32_t)((int32_t)(button->reading) - (int32_t)((button->baseline)>>MTOUCH_BUTTON_BASELINE_GAIN));
+    deviation = (int32_t)((int32_t)Button_Reading(button) - (int32_t)((button->baseline)>>MTOUCH_BUTTON_BASELINE_GAIN));
 
     /* Delta scaling */
-    deviation = deviation >> (button->scaling); /* XC8 compiler will extend sign bit of signed values */
+    deviation = deviation >> Button_Scaling(button); /* XC8 compiler will extend sign bit of signed values */
 
     /* Bounds checking */
     if (deviation > MTOUCH_BUTTON_DEVIATION_MAX)
@@ -357,18 +523,38 @@ static void Button_Deviation_Update(mtouch_button_t* button)
         deviation = MTOUCH_BUTTON_DEVIATION_MIN;
     }
 
-    button->deviation = (mtouch_button_deviation_t)deviation;
+    Button_Deviation(button) = (mtouch_button_deviation_t)deviation;
+}
+
+#if MTOUCH_SLIDERS > 0
+/*
+ *  A finger between two slider buttons can leave both below their
+ *  threshold, and the slow positive tracking would then take it into
+ *  their baselines within a second. The slider holds its buttons'
+ *  baselines while it is active; negative tracking still runs.
+ */
+void MTOUCH_Button_Baseline_Hold(enum mtouch_button_names name, bool hold)
+{
+    if (!MTOUCH_BUTTON_ISVALID(name))
+        return;
+
+    if (hold)
+        baseline_hold |=  ((mtouch_buttonmask_t)0x01 << name);
+    else
+        baseline_hold &= ~((mtouch_buttonmask_t)0x01 << name);
 }
+#endif
 
 mtouch_buttonmask_t MTOUCH_Button_Buttonmask_Get(void)
 {
-    mtouch_buttonmask_t output = 0;
+    mtouch_buttonmask_t         output = 0;
+    enum mtouch_button_names    button;
 
-    for (uint8_t i = 0; i < MTOUCH_BUTTONS; i++)
+    MTOUCH_BUTTON_FOREACH(button)
     {
-        if (MTOUCH_Button_isPressed(i) == true)
+        if (MTOUCH_Button_isPressed(button) == true)
         {
-            output |= (mtouch_buttonmask_t)0x01 << i;
+            output |= (mtouch_buttonmask_t)0x01 << button;
         }
     }
     return output;
@@ -381,53 +567,120 @@ mtouch_buttonmask_t MTOUCH_Button_Buttonmask_Get(void)
  */
 mtouch_button_reading_t MTOUCH_Button_Reading_Get(enum mtouch_button_names name) /* Global */
 {
-    if(name < MTOUCH_BUTTONS)
-        return mtouch_button[name].reading;
+    if(MTOUCH_BUTTON_ISVALID(name))
+        return Button_Reading(&mtouch_button[name]);
     else
         return (mtouch_button_reading_t)0;
 }
 
+#if !MTOUCH_BUTTON_COMPACT
 static void Button_Reading_Update(mtouch_button_t* button)
 {
     if (GIE == (uint8_t)1)
     {
         GIE = (uint8_t)0;
         button->reading   -= button->reading>>MTOUCH_BUTTON_READING_GAIN;
-        button->reading   += MTOUCH_Sensor_RawSample_Get(button->sensor)>>MTOUCH_BUTTON_READING_GAIN;
+        button->reading   += MTOUCH_Sensor_RawSample_Get(Button_Sensor(button))>>MTOUCH_BUTTON_READING_GAIN;
         GIE = (uint8_t)1;
     }
     else
     {
         button->reading   -= button->reading>>MTOUCH_BUTTON_READING_GAIN;
-        button->reading   += MTOUCH_Sensor_RawSample_Get(button->sensor)>>MTOUCH_BUTTON_READING_GAIN;
+        button->reading   += MTOUCH_Sensor_RawSample_Get(Button_Sensor(button))>>MTOUCH_BUTTON_READING_GAIN;
     }
 }
+#endif
 
+/*
+ *  The reading starts from the same sample, otherwise the fine baseline
+ *  updates that follow average in a reading still rising from zero and
+ *  leave the baseline below the untouched level.
+ */
 static void Button_Baseline_Initialize(mtouch_button_t* button)
 {
-    button->baseline   = MTOUCH_Sensor_RawSample_Get(button->sensor);
+#if !MTOUCH_BUTTON_COMPACT
+    button->reading    = MTOUCH_Sensor_RawSample_Get(Button_Sensor(button));
+#endif
+    button->baseline   = Button_Reading(button);
     button->baseline <<= MTOUCH_BUTTON_BASELINE_GAIN;
 }
 
-static void Button_Baseline_Update(mtouch_button_t* button)
+/* Returns the change in the baseline for the drift compensation */
+static int32_t Button_Baseline_Update(mtouch_button_t* button)
 {
+    mtouch_button_baseline_t previous = button->baseline;
+
     if (GIE == (uint8_t)1)
     {
         GIE = (uint8_t)0;
         button->baseline -= (button->baseline) >> MTOUCH_BUTTON_BASELINE_GAIN;
-        button->baseline += button->reading;
+        button->baseline += Button_Reading(button);
         GIE = (uint8_t)1;
     }
     else
     {
         button->baseline -= (button->baseline) >> MTOUCH_BUTTON_BASELINE_GAIN;
-        button->baseline += button->reading;
+        button->baseline += Button_Reading(button);
+    }
+    return (int32_t)(button->baseline - previous);
+}
+
+#if MTOUCH_BUTTON_RECOVERY
+/*
+ *  Fast negative tracking. The baseline closes a fixed fraction of the
+ *  gap to the reading every packet, so a release after a touch during
+ *  initialization, or a quick environmental step down, recovers in a
+ *  few packets without recalibrating the sensor.
+ */
+static void Button_Baseline_Negative(mtouch_button_t* button)
+{
+    int32_t gap;
+
+    gap  = (int32_t)((mtouch_button_baseline_t)Button_Reading(button) << MTOUCH_BUTTON_BASELINE_GAIN);
+    gap -= (int32_t)(button->baseline);
+    button->baseline += gap >> MTOUCH_BUTTON_BASELINE_NEGATIVE_GAIN; /* XC8 compiler will extend sign bit of signed values */
+    Button_BaselineCount(button) = (mtouch_button_baselinecounter_t)0;
+}
+#endif
+
+static void Button_Baseline_Reset(mtouch_button_t* button)
+{
+    button->baseline       = (mtouch_button_baseline_t)Button_Reading(button) << MTOUCH_BUTTON_BASELINE_GAIN;
+    Button_BaselineCount(button) = (mtouch_button_baselinecounter_t)0;
+    Button_Deviation(button)     = (mtouch_button_deviation_t)0;
+}
+
+#if MTOUCH_BUTTON_RECOVERY
+/*
+ *  Drift compensation. Baselines are frozen while pressed, but humidity
+ *  and temperature keep moving every sensor together. The average slow
+ *  baseline change of the released buttons in this pass is applied to
+ *  the pressed ones, so they do not release early or stick on a drift.
+ */
+static void Button_Baseline_Drift(void)
+{
+    enum mtouch_button_names    button;
+    int32_t                     drift;
+
+    if (baseline_drift_count == 0 || baseline_drift == 0)
+        return;
+
+#if MTOUCH_BUTTON_COMPACT
+    drift = baseline_drift / MTOUCH_BUTTONS;        /* one button a pass, each pressed one sees every pass */
+#else
+    drift = baseline_drift / baseline_drift_count;
+#endif
+    MTOUCH_BUTTON_FOREACH(button)
+    {
+        if (mtouch_button[button].state == MTOUCH_BUTTON_STATE_pressed)
+            mtouch_button[button].baseline += drift;
     }
 }
+#endif
 
 mtouch_button_reading_t MTOUCH_Button_Baseline_Get(enum mtouch_button_names name) /* Global */
 {
-    if(name < MTOUCH_BUTTONS)
+    if(MTOUCH_BUTTON_ISVALID(name))
         return Button_Baseline_Get_helper(name);
     else
         return (mtouch_button_reading_t)0;
@@ -45,34 +45,214 @@
  * Application / Configuration Settings
  * =======================================================================
  */
-    #define MTOUCH_BUTTONS (u_int)1
+    /* 1..MTOUCH_SENSORS; a project may set it, e.g. MTOUCH_BUTTONS=1 */
+    #ifndef MTOUCH_BUTTONS
+    #define MTOUCH_BUTTONS MTOUCH_SENSORS
+    #endif
     
+    #if MTOUCH_BUTTONS > MTOUCH_SENSORS
+        #error MTOUCH_BUTTONS must not be more than MTOUCH_SENSORS
+    #endif
+
+    /* Fast negative tracking, drift compensation and the press timeout,
+     * 0 to only reset the baseline after MTOUCH_BUTTON_NEGATIVEDEVIATION
+     * negative packets and hold a press until the deviation falls; off in
+     * a single-button build, which has no released button to take the
+     * drift from */
+    #ifndef MTOUCH_BUTTON_RECOVERY
+    #define MTOUCH_BUTTON_RECOVERY  (MTOUCH_BUTTONS > 1)
+    #endif
+
+    /* Compact button state, on with sequential acquisition: 6 bytes a
+     * button instead of 13. Threshold and scaling stay in program memory,
+     * so MTOUCH_Button_Threshold_Set()/Scaling_Set() are left out; the
+     * reading is the sensor's raw sample, unfiltered, and the deviation
+     * is worked out when needed; the slow baseline update counts the
+     * released packets of all buttons together, which keeps each
+     * button's rate as its packets come one after another. */
+    #ifndef MTOUCH_BUTTON_COMPACT
+    #define MTOUCH_BUTTON_COMPACT   MTOUCH_SENSOR_SEQUENTIAL
+    #endif
+    #if MTOUCH_BUTTON_COMPACT && !MTOUCH_SENSOR_SEQUENTIAL
+        #error MTOUCH_BUTTON_COMPACT needs MTOUCH_SENSOR_SEQUENTIAL
+    #endif
+
     enum mtouch_button_names
     {
         Button0 = 0
+#if MTOUCH_BUTTONS > 1
+       ,Button1 = 1
+#endif
+#if MTOUCH_BUTTONS > 2
+       ,Button2 = 2
+#endif
+#if MTOUCH_BUTTONS > 3
+       ,Button3 = 3
+#endif
+#if MTOUCH_BUTTONS > 4
+       ,Button4 = 4
+#endif
+#if MTOUCH_BUTTONS > 5
+       ,Button5 = 5
+#endif
+#if MTOUCH_BUTTONS > 6
+       ,Button6 = 6
+#endif
+#if MTOUCH_BUTTONS > 7
+       ,Button7 = 7
+#endif
+#if MTOUCH_BUTTONS > 8
+       ,Button8 = 8
+#endif
+#if MTOUCH_BUTTONS > 9
+       ,Button9 = 9
+#endif
+#if MTOUCH_BUTTONS > 10
+       ,Button10 = 10
+#endif
+#if MTOUCH_BUTTONS > 11
+       ,Button11 = 11
+#endif
+#if MTOUCH_BUTTONS > 12
+       ,Button12 = 12
+#endif
+#if MTOUCH_BUTTONS > 13
+       ,Button13 = 13
+#endif
+#if MTOUCH_BUTTONS > 14
+       ,Button14 = 14
+#endif
+#if MTOUCH_BUTTONS > 15
+       ,Button15 = 15
+#endif
     };
 
+    /* Same folding as MTOUCH_SENSOR_FOREACH for a single-button build */
+#if MTOUCH_BUTTONS == 1
+    #define MTOUCH_BUTTON_FOREACH(button)   (button) = (enum mtouch_button_names)0;
+    #define MTOUCH_BUTTON_ISVALID(button)   (true)
+#else
+    #define MTOUCH_BUTTON_FOREACH(button)   for ((button) = 0; (button) < MTOUCH_BUTTONS; (button)++)
+    #define MTOUCH_BUTTON_ISVALID(button)   ((button) < MTOUCH_BUTTONS)
+#endif
+
+    
+#ifdef MTOUCH_SENSOR_MATRIX
+    /* one button per row/column intersection */
+    #define MTOUCH_BUTTON_SENSOR_Button0 Sensor_R0C0
+    #define MTOUCH_BUTTON_SENSOR_Button1 Sensor_R0C1
+    #define MTOUCH_BUTTON_SENSOR_Button2 Sensor_R0C2
+    #define MTOUCH_BUTTON_SENSOR_Button3 Sensor_R0C3
+    #define MTOUCH_BUTTON_SENSOR_Button4 Sensor_R1C0
+    #define MTOUCH_BUTTON_SENSOR_Button5 Sensor_R1C1
+    #define MTOUCH_BUTTON_SENSOR_Button6 Sensor_R1C2
+    #define MTOUCH_BUTTON_SENSOR_Button7 Sensor_R1C3
+    #define MTOUCH_BUTTON_SENSOR_Button8 Sensor_R2C0
+    #define MTOUCH_BUTTON_SENSOR_Button9 Sensor_R2C1
+    #define MTOUCH_BUTTON_SENSOR_Button10 Sensor_R2C2
+    #define MTOUCH_BUTTON_SENSOR_Button11 Sensor_R2C3
+    #define MTOUCH_BUTTON_SENSOR_Button12 Sensor_R3C0
+    #define MTOUCH_BUTTON_SENSOR_Button13 Sensor_R3C1
+    #define MTOUCH_BUTTON_SENSOR_Button14 Sensor_R3C2
+    #define MTOUCH_BUTTON_SENSOR_Button15 Sensor_R3C3
+#else
+    #define MTOUCH_BUTTON_SENSOR_Button0 Sensor_AN5
+    #define MTOUCH_BUTTON_SENSOR_Button1 Sensor_AN4
+    #define MTOUCH_BUTTON_SENSOR_Button2 Sensor_AN6
+    #define MTOUCH_BUTTON_SENSOR_Button3 Sensor_AN7
+    #define MTOUCH_BUTTON_SENSOR_Button4 Sensor_AN2
+    #define MTOUCH_BUTTON_SENSOR_Button5 Sensor_AN3
+    #define MTOUCH_BUTTON_SENSOR_Button6 Sensor_AN0
+    #define MTOUCH_BUTTON_SENSOR_Button7 Sensor_AN1
+#endif
+    
+#ifdef MTOUCH_SENSOR_MATRIX
+    /* A finger on a key raises the other keys of its column by about a
+     * seventh of its own change; at half the gain they stay well under
+     * the threshold with a noisy ADC, and a 0.45 pF touch still gets
+     * over it */
+    #define MTOUCH_BUTTON_THRESHOLD_Button0 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button1 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button2 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button3 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button4 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button5 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button6 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button7 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button8 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button9 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button10 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button11 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button12 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button13 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button14 60
+    #define MTOUCH_BUTTON_THRESHOLD_Button15 60
     
+    #define MTOUCH_BUTTON_SCALING_Button0 2
+    #define MTOUCH_BUTTON_SCALING_Button1 2
+    #define MTOUCH_BUTTON_SCALING_Button2 2
+    #define MTOUCH_BUTTON_SCALING_Button3 2
+    #define MTOUCH_BUTTON_SCALING_Button4 2
+    #define MTOUCH_BUTTON_SCALING_Button5 2
+    #define MTOUCH_BUTTON_SCALING_Button6 2
+    #define MTOUCH_BUTTON_SCALING_Button7 2
+    #define MTOUCH_BUTTON_SCALING_Button8 2
+    #define MTOUCH_BUTTON_SCALING_Button9 2
+    #define MTOUCH_BUTTON_SCALING_Button10 2
+    #define MTOUCH_BUTTON_SCALING_Button11 2
+    #define MTOUCH_BUTTON_SCALING_Button12 2
+    #define MTOUCH_BUTTON_SCALING_Button13 2
+    #define MTOUCH_BUTTON_SCALING_Button14 2
+    #define MTOUCH_BUTTON_SCALING_Button15 2
+#else
     #define MTOUCH_BUTTON_THRESHOLD_Button0 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button1 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button2 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button3 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button4 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button5 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button6 100
+    #define MTOUCH_BUTTON_THRESHOLD_Button7 100
     
     #define MTOUCH_BUTTON_SCALING_Button0 1
+    #define MTOUCH_BUTTON_SCALING_Button1 1
+    #define MTOUCH_BUTTON_SCALING_Button2 1
+    #define MTOUCH_BUTTON_SCALING_Button3 1
+    #define MTOUCH_BUTTON_SCALING_Button4 1
+    #define MTOUCH_BUTTON_SCALING_Button5 1
+    #define MTOUCH_BUTTON_SCALING_Button6 1
+    #define MTOUCH_BUTTON_SCALING_Button7 1
+#endif
 	
 /*
  * =======================================================================
  * Typedefs / Data Types
  * =======================================================================
  */
+#if MTOUCH_BUTTONS > 8
+    typedef uint16_t mtouch_buttonmask_t;
+#else
     typedef uint8_t mtouch_buttonmask_t;
+#endif
     
+#if MTOUCH_BUTTON_COMPACT
+    /* The press timeout counts the button's own packets, 4.1 s with 16 */
+    typedef uint8_t mtouch_button_statecounter_t;
+    #define MTOUCH_BUTTON_STATECOUNTER_MIN (0)
+    #define MTOUCH_BUTTON_STATECOUNTER_MAX (UINT8_MAX)
+    #define MTOUCH_BUTTON_NEGATIVEDEVIATION ((mtouch_button_statecounter_t)32)
+    #define MTOUCH_BUTTON_PRESSTIMEOUT ((mtouch_button_statecounter_t)250)
+#else
     typedef uint16_t mtouch_button_statecounter_t;
     #define MTOUCH_BUTTON_STATECOUNTER_MIN (0)
     #define MTOUCH_BUTTON_STATECOUNTER_MAX (UINT16_MAX)
     #define MTOUCH_BUTTON_NEGATIVEDEVIATION ((mtouch_button_statecounter_t)32)
     #define MTOUCH_BUTTON_PRESSTIMEOUT ((mtouch_button_statecounter_t)1000)
+#endif
     
-    typedef uint16_t mtouch_button_baselinecounter_t;
+    typedef uint8_t mtouch_button_baselinecounter_t;
     #define MTOUCH_BUTTON_BASECOUNTER_MIN (0)
-    #define MTOUCH_BUTTON_BASECOUNTER_MAX (UINT16_MAX)
+    #define MTOUCH_BUTTON_BASECOUNTER_MAX (UINT8_MAX)
     
     typedef uint16_t mtouch_button_reading_t;
     #define MTOUCH_BUTTON_READING_MIN (0)
@@ -85,6 +265,7 @@
     #define MTOUCH_BUTTON_BASELINE_GAIN ((uint8_t)4)
     #define MTOUCH_BUTTON_BASELINE_INIT ((mtouch_button_statecounter_t)16)
     #define MTOUCH_BUTTON_BASELINE_RATE ((mtouch_button_baselinecounter_t)32)
+    #define MTOUCH_BUTTON_BASELINE_NEGATIVE_GAIN ((uint8_t)2)  /* baseline closes 1/4 of a negative deviation per packet */
     
     typedef int8_t mtouch_button_deviation_t;
     #define MTOUCH_BUTTON_DEVIATION_MIN (INT8_MIN)
@@ -111,15 +292,24 @@
     void                        MTOUCH_Button_Initialize    (enum mtouch_button_names button);
     void                        MTOUCH_Button_InitializeAll (void);
     void                        MTOUCH_Button_ServiceAll    (void);
+#if MTOUCH_BUTTON_RECOVERY && !MTOUCH_BUTTON_COMPACT
     void                        MTOUCH_Button_Tick          (void);
+#else
+    #define MTOUCH_Button_Tick()    /* no press timeout to count, or counted per packet */
+#endif
     
     mtouch_button_deviation_t   MTOUCH_Button_Deviation_Get (enum mtouch_button_names button);
     mtouch_button_reading_t     MTOUCH_Button_Reading_Get   (enum mtouch_button_names button);
     mtouch_button_reading_t     MTOUCH_Button_Baseline_Get  (enum mtouch_button_names button);
+    enum mtouch_sensor_names    MTOUCH_Button_Sensor_Get    (enum mtouch_button_names button);
     mtouch_button_scaling_t     MTOUCH_Button_Scaling_Get   (enum mtouch_button_names button);
-    void                        MTOUCH_Button_Scaling_Set   (enum mtouch_button_names button,mtouch_button_scaling_t scaling);
     mtouch_button_threshold_t   MTOUCH_Button_Threshold_Get (enum mtouch_button_names button);
+#if !MTOUCH_BUTTON_COMPACT
+    void                        MTOUCH_Button_Scaling_Set   (enum mtouch_button_names button,mtouch_button_scaling_t scaling);
     void                        MTOUCH_Button_Threshold_Set (enum mtouch_button_names button,mtouch_button_threshold_t threshold);
+#endif
+    
+    void                        MTOUCH_Button_Baseline_Hold (enum mtouch_button_names button, bool hold);  /* with MTOUCH_SLIDERS */
     
     bool                        MTOUCH_Button_isPressed     (enum mtouch_button_names button);
     bool                        MTOUCH_Button_isInitialized (enum mtouch_button_names button);
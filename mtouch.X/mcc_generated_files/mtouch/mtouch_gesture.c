@@ -0,0 +1,315 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mtouch.h"
+#include "mtouch_gesture.h"
+
+#if MTOUCH_GESTURE
+
+/*
+ * =======================================================================
+ * Gesture Type Structure
+ * =======================================================================
+ *  time is the next long-press/repeat deadline while pressed and the
+ *  double-tap deadline while a tap is pending.
+ */
+    typedef struct
+    {
+              mtouch_gesture_time_t     time;
+              unsigned                  pressed     :1;
+              unsigned                  tap_pending :1;
+              unsigned                  long_sent   :1;
+              unsigned                  consumed    :1;     /* part of a swipe, no tap on release */
+    } mtouch_gesture_t;
+
+    static mtouch_gesture_t         mtouch_gesture[MTOUCH_BUTTONS];
+    static mtouch_gesture_time_t    gesture_now;
+
+#ifdef MTOUCH_GESTURE_SWIPE_BUTTONS
+    static const enum mtouch_button_names gesture_swipe_buttons[] = { MTOUCH_GESTURE_SWIPE_BUTTONS };
+    #define GESTURE_SWIPE_COUNT     (uint8_t)(sizeof(gesture_swipe_buttons)/sizeof(enum mtouch_button_names))
+    #define GESTURE_SWIPE_NONE      (uint8_t)0xFF
+
+    static uint8_t                  swipe_index;        /* last button pressed in the swipe row */
+    static int8_t                   swipe_direction;
+    static uint8_t                  swipe_count;
+    static mtouch_gesture_time_t    swipe_time;
+#endif
+
+    static mtouch_gesture_event_t   gesture_queue[MTOUCH_GESTURE_QUEUE_SIZE];
+    static uint8_t                  gesture_head;
+    static uint8_t                  gesture_tail;
+    static uint8_t                  gesture_dropped;
+
+    #define Gesture_Expired(deadline)   ((int16_t)(gesture_now - (deadline)) >= 0)
+
+#if (MTOUCH_GESTURE_QUEUE_SIZE & (MTOUCH_GESTURE_QUEUE_SIZE - 1)) != 0
+    #error MTOUCH_GESTURE_QUEUE_SIZE must be a power of 2
+#endif
+
+/*
+ * =======================================================================
+ *  Local Functions
+ * =======================================================================
+ */
+static void     Gesture_Pressed         (enum mtouch_button_names button);
+static void     Gesture_NotPressed      (enum mtouch_button_names button);
+#ifdef MTOUCH_GESTURE_SWIPE_BUTTONS
+static void     Gesture_Swipe_Update    (enum mtouch_button_names button);
+#endif
+static void     Gesture_Emit            (enum mtouch_gesture_type type, enum mtouch_button_names button, mtouch_gesture_time_t time);
+
+/*
+ * =======================================================================
+ *  MTOUCH_Gesture_Initialize
+ * =======================================================================
+ */
+void MTOUCH_Gesture_Initialize(void)
+{
+    enum mtouch_button_names button;
+
+    MTOUCH_BUTTON_FOREACH(button)
+    {
+        mtouch_gesture[button].pressed      = 0;
+        mtouch_gesture[button].tap_pending  = 0;
+        mtouch_gesture[button].long_sent    = 0;
+        mtouch_gesture[button].consumed     = 0;
+    }
+#ifdef MTOUCH_GESTURE_SWIPE_BUTTONS
+    swipe_index     = GESTURE_SWIPE_NONE;
+    swipe_count     = 0;
+#endif
+    gesture_head    = 0;
+    gesture_tail    = 0;
+    gesture_dropped = 0;
+
+    MTOUCH_Button_SetPressedCallback(Gesture_Pressed);
+    MTOUCH_Button_SetNotPressedCallback(Gesture_NotPressed);
+}
+
+/*
+ * =======================================================================
+ *  Button callbacks
+ * =======================================================================
+ */
+static void Gesture_Pressed(enum mtouch_button_names button)
+{
+    mtouch_gesture_t* gesture = &mtouch_gesture[button];
+
+    /* A pending tap that ran out before the tick saw it is sent now */
+    if (gesture->tap_pending && Gesture_Expired(gesture->time))
+    {
+        gesture->tap_pending = 0;
+        Gesture_Emit(MTOUCH_GESTURE_tap, button, gesture->time - MTOUCH_GESTURE_DOUBLETAP_MS);
+    }
+
+    gesture->pressed   = 1;
+    gesture->long_sent = 0;
+    gesture->consumed  = 0;
+    gesture->time      = gesture_now + MTOUCH_GESTURE_LONGPRESS_MS;
+
+#ifdef MTOUCH_GESTURE_SWIPE_BUTTONS
+    Gesture_Swipe_Update(button);
+#endif
+}
+
+static void Gesture_NotPressed(enum mtouch_button_names button)
+{
+    mtouch_gesture_t* gesture = &mtouch_gesture[button];
+
+    gesture->pressed = 0;
+    if (gesture->long_sent || gesture->consumed)
+        return;
+
+    if (gesture->tap_pending)
+    {
+        gesture->tap_pending = 0;
+        Gesture_Emit(MTOUCH_GESTURE_doubleTap, button, gesture_now);
+    }
+    else
+    {
+        gesture->tap_pending = 1;
+        gesture->time = gesture_now + MTOUCH_GESTURE_DOUBLETAP_MS;
+    }
+}
+
+#ifdef MTOUCH_GESTURE_SWIPE_BUTTONS
+/*
+ *  Presses of neighbouring buttons in the swipe row, each within
+ *  MTOUCH_GESTURE_SWIPE_MS of the last and in the same direction, make
+ *  a swipe. Buttons that take part do not also report taps.
+ */
+static void Gesture_Swipe_Update(enum mtouch_button_names button)
+{
+    enum mtouch_button_names    previous;
+    uint8_t                     index;
+    int8_t                      direction;
+
+    for (index = 0; index < GESTURE_SWIPE_COUNT; index++)
+    {
+        if (gesture_swipe_buttons[index] == button)
+            break;
+    }
+    if (index >= GESTURE_SWIPE_COUNT)
+        return;
+
+    direction = (int8_t)(index - swipe_index);
+    if (swipe_index != GESTURE_SWIPE_NONE
+        && (uint16_t)(gesture_now - swipe_time) <= MTOUCH_GESTURE_SWIPE_MS
+        && (direction == 1 || direction == -1))
+    {
+        if (swipe_count > 1 && direction != swipe_direction)
+            swipe_count = 1;                        /* turned round, start again from the last button */
+        swipe_direction = direction;
+        swipe_count++;
+
+        previous = gesture_swipe_buttons[swipe_index];
+        mtouch_gesture[previous].tap_pending = 0;
+        mtouch_gesture[previous].consumed    = 1;
+        mtouch_gesture[button].consumed      = 1;
+    }
+    else
+    {
+        swipe_count = 1;
+    }
+    swipe_index = index;
+    swipe_time  = gesture_now;
+
+    if (swipe_count >= MTOUCH_GESTURE_SWIPE_LENGTH)
+    {
+        Gesture_Emit((swipe_direction > 0) ? MTOUCH_GESTURE_swipeForward : MTOUCH_GESTURE_swipeBack,
+                     button, gesture_now);
+        swipe_index = GESTURE_SWIPE_NONE;
+        swipe_count = 0;
+    }
+}
+#endif
+
+/*
+ * =======================================================================
+ *  MTOUCH_Gesture_Tick
+ * =======================================================================
+ *  Advances the clock and sends the events that are due on time alone:
+ *  a tap once the double-tap window has closed, long-press and repeat
+ *  while a button is held.
+ */
+void MTOUCH_Gesture_Tick(uint16_t elapsed_ms)
+{
+    enum mtouch_button_names    button;
+    mtouch_gesture_t*           gesture;
+
+    gesture_now += elapsed_ms;
+
+    MTOUCH_BUTTON_FOREACH(button)
+    {
+        gesture = &mtouch_gesture[button];
+
+        if (gesture->pressed)
+        {
+            if (!gesture->consumed && Gesture_Expired(gesture->time))
+            {
+                if (gesture->long_sent)
+                {
+                    Gesture_Emit(MTOUCH_GESTURE_repeat, button, gesture_now);
+                }
+                else
+                {
+                    if (gesture->tap_pending)       /* tap, then held on the second press */
+                    {
+                        gesture->tap_pending = 0;
+                        Gesture_Emit(MTOUCH_GESTURE_tap, button, gesture_now);
+                    }
+                    gesture->long_sent = 1;
+                    Gesture_Emit(MTOUCH_GESTURE_longPress, button, gesture_now);
+                }
+                gesture->time += MTOUCH_GESTURE_REPEAT_MS;
+            }
+        }
+        else if (gesture->tap_pending && Gesture_Expired(gesture->time))
+        {
+            gesture->tap_pending = 0;
+            Gesture_Emit(MTOUCH_GESTURE_tap, button, gesture->time - MTOUCH_GESTURE_DOUBLETAP_MS);
+        }
+    }
+}
+
+/*
+ * =======================================================================
+ * Event Queue
+ * =======================================================================
+ *  Filled and drained from the mainloop only. When full, new events are
+ *  dropped and counted.
+ */
+static void Gesture_Emit(enum mtouch_gesture_type type, enum mtouch_button_names button, mtouch_gesture_time_t time)
+{
+    mtouch_gesture_event_t* event;
+
+    if ((uint8_t)(gesture_head - gesture_tail) >= MTOUCH_GESTURE_QUEUE_SIZE)
+    {
+        if (gesture_dropped < UINT8_MAX)
+            gesture_dropped++;
+        return;
+    }
+    event = &gesture_queue[gesture_head & (MTOUCH_GESTURE_QUEUE_SIZE - 1)];
+    event->type   = type;
+    event->button = button;
+    event->time   = time;
+    gesture_head++;
+}
+
+bool MTOUCH_Gesture_Get(mtouch_gesture_event_t* event)
+{
+    if (gesture_head == gesture_tail)
+        return false;
+
+    *event = gesture_queue[gesture_tail & (MTOUCH_GESTURE_QUEUE_SIZE - 1)];
+    gesture_tail++;
+    return true;
+}
+
+mtouch_gesture_time_t MTOUCH_Gesture_Time_Get(void)
+{
+    return gesture_now;
+}
+
+uint8_t MTOUCH_Gesture_Dropped_Get(void)
+{
+    return gesture_dropped;
+}
+#endif
@@ -0,0 +1,118 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#ifndef MTOUCH_GESTURE_H
+#define MTOUCH_GESTURE_H
+    
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include "mtouch.h"
+    
+/*
+ * =======================================================================
+ * Application / Configuration Settings
+ * =======================================================================
+ *  The gesture layer takes over the button pressed/notPressed callbacks
+ *  and turns them into timestamped events in a small queue. Drain it
+ *  with MTOUCH_Gesture_Get() from the application mainloop.
+ *
+ *  Times are in milliseconds on the library clock, which MTOUCH_Tick()
+ *  advances by the length of each processed round. A press longer than
+ *  MTOUCH_BUTTON_PRESSTIMEOUT rounds still recalibrates the button, so
+ *  repeat events stop there.
+ */
+    /* 1 builds the gesture layer, about 40 bytes of RAM; off by default */
+    #ifndef MTOUCH_GESTURE
+    #define MTOUCH_GESTURE                  0
+    #endif
+
+    #define MTOUCH_GESTURE_DOUBLETAP_MS     (uint16_t)300   /* max gap from a tap release to the next press */
+    #define MTOUCH_GESTURE_LONGPRESS_MS     (uint16_t)800   /* press held this long is a long-press, not a tap */
+    #define MTOUCH_GESTURE_REPEAT_MS        (uint16_t)200   /* repeat period after the long-press */
+    #define MTOUCH_GESTURE_SWIPE_MS         (uint16_t)250   /* max gap between presses of neighbouring buttons */
+    #define MTOUCH_GESTURE_SWIPE_LENGTH     (uint8_t)3      /* buttons pressed in a row to make a swipe */
+
+    /* Buttons in swipe order, first to last; leave undefined for no swipes */
+#if MTOUCH_BUTTONS > 4
+    #define MTOUCH_GESTURE_SWIPE_BUTTONS    Button1, Button2, Button3, Button4
+#endif
+
+    #define MTOUCH_GESTURE_QUEUE_SIZE       4               /* 2, 4 or 8 */
+	
+/*
+ * =======================================================================
+ * Typedefs / Data Types
+ * =======================================================================
+ */
+    enum mtouch_gesture_type
+    {
+        MTOUCH_GESTURE_tap              = 0,
+        MTOUCH_GESTURE_doubleTap        = 1,
+        MTOUCH_GESTURE_longPress        = 2,
+        MTOUCH_GESTURE_repeat           = 3,
+        MTOUCH_GESTURE_swipeForward     = 4,    /* towards the last swipe button */
+        MTOUCH_GESTURE_swipeBack        = 5     /* towards the first swipe button */
+    };
+
+    typedef uint16_t mtouch_gesture_time_t;     /* ms, wraps after 65 s */
+
+    typedef struct
+    {
+        enum mtouch_gesture_type    type;
+        enum mtouch_button_names    button;     /* the last button of a swipe */
+        mtouch_gesture_time_t       time;       /* release for a tap, otherwise when it was recognised */
+    } mtouch_gesture_event_t;
+
+/*
+ * =======================================================================
+ * Global Functions
+ * =======================================================================
+ */
+#if MTOUCH_GESTURE
+    void                    MTOUCH_Gesture_Initialize   (void);
+    void                    MTOUCH_Gesture_Tick         (uint16_t elapsed_ms);
+    
+    bool                    MTOUCH_Gesture_Get          (mtouch_gesture_event_t* event);
+    mtouch_gesture_time_t   MTOUCH_Gesture_Time_Get     (void);
+    uint8_t                 MTOUCH_Gesture_Dropped_Get  (void);
+#else
+    /* No gesture layer in this build, the calls fold away */
+    #define MTOUCH_Gesture_Initialize()
+    #define MTOUCH_Gesture_Tick(elapsed_ms)
+    #define MTOUCH_Gesture_Get(event)       (false)
+    #define MTOUCH_Gesture_Time_Get()       ((mtouch_gesture_time_t)0)
+    #define MTOUCH_Gesture_Dropped_Get()    ((uint8_t)0)
+#endif
+#endif // MTOUCH_GESTURE_H
@@ -0,0 +1,252 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mtouch.h"
+#include "mtouch_proximity.h"
+
+#if MTOUCH_PROXIMITY
+
+#if   MTOUCH_PROXIMITY_DECIMATION == 4
+    #define PROXIMITY_DECIMATION_SHIFT  2
+#elif MTOUCH_PROXIMITY_DECIMATION == 8
+    #define PROXIMITY_DECIMATION_SHIFT  3
+#elif MTOUCH_PROXIMITY_DECIMATION == 16
+    #define PROXIMITY_DECIMATION_SHIFT  4
+#elif MTOUCH_PROXIMITY_DECIMATION == 32
+    #define PROXIMITY_DECIMATION_SHIFT  5
+#else
+    #error MTOUCH_PROXIMITY_DECIMATION must be 4, 8, 16 or 32
+#endif
+
+/* Second order CIC gain is DECIMATION^2 */
+#define PROXIMITY_OUTPUT_SHIFT  (2*PROXIMITY_DECIMATION_SHIFT - MTOUCH_PROXIMITY_FRACTION)
+#define PROXIMITY_WARMUP        (uint8_t)2      /* outputs until both combs hold real data */
+
+/*
+ * =======================================================================
+ * Proximity Type Structure
+ * =======================================================================
+ *  The integrators and combs wrap; the CIC output is still exact as
+ *  long as it fits in 32 bits.
+ */
+    typedef struct
+    {
+              uint32_t                      integrator[2];
+              uint32_t                      comb[2];
+              uint32_t                      baseline;       /* output << BASELINE_GAIN */
+              mtouch_proximity_deviation_t  deviation;
+              mtouch_proximity_level_t      level;
+              uint16_t                      counter;        /* outputs near, or below the baseline */
+              uint8_t                       phase;          /* rounds into the current output */
+              uint8_t                       warmup;
+              unsigned                      near        :1;
+              unsigned                      initialized :1;
+    } mtouch_proximity_t;
+
+    static mtouch_proximity_t mtouch_proximity;
+
+/*
+ * =======================================================================
+ *  Local Functions
+ * =======================================================================
+ */
+static bool     Proximity_Decimate          (uint32_t* output);
+static void     Proximity_Baseline_Reset    (uint32_t output);
+static void     Proximity_Level_Update      (void);
+
+/*
+ * =======================================================================
+ *  MTOUCH_Proximity_Initialize
+ * =======================================================================
+ */
+void MTOUCH_Proximity_Initialize(void)
+{
+    mtouch_proximity.integrator[0]  = 0;
+    mtouch_proximity.integrator[1]  = 0;
+    mtouch_proximity.comb[0]        = 0;
+    mtouch_proximity.comb[1]        = 0;
+    mtouch_proximity.deviation      = 0;
+    mtouch_proximity.level          = (mtouch_proximity_level_t)0;
+    mtouch_proximity.counter        = 0;
+    mtouch_proximity.phase          = 0;
+    mtouch_proximity.warmup         = PROXIMITY_WARMUP;
+    mtouch_proximity.near           = 0;
+    mtouch_proximity.initialized    = 0;
+}
+
+/*
+ * =======================================================================
+ *  MTOUCH_Proximity_Service
+ * =======================================================================
+ *  Called once per processed round, before the sampled flags are reset.
+ */
+void MTOUCH_Proximity_Service(void)
+{
+    uint32_t output;
+
+    if (!MTOUCH_Sensor_wasSampled(MTOUCH_PROXIMITY_SENSOR) || !MTOUCH_Sensor_isCalibrated(MTOUCH_PROXIMITY_SENSOR))
+        return;
+
+    if (!Proximity_Decimate(&output))
+        return;
+
+    if (mtouch_proximity.warmup)
+    {
+        mtouch_proximity.warmup--;
+        return;
+    }
+    if (!mtouch_proximity.initialized)
+    {
+        Proximity_Baseline_Reset(output);
+        mtouch_proximity.initialized = 1;
+        return;
+    }
+
+    mtouch_proximity.deviation = (mtouch_proximity_deviation_t)output
+                               - (mtouch_proximity_deviation_t)(mtouch_proximity.baseline >> MTOUCH_PROXIMITY_BASELINE_GAIN);
+
+    if (mtouch_proximity.deviation < MTOUCH_PROXIMITY_NEGATIVE)
+    {
+        /* Reading below the baseline: follow it once it stays there, not on noise */
+        if (++mtouch_proximity.counter >= MTOUCH_PROXIMITY_NEGATIVE_OUTPUTS)
+            Proximity_Baseline_Reset(output);
+    }
+    else if (mtouch_proximity.near)
+    {
+        /* Baseline frozen; a stuck near state is recalibrated */
+        if (++mtouch_proximity.counter >= MTOUCH_PROXIMITY_NEAR_TIMEOUT)
+            Proximity_Baseline_Reset(output);
+    }
+    else
+    {
+        mtouch_proximity.counter = 0;
+        mtouch_proximity.baseline -= mtouch_proximity.baseline >> MTOUCH_PROXIMITY_BASELINE_GAIN;
+        mtouch_proximity.baseline += output;
+    }
+
+    Proximity_Level_Update();
+}
+
+/*
+ *  One round into the CIC. Returns true with a new output every
+ *  MTOUCH_PROXIMITY_DECIMATION rounds.
+ */
+static bool Proximity_Decimate(uint32_t* output)
+{
+    uint32_t value;
+    uint32_t delayed;
+
+    mtouch_proximity.integrator[0] += MTOUCH_Sensor_RawSample_Get(MTOUCH_PROXIMITY_SENSOR);
+    mtouch_proximity.integrator[1] += mtouch_proximity.integrator[0];
+
+    if (++mtouch_proximity.phase < MTOUCH_PROXIMITY_DECIMATION)
+        return false;
+    mtouch_proximity.phase = 0;
+
+    value   = mtouch_proximity.integrator[1];
+    delayed = mtouch_proximity.comb[0];
+    mtouch_proximity.comb[0] = value;
+    value  -= delayed;
+    delayed = mtouch_proximity.comb[1];
+    mtouch_proximity.comb[1] = value;
+    value  -= delayed;
+
+    *output = value >> PROXIMITY_OUTPUT_SHIFT;
+    return true;
+}
+
+static void Proximity_Baseline_Reset(uint32_t output)
+{
+    mtouch_proximity.baseline   = output << MTOUCH_PROXIMITY_BASELINE_GAIN;
+    mtouch_proximity.deviation  = 0;
+    mtouch_proximity.counter = 0;
+}
+
+/* Level with hysteresis on the near threshold, same as a button */
+static void Proximity_Level_Update(void)
+{
+    mtouch_proximity_deviation_t level;
+
+    level = mtouch_proximity.deviation >> MTOUCH_PROXIMITY_LEVEL_SHIFT; /* XC8 compiler will extend sign bit of signed values */
+    if (level < MTOUCH_PROXIMITY_LEVEL_MIN)
+        level = MTOUCH_PROXIMITY_LEVEL_MIN;
+    if (level > MTOUCH_PROXIMITY_LEVEL_MAX)
+        level = MTOUCH_PROXIMITY_LEVEL_MAX;
+    mtouch_proximity.level = (mtouch_proximity_level_t)level;
+
+    if (mtouch_proximity.near)
+    {
+        if (mtouch_proximity.level < (mtouch_proximity_level_t)(MTOUCH_PROXIMITY_THRESHOLD >> 1))
+        {
+            mtouch_proximity.near       = 0;
+            mtouch_proximity.counter = 0;
+        }
+    }
+    else if (mtouch_proximity.level > MTOUCH_PROXIMITY_THRESHOLD)
+    {
+        mtouch_proximity.near       = 1;
+        mtouch_proximity.counter = 0;
+    }
+}
+
+/*
+ * =======================================================================
+ * Proximity State and Level
+ * =======================================================================
+ */
+bool MTOUCH_Proximity_isNear(void)
+{
+    return (mtouch_proximity.near) ? true : false;
+}
+
+bool MTOUCH_Proximity_isInitialized(void)
+{
+    return (mtouch_proximity.initialized) ? true : false;
+}
+
+mtouch_proximity_level_t MTOUCH_Proximity_Level_Get(void)
+{
+    return mtouch_proximity.level;
+}
+
+mtouch_proximity_deviation_t MTOUCH_Proximity_Deviation_Get(void)
+{
+    return mtouch_proximity.deviation;
+}
+#endif
@@ -0,0 +1,114 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#ifndef MTOUCH_PROXIMITY_H
+#define MTOUCH_PROXIMITY_H
+    
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include "mtouch.h"
+    
+/*
+ * =======================================================================
+ * Application / Configuration Settings
+ * =======================================================================
+ *  Proximity runs beside the button on the same sensor. Every round's
+ *  sample goes through a second order CIC decimator, which trades
+ *  update rate for resolution: the output comes once per
+ *  MTOUCH_PROXIMITY_DECIMATION rounds with the noise of a much longer
+ *  packet. The baseline tracks drift on a slower time constant than a
+ *  button's and is frozen while a hand is near.
+ *
+ *  The sensor keeps full length packets however quiet it is, adaptive
+ *  oversampling would otherwise cut them to 8 samples and quadruple the
+ *  noise the decimator has to average out. In low-power mode a round
+ *  runs once a watchdog period, so an output takes DECIMATION sleeps,
+ *  about 4 s: a hand only wakes the keys from full-rate scanning.
+ */
+    /* 1 builds proximity, about 30 bytes of RAM; off by default */
+    #ifndef MTOUCH_PROXIMITY
+    #define MTOUCH_PROXIMITY                0
+    #endif
+
+#ifdef MTOUCH_SENSOR_MATRIX
+    #define MTOUCH_PROXIMITY_SENSOR         Sensor_R0C0
+#else
+    #define MTOUCH_PROXIMITY_SENSOR         Sensor_AN5
+#endif
+    #define MTOUCH_PROXIMITY_DECIMATION     32              /* rounds per output, 4, 8, 16 or 32 */
+    #define MTOUCH_PROXIMITY_FRACTION       4               /* extra resolution bits kept in the output */
+    
+    #define MTOUCH_PROXIMITY_BASELINE_GAIN  ((uint8_t)4)    /* baseline time constant in outputs, 2^n */
+    #define MTOUCH_PROXIMITY_NEGATIVE       ((mtouch_proximity_deviation_t)-64) /* deviation that resets the baseline ... */
+    #define MTOUCH_PROXIMITY_NEGATIVE_OUTPUTS ((uint16_t)4) /* ... once this many outputs in a row are below it */
+    #define MTOUCH_PROXIMITY_NEAR_TIMEOUT   ((uint16_t)300) /* outputs near before the baseline is reset */
+    
+    #define MTOUCH_PROXIMITY_LEVEL_SHIFT    ((uint8_t)2)    /* deviation per level count, 2^n */
+    #define MTOUCH_PROXIMITY_THRESHOLD      ((mtouch_proximity_level_t)40)  /* level that reports near */
+	
+/*
+ * =======================================================================
+ * Typedefs / Data Types
+ * =======================================================================
+ */
+    typedef int32_t mtouch_proximity_deviation_t;
+
+    typedef uint8_t mtouch_proximity_level_t;
+    #define MTOUCH_PROXIMITY_LEVEL_MIN (0)
+    #define MTOUCH_PROXIMITY_LEVEL_MAX (UINT8_MAX)
+
+/*
+ * =======================================================================
+ * Global Functions
+ * =======================================================================
+ */
+#if MTOUCH_PROXIMITY
+    void                            MTOUCH_Proximity_Initialize     (void);
+    void                            MTOUCH_Proximity_Service        (void);
+    
+    bool                            MTOUCH_Proximity_isNear         (void);
+    bool                            MTOUCH_Proximity_isInitialized  (void);
+    mtouch_proximity_level_t        MTOUCH_Proximity_Level_Get      (void);
+    mtouch_proximity_deviation_t    MTOUCH_Proximity_Deviation_Get  (void);
+#else
+    /* No proximity sensor in this build, the calls fold away */
+    #define MTOUCH_Proximity_Initialize()
+    #define MTOUCH_Proximity_Service()
+    #define MTOUCH_Proximity_isNear()           (false)
+    #define MTOUCH_Proximity_isInitialized()    (false)
+    #define MTOUCH_Proximity_Level_Get()        ((mtouch_proximity_level_t)0)
+    #define MTOUCH_Proximity_Deviation_Get()    ((mtouch_proximity_deviation_t)0)
+#endif
+#endif // MTOUCH_PROXIMITY_H
@@ -37,10 +37,17 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#include "../tmr2.h"
+#ifndef MTOUCH_SENSOR_SHARED
+#include "tmr2.h"
+#endif
 
 #include "mtouch_sensor.h"
 #include "mtouch_sensor_scan.h"
+#include "mtouch_proximity.h"
+
+#if defined(MTOUCH_SENSOR_SHARED) && !defined(MTOUCH_SENSOR_SHARED_SCAN_CYCLES)
+    #error MTOUCH_SENSOR_SHARED_SCAN_CYCLES must be set in a shared build
+#endif
 
 
 #define PIC_ADC_RESOLUTION                                  ((mtouch_sensor_adcsample_t)1024)
@@ -69,36 +76,127 @@ typedef uint8_t mtouch_sensor_sampleperiod_t;
 
 #define SCAN_RETRY                                                      (uint8_t)5
 
-typedef void(*scanFunction)(void);
+#define Sensor_calculate_noise_thrs(oversampling)           (mtouch_sensor_packetnoise_t)(oversampling)*MTOUCH_SENSOR_NOISE_THRESHOLD
+#define MTOUCH_SENSOR_HOP_COUNT                                         (uint8_t)5
+
+#ifdef MTOUCH_SENSOR_FREQUENCY_HOPPING
+/* Phase of the scan taken at a packet counter, A A B B A A B B ... Plain
+ * A B order keeps interference that aliases to half the per-sensor scan
+ * rate out of the packet noise the hop decides on, though it leaks into
+ * the sample; in this order every alias that leaks also shows as noise. */
+#define Sensor_Scan_isPhaseB(counter)                       (((counter) ^ ((counter)>>1)) & 0x01)
+#else
+/* A B A B, which leaks less over an RF sweep at a fixed period (test/hop_sim.c) */
+#define Sensor_Scan_isPhaseB(counter)                       ((counter) & 0x01)
+#endif
+
+#if MTOUCH_SENSORS == 1
+/* The one sensor; its pins and packet are then addressed as constants */
+#define Sensor_Index(name)          ((enum mtouch_sensor_names)0)
+#else
+#define Sensor_Index(name)          (name)
+#endif
+
+#if MTOUCH_SENSOR_SEQUENTIAL
+/* One packet, of currentScannSensor; a round is that sensor's packet, so
+ * a loop over the round folds to it like MTOUCH_SENSOR_FOREACH */
+#define Sensor_Packet(name)         (sensor_packet[0])
+#define Sensor_Noise(name)          (packet_noise)
+#define Sensor_Round_FOREACH(sensor)    (sensor) = currentScannSensor;
+#else
+#define Sensor_Packet(name)         (sensor_packet[Sensor_Index(name)])
+#define Sensor_Noise(name)          (mtouch_sensor[name].packet_noise)
+#define Sensor_Round_FOREACH(sensor)    MTOUCH_SENSOR_FOREACH(sensor)
+#endif
+
+#if MTOUCH_SENSOR_SEQUENTIAL
+/* The sensor flags as masks, 6 bytes for 16 sensors instead of 16 */
+#define Sensor_Bit(sensor)              ((mtouch_sensor_mask_t)1 << ((sensor) - mtouch_sensor))
+#define Sensor_Flag(flag, sensor)       ((sensor_##flag & Sensor_Bit(sensor)) != 0)
+#define Sensor_Flag_Set(flag, sensor)   (sensor_##flag |= Sensor_Bit(sensor))
+#define Sensor_Flag_Clear(flag, sensor) (sensor_##flag &= (mtouch_sensor_mask_t)~Sensor_Bit(sensor))
+#else
+#define Sensor_Flag(flag, sensor)       ((sensor)->flag)
+#define Sensor_Flag_Set(flag, sensor)   ((sensor)->flag = 1)
+#define Sensor_Flag_Clear(flag, sensor) ((sensor)->flag = 0)
+#endif
+
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+#define Sensor_Oversampling(name)   (mtouch_sensor[name].oversampling)
+#if MTOUCH_PROXIMITY
+/* The proximity decimator needs the resolution, its packets are not shortened */
+#define Sensor_Oversampling_Min(name)   (((name) == MTOUCH_PROXIMITY_SENSOR) ? MTOUCH_SENSOR_PACKET_ADCSAMPLES : MTOUCH_SENSOR_OVERSAMPLING_MIN)
+#else
+#define Sensor_Oversampling_Min(name)   MTOUCH_SENSOR_OVERSAMPLING_MIN
+#endif
+#else
+#define Sensor_Oversampling(name)   MTOUCH_SENSOR_PACKET_ADCSAMPLES
+#endif
+#ifdef MTOUCH_LOWPOWER
+#define Sensor_Packet_Length(name)  ((sensor_globalFlags.round_lowpower) ? MTOUCH_SENSOR_LOWPOWER_OVERSAMPLING : Sensor_Oversampling(name))
+#else
+#define Sensor_Packet_Length(name)  Sensor_Oversampling(name)
+#endif
 
 typedef struct
 {
-    unsigned    packet_done:1;
+    unsigned    packet_done:1;      /* no round in progress, TMR2 stopped or no scan slots taken */
     unsigned    interrupted:1;
+    unsigned    round_done:1;       /* packets of every enabled sensor are complete */
+    unsigned    round_error:1;      /* round given up after SCAN_RETRY interrupted scans */
+    unsigned    scan_pending:1;     /* a conversion of currentScannSensor is running */
+    unsigned    lowpower:1;         /* short packets, no round started until asked for */
+    unsigned    round_lowpower:1;   /* the current round uses low-power packets */
+    unsigned    noisy:1;            /* a sensor's filtered noise is over the hop threshold */
 } mtouch_sensor_globalflags_t;
 
 typedef struct
 {
- const  enum mtouch_sensor_names        sensor_name;
- const  scanFunction                    scanA;
- const  scanFunction                    scanB;
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
         mtouch_sensor_packetcounter_t   oversampling;
+        uint8_t                         noise_level;    /* filtered noise per ADC sample x4 */
+#endif
         mtouch_sensor_sample_t          rawSample;
+#if !MTOUCH_SENSOR_SEQUENTIAL
+        uint8_t                         packet_noise;   /* noise per ADC sample x4 of the last packet */
+#endif
+#if !MTOUCH_SENSOR_SEQUENTIAL
         unsigned                        enabled:1;
         unsigned                        sampled:1;
-        unsigned                        acitve:1;
+        unsigned                        active:1;
+#endif
 } mtouch_sensor_t;
 
+/* packet accumulators, owned by the TMR2 interrupt while a round runs,
+ * in a shared build by the scan slot or by Sensor_Acq_Collect() in turn */
+typedef struct
+{
+        mtouch_sensor_packetcounter_t   counter;
+        mtouch_sensor_packetsample_t    sample;
+        mtouch_sensor_packetnoise_t     noise;
+        mtouch_sensor_adcsample_t       last_a;
+        mtouch_sensor_adcsample_t       last_b;
+} mtouch_sensor_packet_t;
+
 /*
  * =======================================================================
  * LOCAL FUNCTIONS
  * =======================================================================
  */
-static enum mtouch_sensor_error Sensor_Service              (enum mtouch_sensor_names name);
-static void                     Sensor_setScanFunction      (mtouch_sensor_t* sensor);
-static enum mtouch_sensor_error Sensor_Acquisition          (mtouch_sensor_t* sensor);
-static enum mtouch_sensor_error Sensor_Acq_ExecutePacket    (mtouch_sensor_t* sensor);
+static void                     Sensor_Service              (enum mtouch_sensor_names name);
+static void                     Sensor_Acq_Start            (void);
+#if MTOUCH_SENSOR_SEQUENTIAL
+static enum mtouch_sensor_names Sensor_Acq_NextSensor       (void);
+#endif
+static void                     Sensor_Acq_StartRound       (void);
+static void                     Sensor_Acq_CompleteRound    (void);
+static bool                     Sensor_Acq_NextScan         (void);
+static void                     Sensor_Acq_Precharge        (void);
+static bool                     Sensor_Acq_Collect          (void);
+static void                     Sensor_Acq_Scan             (void);
+#ifndef MTOUCH_SENSOR_SHARED
 static void                     Sensor_Acq_ExecuteScan      (void);
+#endif
 
 static inline void              Sensor_setSampled           (mtouch_sensor_t* sensor);
 static inline void              Sensor_Sampled_Reset        (mtouch_sensor_t* sensor);
@@ -106,11 +204,19 @@ static inline void              Sensor_setActive            (mtouch_sensor_t* se
 static inline void              Sensor_setInactive          (mtouch_sensor_t* sensor);
 static        bool              Sensor_isEnabled            (mtouch_sensor_t* sensor);
 
-static void                     Sensor_RawSample_Update     (mtouch_sensor_t* sensor);
+static void                     Sensor_RawSample_Update     (mtouch_sensor_t* sensor, mtouch_sensor_packetsample_t sample);
+static void                     Sensor_Packet_Normalize     (enum mtouch_sensor_names name);
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+static bool                     Sensor_Oversampling_isNoisy (void);
+static void                     Sensor_Oversampling_Update  (enum mtouch_sensor_names name, bool noisy);
+#endif
 
 static void                     Sensor_DefaultCallback      (enum mtouch_sensor_names sensor);
 
-static enum mtouch_sensor_error Sensor_Scanfrequency_Evaluation(mtouch_sensor_t* sensor);
+#ifdef MTOUCH_SENSOR_FREQUENCY_HOPPING
+static bool                     Sensor_Scanfrequency_Evaluation(void);
+static void                     Sensor_Scanfrequency_Hop    (mtouch_sensor_sampleperiod_t hop);
+#endif
 
 /*
  * =======================================================================
@@ -124,21 +230,79 @@ static void (*callback_sampled)(enum mtouch_sensor_names sensor) = Sensor_Defaul
  *  Local Variables
  * =======================================================================
  */
-static volatile mtouch_sensor_globalflags_t   sensor_globalFlags;
+static volatile mtouch_sensor_globalflags_t   sensor_globalFlags = {1,0,0,0,0,0,0,0};
+#if MTOUCH_SENSOR_SEQUENTIAL
+static enum mtouch_sensor_names         currentScannSensor = MTOUCH_SENSORS-1;  /* the first packet goes to sensor 0 */
+#else
 static enum mtouch_sensor_names         currentScannSensor;
-static mtouch_sensor_packetcounter_t    packet_counter;
-static mtouch_sensor_packetsample_t     packet_sample;
+#endif
 static mtouch_sensor_sampleperiod_t     sample_period = MTOUCH_SENSOR_SAMPLEPERIOD_MIN;
-static mtouch_sensor_packetnoise_t      packet_noise;
-static scanFunction                     Sensor_scanA = MTOUCH_CVD_ScanA_0;
-static scanFunction                     Sensor_scanB = MTOUCH_CVD_ScanB_0;
+static uint8_t                          round_retry;
+#if MTOUCH_SENSOR_ROUNDCYCLES
+static uint32_t                         round_cycles;           /* instruction cycles of the last round started */
+static uint32_t                         elapsed_cycles;         /* rounds completed since the last one processed */
+static uint32_t                         processed_cycles;       /* rounds up to and including the last one processed */
+#endif
+#if MTOUCH_SENSOR_SEQUENTIAL
+static mtouch_sensor_packet_t           sensor_packet[1];
+static uint8_t                          packet_noise;           /* noise per ADC sample x4 of the last packet, of any sensor */
+#else
+static mtouch_sensor_packet_t           sensor_packet[MTOUCH_SENSORS];
+#endif
+#ifdef MTOUCH_SENSOR_FREQUENCY_HOPPING
+static const mtouch_sensor_sampleperiod_t frequency_hop[MTOUCH_SENSOR_HOP_COUNT] = {3,13,14,20,13};
+static uint8_t                          hop_index;              /* 0 while not hopping */
+static bool                             hop_settled;            /* on the period a search chose */
+static mtouch_sensor_sampleperiod_t     best_sample_period;
+static mtouch_sensor_packetnoise_t      best_noise;
+#endif
 /*
  * =======================================================================
  *  Sensor Configurations
  * =======================================================================
  */
-static mtouch_sensor_t mtouch_sensor[MTOUCH_SENSORS] ={
-    {Sensor_AN5,MTOUCH_CVD_ScanA_0,MTOUCH_CVD_ScanB_0, 32,0,0,0,0},
+static mtouch_sensor_t mtouch_sensor[MTOUCH_SENSORS];
+#if MTOUCH_SENSOR_SEQUENTIAL
+static mtouch_sensor_mask_t sensor_enabled;
+static mtouch_sensor_mask_t sensor_sampled;
+static mtouch_sensor_mask_t sensor_active;
+#endif
+
+static const mtouch_sensor_pin_t mtouch_sensor_pin[MTOUCH_SENSORS] ={
+    MTOUCH_SENSOR_PIN(0),
+#if MTOUCH_SENSORS > 1
+    MTOUCH_SENSOR_PIN(1),
+#endif
+#if MTOUCH_SENSORS > 2
+    MTOUCH_SENSOR_PIN(2),
+#endif
+#if MTOUCH_SENSORS > 3
+    MTOUCH_SENSOR_PIN(3),
+#endif
+#if MTOUCH_SENSORS > 4
+    MTOUCH_SENSOR_PIN(4),
+#endif
+#if MTOUCH_SENSORS > 5
+    MTOUCH_SENSOR_PIN(5),
+#endif
+#if MTOUCH_SENSORS > 6
+    MTOUCH_SENSOR_PIN(6),
+#endif
+#if MTOUCH_SENSORS > 7
+    MTOUCH_SENSOR_PIN(7),
+#endif
+#if MTOUCH_SENSORS > 8
+    MTOUCH_SENSOR_PIN(8),
+    MTOUCH_SENSOR_PIN(9),
+    MTOUCH_SENSOR_PIN(10),
+    MTOUCH_SENSOR_PIN(11),
+#endif
+#if MTOUCH_SENSORS > 12
+    MTOUCH_SENSOR_PIN(12),
+    MTOUCH_SENSOR_PIN(13),
+    MTOUCH_SENSOR_PIN(14),
+    MTOUCH_SENSOR_PIN(15),
+#endif
 };
 
 /*
@@ -148,16 +312,26 @@ static mtouch_sensor_t mtouch_sensor[MTOUCH_SENSORS] ={
  */
 enum mtouch_sensor_error MTOUCH_Sensor_Initialize(enum mtouch_sensor_names sensor)
 {
-    switch(sensor)                                  /* Overwrite TRIS,ANSEL and WPU*/
-    {
-        case 0:  
-            WPUCbits.WPUC1 = 0;
-            ANSELCbits.ANSC1 = 0;
-            TRISCbits.TRISC1 = 0;
-            break;
-        default: return MTOUCH_SENSOR_ERROR_invalid_index;
-    }
+    const mtouch_sensor_pin_t* pin;
+
+    if(!MTOUCH_SENSOR_ISVALID(sensor))
+        return MTOUCH_SENSOR_ERROR_invalid_index;
+
+    pin = &mtouch_sensor_pin[Sensor_Index(sensor)]; /* Overwrite TRIS,ANSEL and WPU*/
+    *(pin->wpu)   &= (uint8_t)~(pin->mask);
+    *(pin->ansel) &= (uint8_t)~(pin->mask);
+    *(pin->lat)   &= (uint8_t)~(pin->mask);
+    *(pin->tris)  &= (uint8_t)~(pin->mask);
+#ifdef MTOUCH_SENSOR_MATRIX
+    *(pin->row_wpu)   &= (uint8_t)~(pin->row_mask);  /* row: digital output, idle low */
+    *(pin->row_ansel) &= (uint8_t)~(pin->row_mask);
+    *(pin->row_lat)   &= (uint8_t)~(pin->row_mask);
+    *(pin->row_tris)  &= (uint8_t)~(pin->row_mask);
+#endif
     
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+    mtouch_sensor[sensor].oversampling = MTOUCH_SENSOR_PACKET_ADCSAMPLES;
+#endif
     MTOUCH_Sensor_Enable(sensor);
     Sensor_Sampled_Reset(&mtouch_sensor[sensor]);
     
@@ -173,7 +347,7 @@ enum mtouch_sensor_error MTOUCH_Sensor_Initialize(enum mtouch_sensor_names senso
 void MTOUCH_Sensor_InitializeAll(void)
 {
     enum mtouch_sensor_names sensor; 
-    for (sensor = 0; sensor < MTOUCH_SENSORS; sensor++)
+    MTOUCH_SENSOR_FOREACH(sensor)
     {
         MTOUCH_Sensor_Initialize(sensor);
     }
@@ -187,11 +361,13 @@ void MTOUCH_Sensor_InitializeAll(void)
  */
 void MTOUCH_Sensor_Scan_Initialize(void)
 {
+#ifndef MTOUCH_SENSOR_SHARED                        /* shared: the project sets the ADC up for each scan slot */
     T2CONbits.T2CKPS = 0x0;
 
     ADCON0 = (uint8_t)0;                            /* overwrite the ADC configuration for mTouch scan */
     ADCON1 = (uint8_t)( 0x1<<7 | 0x2<<4 | 0x0 );
     ADCON2 = (uint8_t)0;
+#endif
 }
 
 
@@ -199,19 +375,112 @@ void MTOUCH_Sensor_Scan_Initialize(void)
  * =======================================================================
  * MTOUCH_Sensor_SampleAll()
  * =======================================================================
- *  
+ *  Non-blocking. A round of packets is acquired by the TMR2 interrupt,
+ *  which scans the enabled sensors round-robin, one scan per period.
+ *  When a round is complete its packets are processed here and the next
+ *  round is started at once. Returns true when a round was processed.
+ *  Rounds taken while hopping to a quieter sample period are dropped.
+ *  In a sequential build a round is the packet of one sensor, and the
+ *  next round goes to the next enabled sensor.
  */
 
 bool MTOUCH_Sensor_SampleAll(void)
 {
-    enum mtouch_sensor_names sensor;   
-    for (sensor = 0; sensor < MTOUCH_SENSORS; sensor++)
+    enum mtouch_sensor_names sensor;
+    bool                     usable;
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+    bool                     noisy;
+#endif
+
+    /* software CVD with AFA requires interrupt enabled */
+    if(!(INTCONbits.GIE & INTCONbits.PEIE))
+        return false;
+
+    if(sensor_globalFlags.packet_done == 0)
+        return false;                               /* round still running */
+
+    if(sensor_globalFlags.round_done == 0)
     {
-        if(Sensor_Service(sensor)!= MTOUCH_SENSOR_ERROR_none)
-            return false;
+        Sensor_Acq_Start();                         /* first round */
+        return false;
     }
-    return true;
+
+    sensor_globalFlags.round_done = 0;
+#if MTOUCH_SENSOR_ROUNDCYCLES
+    elapsed_cycles += round_cycles;
+#endif
+    usable = (sensor_globalFlags.round_error) ? false : true;
+    if(usable)
+    {
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+        noisy = Sensor_Oversampling_isNoisy();      /* as filtered up to the last round */
+#endif
+        Sensor_Round_FOREACH(sensor)
+        {
+            Sensor_Packet_Normalize(sensor);
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+            if(!sensor_globalFlags.round_lowpower)
+                Sensor_Oversampling_Update(sensor, noisy); /* takes effect from the next round */
+#endif
+        }
+    }
+#ifdef MTOUCH_SENSOR_FREQUENCY_HOPPING
+    if(usable)
+        usable = Sensor_Scanfrequency_Evaluation();
+#endif
+    if(usable)
+    {
+        Sensor_Round_FOREACH(sensor)
+        {
+            Sensor_Service(sensor);
+        }
+#if MTOUCH_SENSOR_ROUNDCYCLES
+        processed_cycles = elapsed_cycles;          /* dropped rounds took time too */
+        elapsed_cycles = 0;
+#endif
+    }
+    if(!sensor_globalFlags.lowpower)
+        Sensor_Acq_Start();                         /* next round runs while the buttons are serviced */
+#if MTOUCH_SENSOR_SEQUENTIAL
+    else if(Sensor_Acq_NextSensor() > currentScannSensor)
+        Sensor_Acq_Start();                         /* one wake still sweeps every sensor */
+#endif
+
+    return usable;
+}
+
+
+#ifdef MTOUCH_LOWPOWER
+/*
+ * =======================================================================
+ * Low Power Support
+ * =======================================================================
+ *  In low-power mode every round uses MTOUCH_SENSOR_LOWPOWER_OVERSAMPLING
+ *  samples per packet and, once processed, the next round is not started
+ *  until MTOUCH_Sensor_SampleAll() is called again. The change takes
+ *  effect from the next round started. In a sequential build the
+ *  packets of the sensors follow one another up to the last enabled
+ *  one before the library waits to be called again.
+ */
+void MTOUCH_Sensor_LowPower_Set(bool enable)
+{
+    sensor_globalFlags.lowpower = (enable) ? 1 : 0;
+}
+
+/* true when no round is running or waiting to be processed, i.e. the device may sleep */
+bool MTOUCH_Sensor_isIdle(void)
+{
+    return (sensor_globalFlags.packet_done && !sensor_globalFlags.round_done) ? true : false;
 }
+#endif
+
+#if MTOUCH_SENSOR_ROUNDCYCLES
+/* Instruction cycles since the previous processed round, for the time base */
+uint32_t MTOUCH_Sensor_RoundCycles_Get(void)
+{
+    return processed_cycles;
+}
+#endif
 
 
 /*
@@ -219,25 +488,25 @@ bool MTOUCH_Sensor_SampleAll(void)
  * Sensor_Service()
  * =======================================================================
  */
-static enum mtouch_sensor_error Sensor_Service(enum mtouch_sensor_names name)
+static void Sensor_Service(enum mtouch_sensor_names name)
 {
     mtouch_sensor_t*       sensor = &mtouch_sensor[name];
-    enum mtouch_sensor_error error = Sensor_Acquisition(sensor);
+    mtouch_sensor_packetsample_t sample = Sensor_Packet(name).sample;
+
+    if(!Sensor_isEnabled(sensor))
+        return;
 
-    /* Validate sensor output. Handle errors. */
-    switch(error)
+    if((mtouch_sensor_packetsample_t)abs(sample - sensor->rawSample) > Sensor_calculate_active_thrs(MTOUCH_SENSOR_PACKET_ADCSAMPLES))
     {
-        case MTOUCH_SENSOR_ERROR_none:
-        {
-            Sensor_RawSample_Update(sensor);
-            Sensor_setSampled(sensor);
-            callback_sampled(name);
-        }
-        break;
-        default: break;
+        Sensor_setActive(sensor);
     }
-
-    return error;
+    else
+    {
+        Sensor_setInactive(sensor);
+    }
+    Sensor_RawSample_Update(sensor, sample);
+    Sensor_setSampled(sensor);
+    callback_sampled(name);
 }
 
 
@@ -248,215 +517,531 @@ void MTOUCH_Sensor_NotifyInterruptOccurred(void)
 }
 /*
  * =======================================================================
- * Sensor_Acquisition()
+ * Sensor_Acq_Start()
  * =======================================================================
+ * Start a round of packets. Only called from the mainloop while TMR2 is
+ * stopped, or in a shared build while no scan slot is taken. A
+ * sequential build moves on to the next enabled sensor first.
  */
-static enum mtouch_sensor_error Sensor_Acquisition(mtouch_sensor_t* sensor)
+static void Sensor_Acq_Start(void)
 {
+#if MTOUCH_SENSOR_ROUNDCYCLES
+#if !MTOUCH_SENSOR_SEQUENTIAL
+    enum mtouch_sensor_names sensor;
+#endif
+    uint16_t                 scans = 0;
+#endif
 
-    uint8_t retry = SCAN_RETRY;
-     
-    if(!Sensor_isEnabled(sensor))
-        return MTOUCH_SENSOR_ERROR_none;
-    
-    while(Sensor_Acq_ExecutePacket(sensor))
+#if MTOUCH_SENSOR_SEQUENTIAL
+    currentScannSensor = Sensor_Acq_NextSensor();
+#endif
+
+    MTOUCH_Sensor_Scan_Initialize();
+
+#ifndef MTOUCH_SENSOR_SHARED
+    TMR2_SetInterruptHandler(Sensor_Acq_ExecuteScan);  /* Use timer2 to schedule the scan */
+    TMR2_LoadPeriodRegister(sample_period);
+#endif
+
+    round_retry = SCAN_RETRY;
+    sensor_globalFlags.round_error = 0;
+#ifdef MTOUCH_LOWPOWER
+    sensor_globalFlags.round_lowpower = sensor_globalFlags.lowpower;
+#endif
+    Sensor_Acq_StartRound();
+
+#if MTOUCH_SENSOR_ROUNDCYCLES
+#if MTOUCH_SENSOR_SEQUENTIAL
+    scans = sensor_packet[0].counter;
+#else
+    MTOUCH_SENSOR_FOREACH(sensor)
     {
-        retry--;
-        if(retry == 0)
-        {
-            return MTOUCH_SENSOR_ERROR_tooManyRetries;
-        }
+        scans += sensor_packet[sensor].counter;
     }
+#endif
+#ifdef MTOUCH_SENSOR_SHARED
+    round_cycles = (uint32_t)scans * MTOUCH_SENSOR_SHARED_SCAN_CYCLES;
+#else
+    round_cycles = (uint32_t)(scans + 1) * ((uint16_t)sample_period + 1);   /* one extra period collects the last result */
+#endif
+#endif
 
-    if((mtouch_sensor_packetsample_t)abs(packet_sample - sensor->rawSample) > Sensor_calculate_active_thrs(sensor->oversampling))
+    if(sensor_globalFlags.packet_done)
     {
-        Sensor_setActive(sensor);
-        //return Sensor_Scanfrequency_Evaluation(sensor);
+        sensor_globalFlags.round_done = 1;          /* no sensor enabled */
+        return;
     }
-    else
+#ifndef MTOUCH_SENSOR_SHARED
+    TMR2_StartTimer();
+#endif
+}
+
+
+#if MTOUCH_SENSOR_SEQUENTIAL
+/* The enabled sensor after currentScannSensor round-robin, or
+ * currentScannSensor when none is enabled */
+static enum mtouch_sensor_names Sensor_Acq_NextSensor(void)
+{
+    enum mtouch_sensor_names    next = currentScannSensor;
+    uint8_t                     i;
+
+    for(i = 0; i < MTOUCH_SENSORS; i++)
     {
-        Sensor_setInactive(sensor);
+        next++;
+        if(next >= MTOUCH_SENSORS)
+            next = 0;
+        if(Sensor_Flag(enabled, &mtouch_sensor[next]))
+            break;
     }
-    
-    return MTOUCH_SENSOR_ERROR_none;
+    return next;
 }
+#endif
 
 
 /*
  * =======================================================================
- * Sensor_Acq_ExecutePacket()
+ * Sensor_Acq_StartRound()
  * =======================================================================
+ * Reset the packet of every enabled sensor, in a sequential build of
+ * currentScannSensor only, so a retry scans the same sensor again. The
+ * first scan is taken on the next TMR2 period match.
  */
-static enum mtouch_sensor_error Sensor_Acq_ExecutePacket(mtouch_sensor_t* sensor)
+static void Sensor_Acq_StartRound(void)
 {
-    /* software CVD with AFA requires interrupt enabled */
-    if(!(INTCONbits.GIE & INTCONbits.PEIE))
-        return MTOUCH_SENSOR_ERROR_interrupt_notEnabled;
-        
-    enum mtouch_sensor_error        error = MTOUCH_SENSOR_ERROR_none;
- /*   uint8_t ADCON0_temp;
-    uint8_t ADCON1_temp;
-    uint8_t ADCON2_temp;
-    
+    enum mtouch_sensor_names    sensor;
+    bool                        any = false;
 
-    ADCON0_temp = ADCON0;       // store the current ADC configuration 
-    ADCON1_temp = ADCON1;
-    ADCON2_temp = ADCON2;*/
-    MTOUCH_Sensor_Scan_Initialize();
-    
-                 
-    Sensor_setScanFunction(sensor);  /* Setup the scan function */
-
-    currentScannSensor = sensor->sensor_name;
-    packet_counter  = sensor->oversampling;
-    packet_sample = 0;
-    sensor_globalFlags.packet_done = 0;
-    packet_noise = 0;
-    
-    TMR2_SetInterruptHandler(Sensor_Acq_ExecuteScan);  /* Use timer2 to schedule the scan */
-    TMR2_LoadPeriodRegister(sample_period);
-    TMR2_StartTimer();
-    
-    sensor_globalFlags.interrupted = false;
-    
-    /* Perform packet samples */
-    do
+    Sensor_Round_FOREACH(sensor)
     {
-        while(PIR1bits.ADIF == 0) 
+        /* Not Sensor_isEnabled(): the retry runs this from the interrupt,
+         * where each call level is one of the 16 hardware stack levels. */
+        if(Sensor_Flag(enabled, &mtouch_sensor[sensor]))
+        {
+            Sensor_Packet(sensor).counter = Sensor_Packet_Length(sensor);
+            any = true;
+        }
+        else
         {
-            if(sensor_globalFlags.packet_done == (uint8_t)1)
-                break;
+            Sensor_Packet(sensor).counter = 0;
         }
-        PIR1bits.ADIF = 0;    
-    } while(sensor_globalFlags.packet_done == 0);
+        Sensor_Packet(sensor).sample = 0;
+        Sensor_Packet(sensor).noise  = 0;
+    }
 
+#if !MTOUCH_SENSOR_SEQUENTIAL
+    currentScannSensor = MTOUCH_SENSORS-1;          /* the first scan goes to sensor 0 */
+#endif
+    sensor_globalFlags.scan_pending = 0;
+    sensor_globalFlags.interrupted  = false;
+    sensor_globalFlags.packet_done  = (any) ? 0 : 1;
+}
 
-    TMR2_StopTimer();
-    /* restore the previous ADC configuration */
-   /* ADCON0 = ADCON0_temp;       
-    ADCON1 = ADCON1_temp;
-    ADCON2 = ADCON2_temp;*/
-    
+
+/*
+ * =======================================================================
+ * Sensor_Acq_NextScan()
+ * =======================================================================
+ * Move currentScannSensor round-robin to the next sensor whose packet
+ * still needs samples. Returns false when every packet is complete.
+ */
+static bool Sensor_Acq_NextScan(void)
+{
+#if MTOUCH_SENSORS == 1 || MTOUCH_SENSOR_SEQUENTIAL
+    return (sensor_packet[0].counter != (mtouch_sensor_packetcounter_t)0) ? true : false;
+#else
+    uint8_t i;
+
+    for (i = 0; i < MTOUCH_SENSORS; i++)
+    {
+        currentScannSensor++;
+        if(currentScannSensor >= MTOUCH_SENSORS)
+            currentScannSensor = 0;
+        if(sensor_packet[currentScannSensor].counter != (mtouch_sensor_packetcounter_t)0)
+            return true;
+    }
+    return false;
+#endif
+}
+
+
+/*
+ * =======================================================================
+ * Sensor_Acq_Precharge()
+ * =======================================================================
+ * Drive the following sensor to the level its next scan precharges to
+ * (high for scanA, low for scanB; high for both on a matrix column,
+ * whose row sets the phase). Called right after a conversion has
+ * started, so the sensor charges while the ADC converts and the scan
+ * only has to equalize the ADC hold capacitor.
+ */
+static void Sensor_Acq_Precharge(void)
+{
+#if MTOUCH_SENSORS == 1
+    const enum mtouch_sensor_names next = 0;        /* the same sensor is scanned again */
+#elif MTOUCH_SENSOR_SEQUENTIAL
+    const enum mtouch_sensor_names next = currentScannSensor;
+#else
+    enum mtouch_sensor_names    next = currentScannSensor + 1;
+#endif
+    const mtouch_sensor_pin_t*  pin;
+
+#if MTOUCH_SENSORS > 1 && !MTOUCH_SENSOR_SEQUENTIAL
+    if(next >= MTOUCH_SENSORS)
+        next = 0;
+#endif
+    if(Sensor_Packet(next).counter == (mtouch_sensor_packetcounter_t)0)
+        return;
+
+    pin = &mtouch_sensor_pin[next];
+#ifdef MTOUCH_SENSOR_MATRIX
+    *(pin->lat) |= pin->mask;
+#else
+    if(Sensor_Scan_isPhaseB(Sensor_Packet(next).counter))
+        *(pin->lat) &= (uint8_t)~(pin->mask);
+    else
+        *(pin->lat) |= pin->mask;
+#endif
+}
+
+
+/*
+ * =======================================================================
+ * Sensor_Acq_CompleteRound()
+ * =======================================================================
+ * Called after the last result of a round. A round that was
+ * interrupted is repeated up to SCAN_RETRY times.
+ */
+static void Sensor_Acq_CompleteRound(void)
+{
     if(sensor_globalFlags.interrupted)
     {
-        error = MTOUCH_SENSOR_ERROR_interruptedScan;
+        if(--round_retry != (uint8_t)0)
+        {
+#if MTOUCH_SENSOR_ROUNDCYCLES
+            elapsed_cycles += round_cycles;
+#endif
+            Sensor_Acq_StartRound();                /* rescan every sensor */
+            return;
+        }
+        sensor_globalFlags.round_error = 1;
     }
-    
-    return error;
+
+#ifndef MTOUCH_SENSOR_SHARED
+    TMR2_StopTimer();
+#endif
+    sensor_globalFlags.packet_done = 1;
+    sensor_globalFlags.round_done  = 1;
 }
 
 
 /*
  * =======================================================================
- * Sensor_Acq_ExecuteScan()
+ * Sensor_Acq_Collect()
  * =======================================================================
- * Perform a single sample on the sensor. This is a local function and
- * requires that the ExecutePacket() function guarantees the correct PIC
- * and scanning configuration.
- *
- * This function is written to be independent of mainloop vs ISR context.
+ * Accumulates the result of the previous scan and moves to the next
+ * sensor round-robin. Returns true when a scan of currentScannSensor is
+ * to follow, false when no round is running or the round is complete.
  */
-static void Sensor_Acq_ExecuteScan(void)
+static bool Sensor_Acq_Collect(void)
 {
-    mtouch_sensor_adcsample_t result = ADRES;       /* result from previous scan */
-    static mtouch_sensor_adcsample_t last_a,last_b;
+    mtouch_sensor_adcsample_t result;
+    mtouch_sensor_packet_t*   packet;
 
     if(sensor_globalFlags.packet_done)
-        return;
-    
-    if (packet_counter != (uint8_t)0)
+        return false;
+
+    /* Accumulate previous sample result, its conversion ran since the last period match */
+    if(sensor_globalFlags.scan_pending)
     {
-        #pragma switch time
-        switch(packet_counter & 0x01)
-        {
-            case 0: Sensor_scanA();break;
-            case 1: Sensor_scanB();break;
-            default: break;
+        result = MTOUCH_SCAN_RESULT();
+        packet = &Sensor_Packet(currentScannSensor);
+        if(!Sensor_Scan_isPhaseB(packet->counter + 1))
+        {    
+            result = PIC_ADC_RESOLUTION - result;
+            packet->noise += (mtouch_sensor_packetnoise_t)abs(packet->last_a-result);
+            packet->last_a = result;
         }
-        /* Accumulate previous sample result during the ADC conversion */
-        if(packet_counter!=mtouch_sensor[currentScannSensor].oversampling)
+        else
         {
-            if(packet_counter & 0x01)
-            {    
-                result = PIC_ADC_RESOLUTION - result;
-                packet_noise += (mtouch_sensor_packetsample_t)abs(last_a-result);
-                last_a = result;
-            }
-            else
-            {
-                packet_noise += (mtouch_sensor_packetsample_t)abs(last_b-result);
-                last_b = result;
-            }
-            packet_sample += result;
+            packet->noise += (mtouch_sensor_packetnoise_t)abs(packet->last_b-result);
+            packet->last_b = result;
         }
-        packet_counter--;
+        packet->sample += result;
+        sensor_globalFlags.scan_pending = 0;
     }
-    else
+
+    if(!Sensor_Acq_NextScan())
+    {
+        Sensor_Acq_CompleteRound();
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * =======================================================================
+ * Sensor_Acq_Scan()
+ * =======================================================================
+ * Takes a single sample on currentScannSensor and precharges the sensor
+ * after it while the conversion runs.
+ */
+static void Sensor_Acq_Scan(void)
+{
+    mtouch_sensor_packet_t*   packet = &Sensor_Packet(currentScannSensor);
+
+    #pragma switch time
+    switch(Sensor_Scan_isPhaseB(packet->counter))
     {
-        packet_sample += result;
-        packet_noise += (mtouch_sensor_packetsample_t)abs(last_b-result);
-        sensor_globalFlags.packet_done = (uint8_t)1;
+        case 0: mtouch_sensor_pin[Sensor_Index(currentScannSensor)].scanA();break;
+        case 1: mtouch_sensor_pin[Sensor_Index(currentScannSensor)].scanB();break;
+        default: break;
     }
+    packet->counter--;
+    sensor_globalFlags.scan_pending = 1;
+
+    Sensor_Acq_Precharge();
 }
 
+
+#ifdef MTOUCH_SENSOR_SHARED
+/*
+ * =======================================================================
+ * Shared acquisition slots
+ * =======================================================================
+ * MTOUCH_Sensor_Acq_Scan() only runs after MTOUCH_Sensor_Acq_Collect()
+ * has returned true, and the next collect only after that scan's
+ * conversion is done, so the two never touch a packet at the same time.
+ */
+bool MTOUCH_Sensor_Acq_Collect(void)
+{
+    return Sensor_Acq_Collect();
+}
+
+void MTOUCH_Sensor_Acq_Scan(void)
+{
+    Sensor_Acq_Scan();
+}
+#else
+/*
+ * =======================================================================
+ * Sensor_Acq_ExecuteScan()
+ * =======================================================================
+ * TMR2 interrupt handler. Accumulates the result of the previous scan,
+ * then takes a single sample on the next sensor round-robin. Requires
+ * that Sensor_Acq_Start() has set up the PIC and scanning configuration.
+ */
+static void Sensor_Acq_ExecuteScan(void)
+{
+    if(Sensor_Acq_Collect())
+        Sensor_Acq_Scan();
+}
+#endif
+
 /*
  * 
  *=======================================================================
  * Automatic Frequency Adaptation
  *=======================================================================
+ * Called once per completed round, before the packets are used. Costs
+ * no extra packets: a quiet round is used as it is. When any sensor's
+ * packet noise is above its threshold, the following rounds step
+ * sample_period through frequency_hop[], one candidate per round, and
+ * those rounds are dropped. The hop ends early at the first quiet
+ * period. Otherwise the quietest period is kept, and the starting period
+ * is only left if a candidate is at least 25% quieter (stickiness).
+ * Once a search has chosen a period, quiet or not, its rounds are used
+ * until the noise doubles from when it was chosen; the packet average
+ * takes care of the rest, and searching again would only drop rounds.
+ * Without this, white noise near the threshold, which no period gets
+ * away from, would start a search every few rounds.
  *
+ * Returns true if the round's packets can be used.
  */
-static enum mtouch_sensor_error Sensor_Scanfrequency_Evaluation(mtouch_sensor_t* sensor)
+#ifdef MTOUCH_SENSOR_FREQUENCY_HOPPING
+static bool Sensor_Scanfrequency_Evaluation(void)
 {
-    uint8_t i;
-    const mtouch_sensor_sampleperiod_t  frequency_hop[5] = {3,13,14,20,13};
-    mtouch_sensor_packetnoise_t         packet_noise_Max;
-    mtouch_sensor_sampleperiod_t        best_sample_period;
-    mtouch_sensor_packetsample_t        best_packet_sample;    
-    uint8_t                             retry; 
-    
-    packet_noise_Max = packet_noise + (packet_noise>>2); /* put stickiness to the current scan frequency */
-    best_sample_period = sample_period;
-    best_packet_sample = packet_sample;
-    
+    enum mtouch_sensor_names            sensor;
+    mtouch_sensor_packetnoise_t         noise = 0;
+    bool                                noisy = false;
 
-    for(i=(uint8_t)0;i<(uint8_t)5;i++)
-    {   
-        sample_period += frequency_hop[i];
-        if(sample_period > MTOUCH_SENSOR_SAMPLEPERIOD_MAX)
+    Sensor_Round_FOREACH(sensor)
+    {
+        if(Sensor_isEnabled(&mtouch_sensor[sensor]))
         {
-            sample_period-=MTOUCH_SENSOR_SAMPLEPERIOD_MAX;
-            sample_period+=MTOUCH_SENSOR_SAMPLEPERIOD_MIN;
+            if(Sensor_Packet(sensor).noise > noise)
+                noise = Sensor_Packet(sensor).noise;
+            if(Sensor_Packet(sensor).noise > Sensor_calculate_noise_thrs(MTOUCH_SENSOR_PACKET_ADCSAMPLES))
+                noisy = true;
         }
-        else if(sample_period < MTOUCH_SENSOR_SAMPLEPERIOD_MIN)
+    }
+
+    if(hop_index == (uint8_t)0)
+    {
+        if(!noisy)
+            return true;
+        if(hop_settled && (noise>>1) <= best_noise)
+            return true;                            /* best period found so far, use it */
+        hop_settled = false;
+        best_sample_period = sample_period;
+        best_noise = noise - (noise>>2);            /* put stickiness to the current scan frequency */
+    }
+    else
+    {
+        if(!noisy)
         {
-            sample_period += MTOUCH_SENSOR_SAMPLEPERIOD_MIN;
+            hop_index = 0;                          /* quiet here, stay */
+            best_noise = noise;
+            hop_settled = true;
+            return true;
         }
-        
-        retry = SCAN_RETRY;
-        
-        while(Sensor_Acq_ExecutePacket(sensor))
+        if(noise < best_noise)
         {
-            retry--;
-            if(retry == 0)
-            {
-                return MTOUCH_SENSOR_ERROR_tooManyRetries;
-            }
+            best_noise = noise;
+            best_sample_period = sample_period;
         }
-        
-        if(packet_noise_Max < packet_noise)
+        if(hop_index >= MTOUCH_SENSOR_HOP_COUNT)
         {
-            packet_noise_Max = packet_noise;
-            best_sample_period = sample_period;
-            best_packet_sample = packet_sample;
-        }       
+            sample_period = best_sample_period;
+            hop_index = 0;
+            hop_settled = true;
+            return false;
+        }
     }
-    
-    sample_period = best_sample_period;
-    packet_sample = best_packet_sample;
-    
-    return MTOUCH_SENSOR_ERROR_none;
+
+    Sensor_Scanfrequency_Hop(frequency_hop[hop_index]);
+    hop_index++;
+    return false;
+}
+
+static void Sensor_Scanfrequency_Hop(mtouch_sensor_sampleperiod_t hop)
+{
+    uint16_t period = (uint16_t)sample_period + hop;   /* 8 bits would wrap before the check */
+
+    if(period > MTOUCH_SENSOR_SAMPLEPERIOD_MAX)
+        period = period - MTOUCH_SENSOR_SAMPLEPERIOD_MAX + MTOUCH_SENSOR_SAMPLEPERIOD_MIN;
+    sample_period = (mtouch_sensor_sampleperiod_t)period;
 }
+#endif
+
+/*
+ * =======================================================================
+ * Packet Length
+ * =======================================================================
+ * Packets may be 8 to 64 samples long, MTOUCH_SENSOR_OVERSAMPLING_MAX
+ * sets the longest. Sample and noise are scaled to a packet of
+ * MTOUCH_SENSOR_PACKET_ADCSAMPLES, so the raw sample, the
+ * active and noise thresholds and the button reading/baseline gains do
+ * not depend on the packet length.
+ */
+static void Sensor_Packet_Normalize(enum mtouch_sensor_names name)
+{
+    mtouch_sensor_packet_t*         packet = &Sensor_Packet(name);
+    mtouch_sensor_packetcounter_t   length = Sensor_Packet_Length(name);
+    uint16_t                        level;
+
+    while(length < MTOUCH_SENSOR_PACKET_ADCSAMPLES)
+    {
+        packet->sample <<= 1;
+        packet->noise  <<= 1;
+        length <<= 1;
+    }
+    while(length > MTOUCH_SENSOR_PACKET_ADCSAMPLES)
+    {
+        packet->sample >>= 1;
+        packet->noise  >>= 1;
+        length >>= 1;
+    }
+
+    /* noise per ADC sample x4, kept after the next round clears the packet */
+    level = packet->noise / (MTOUCH_SENSOR_PACKET_ADCSAMPLES/4);
+    if(level > UINT8_MAX)
+        level = UINT8_MAX;
+    Sensor_Noise(name) = (uint8_t)level;
+}
+
+#ifdef MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+/*
+ * Filter the normalized packet noise and halve the packet length on a
+ * quiet sensor or double it on a noisy one. The gap between
+ * MTOUCH_SENSOR_NOISE_QUIET and MTOUCH_SENSOR_NOISE_LOUD is the
+ * hysteresis. Both are for the shortest packet and grow with the square
+ * root of the length, as the packet average shrinks the noise: the noise
+ * per sample stays the same however long the packet, so fixed bounds
+ * would send every sensor over MTOUCH_SENSOR_NOISE_LOUD to the longest
+ * packet and the slowest response.
+ *
+ * Once any sensor's filtered noise is over the hop threshold, the
+ * noise is left to the frequency hopping and every sensor scans full
+ * length packets, as a fixed build does, until all are under half of it. A length change moves the
+ * sample timing of every sensor after it in the round, like a hop
+ * nobody chose, and test/hop_sim.c showed it landing a carrier back on
+ * the period the hop had just left.
+ */
+static const uint8_t oversampling_loud[4] =         /* x4, per doubling of the packet */
+{
+    MTOUCH_SENSOR_NOISE_LOUD*4, MTOUCH_SENSOR_NOISE_LOUD*4*141/100,
+    MTOUCH_SENSOR_NOISE_LOUD*4*2, MTOUCH_SENSOR_NOISE_LOUD*4*283/100
+};
+static const uint8_t oversampling_quiet[4] =
+{
+    MTOUCH_SENSOR_NOISE_QUIET*4, MTOUCH_SENSOR_NOISE_QUIET*4*141/100,
+    MTOUCH_SENSOR_NOISE_QUIET*4*2, MTOUCH_SENSOR_NOISE_QUIET*4*283/100
+};
+
+static bool Sensor_Oversampling_isNoisy(void)
+{
+    enum mtouch_sensor_names sensor;
+    uint8_t                  level = 0;
+
+    MTOUCH_SENSOR_FOREACH(sensor)
+    {
+        if(Sensor_isEnabled(&mtouch_sensor[sensor]) && mtouch_sensor[sensor].noise_level > level)
+            level = mtouch_sensor[sensor].noise_level;
+    }
+    if(level > (uint8_t)(MTOUCH_SENSOR_NOISE_THRESHOLD*4))
+        sensor_globalFlags.noisy = 1;
+    else if(level <= (uint8_t)(MTOUCH_SENSOR_NOISE_THRESHOLD*2))
+        sensor_globalFlags.noisy = 0;
+    return (bool)sensor_globalFlags.noisy;
+}
+
+static void Sensor_Oversampling_Update(enum mtouch_sensor_names name, bool noisy)
+{
+    mtouch_sensor_t*    sensor = &mtouch_sensor[name];
+    uint8_t             level;
+    uint8_t             step = 0;
+    uint8_t             length;
+
+    if(!Sensor_isEnabled(sensor))
+        return;
+
+    level = Sensor_Noise(name);
+    if(level > sensor->noise_level)
+        sensor->noise_level += (level - sensor->noise_level + 3) >> 2;
+    else
+        sensor->noise_level -= (sensor->noise_level - level) >> 2;
+
+    for(length = sensor->oversampling; length > MTOUCH_SENSOR_OVERSAMPLING_MIN; length >>= 1)
+        step++;
+
+    if(sensor->noise_level > oversampling_loud[step])
+    {
+        if(sensor->oversampling < MTOUCH_SENSOR_OVERSAMPLING_MAX)
+            sensor->oversampling <<= 1;
+    }
+    else if(noisy)
+    {
+        if(sensor->oversampling < MTOUCH_SENSOR_PACKET_ADCSAMPLES)
+            sensor->oversampling <<= 1;
+    }
+    else if(sensor->noise_level < oversampling_quiet[step])
+    {
+        if(sensor->oversampling > Sensor_Oversampling_Min(name))
+            sensor->oversampling >>= 1;
+    }
+}
+#endif
 
 /*
  * =======================================================================
@@ -465,7 +1050,7 @@ static enum mtouch_sensor_error Sensor_Scanfrequency_Evaluation(mtouch_sensor_t*
  */ 
 mtouch_sensor_sample_t MTOUCH_Sensor_RawSample_Get(enum mtouch_sensor_names name) /* Global */
 {
-    if (name < MTOUCH_SENSORS)
+    if (MTOUCH_SENSOR_ISVALID(name))
     {
         return mtouch_sensor[name].rawSample;
     }
@@ -473,18 +1058,20 @@ mtouch_sensor_sample_t MTOUCH_Sensor_RawSample_Get(enum mtouch_sensor_names name
         return (mtouch_sensor_sample_t)0;
 }
 
-static void Sensor_RawSample_Update(mtouch_sensor_t* sensor) /* Local */
+/* In a sequential build the noise of the last packet, whichever sensor took it */
+uint8_t MTOUCH_Sensor_PacketNoise_Get(enum mtouch_sensor_names name) /* Global */
 {
-    if (INTCONbits.GIE == (uint8_t)1)
+    if (MTOUCH_SENSOR_ISVALID(name))
     {
-        INTCONbits.GIE = (uint8_t)0;
-        sensor->rawSample = packet_sample;
-        INTCONbits.GIE = (uint8_t)1;
+        return Sensor_Noise(name);
     }
     else
-    {
-        sensor->rawSample = packet_sample;
-    }
+        return (uint8_t)0;
+}
+
+static void Sensor_RawSample_Update(mtouch_sensor_t* sensor, mtouch_sensor_packetsample_t sample) /* Local */
+{
+    sensor->rawSample = sample;                     /* only read and written by the mainloop */
 }
 
 
@@ -499,18 +1086,6 @@ void MTOUCH_Sensor_SetSampledCallback(void (*callback)(enum mtouch_sensor_names
     callback_sampled = callback;
 }
 
-/*
- * =======================================================================
- * Scan Setter Function
- * =======================================================================
- */ 
-
-static void Sensor_setScanFunction(mtouch_sensor_t* sensor)
-{
-    Sensor_scanA = sensor->scanA;
-    Sensor_scanB = sensor->scanB;
-}
-
 
 /*
  * =======================================================================
@@ -518,23 +1093,22 @@ static void Sensor_setScanFunction(mtouch_sensor_t* sensor)
  * =======================================================================
  * 
  */
-/*
 void MTOUCH_Sensor_Disable(enum mtouch_sensor_names sensor)
 {
-    if(sensor < MTOUCH_SENSORS)   
-        mtouch_sensor[sensor].enabled = 0;
+    if(MTOUCH_SENSOR_ISVALID(sensor))
+        Sensor_Flag_Clear(enabled, &mtouch_sensor[sensor]);
 }
 
 void MTOUCH_Sensor_Enable(enum mtouch_sensor_names sensor)
 {
-    if(sensor < MTOUCH_SENSORS)   
-        mtouch_sensor[sensor].enabled = 1;
+    if(MTOUCH_SENSOR_ISVALID(sensor))
+        Sensor_Flag_Set(enabled, &mtouch_sensor[sensor]);
 }
 
 bool MTOUCH_Sensor_isEnabled(enum mtouch_sensor_names sensor)
 {
-    if(sensor < MTOUCH_SENSORS)   
-        return (bool)mtouch_sensor[sensor].enabled;
+    if(MTOUCH_SENSOR_ISVALID(sensor))
+        return (bool)Sensor_Flag(enabled, &mtouch_sensor[sensor]);
     else
         return false;
 }
@@ -542,11 +1116,10 @@ bool MTOUCH_Sensor_isEnabled(enum mtouch_sensor_names sensor)
 static bool Sensor_isEnabled(mtouch_sensor_t* sensor)
 {
     if(sensor!=NULL)
-        return (bool)sensor->enabled;
+        return (bool)Sensor_Flag(enabled, sensor);
     else
         return false;
 }
-*/
 /*
  * =======================================================================
  *  Sensor active status
@@ -556,22 +1129,20 @@ static bool Sensor_isEnabled(mtouch_sensor_t* sensor)
 
 static inline void Sensor_setActive(mtouch_sensor_t* sensor)
 {
-    sensor->acitve = 1;
+    Sensor_Flag_Set(active, sensor);
 }
 
 static inline void Sensor_setInactive(mtouch_sensor_t* sensor)
 {
-    sensor->acitve = 0;
+    Sensor_Flag_Clear(active, sensor);
 }
-/*
 
 bool MTOUCH_Sensor_isActive(enum mtouch_sensor_names sensor)
 {
-    if(sensor <= MTOUCH_SENSORS)
-        return (bool)mtouch_sensor[sensor].acitve;
+    if(MTOUCH_SENSOR_ISVALID(sensor))
+        return (bool)Sensor_Flag(active, &mtouch_sensor[sensor]);
     return false;
 }
-*/
 
 bool MTOUCH_Sensor_isCalibrated(enum mtouch_sensor_names sensor)
 {
@@ -593,27 +1164,27 @@ void MTOUCH_Sensor_Calibrate(enum mtouch_sensor_names sensor)
 
 void MTOUCH_Sensor_Sampled_ResetAll(void)
 {
-    mtouch_sensor_t* sensor;
-    for(sensor = &mtouch_sensor[0];sensor<= &mtouch_sensor[MTOUCH_SENSORS-1];sensor++)
+    enum mtouch_sensor_names sensor;
+    MTOUCH_SENSOR_FOREACH(sensor)
     {      
-        Sensor_Sampled_Reset(sensor);
+        Sensor_Sampled_Reset(&mtouch_sensor[sensor]);
     }
 }
 
 bool MTOUCH_Sensor_wasSampled(enum mtouch_sensor_names sensor) 
 {
    // if(sensor < MTOUCH_SENSORS)
-        return (bool)mtouch_sensor[sensor].sampled;
+        return (bool)Sensor_Flag(sampled, &mtouch_sensor[sensor]);
    // else
      //   return false;
 }
 
 static inline void Sensor_Sampled_Reset(mtouch_sensor_t* sensor) 
 {
-    sensor->sampled = 0;
+    Sensor_Flag_Clear(sampled, sensor);
 }
 
 static inline void Sensor_setSampled(mtouch_sensor_t* sensor) 
 {
-    sensor->sampled = 1;
+    Sensor_Flag_Set(sampled, sensor);
 }
@@ -39,13 +39,182 @@
     #include <stdint.h>
     #include <stdbool.h>
         
-    #define MTOUCH_SENSORS      1
+    /*
+     * Mutual-capacitance keypad, off by default. A project builds with
+     * MTOUCH_SENSOR_MATRIX defined to scan a matrix instead of one
+     * self-capacitance key per pin: each sensor is then a row/column
+     * intersection, see mtouch_sensor_scan.h. 4 rows serve 16 keys from
+     * 8 pins. Past 8 keys the build is sequential and its buttons
+     * compact, which brings a key down to about 8.5 bytes of RAM; a 4x4
+     * pad with low power then fits the PIC16F1703, see
+     * test/ram_budget.py.
+     * Each key updates at least once per MTOUCH_SENSORS *
+     * MTOUCH_SENSOR_OVERSAMPLING_MAX sample periods, 8.2 ms for 8 keys
+     * at the longest sample period and 16.4 ms for 16.
+     */
+#ifdef MTOUCH_SENSOR_MATRIX
+    #ifndef MTOUCH_SENSOR_MATRIX_ROWS
+    #define MTOUCH_SENSOR_MATRIX_ROWS   2       /* 1 to 4 */
+    #endif
+    #define MTOUCH_SENSOR_MATRIX_COLS   4
+
+    #if MTOUCH_SENSOR_MATRIX_ROWS < 1 || MTOUCH_SENSOR_MATRIX_ROWS > 4
+        #error MTOUCH_SENSOR_MATRIX_ROWS must be 1 to 4
+    #endif
+    #ifdef MTOUCH_SENSORS
+        #error MTOUCH_SENSORS is set by MTOUCH_SENSOR_MATRIX_ROWS in a matrix build
+    #endif
+    #define MTOUCH_SENSORS      (MTOUCH_SENSOR_MATRIX_ROWS*MTOUCH_SENSOR_MATRIX_COLS)
+#endif
+
+    /*
+     * 1..8, up to 16 in a matrix build; a project may set it, e.g.
+     * MTOUCH_SENSORS=1 for a single-sensor build. Every sensor takes
+     * about 28 bytes of RAM with its packet and button, so 4 is what the
+     * PIC16F1703 holds next to the low-power mode, the compiled stack and
+     * the MCC drivers; test/ram_budget.py adds it up for the projects'
+     * configurations.
+     */
+    #ifndef MTOUCH_SENSORS
+    #define MTOUCH_SENSORS      4
+    #endif
+
+    /*
+     * Sequential acquisition, on past 8 sensors. The sensors take their
+     * packets one after another instead of interleaved in a round, so a
+     * single packet accumulator serves them all, and each processed
+     * packet services one sensor. That saves 9 bytes per sensor, and the
+     * buttons drop another 6 with it, see MTOUCH_BUTTON_COMPACT. A sensor
+     * still updates once per MTOUCH_SENSORS packets.
+     */
+    #ifndef MTOUCH_SENSOR_SEQUENTIAL
+    #define MTOUCH_SENSOR_SEQUENTIAL    (MTOUCH_SENSORS > 8)
+    #endif
+    
+    /*
+     * Shared acquisition, off by default. A project that runs its own
+     * timer and ADC work on the same PIC builds with MTOUCH_SENSOR_SHARED
+     * defined. The library then leaves TMR2 and the ADC setup alone and
+     * the project hands out the scan slots:
+     *  - it calls MTOUCH_Sensor_Acq_Scan() with interrupts off, from its
+     *    interrupt or its mainloop, with the ADC set up for a Vdd
+     *    referenced conversion, and keeps the ADC until the conversion is
+     *    done
+     *  - its mainloop calls MTOUCH_Sensor_Acq_Collect() once each scan's
+     *    conversion is done, and while no scan is wanted; a scan may
+     *    follow whenever it returns true
+     *  - MTOUCH_SCAN_RESULT() returns the result it kept from that conversion
+     * MTOUCH_SENSOR_SHARED_SCAN_CYCLES, the nominal instruction cycles
+     * from one scan to the next, is the time base of MTOUCH_Tick().
+     */
+    
+    /* Noise-adaptive frequency hopping, 0 to scan at a fixed sample period; off in a single-sensor build */
+    #ifndef MTOUCH_SENSOR_HOPPING
+    #define MTOUCH_SENSOR_HOPPING   (MTOUCH_SENSORS > 1)
+    #endif
+#if MTOUCH_SENSOR_HOPPING
+    #define MTOUCH_SENSOR_FREQUENCY_HOPPING
+#endif
+#ifdef MTOUCH_SENSOR_SHARED
+    #undef MTOUCH_SENSOR_FREQUENCY_HOPPING          /* the sample period is the project's */
+#endif
+    #define MTOUCH_SENSOR_NOISE_THRESHOLD   8       /* packet noise per ADC sample that starts a hop */
+    
+    /* Adaptive packet length, 0 for a fixed 32 sample packet; off in a
+     * single-sensor build, and in a sequential one, where it would cost
+     * back 2 of the bytes per sensor */
+    #ifndef MTOUCH_SENSOR_ADAPTIVE
+    #define MTOUCH_SENSOR_ADAPTIVE  (MTOUCH_SENSORS > 1 && !MTOUCH_SENSOR_SEQUENTIAL)
+    #endif
+#if MTOUCH_SENSOR_ADAPTIVE
+    #define MTOUCH_SENSOR_ADAPTIVE_OVERSAMPLING
+#endif
+    #define MTOUCH_SENSOR_OVERSAMPLING_MIN  8       /* 8, 16, 32 or 64 */
+    #define MTOUCH_SENSOR_OVERSAMPLING_MAX  32      /* no longer than a fixed packet, a noisy board hops instead */
+    #define MTOUCH_SENSOR_NOISE_QUIET       2       /* filtered noise per ADC sample to halve the packet */
+    #define MTOUCH_SENSOR_NOISE_LOUD        5       /* filtered noise per ADC sample to double the packet */
+    
+    #define MTOUCH_SENSOR_LOWPOWER_OVERSAMPLING 8   /* packet length in low-power mode */
+
+    /* Round length bookkeeping for MTOUCH_Sensor_RoundCycles_Get(), the time
+     * base of the gesture timeouts and the low-power stats; left out when
+     * the project builds neither */
+    #ifndef MTOUCH_SENSOR_ROUNDCYCLES
+    #if MTOUCH_GESTURE || defined(MTOUCH_LOWPOWER)
+    #define MTOUCH_SENSOR_ROUNDCYCLES   1
+    #else
+    #define MTOUCH_SENSOR_ROUNDCYCLES   0
+    #endif
+    #endif
     
     
+#ifdef MTOUCH_SENSOR_MATRIX
+    /* Sensor_R<row>C<column>, numbered along the rows */
+    enum mtouch_sensor_names
+    {
+        Sensor_R0C0 = 0
+       ,Sensor_R0C1 = 1
+       ,Sensor_R0C2 = 2
+       ,Sensor_R0C3 = 3
+#if MTOUCH_SENSORS > 4
+       ,Sensor_R1C0 = 4
+       ,Sensor_R1C1 = 5
+       ,Sensor_R1C2 = 6
+       ,Sensor_R1C3 = 7
+#endif
+#if MTOUCH_SENSORS > 8
+       ,Sensor_R2C0 = 8
+       ,Sensor_R2C1 = 9
+       ,Sensor_R2C2 = 10
+       ,Sensor_R2C3 = 11
+#endif
+#if MTOUCH_SENSORS > 12
+       ,Sensor_R3C0 = 12
+       ,Sensor_R3C1 = 13
+       ,Sensor_R3C2 = 14
+       ,Sensor_R3C3 = 15
+#endif
+    };
+#else
     enum mtouch_sensor_names
     {
         Sensor_AN5 = 0
+#if MTOUCH_SENSORS > 1
+       ,Sensor_AN4 = 1
+#endif
+#if MTOUCH_SENSORS > 2
+       ,Sensor_AN6 = 2
+#endif
+#if MTOUCH_SENSORS > 3
+       ,Sensor_AN7 = 3
+#endif
+#if MTOUCH_SENSORS > 4
+       ,Sensor_AN2 = 4
+#endif
+#if MTOUCH_SENSORS > 5
+       ,Sensor_AN3 = 5
+#endif
+#if MTOUCH_SENSORS > 6
+       ,Sensor_AN0 = 6
+#endif
+#if MTOUCH_SENSORS > 7
+       ,Sensor_AN1 = 7
+#endif
     };
+#endif
+    
+    /*
+     * Per-sensor loops and index checks. With a single sensor they fold to
+     * straight-line code on sensor 0, so a loop body must not use break or
+     * continue. The enum then has a single name and needs no check.
+     */
+#if MTOUCH_SENSORS == 1
+    #define MTOUCH_SENSOR_FOREACH(sensor)   (sensor) = (enum mtouch_sensor_names)0;
+    #define MTOUCH_SENSOR_ISVALID(sensor)   (true)
+#else
+    #define MTOUCH_SENSOR_FOREACH(sensor)   for ((sensor) = 0; (sensor) < MTOUCH_SENSORS; (sensor)++)
+    #define MTOUCH_SENSOR_ISVALID(sensor)   ((sensor) < MTOUCH_SENSORS)
+#endif
     
     enum mtouch_sensor_error
     {
@@ -67,9 +236,15 @@
     #define MTOUCH_SENSOR_SAMPLE_MIN (0)
     #define MTOUCH_SENSOR_SAMPLE_MAX (UINT16_MAX)
 
+#if MTOUCH_SENSORS > 8
+    typedef uint16_t mtouch_sensor_mask_t;
+    #define MTOUCH_SENSOR_MASK_MIN (0)
+    #define MTOUCH_SENSOR_MASK_MAX (UINT16_MAX)
+#else
     typedef uint8_t mtouch_sensor_mask_t;
     #define MTOUCH_SENSOR_MASK_MIN (0)
     #define MTOUCH_SENSOR_MASK_MAX (UINT8_MAX)
+#endif
 
 /*
  * =======================================================================
@@ -92,6 +267,20 @@
     void                        MTOUCH_Sensor_Enable            (enum mtouch_sensor_names sensor);
     void                        MTOUCH_Sensor_Calibrate         (enum mtouch_sensor_names sensor); 
     mtouch_sensor_sample_t      MTOUCH_Sensor_RawSample_Get     (enum mtouch_sensor_names sensor);
+    uint8_t                     MTOUCH_Sensor_PacketNoise_Get   (enum mtouch_sensor_names sensor);
     
     void                        MTOUCH_Sensor_NotifyInterruptOccurred(void);
+    
+#ifdef MTOUCH_LOWPOWER
+    void                        MTOUCH_Sensor_LowPower_Set      (bool enable);
+    bool                        MTOUCH_Sensor_isIdle            (void);
+#endif
+#if MTOUCH_SENSOR_ROUNDCYCLES
+    uint32_t                    MTOUCH_Sensor_RoundCycles_Get   (void);
+#endif
+    
+#ifdef MTOUCH_SENSOR_SHARED
+    bool                        MTOUCH_Sensor_Acq_Collect       (void);
+    void                        MTOUCH_Sensor_Acq_Scan          (void);
+#endif
 #endif
\ No newline at end of file
@@ -35,155 +35,177 @@
 */
 #include <xc.h>
 
-#define MTOUCH_S0_ADCON0_SENSOR              ( 0x5<<2 | 0x1 )
-#define MTOUCH_S0_LAT                        LATC
-#define MTOUCH_S0_TRIS                       TRISC
-#define MTOUCH_S0_PIN                        1
-#define MTOUCH_S0_REF_ADCON0                 ( 0x5<<2 | 0x1 )
-#define MTOUCH_S0_REF_LAT                    LATC
-#define MTOUCH_S0_REF_PIN                    1
-#define MTOUCH_S0_PRECHARGE_TIME             10
-#define MTOUCH_S0_ACQUISITION_TIME           5
-#define MTOUCH_S0_SWITCH_TIME                0
-#define MTOUCH_S0_DISCON_TIME                3
+#include "mtouch_sensor.h"
+#include "mtouch_sensor_scan.h"
 
 
 /**
-* @prototype    void MTOUCH_CVD_ScanA_0
+* @prototype    MTOUCH_CVD_SCAN(n, phase, PRECHARGE, REFERENCE, DRIVE_SET, DRIVE_SWITCH)
 *
-* @description  CVD scanA for sensor 0
-*               - name:                         Sensor_AN5
-*               - pin:                          RC1
-*               - analog channel:               AN5
+* @description  Generates CVD scan routine MTOUCH_CVD_Scan<phase>_<n> for
+*               sensor n of the pin table in mtouch_sensor_scan.h
 *               - reference type:               MTOUCH_OPTION_REFTYPE_SELF
-*               - guard type:                   NONE
+*               - guard type:                   MTOUCH_SENSOR_DRIVE_TYPE(n)
 *
-*/
-void MTOUCH_CVD_ScanA_0(void)
-{
-    /* Initialize Precharge Source - Sensor itself RC1 */
-    asm("BANKSEL        LATC");
-    asm("bsf            LATC & 0x7F, 1");
-
-    /* Begin Precharge Stage */
-    asm("BANKSEL        ADCON0");
-    asm("movlw          ( 0x5<<2 | 0x1 )");
-    asm("movwf          ADCON0 & 0x7F");
-
-    /* Precharge Delay */
-    _delay(MTOUCH_S0_PRECHARGE_TIME);
-
-    /* Self-Reference Logic */
-    asm("movlw          113");
-    asm("movwf          ADCON0 & 0x7F");
-    asm("BANKSEL        LATC");
-    asm("bcf            LATC & 0x7F, 1");
-    asm("BANKSEL        ADCON0");
-
-    /* Prepare FSR0 for Settling Phase */
-    asm("movlw LOW      TRISC");
-    asm("movwf          FSR0L & 0x7F");
-    asm("movlw HIGH     TRISC");
-    asm("movwf          FSR0H & 0x7F");
-
-    /* Prepare FSR1 for Settling Phase */
-    asm("movlw LOW      LATC");
-    asm("movwf          FSR1L & 0x7F");
-    asm("movlw HIGH     LATC");
-    asm("movwf          FSR1H & 0x7F");
-
-    /* Begin Settling Stage: Connect */
-    asm("movlw          " ___mkstr(MTOUCH_S0_ADCON0_SENSOR));
-    asm("bsf            INDF0 & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-    _delay(MTOUCH_S0_SWITCH_TIME);
-    asm("movwf          ADCON0 & 0x7F");
-
-
-
-    /* Settling Delay */
-    _delay(MTOUCH_S0_ACQUISITION_TIME);
-
-    /* Begin Conversion */
-    asm("BANKSEL        ADCON0");
-    asm("bsf            ADCON0 & 0x7F, 1");
-
-    /* Disconnection Delay */
-    _delay(MTOUCH_S0_DISCON_TIME);
-
-    /* Exit Logic - Output Low */
-    asm("BANKSEL        LATC");
-    asm("bsf            LATC & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-    asm("bcf            INDF0 & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-
-}
-
-/**
-* @prototype    void MTOUCH_CVD_ScanB_0
+*               scanA precharges the sensor high (PRECHARGE "bsf"),
+*               scanB precharges it low (PRECHARGE "bcf"). The sensor is
+*               left driven at its precharge level on exit.
 *
-* @description    CVD scanB for sensor 0
-*                - name:                         Sensor_AN5
-*                - pin:                          RC1
-*                - analog channel:               AN5
-*                - reference type:               MTOUCH_OPTION_REFTYPE_SELF
-*                - guard type:                   NONE
+*               A drive line (guard, or the row of a matrix key) is set
+*               to DRIVE_SET with the sensor precharge and switched to
+*               DRIVE_SWITCH one cycle after the sensor is connected to
+*               the ADC, through FSR1 so no bank switch delays the edge.
+*               It is left at DRIVE_SWITCH on exit.
 *
 */
-void MTOUCH_CVD_ScanB_0(void)
-{
-    /* Initialize Precharge Source - Sensor itself RC1 */
-    asm("BANKSEL        LATC");
-    asm("bcf            LATC & 0x7F, 1");
-
-    /* Begin Precharge Stage */
-    asm("BANKSEL        ADCON0");
-    asm("movlw          ( 0x5<<2 | 0x1 )");
-    asm("movwf          ADCON0 & 0x7F");
-
-    /* Precharge Delay */
-    _delay(MTOUCH_S0_PRECHARGE_TIME);
-
-    /* Self-Reference Logic */
-    asm("movlw          113");
-    asm("movwf          ADCON0 & 0x7F");
-    asm("BANKSEL        LATC");
-    asm("bsf            LATC & 0x7F, 1");
-    asm("BANKSEL        ADCON0");
-
-    /* Prepare FSR0 for Settling Phase */
-    asm("movlw LOW      TRISC");
-    asm("movwf          FSR0L & 0x7F");
-    asm("movlw HIGH     TRISC");
-    asm("movwf          FSR0H & 0x7F");
-
-    /* Prepare FSR1 for Settling Phase */
-    asm("movlw LOW      LATC");
-    asm("movwf          FSR1L & 0x7F");
-    asm("movlw HIGH     LATC");
+#define MTOUCH_CVD_DRIVE_SET(n, LEVEL)          MTOUCH_CVD_DRIVE_SET_(MTOUCH_SENSOR_DRIVE_TYPE(n), n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SET_(type, n, LEVEL)   MTOUCH_CVD_DRIVE_SET__(type, n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SET__(type, n, LEVEL)  MTOUCH_CVD_DRIVE_SET_##type(n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SET_0(n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SET_1(n, LEVEL)                                                        \
+    asm("BANKSEL        " ___mkstr(MTOUCH_SENSOR_DRIVE(n, LAT)));                               \
+    asm(LEVEL "            " ___mkstr(MTOUCH_SENSOR_DRIVE(n, LAT)) " & 0x7F, " ___mkstr(MTOUCH_SENSOR_DRIVE(n, PIN)));
+
+#define MTOUCH_CVD_DRIVE_POINT(n)               MTOUCH_CVD_DRIVE_POINT_(MTOUCH_SENSOR_DRIVE_TYPE(n), n)
+#define MTOUCH_CVD_DRIVE_POINT_(type, n)        MTOUCH_CVD_DRIVE_POINT__(type, n)
+#define MTOUCH_CVD_DRIVE_POINT__(type, n)       MTOUCH_CVD_DRIVE_POINT_##type(n)
+#define MTOUCH_CVD_DRIVE_POINT_0(n)
+#define MTOUCH_CVD_DRIVE_POINT_1(n)                                                             \
+    asm("movlw LOW      " ___mkstr(MTOUCH_SENSOR_DRIVE(n, LAT)));                               \
+    asm("movwf          FSR1L & 0x7F");                                                         \
+    asm("movlw HIGH     " ___mkstr(MTOUCH_SENSOR_DRIVE(n, LAT)));                               \
     asm("movwf          FSR1H & 0x7F");
 
-    /* Begin Settling Stage: Connect */
-    asm("movlw          " ___mkstr(MTOUCH_S0_ADCON0_SENSOR));
-    asm("bsf            INDF0 & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-    _delay(MTOUCH_S0_SWITCH_TIME);
-    asm("movwf          ADCON0 & 0x7F");
-
-
-
-
-    /* Settling Delay */
-    _delay(MTOUCH_S0_ACQUISITION_TIME);
-
-    /* Begin Conversion */
-    asm("BANKSEL        ADCON0");
-    asm("bsf            ADCON0 & 0x7F, 1");
-
-    /* Disconnection Delay */
-    _delay(MTOUCH_S0_DISCON_TIME);
-
-    /* Exit Logic - Output Low */
-    asm("BANKSEL        LATC");
-    asm("bcf            LATC & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-    asm("bcf            INDF0 & 0x7F, " ___mkstr(MTOUCH_S0_PIN));
-
+#define MTOUCH_CVD_DRIVE_SWITCH(n, LEVEL)       MTOUCH_CVD_DRIVE_SWITCH_(MTOUCH_SENSOR_DRIVE_TYPE(n), n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SWITCH_(type, n, LEVEL)    MTOUCH_CVD_DRIVE_SWITCH__(type, n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SWITCH__(type, n, LEVEL)   MTOUCH_CVD_DRIVE_SWITCH_##type(n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SWITCH_0(n, LEVEL)
+#define MTOUCH_CVD_DRIVE_SWITCH_1(n, LEVEL)                                                     \
+    asm(LEVEL "            INDF1 & 0x7F, " ___mkstr(MTOUCH_SENSOR_DRIVE(n, PIN)));
+
+#define MTOUCH_CVD_SCAN(n, phase, PRECHARGE, REFERENCE, DRIVE_SET, DRIVE_SWITCH)                \
+void MTOUCH_CVD_Scan##phase##_##n(void)                                                         \
+{                                                                                               \
+    /* Initialize Precharge Source - Sensor itself */                                           \
+    asm("BANKSEL        " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)));                               \
+    asm(PRECHARGE "            " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)) " & 0x7F, " ___mkstr(MTOUCH_SENSOR_FIELD(n, PIN))); \
+    MTOUCH_CVD_DRIVE_SET(n, DRIVE_SET)                                                          \
+                                                                                                \
+    /* Begin Precharge Stage */                                                                 \
+    asm("BANKSEL        ADCON0");                                                               \
+    asm("movlw          " ___mkstr(MTOUCH_ADCON0_SENSOR(MTOUCH_SENSOR_FIELD(n, CHANNEL))));     \
+    asm("movwf          ADCON0 & 0x7F");                                                        \
+                                                                                                \
+    /* Precharge Delay */                                                                       \
+    _delay(MTOUCH_CVD_PRECHARGE_TIME);                                                          \
+                                                                                                \
+    /* Self-Reference Logic */                                                                  \
+    asm("movlw          113");                                                                  \
+    asm("movwf          ADCON0 & 0x7F");                                                        \
+    asm("BANKSEL        " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)));                               \
+    asm(REFERENCE "            " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)) " & 0x7F, " ___mkstr(MTOUCH_SENSOR_FIELD(n, PIN))); \
+    asm("BANKSEL        ADCON0");                                                               \
+                                                                                                \
+    /* Prepare FSR0 for Settling Phase */                                                       \
+    asm("movlw LOW      " ___mkstr(MTOUCH_SENSOR_FIELD(n, TRIS)));                              \
+    asm("movwf          FSR0L & 0x7F");                                                         \
+    asm("movlw HIGH     " ___mkstr(MTOUCH_SENSOR_FIELD(n, TRIS)));                              \
+    asm("movwf          FSR0H & 0x7F");                                                         \
+                                                                                                \
+    /* Prepare FSR1 for Settling Phase */                                                       \
+    asm("movlw LOW      " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)));                               \
+    asm("movwf          FSR1L & 0x7F");                                                         \
+    asm("movlw HIGH     " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)));                               \
+    asm("movwf          FSR1H & 0x7F");                                                         \
+    MTOUCH_CVD_DRIVE_POINT(n)                                                                   \
+                                                                                                \
+    /* Begin Settling Stage: Connect */                                                         \
+    asm("movlw          " ___mkstr(MTOUCH_ADCON0_SENSOR(MTOUCH_SENSOR_FIELD(n, CHANNEL))));     \
+    asm("bsf            INDF0 & 0x7F, " ___mkstr(MTOUCH_SENSOR_FIELD(n, PIN)));                 \
+    _delay(MTOUCH_CVD_SWITCH_TIME);                                                             \
+    asm("movwf          ADCON0 & 0x7F");                                                        \
+    MTOUCH_CVD_DRIVE_SWITCH(n, DRIVE_SWITCH)                                                    \
+                                                                                                \
+    /* Settling Delay */                                                                        \
+    _delay(MTOUCH_CVD_ACQUISITION_TIME);                                                        \
+                                                                                                \
+    /* Begin Conversion */                                                                      \
+    asm("BANKSEL        ADCON0");                                                               \
+    asm("bsf            ADCON0 & 0x7F, 1");                                                     \
+                                                                                                \
+    /* Disconnection Delay */                                                                   \
+    _delay(MTOUCH_CVD_DISCON_TIME);                                                             \
+                                                                                                \
+    /* Exit Logic - Output at the precharge level */                                            \
+    asm("BANKSEL        " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)));                               \
+    asm(PRECHARGE "            " ___mkstr(MTOUCH_SENSOR_FIELD(n, LAT)) " & 0x7F, " ___mkstr(MTOUCH_SENSOR_FIELD(n, PIN))); \
+    asm("bcf            INDF0 & 0x7F, " ___mkstr(MTOUCH_SENSOR_FIELD(n, PIN)));                 \
 }
 
+#ifdef MTOUCH_SENSOR_MATRIX
+/*
+ * The column precharges the same way in both phases and the row sets
+ * the phase: it rises on the connect in scanA and falls in scanB. The
+ * charge it pushes through the key's mutual capacitance moves the column
+ * up in scanA and down in scanB, so it adds once scanA is inverted, see
+ * Sensor_Acq_Collect(), while the column's own charge and interference
+ * move both phases alike and cancel.
+ */
+#define MTOUCH_CVD_SCAN_SENSOR(n)                                                               \
+    MTOUCH_CVD_SCAN(n, A, "bsf", "bcf", "bcf", "bsf")                                           \
+    MTOUCH_CVD_SCAN(n, B, "bsf", "bcf", "bsf", "bcf")
+#else
+/* The guard follows the sensor */
+#define MTOUCH_CVD_SCAN_SENSOR(n)                                                               \
+    MTOUCH_CVD_SCAN(n, A, "bsf", "bcf", "bsf", "bcf")                                           \
+    MTOUCH_CVD_SCAN(n, B, "bcf", "bsf", "bcf", "bsf")
+#endif
+
+#ifndef MTOUCH_SENSOR_SCAN_EXTERNAL
+MTOUCH_CVD_SCAN_SENSOR(0)
+#if MTOUCH_SENSORS > 1
+MTOUCH_CVD_SCAN_SENSOR(1)
+#endif
+#if MTOUCH_SENSORS > 2
+MTOUCH_CVD_SCAN_SENSOR(2)
+#endif
+#if MTOUCH_SENSORS > 3
+MTOUCH_CVD_SCAN_SENSOR(3)
+#endif
+#if MTOUCH_SENSORS > 4
+MTOUCH_CVD_SCAN_SENSOR(4)
+#endif
+#if MTOUCH_SENSORS > 5
+MTOUCH_CVD_SCAN_SENSOR(5)
+#endif
+#if MTOUCH_SENSORS > 6
+MTOUCH_CVD_SCAN_SENSOR(6)
+#endif
+#if MTOUCH_SENSORS > 7
+MTOUCH_CVD_SCAN_SENSOR(7)
+#endif
+#if MTOUCH_SENSORS > 8
+MTOUCH_CVD_SCAN_SENSOR(8)
+#endif
+#if MTOUCH_SENSORS > 9
+MTOUCH_CVD_SCAN_SENSOR(9)
+#endif
+#if MTOUCH_SENSORS > 10
+MTOUCH_CVD_SCAN_SENSOR(10)
+#endif
+#if MTOUCH_SENSORS > 11
+MTOUCH_CVD_SCAN_SENSOR(11)
+#endif
+#if MTOUCH_SENSORS > 12
+MTOUCH_CVD_SCAN_SENSOR(12)
+#endif
+#if MTOUCH_SENSORS > 13
+MTOUCH_CVD_SCAN_SENSOR(13)
+#endif
+#if MTOUCH_SENSORS > 14
+MTOUCH_CVD_SCAN_SENSOR(14)
+#endif
+#if MTOUCH_SENSORS > 15
+MTOUCH_CVD_SCAN_SENSOR(15)
+#endif
+#endif /* MTOUCH_SENSOR_SCAN_EXTERNAL */
@@ -36,7 +36,348 @@
 #ifndef MTOUCH_SENSOR_SCAN_H
 #define MTOUCH_SENSOR_SCAN_H
 
+    #include <stdint.h>
+    #include "mtouch_sensor.h"
+
+    #define MTOUCH_GUARD_NONE                   0
+    #define MTOUCH_GUARD_DRIVEN                 1
+
+#ifdef MTOUCH_SENSOR_MATRIX
+/*
+ * =======================================================================
+ * Sensor Pin Table, matrix build
+ * =======================================================================
+ *  column  pin     analog channel          row     pin
+ *  0       RC0     AN4                     0       RA2
+ *  1       RC1     AN5                     1       RA4
+ *  2       RC2     AN6                     2       RA0     shared with ICSPDAT
+ *  3       RC3     AN7                     3       RA1     shared with ICSPCLK
+ *
+ *  Sensor_R<r>C<c> is sensor 4*r+c, so consecutive scans move to the
+ *  next column. A column is measured like a self-capacitance key
+ *  precharged as for scanA in both phases. The row of the key is its
+ *  drive line and sets the phase: it rises as the column is connected
+ *  to the ADC in scanA and falls in scanB. The other rows hold their
+ *  level and couple no charge. A finger takes field lines away from the
+ *  row, which reads as a rising deviation like a self key.
+ *
+ *  Rows past MTOUCH_SENSOR_MATRIX_ROWS are not used; with 2 rows
+ *  RA0/RA1 are free.
+ */
+    #define MTOUCH_COL0_CHANNEL                 0x4
+    #define MTOUCH_COL0_LAT                     LATC
+    #define MTOUCH_COL0_TRIS                    TRISC
+    #define MTOUCH_COL0_ANSEL                   ANSELC
+    #define MTOUCH_COL0_WPU                     WPUC
+    #define MTOUCH_COL0_PIN                     0
+
+    #define MTOUCH_COL1_CHANNEL                 0x5
+    #define MTOUCH_COL1_LAT                     LATC
+    #define MTOUCH_COL1_TRIS                    TRISC
+    #define MTOUCH_COL1_ANSEL                   ANSELC
+    #define MTOUCH_COL1_WPU                     WPUC
+    #define MTOUCH_COL1_PIN                     1
+
+    #define MTOUCH_COL2_CHANNEL                 0x6
+    #define MTOUCH_COL2_LAT                     LATC
+    #define MTOUCH_COL2_TRIS                    TRISC
+    #define MTOUCH_COL2_ANSEL                   ANSELC
+    #define MTOUCH_COL2_WPU                     WPUC
+    #define MTOUCH_COL2_PIN                     2
+
+    #define MTOUCH_COL3_CHANNEL                 0x7
+    #define MTOUCH_COL3_LAT                     LATC
+    #define MTOUCH_COL3_TRIS                    TRISC
+    #define MTOUCH_COL3_ANSEL                   ANSELC
+    #define MTOUCH_COL3_WPU                     WPUC
+    #define MTOUCH_COL3_PIN                     3
+
+    #define MTOUCH_ROW0_LAT                     LATA
+    #define MTOUCH_ROW0_TRIS                    TRISA
+    #define MTOUCH_ROW0_ANSEL                   ANSELA
+    #define MTOUCH_ROW0_WPU                     WPUA
+    #define MTOUCH_ROW0_PIN                     2
+
+    #define MTOUCH_ROW1_LAT                     LATA
+    #define MTOUCH_ROW1_TRIS                    TRISA
+    #define MTOUCH_ROW1_ANSEL                   ANSELA
+    #define MTOUCH_ROW1_WPU                     WPUA
+    #define MTOUCH_ROW1_PIN                     4
+
+    #define MTOUCH_ROW2_LAT                     LATA
+    #define MTOUCH_ROW2_TRIS                    TRISA
+    #define MTOUCH_ROW2_ANSEL                   ANSELA
+    #define MTOUCH_ROW2_WPU                     WPUA
+    #define MTOUCH_ROW2_PIN                     0
+
+    #define MTOUCH_ROW3_LAT                     LATA
+    #define MTOUCH_ROW3_TRIS                    TRISA
+    #define MTOUCH_ROW3_ANSEL                   ANSELA
+    #define MTOUCH_ROW3_WPU                     WPUA
+    #define MTOUCH_ROW3_PIN                     1
+
+    #define MTOUCH_S0_ROW                       0
+    #define MTOUCH_S0_COL                       0
+    #define MTOUCH_S1_ROW                       0
+    #define MTOUCH_S1_COL                       1
+    #define MTOUCH_S2_ROW                       0
+    #define MTOUCH_S2_COL                       2
+    #define MTOUCH_S3_ROW                       0
+    #define MTOUCH_S3_COL                       3
+    #define MTOUCH_S4_ROW                       1
+    #define MTOUCH_S4_COL                       0
+    #define MTOUCH_S5_ROW                       1
+    #define MTOUCH_S5_COL                       1
+    #define MTOUCH_S6_ROW                       1
+    #define MTOUCH_S6_COL                       2
+    #define MTOUCH_S7_ROW                       1
+    #define MTOUCH_S7_COL                       3
+    #define MTOUCH_S8_ROW                       2
+    #define MTOUCH_S8_COL                       0
+    #define MTOUCH_S9_ROW                       2
+    #define MTOUCH_S9_COL                       1
+    #define MTOUCH_S10_ROW                      2
+    #define MTOUCH_S10_COL                      2
+    #define MTOUCH_S11_ROW                      2
+    #define MTOUCH_S11_COL                      3
+    #define MTOUCH_S12_ROW                      3
+    #define MTOUCH_S12_COL                      0
+    #define MTOUCH_S13_ROW                      3
+    #define MTOUCH_S13_COL                      1
+    #define MTOUCH_S14_ROW                      3
+    #define MTOUCH_S14_COL                      2
+    #define MTOUCH_S15_ROW                      3
+    #define MTOUCH_S15_COL                      3
+
+    /* Pin of sensor n: its column. Drive line: its row. */
+    #define MTOUCH_SENSOR_FIELD(n, field)       MTOUCH_MATRIX_FIELD_(COL, MTOUCH_S##n##_COL, field)
+    #define MTOUCH_SENSOR_DRIVE(n, field)       MTOUCH_MATRIX_FIELD_(ROW, MTOUCH_S##n##_ROW, field)
+    #define MTOUCH_SENSOR_DRIVE_TYPE(n)         MTOUCH_GUARD_DRIVEN
+    #define MTOUCH_MATRIX_FIELD_(line, i, field)    MTOUCH_MATRIX_FIELD__(line, i, field)
+    #define MTOUCH_MATRIX_FIELD__(line, i, field)   MTOUCH_##line##i##_##field
+
+#elif defined(MTOUCH_SENSOR_BOARD)
+/*
+ * =======================================================================
+ * Sensor Pin Table, project board
+ * =======================================================================
+ *  A project on another PIC or board builds with MTOUCH_SENSOR_BOARD
+ *  defined and supplies mtouch_board.h on its include path. It holds
+ *  the MTOUCH_Sn_* entries of the table below for its own pins, up to
+ *  MTOUCH_SENSORS, and may also set MTOUCH_SCAN_RESULT().
+ */
+    #include "mtouch_board.h"
+
+    #define MTOUCH_SENSOR_FIELD(n, field)       MTOUCH_S##n##_##field
+    #define MTOUCH_SENSOR_DRIVE(n, field)       MTOUCH_GUARD_##field
+    #define MTOUCH_SENSOR_DRIVE_TYPE(n)         MTOUCH_S##n##_GUARD
+
+#else
+/*
+ * =======================================================================
+ * Sensor Pin Table
+ * =======================================================================
+ *  index   name            pin     analog channel
+ *  0       Sensor_AN5      RC1     AN5
+ *  1       Sensor_AN4      RC0     AN4
+ *  2       Sensor_AN6      RC2     AN6
+ *  3       Sensor_AN7      RC3     AN7
+ *  4       Sensor_AN2      RA2     AN2
+ *  5       Sensor_AN3      RA4     AN3
+ *  6       Sensor_AN0      RA0     AN0     shared with ICSPDAT
+ *  7       Sensor_AN1      RA1     AN1     shared with ICSPCLK
+ *
+ *  The scan routines for every sensor in the table are generated in
+ *  mtouch_sensor_scan.c. Sensors past MTOUCH_SENSORS are not built.
+ *
+ *  MTOUCH_Sn_GUARD selects the guard type of each sensor:
+ *      MTOUCH_GUARD_NONE       self-reference only
+ *      MTOUCH_GUARD_DRIVEN     the guard pin follows the sensor, at the
+ *                              precharge level while the sensor charges
+ *                              and at the reference level from the moment
+ *                              it is connected to the ADC
+ *  A guard trace around the key and under its feed line then carries the
+ *  same voltage swing as the sensor, so a water film or a long trace adds
+ *  little charge. The quieter packets let the adaptive oversampling settle
+ *  on shorter packets for the same margin.
+ */
+    /* RA5, one guard for all guarded sensors, set up as a digital output by PIN_MANAGER_Initialize() */
+    #define MTOUCH_GUARD_LAT                    LATA
+    #define MTOUCH_GUARD_PIN                    5
+
+    #define MTOUCH_S0_CHANNEL                   0x5
+    #define MTOUCH_S0_LAT                       LATC
+    #define MTOUCH_S0_TRIS                      TRISC
+    #define MTOUCH_S0_ANSEL                     ANSELC
+    #define MTOUCH_S0_WPU                       WPUC
+    #define MTOUCH_S0_PIN                       1
+    #define MTOUCH_S0_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S1_CHANNEL                   0x4
+    #define MTOUCH_S1_LAT                       LATC
+    #define MTOUCH_S1_TRIS                      TRISC
+    #define MTOUCH_S1_ANSEL                     ANSELC
+    #define MTOUCH_S1_WPU                       WPUC
+    #define MTOUCH_S1_PIN                       0
+    #define MTOUCH_S1_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S2_CHANNEL                   0x6
+    #define MTOUCH_S2_LAT                       LATC
+    #define MTOUCH_S2_TRIS                      TRISC
+    #define MTOUCH_S2_ANSEL                     ANSELC
+    #define MTOUCH_S2_WPU                       WPUC
+    #define MTOUCH_S2_PIN                       2
+    #define MTOUCH_S2_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S3_CHANNEL                   0x7
+    #define MTOUCH_S3_LAT                       LATC
+    #define MTOUCH_S3_TRIS                      TRISC
+    #define MTOUCH_S3_ANSEL                     ANSELC
+    #define MTOUCH_S3_WPU                       WPUC
+    #define MTOUCH_S3_PIN                       3
+    #define MTOUCH_S3_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S4_CHANNEL                   0x2
+    #define MTOUCH_S4_LAT                       LATA
+    #define MTOUCH_S4_TRIS                      TRISA
+    #define MTOUCH_S4_ANSEL                     ANSELA
+    #define MTOUCH_S4_WPU                       WPUA
+    #define MTOUCH_S4_PIN                       2
+    #define MTOUCH_S4_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S5_CHANNEL                   0x3
+    #define MTOUCH_S5_LAT                       LATA
+    #define MTOUCH_S5_TRIS                      TRISA
+    #define MTOUCH_S5_ANSEL                     ANSELA
+    #define MTOUCH_S5_WPU                       WPUA
+    #define MTOUCH_S5_PIN                       4
+    #define MTOUCH_S5_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S6_CHANNEL                   0x0
+    #define MTOUCH_S6_LAT                       LATA
+    #define MTOUCH_S6_TRIS                      TRISA
+    #define MTOUCH_S6_ANSEL                     ANSELA
+    #define MTOUCH_S6_WPU                       WPUA
+    #define MTOUCH_S6_PIN                       0
+    #define MTOUCH_S6_GUARD                     MTOUCH_GUARD_NONE
+
+    #define MTOUCH_S7_CHANNEL                   0x1
+    #define MTOUCH_S7_LAT                       LATA
+    #define MTOUCH_S7_TRIS                      TRISA
+    #define MTOUCH_S7_ANSEL                     ANSELA
+    #define MTOUCH_S7_WPU                       WPUA
+    #define MTOUCH_S7_PIN                       1
+    #define MTOUCH_S7_GUARD                     MTOUCH_GUARD_NONE
+
+    /* Pin of sensor n: its table entry. Drive line: the guard. */
+    #define MTOUCH_SENSOR_FIELD(n, field)       MTOUCH_S##n##_##field
+    #define MTOUCH_SENSOR_DRIVE(n, field)       MTOUCH_GUARD_##field
+    #define MTOUCH_SENSOR_DRIVE_TYPE(n)         MTOUCH_S##n##_GUARD
+
+#endif
+
+    #define MTOUCH_ADCON0_SENSOR(channel)       ( channel<<2 | 0x1 )
+
+/*
+ * =======================================================================
+ * Scan Timing, common to all sensors
+ * =======================================================================
+ */
+    #define MTOUCH_CVD_PRECHARGE_TIME           10
+    #define MTOUCH_CVD_ACQUISITION_TIME         5
+    #define MTOUCH_CVD_SWITCH_TIME              0
+    #define MTOUCH_CVD_DISCON_TIME              3
+
+/*
+ * =======================================================================
+ * Scan Hardware Seam
+ * =======================================================================
+ *  The acquisition reaches the ADC only through the scan routines and
+ *  MTOUCH_SCAN_RESULT(). Defining MTOUCH_SENSOR_SCAN_EXTERNAL leaves the
+ *  asm routines out of mtouch_sensor_scan.c, so a build against a model
+ *  of the sensors can supply MTOUCH_CVD_ScanA_n/ScanB_n and its own
+ *  MTOUCH_SCAN_RESULT() while running the unchanged acquisition, baseline
+ *  and button code.
+ */
+    #ifndef MTOUCH_SCAN_RESULT
+    #define MTOUCH_SCAN_RESULT()                ADRES
+    #endif
+
+/*
+ * =======================================================================
+ * Pin Access Table Entry
+ * =======================================================================
+ *  Used by the C side of the scan: pin setup and precharge of the next
+ *  sensor while the current conversion runs.
+ */
+    typedef void(*scanFunction)(void);
+
+    typedef struct
+    {
+        const scanFunction              scanA;
+        const scanFunction              scanB;
+        volatile uint8_t*   const       lat;
+        volatile uint8_t*   const       tris;
+        volatile uint8_t*   const       ansel;
+        volatile uint8_t*   const       wpu;
+        const uint8_t                   mask;
+#ifdef MTOUCH_SENSOR_MATRIX
+        volatile uint8_t*   const       row_lat;
+        volatile uint8_t*   const       row_tris;
+        volatile uint8_t*   const       row_ansel;
+        volatile uint8_t*   const       row_wpu;
+        const uint8_t                   row_mask;
+#endif
+    } mtouch_sensor_pin_t;
+
+#ifdef MTOUCH_SENSOR_MATRIX
+    #define MTOUCH_SENSOR_PIN(n)                                                            \
+        {   MTOUCH_CVD_ScanA_##n, MTOUCH_CVD_ScanB_##n,                                     \
+            &MTOUCH_SENSOR_FIELD(n, LAT), &MTOUCH_SENSOR_FIELD(n, TRIS),                    \
+            &MTOUCH_SENSOR_FIELD(n, ANSEL), &MTOUCH_SENSOR_FIELD(n, WPU),                   \
+            (uint8_t)(1<<MTOUCH_SENSOR_FIELD(n, PIN)),                                      \
+            &MTOUCH_SENSOR_DRIVE(n, LAT), &MTOUCH_SENSOR_DRIVE(n, TRIS),                    \
+            &MTOUCH_SENSOR_DRIVE(n, ANSEL), &MTOUCH_SENSOR_DRIVE(n, WPU),                   \
+            (uint8_t)(1<<MTOUCH_SENSOR_DRIVE(n, PIN)) }
+#else
+    #define MTOUCH_SENSOR_PIN(n)                                                            \
+        {   MTOUCH_CVD_ScanA_##n, MTOUCH_CVD_ScanB_##n,                                     \
+            &MTOUCH_SENSOR_FIELD(n, LAT), &MTOUCH_SENSOR_FIELD(n, TRIS),                    \
+            &MTOUCH_SENSOR_FIELD(n, ANSEL), &MTOUCH_SENSOR_FIELD(n, WPU),                   \
+            (uint8_t)(1<<MTOUCH_SENSOR_FIELD(n, PIN)) }
+#endif
+
     void MTOUCH_CVD_ScanA_0(void);
     void MTOUCH_CVD_ScanB_0(void);
+    void MTOUCH_CVD_ScanA_1(void);
+    void MTOUCH_CVD_ScanB_1(void);
+    void MTOUCH_CVD_ScanA_2(void);
+    void MTOUCH_CVD_ScanB_2(void);
+    void MTOUCH_CVD_ScanA_3(void);
+    void MTOUCH_CVD_ScanB_3(void);
+    void MTOUCH_CVD_ScanA_4(void);
+    void MTOUCH_CVD_ScanB_4(void);
+    void MTOUCH_CVD_ScanA_5(void);
+    void MTOUCH_CVD_ScanB_5(void);
+    void MTOUCH_CVD_ScanA_6(void);
+    void MTOUCH_CVD_ScanB_6(void);
+    void MTOUCH_CVD_ScanA_7(void);
+    void MTOUCH_CVD_ScanB_7(void);
+    void MTOUCH_CVD_ScanA_8(void);
+    void MTOUCH_CVD_ScanB_8(void);
+    void MTOUCH_CVD_ScanA_9(void);
+    void MTOUCH_CVD_ScanB_9(void);
+    void MTOUCH_CVD_ScanA_10(void);
+    void MTOUCH_CVD_ScanB_10(void);
+    void MTOUCH_CVD_ScanA_11(void);
+    void MTOUCH_CVD_ScanB_11(void);
+    void MTOUCH_CVD_ScanA_12(void);
+    void MTOUCH_CVD_ScanB_12(void);
+    void MTOUCH_CVD_ScanA_13(void);
+    void MTOUCH_CVD_ScanB_13(void);
+    void MTOUCH_CVD_ScanA_14(void);
+    void MTOUCH_CVD_ScanB_14(void);
+    void MTOUCH_CVD_ScanA_15(void);
+    void MTOUCH_CVD_ScanB_15(void);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,368 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mtouch.h"
+#include "mtouch_slider.h"
+
+#if MTOUCH_SLIDERS > 0
+/*
+ * =======================================================================
+ * Slider Type Structure
+ * =======================================================================
+ */
+    typedef struct
+    {
+              mtouch_slider_position_t      position;
+              int16_t                       velocity;   /* counts per round << (FRACTION + GAIN) */
+              unsigned                      active  :1;
+              unsigned                      tracking:1;
+    } mtouch_slider_t;
+
+    /* Fixed part of the configuration, kept in program memory */
+    typedef struct
+    {
+        const enum mtouch_button_names*     buttons;
+        const uint8_t                       count;
+        const enum mtouch_slider_type       type;
+        const uint8_t                       segment;    /* position counts between two buttons */
+        const mtouch_button_deviation_t     threshold;
+    } mtouch_slider_config_t;
+
+    #define MTOUCH_SLIDER_BUTTONS_COUNT(list)   (uint8_t)(sizeof(list)/sizeof(enum mtouch_button_names))
+
+    /* A slider spans 0..255 over count-1 segments, a wheel spans 256 over count */
+    #define MTOUCH_SLIDER_SEGMENT(list, type)                                   \
+        (uint8_t)(((type) == MTOUCH_SLIDER_TYPE_wheel)                          \
+            ? (256u / MTOUCH_SLIDER_BUTTONS_COUNT(list))                        \
+            : (255u / (MTOUCH_SLIDER_BUTTONS_COUNT(list) - 1u)))
+
+    #define MTOUCH_SLIDER_CONFIG(n)                                             \
+        {   slider##n##_buttons,                                                \
+            MTOUCH_SLIDER_BUTTONS_COUNT(slider##n##_buttons),                   \
+            MTOUCH_SLIDER_TYPE_Slider##n,                                       \
+            MTOUCH_SLIDER_SEGMENT(slider##n##_buttons, MTOUCH_SLIDER_TYPE_Slider##n), \
+            (mtouch_button_deviation_t)MTOUCH_SLIDER_THRESHOLD_Slider##n        \
+        }
+
+    static const enum mtouch_button_names slider0_buttons[] = { MTOUCH_SLIDER_BUTTONS_Slider0 };
+
+    const  mtouch_slider_config_t mtouch_slider_config[MTOUCH_SLIDERS] =
+    {
+        MTOUCH_SLIDER_CONFIG(0)
+    };
+
+    static mtouch_slider_t mtouch_slider[MTOUCH_SLIDERS];
+
+/*
+ * =======================================================================
+ *  Reciprocal Table
+ * =======================================================================
+ *  (16384 / (64 + i)) - 128 for a denominator normalized to 64..127.
+ *  Keeps the centroid free of a software divide.
+ */
+    static const uint8_t Slider_Reciprocal[64] =
+    {
+        128,124,120,117,113,109,106,103,100, 96, 93, 90, 88, 85, 82, 79,
+         77, 74, 72, 69, 67, 65, 63, 60, 58, 56, 54, 52, 50, 48, 46, 44,
+         43, 41, 39, 37, 36, 34, 33, 31, 30, 28, 27, 25, 24, 22, 21, 20,
+         18, 17, 16, 14, 13, 12, 11, 10,  9,  7,  6,  5,  4,  3,  2,  1
+    };
+
+/*
+ * =======================================================================
+ *  Local Functions
+ * =======================================================================
+ */
+static void                     Slider_Service              (enum mtouch_slider_names name);
+static uint8_t                  Slider_Deviation_Get        (enum mtouch_button_names button);
+static int16_t                  Slider_Centroid_Offset      (int16_t numerator, uint16_t denominator, uint8_t segment);
+static void                     Slider_Position_Update      (mtouch_slider_t* slider, mtouch_slider_position_t raw, bool wheel);
+static void                     Slider_Baseline_Hold        (const mtouch_slider_config_t* config, bool hold);
+
+/*
+ * =======================================================================
+ *  MTOUCH_Slider_InitializeAll
+ * =======================================================================
+ */
+void MTOUCH_Slider_InitializeAll(void)
+{
+    enum mtouch_slider_names slider;
+
+    for (slider = 0; slider < MTOUCH_SLIDERS; slider++)
+    {
+        mtouch_slider[slider].position  = (mtouch_slider_position_t)0;
+        mtouch_slider[slider].velocity  = 0;
+        mtouch_slider[slider].active    = 0;
+        mtouch_slider[slider].tracking  = 0;
+        Slider_Baseline_Hold(&mtouch_slider_config[slider], false);
+    }
+}
+
+/*
+ * =======================================================================
+ *  MTOUCH_Slider_ServiceAll
+ * =======================================================================
+ *  Runs after MTOUCH_Button_ServiceAll so the deviations are current.
+ *  The buttons under a slider keep working as buttons.
+ */
+void MTOUCH_Slider_ServiceAll(void)
+{
+    enum mtouch_slider_names slider;
+    for (slider = 0; slider < MTOUCH_SLIDERS; slider++)
+    {
+        Slider_Service(slider);
+    }
+}
+
+static void Slider_Service(enum mtouch_slider_names name)
+{
+    mtouch_slider_t*                slider = &mtouch_slider[name];
+    const mtouch_slider_config_t*   config = &mtouch_slider_config[name];
+    bool                            wheel  = (config->type == MTOUCH_SLIDER_TYPE_wheel) ? true : false;
+    uint8_t                         i;
+    uint8_t                         peak_index = 0;
+    uint8_t                         peak  = 0;
+    uint8_t                         prev;
+    uint8_t                         next;
+    uint8_t                         deviation;
+    int16_t                         raw;
+
+    /* Find the button with the largest deviation */
+    for (i = 0; i < config->count; i++)
+    {
+        deviation = Slider_Deviation_Get(config->buttons[i]);
+        if (deviation > peak)
+        {
+            peak       = deviation;
+            peak_index = i;
+        }
+    }
+
+    /* Activity with the same hysteresis as a button */
+    if (slider->active)
+    {
+        if (peak < (uint8_t)(config->threshold >> 1))
+        {
+            slider->active   = 0;
+            slider->tracking = 0;
+            slider->velocity = 0;
+            Slider_Baseline_Hold(config, false);
+        }
+    }
+    else if (peak > (uint8_t)config->threshold)
+    {
+        slider->active = 1;
+        Slider_Baseline_Hold(config, true);
+    }
+    if (!slider->active)
+    {
+        return;
+    }
+
+    /* Neighbours of the peak; a wheel wraps around, a slider ends at zero */
+    if (peak_index > 0)
+        prev = Slider_Deviation_Get(config->buttons[peak_index - 1]);
+    else
+        prev = wheel ? Slider_Deviation_Get(config->buttons[config->count - 1]) : 0;
+
+    if (peak_index < (uint8_t)(config->count - 1))
+        next = Slider_Deviation_Get(config->buttons[peak_index + 1]);
+    else
+        next = wheel ? Slider_Deviation_Get(config->buttons[0]) : 0;
+
+    /* Three point centroid around the peak */
+    raw  = (int16_t)((uint16_t)peak_index * config->segment);
+    raw += Slider_Centroid_Offset((int16_t)next - (int16_t)prev,
+                                  (uint16_t)prev + peak + next,
+                                  config->segment);
+
+    if (wheel)
+    {
+        raw &= 0xFF;
+    }
+    else if (raw < MTOUCH_SLIDER_POSITION_MIN)
+    {
+        raw = MTOUCH_SLIDER_POSITION_MIN;
+    }
+    else if (raw > MTOUCH_SLIDER_POSITION_MAX)
+    {
+        raw = MTOUCH_SLIDER_POSITION_MAX;
+    }
+
+    Slider_Position_Update(slider, (mtouch_slider_position_t)raw, wheel);
+}
+
+/* The finger's share on the buttons beside the peak stays out of their baselines */
+static void Slider_Baseline_Hold(const mtouch_slider_config_t* config, bool hold)
+{
+    uint8_t i;
+
+    for (i = 0; i < config->count; i++)
+    {
+        MTOUCH_Button_Baseline_Hold(config->buttons[i], hold);
+    }
+}
+
+/*
+ *  Noise, negative deviations and buttons still initializing do not
+ *  pull the centroid: a button the finger is not on would otherwise
+ *  move the position by its noise whenever the peak changes sides.
+ */
+static uint8_t Slider_Deviation_Get(enum mtouch_button_names button)
+{
+    mtouch_button_deviation_t deviation;
+
+    if (!MTOUCH_Button_isInitialized(button))
+        return 0;
+
+    deviation = MTOUCH_Button_Deviation_Get(button);
+    return (deviation > MTOUCH_SLIDER_NOISE) ? (uint8_t)(deviation - MTOUCH_SLIDER_NOISE) : 0;
+}
+
+/*
+ *  segment * numerator / denominator
+ *
+ *  The denominator is shifted into 64..127 and the divide becomes a
+ *  multiply by the table reciprocal. Error is within 3 position counts,
+ *  which the position hysteresis absorbs.
+ */
+static int16_t Slider_Centroid_Offset(int16_t numerator, uint16_t denominator, uint8_t segment)
+{
+    int32_t product;
+    uint8_t shift = 14;
+
+    if (denominator == 0u)
+        return 0;
+
+    while (denominator > 127u)
+    {
+        denominator >>= 1;
+        shift++;
+    }
+    while (denominator < 64u)
+    {
+        denominator <<= 1;
+        shift--;
+    }
+
+    product  = (int32_t)numerator * segment;
+    product *= (int16_t)Slider_Reciprocal[denominator - 64u] + 128;
+    return (int16_t)(product >> shift); /* XC8 compiler will extend sign bit of signed values */
+}
+
+static void Slider_Position_Update(mtouch_slider_t* slider, mtouch_slider_position_t raw, bool wheel)
+{
+    int16_t delta;
+    mtouch_slider_position_t position;
+
+    if (!slider->tracking)
+    {
+        slider->position = raw;
+        slider->velocity = 0;
+        slider->tracking = 1;
+        return;
+    }
+
+    /* A wheel takes the short way around */
+    delta = (int16_t)raw - (int16_t)slider->position;
+    if (wheel)
+    {
+        delta = (int16_t)(int8_t)(uint8_t)delta;
+    }
+
+    /* Report only moves larger than the hysteresis, then follow at its edge */
+    position = slider->position;
+    if (delta > (int16_t)MTOUCH_SLIDER_HYSTERESIS)
+    {
+        position = (mtouch_slider_position_t)(raw - MTOUCH_SLIDER_HYSTERESIS);
+    }
+    else if (delta < -(int16_t)MTOUCH_SLIDER_HYSTERESIS)
+    {
+        position = (mtouch_slider_position_t)(raw + MTOUCH_SLIDER_HYSTERESIS);
+    }
+
+    delta = (int16_t)position - (int16_t)slider->position;
+    if (wheel)
+    {
+        delta = (int16_t)(int8_t)(uint8_t)delta;
+    }
+    slider->position = position;
+
+    /* Velocity first order filtered, scaled up so a slow move of under a
+     * count per round still shows and the shift rounds both ways alike */
+    slider->velocity += (int16_t)(delta * (1 << MTOUCH_SLIDER_VELOCITY_FRACTION))
+                      - (slider->velocity >> MTOUCH_SLIDER_VELOCITY_GAIN); /* XC8 compiler will extend sign bit of signed values */
+}
+
+/*
+ * =======================================================================
+ * Slider State and Position
+ * =======================================================================
+ */
+bool MTOUCH_Slider_isActive(enum mtouch_slider_names name)
+{
+    if(name < MTOUCH_SLIDERS)
+        return (mtouch_slider[name].active) ? true : false;
+    else
+        return false;
+}
+
+mtouch_slider_position_t MTOUCH_Slider_Position_Get(enum mtouch_slider_names name)
+{
+    if(name < MTOUCH_SLIDERS)
+        return mtouch_slider[name].position;
+    else
+        return (mtouch_slider_position_t)0;
+}
+
+mtouch_slider_velocity_t MTOUCH_Slider_Velocity_Get(enum mtouch_slider_names name)
+{
+    int16_t velocity;
+
+    if(name >= MTOUCH_SLIDERS)
+        return (mtouch_slider_velocity_t)0;
+
+    velocity = mtouch_slider[name].velocity >> MTOUCH_SLIDER_VELOCITY_GAIN;
+    if(velocity < MTOUCH_SLIDER_VELOCITY_MIN)
+        velocity = MTOUCH_SLIDER_VELOCITY_MIN;
+    if(velocity > MTOUCH_SLIDER_VELOCITY_MAX)
+        velocity = MTOUCH_SLIDER_VELOCITY_MAX;
+    return (mtouch_slider_velocity_t)velocity;
+}
+#endif
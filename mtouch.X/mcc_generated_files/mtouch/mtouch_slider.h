@@ -0,0 +1,115 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#ifndef MTOUCH_SLIDER_H
+#define MTOUCH_SLIDER_H
+    
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include "mtouch.h"
+    
+/*
+ * =======================================================================
+ * Application / Configuration Settings
+ * =======================================================================
+ *  A slider or wheel is a row of adjacent buttons. The position is the
+ *  centroid of the peak button deviation and its two neighbours, 0..255
+ *  along a slider or once around a wheel.
+ */
+    /* 1 builds Slider0 on Button1..Button4; off by default */
+    #ifndef MTOUCH_SLIDERS
+    #define MTOUCH_SLIDERS 0
+    #endif
+
+    #if MTOUCH_SLIDERS > 0 && MTOUCH_BUTTONS < 5
+        #error Slider0 needs MTOUCH_BUTTONS of 5 or more
+    #endif
+    
+    enum mtouch_slider_names
+    {
+        Slider0 = 0
+    };
+
+    enum mtouch_slider_type
+    {
+        MTOUCH_SLIDER_TYPE_slider   = 0,    /* ends at 0 and 255 */
+        MTOUCH_SLIDER_TYPE_wheel    = 1     /* 255 wraps around to 0 */
+    };
+
+    #define MTOUCH_SLIDER_BUTTONS_Slider0   Button1, Button2, Button3, Button4
+    #ifndef MTOUCH_SLIDER_TYPE_Slider0
+    #define MTOUCH_SLIDER_TYPE_Slider0      MTOUCH_SLIDER_TYPE_slider
+    #endif
+    #define MTOUCH_SLIDER_THRESHOLD_Slider0 50
+    
+    #define MTOUCH_SLIDER_NOISE             ((mtouch_button_deviation_t)8)  /* deviation left out of the centroid */
+    #define MTOUCH_SLIDER_HYSTERESIS        ((mtouch_slider_position_t)4)
+    #define MTOUCH_SLIDER_VELOCITY_GAIN     ((uint8_t)2)    /* velocity filter time constant in rounds, 2^n */
+    #define MTOUCH_SLIDER_VELOCITY_FRACTION ((uint8_t)4)    /* velocity in counts per 2^n rounds */
+	
+/*
+ * =======================================================================
+ * Typedefs / Data Types
+ * =======================================================================
+ */
+    typedef uint8_t mtouch_slider_position_t;
+    #define MTOUCH_SLIDER_POSITION_MIN (0)
+    #define MTOUCH_SLIDER_POSITION_MAX (UINT8_MAX)
+
+    typedef int8_t mtouch_slider_velocity_t;
+    #define MTOUCH_SLIDER_VELOCITY_MIN (INT8_MIN)
+    #define MTOUCH_SLIDER_VELOCITY_MAX (INT8_MAX)
+
+/*
+ * =======================================================================
+ * Global Functions
+ * =======================================================================
+ */
+#if MTOUCH_SLIDERS > 0
+    void                        MTOUCH_Slider_InitializeAll (void);
+    void                        MTOUCH_Slider_ServiceAll    (void);
+    
+    bool                        MTOUCH_Slider_isActive      (enum mtouch_slider_names slider);
+    mtouch_slider_position_t    MTOUCH_Slider_Position_Get  (enum mtouch_slider_names slider);
+    mtouch_slider_velocity_t    MTOUCH_Slider_Velocity_Get  (enum mtouch_slider_names slider);
+#else
+    /* No slider in this build, the calls fold away */
+    #define MTOUCH_Slider_InitializeAll()
+    #define MTOUCH_Slider_ServiceAll()
+    #define MTOUCH_Slider_isActive(slider)      (false)
+    #define MTOUCH_Slider_Position_Get(slider)  ((mtouch_slider_position_t)0)
+    #define MTOUCH_Slider_Velocity_Get(slider)  ((mtouch_slider_velocity_t)0)
+#endif
+#endif // MTOUCH_SLIDER_H
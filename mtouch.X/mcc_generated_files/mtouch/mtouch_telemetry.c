@@ -0,0 +1,222 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mtouch.h"
+#include "mtouch_telemetry.h"
+#include "mcc.h"
+
+#ifdef MTOUCH_TELEMETRY
+
+#define TELEMETRY_BUFFER_MASK   (uint8_t)(MTOUCH_TELEMETRY_BUFFER_SIZE-1)
+#define TELEMETRY_DATA_BITS     (uint8_t)8
+
+/*
+ * =======================================================================
+ *  Local Variables
+ * =======================================================================
+ *  The mainloop writes tx_buffer and tx_head, the TMR0 interrupt reads
+ *  them and owns everything else on the TX side.
+ */
+    static uint8_t              tx_buffer[MTOUCH_TELEMETRY_BUFFER_SIZE];
+    static volatile uint8_t     tx_head;
+    static volatile uint8_t     tx_tail;
+    static uint8_t              tx_shift;
+    static uint8_t              tx_bits;        /* data and stop bits still to go */
+    static uint8_t              tx_level;       /* driven at the next bit edge */
+
+    static enum mtouch_button_names telemetry_cursor;
+    static uint8_t              telemetry_round;
+    static uint8_t              telemetry_checksum;
+    static uint16_t             telemetry_skipped;
+
+/*
+ * =======================================================================
+ *  Local Functions
+ * =======================================================================
+ */
+static void     Telemetry_TX_ISR    (void);
+static uint8_t  Telemetry_Free      (void);
+static void     Telemetry_Put       (uint8_t data);
+static void     Telemetry_Record    (enum mtouch_button_names button);
+
+/*
+ * =======================================================================
+ *  MTOUCH_Telemetry_Initialize
+ * =======================================================================
+ */
+void MTOUCH_Telemetry_Initialize(void)
+{
+    INTCONbits.TMR0IE   = 0;
+    TX_SetHigh();
+    tx_head             = 0;
+    tx_tail             = 0;
+    tx_bits             = 0;
+    tx_level            = 1;
+    telemetry_cursor    = (enum mtouch_button_names)0;
+    telemetry_round     = 0;
+    telemetry_skipped   = 0;
+    TMR0_SetInterruptHandler(Telemetry_TX_ISR);
+}
+
+/*
+ * =======================================================================
+ *  MTOUCH_Telemetry_Service
+ * =======================================================================
+ *  Called once per processed round, after the buttons are serviced.
+ *  Queues as many button records as fit and starts the transmitter.
+ */
+void MTOUCH_Telemetry_Service(void)
+{
+    uint8_t count;
+
+    telemetry_round++;
+    for(count = 0; count < (uint8_t)MTOUCH_BUTTONS; count++)
+    {
+        if(Telemetry_Free() < (uint8_t)MTOUCH_TELEMETRY_RECORD_SIZE)
+        {
+            telemetry_skipped += (uint16_t)((uint8_t)MTOUCH_BUTTONS - count);
+            break;
+        }
+        Telemetry_Record(telemetry_cursor);
+        if(++telemetry_cursor >= MTOUCH_BUTTONS)
+            telemetry_cursor = (enum mtouch_button_names)0;
+    }
+
+    if(INTCONbits.TMR0IE == 0 && tx_head != tx_tail)
+    {
+        INTCONbits.TMR0IF = 0;                      /* first overflow only fetches the byte */
+        INTCONbits.TMR0IE = 1;
+    }
+}
+
+/* true while bytes are queued or going out; the device must not sleep */
+bool MTOUCH_Telemetry_isBusy(void)
+{
+    return (INTCONbits.TMR0IE) ? true : false;
+}
+
+/* button records left out because the buffer was full */
+uint16_t MTOUCH_Telemetry_Skipped_Get(void)
+{
+    return telemetry_skipped;
+}
+
+/*
+ * =======================================================================
+ *  Telemetry_Record
+ * =======================================================================
+ */
+static void Telemetry_Record(enum mtouch_button_names button)
+{
+    enum mtouch_sensor_names    sensor  = MTOUCH_Button_Sensor_Get(button);
+    mtouch_sensor_sample_t      raw     = MTOUCH_Sensor_RawSample_Get(sensor);
+    mtouch_button_reading_t     base    = MTOUCH_Button_Baseline_Get(button);
+    uint8_t                     state   = 0;
+
+    if(MTOUCH_Sensor_isActive(sensor))
+        state |= MTOUCH_TELEMETRY_STATE_active;
+    if(MTOUCH_Button_isPressed(button))
+        state |= MTOUCH_TELEMETRY_STATE_pressed;
+    if(MTOUCH_Button_isInitialized(button))
+        state |= MTOUCH_TELEMETRY_STATE_initialized;
+
+    Telemetry_Put(MTOUCH_TELEMETRY_SYNC);
+    telemetry_checksum = 0;
+    Telemetry_Put((uint8_t)((uint8_t)sensor << 4 | (uint8_t)button));
+    Telemetry_Put(telemetry_round);
+    Telemetry_Put((uint8_t)raw);
+    Telemetry_Put((uint8_t)(raw >> 8));
+    Telemetry_Put((uint8_t)base);
+    Telemetry_Put((uint8_t)(base >> 8));
+    Telemetry_Put((uint8_t)MTOUCH_Button_Deviation_Get(button));
+    Telemetry_Put(MTOUCH_Sensor_PacketNoise_Get(sensor));
+    Telemetry_Put(state);
+    Telemetry_Put((uint8_t)(0 - telemetry_checksum));
+}
+
+static uint8_t Telemetry_Free(void)
+{
+    return (uint8_t)(TELEMETRY_BUFFER_MASK - ((uint8_t)(tx_head - tx_tail) & TELEMETRY_BUFFER_MASK));
+}
+
+static void Telemetry_Put(uint8_t data)
+{
+    tx_buffer[tx_head]  = data;
+    tx_head             = (uint8_t)(tx_head + 1) & TELEMETRY_BUFFER_MASK;
+    telemetry_checksum += data;
+}
+
+/*
+ * =======================================================================
+ *  Telemetry_TX_ISR
+ * =======================================================================
+ *  TMR0 overflow, once per bit. The level for this edge was worked out
+ *  on the previous overflow, so the edge only moves with the interrupt
+ *  latency. A stop bit is followed at once by the next start bit while
+ *  bytes are queued; with the buffer empty the interrupt turns itself
+ *  off and the line stays idle high.
+ */
+static void Telemetry_TX_ISR(void)
+{
+    TX_LAT = tx_level;
+
+    if(tx_bits > (uint8_t)1)
+    {
+        tx_level = tx_shift & 0x01;
+        tx_shift >>= 1;
+        tx_bits--;
+    }
+    else if(tx_bits == (uint8_t)1)
+    {
+        tx_level = 1;                               /* stop bit */
+        tx_bits  = 0;
+    }
+    else if(tx_tail != tx_head)
+    {
+        tx_shift = tx_buffer[tx_tail];
+        tx_tail  = (uint8_t)(tx_tail + 1) & TELEMETRY_BUFFER_MASK;
+        tx_level = 0;                               /* start bit */
+        tx_bits  = TELEMETRY_DATA_BITS + 1;
+    }
+    else
+    {
+        INTCONbits.TMR0IE = 0;
+    }
+}
+#endif
@@ -0,0 +1,110 @@
+/*
+    MICROCHIP SOFTWARE NOTICE AND DISCLAIMER:
+
+    You may use this software, and any derivatives created by any person or
+    entity by or on your behalf, exclusively with Microchip's products.
+    Microchip and its subsidiaries ("Microchip"), and its licensors, retain all
+    ownership and intellectual property rights in the accompanying software and
+    in all derivatives hereto.
+
+    This software and any accompanying information is for suggestion only. It
+    does not modify Microchip's standard warranty for its products.  You agree
+    that you are solely responsible for testing the software and determining
+    its suitability.  Microchip has no obligation to modify, test, certify, or
+    support the software.
+
+    THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS".  NO WARRANTIES, WHETHER
+    EXPRESS, IMPLIED OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED
+    WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+    PARTICULAR PURPOSE APPLY TO THIS SOFTWARE, ITS INTERACTION WITH MICROCHIP'S
+    PRODUCTS, COMBINATION WITH ANY OTHER PRODUCTS, OR USE IN ANY APPLICATION.
+
+    IN NO EVENT, WILL MICROCHIP BE LIABLE, WHETHER IN CONTRACT, WARRANTY, TORT
+    (INCLUDING NEGLIGENCE OR BREACH OF STATUTORY DUTY), STRICT LIABILITY,
+    INDEMNITY, CONTRIBUTION, OR OTHERWISE, FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+    EXEMPLARY, INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, FOR COST OR EXPENSE OF
+    ANY KIND WHATSOEVER RELATED TO THE SOFTWARE, HOWSOEVER CAUSED, EVEN IF
+    MICROCHIP HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE
+    FORESEEABLE.  TO THE FULLEST EXTENT ALLOWABLE BY LAW, MICROCHIP'S TOTAL
+    LIABILITY ON ALL CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED
+    THE AMOUNT OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR
+    THIS SOFTWARE.
+
+    MICROCHIP PROVIDES THIS SOFTWARE CONDITIONALLY UPON YOUR ACCEPTANCE OF
+    THESE TERMS.
+*/
+#ifndef MTOUCH_TELEMETRY_H
+#define MTOUCH_TELEMETRY_H
+    
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include "mtouch.h"
+    
+/*
+ * =======================================================================
+ * Application / Configuration Settings
+ * =======================================================================
+ *  Streams the button tuning values to a host for threshold and scaling
+ *  work. Build with MTOUCH_TELEMETRY defined to turn it on; without it
+ *  the calls fold away and the TX pin is left idle high.
+ *
+ *  The PIC16F1703 has no EUSART, so TX is a software UART on the TX pin
+ *  (RC4), 8N1 at Fosc/4/1024 (7812.5 baud at 32 MHz). TMR0 runs free
+ *  with a 1:4 prescaler and its overflow interrupt clocks out one bit,
+ *  so the bit period never drifts and no byte ever waits in the
+ *  mainloop. A bit edge waits for a TMR2 scan interrupt that is running:
+ *  test/telemetry_timing puts the latest edge at about 335 instruction
+ *  cycles, which is why the bit is not the 512 cycles of a 1:2 prescaler,
+ *  whose half bit the receiver samples at would be missed.
+ *
+ *  After every processed round one record per button is queued while
+ *  the ring buffer has room. The next round starts with the first button
+ *  left out; the round number in each record shows the host which round
+ *  it belongs to. The scan period stays set by TMR2, but while bytes
+ *  are queued the TX interrupt takes about 10% of the CPU, and
+ *  test/telemetry_timing shows about 10% fewer processed rounds.
+ *
+ *  Record, 11 bytes, multi-byte values little endian:
+ *      0       MTOUCH_TELEMETRY_SYNC
+ *      1       button in bits 0..3, sensor in bits 4..7
+ *      2       round number, modulo 256
+ *      3..4    sensor rawSample
+ *      5..6    button baseline
+ *      7       button deviation, signed
+ *      8       packet noise per ADC sample x4
+ *      9       state, MTOUCH_TELEMETRY_STATE_*
+ *      10      checksum, bytes 1..10 add up to 0 modulo 256
+ */
+    #define MTOUCH_TELEMETRY_SYNC           (uint8_t)0xA5
+    #define MTOUCH_TELEMETRY_RECORD_SIZE    11
+    #define MTOUCH_TELEMETRY_BUFFER_SIZE    16      /* power of 2, holds one record */
+
+    #define MTOUCH_TELEMETRY_STATE_active       (uint8_t)0x01   /* sensor moved in the last packet */
+    #define MTOUCH_TELEMETRY_STATE_pressed      (uint8_t)0x02
+    #define MTOUCH_TELEMETRY_STATE_initialized  (uint8_t)0x04   /* button baseline is valid */
+
+    #if (MTOUCH_TELEMETRY_BUFFER_SIZE & (MTOUCH_TELEMETRY_BUFFER_SIZE-1)) != 0
+        #error MTOUCH_TELEMETRY_BUFFER_SIZE must be a power of 2
+    #endif
+    #if MTOUCH_TELEMETRY_BUFFER_SIZE <= MTOUCH_TELEMETRY_RECORD_SIZE
+        #error MTOUCH_TELEMETRY_BUFFER_SIZE must hold a record
+    #endif
+
+/*
+ * =======================================================================
+ * Global Functions
+ * =======================================================================
+ */
+#ifdef MTOUCH_TELEMETRY
+    void                        MTOUCH_Telemetry_Initialize (void);
+    void                        MTOUCH_Telemetry_Service    (void);
+    bool                        MTOUCH_Telemetry_isBusy     (void);
+    uint16_t                    MTOUCH_Telemetry_Skipped_Get(void);
+#else
+    /* Telemetry off in this build, the calls fold away */
+    #define MTOUCH_Telemetry_Initialize()
+    #define MTOUCH_Telemetry_Service()
+    #define MTOUCH_Telemetry_isBusy()       (false)
+    #define MTOUCH_Telemetry_Skipped_Get()  ((uint16_t)0)
+#endif
+#endif // MTOUCH_TELEMETRY_H
@@ -60,18 +60,18 @@ void PIN_MANAGER_Initialize(void)
     LATx registers
     */
     LATA = 0x00;
-    LATC = 0x00;
+    LATC = 0x10;
 
     /**
     TRISx registers
     */
-    TRISA = 0x37;
-    TRISC = 0x1F;
+    TRISA = 0x17;
+    TRISC = 0x0F;
 
     /**
     ANSELx registers
     */
-    ANSELC = 0x3F;
+    ANSELC = 0x2F;
     ANSELA = 0x17;
 
     /**
@@ -91,6 +91,43 @@
 #define LED_SetAnalogMode()      do { ANSELCbits.ANSC5 = 1; } while(0)
 #define LED_SetDigitalMode()     do { ANSELCbits.ANSC5 = 0; } while(0)
 
+// get/set GUARD aliases
+#define GUARD_TRIS                 TRISAbits.TRISA5
+#define GUARD_LAT                  LATAbits.LATA5
+#define GUARD_PORT                 PORTAbits.RA5
+#define GUARD_WPU                  WPUAbits.WPUA5
+#define GUARD_OD                   ODCONAbits.ODA5
+#define GUARD_SetHigh()            do { LATAbits.LATA5 = 1; } while(0)
+#define GUARD_SetLow()             do { LATAbits.LATA5 = 0; } while(0)
+#define GUARD_Toggle()             do { LATAbits.LATA5 = ~LATAbits.LATA5; } while(0)
+#define GUARD_GetValue()           PORTAbits.RA5
+#define GUARD_SetDigitalInput()    do { TRISAbits.TRISA5 = 1; } while(0)
+#define GUARD_SetDigitalOutput()   do { TRISAbits.TRISA5 = 0; } while(0)
+#define GUARD_SetPullup()          do { WPUAbits.WPUA5 = 1; } while(0)
+#define GUARD_ResetPullup()        do { WPUAbits.WPUA5 = 0; } while(0)
+#define GUARD_SetPushPull()        do { ODCONAbits.ODA5 = 0; } while(0)
+#define GUARD_SetOpenDrain()       do { ODCONAbits.ODA5 = 1; } while(0)
+
+// get/set TX aliases
+#define TX_TRIS                 TRISCbits.TRISC4
+#define TX_LAT                  LATCbits.LATC4
+#define TX_PORT                 PORTCbits.RC4
+#define TX_WPU                  WPUCbits.WPUC4
+#define TX_OD                   ODCONCbits.ODC4
+#define TX_ANS                  ANSELCbits.ANSC4
+#define TX_SetHigh()            do { LATCbits.LATC4 = 1; } while(0)
+#define TX_SetLow()             do { LATCbits.LATC4 = 0; } while(0)
+#define TX_Toggle()             do { LATCbits.LATC4 = ~LATCbits.LATC4; } while(0)
+#define TX_GetValue()           PORTCbits.RC4
+#define TX_SetDigitalInput()    do { TRISCbits.TRISC4 = 1; } while(0)
+#define TX_SetDigitalOutput()   do { TRISCbits.TRISC4 = 0; } while(0)
+#define TX_SetPullup()          do { WPUCbits.WPUC4 = 1; } while(0)
+#define TX_ResetPullup()        do { WPUCbits.WPUC4 = 0; } while(0)
+#define TX_SetPushPull()        do { ODCONCbits.ODC4 = 0; } while(0)
+#define TX_SetOpenDrain()       do { ODCONCbits.ODC4 = 1; } while(0)
+#define TX_SetAnalogMode()      do { ANSELCbits.ANSC4 = 1; } while(0)
+#define TX_SetDigitalMode()     do { ANSELCbits.ANSC4 = 0; } while(0)
+
 /**
    @Param
     none
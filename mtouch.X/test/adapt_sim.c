@@ -0,0 +1,269 @@
+/*
+ * Adaptive packet length against ADC noise, on touch_model.c.
+ *
+ * Built twice from the same source: adapt_sim with the library's
+ * adaptive oversampling and adapt_sim_fixed with MTOUCH_SENSOR_ADAPTIVE=0,
+ * which takes 32 samples a packet. Taps run over all keys at rising
+ * levels of white ADC noise, and each level reports:
+ *      press/release       response time, finger down to pressed and
+ *                          finger up to released, mean and worst
+ *      false/missed        presses with no finger, taps never reported
+ *      scan cost           instruction cycles of acquisition per
+ *                          processed round
+ * Both builds fail on a false press or a missed tap. The adaptive build
+ * also fails on a press reported after the finger lifts, a release
+ * reported after the next tap could start, or a quiet board that does
+ * not scan in less than half the time of 32 sample packets. It runs
+ * adapt_sim_fixed for its figures and fails at any level where it
+ * responds or scans slower than 32 sample packets.
+ */
+#define _POSIX_C_SOURCE 200809L         /* popen() under -std=c99 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define ADAPT_TAPS          24
+#define ADAPT_FIRST_MS      1000
+#define ADAPT_ON_MS         150
+#define ADAPT_OFF_MS        350
+#define ADAPT_DELTA_PF      0.6
+#define ADAPT_LATE_MS       100         /* a press this long after the finger lifts still counts */
+
+#define ADAPT_QUIET_NOISE   1.0         /* counts, below this the packets should be short */
+#define ADAPT_FIXED_CYCLES  ((double)MTOUCH_SENSORS * 32 * 201) /* 32 samples at the starting period */
+#define ADAPT_SLACK         1.05        /* of adapt_sim_fixed's press time and scan cost */
+
+typedef struct
+{
+    uint8_t         presses;
+    double          press_sum, press_max;
+    uint8_t         releases;
+    double          release_sum, release_max;
+    uint8_t         false_presses;
+    uint8_t         missed;
+    uint32_t        rounds;
+    uint64_t        scan_cycles;
+} adapt_result_t;
+
+static const double     levels[] = { 0.5, 1.0, 2.0, 3.0, 4.0, 6.0, 8.0, 12.0 };   /* white noise, ADC counts rms */
+
+static model_touch_t    touch[ADAPT_TAPS];
+static bool             touch_pressed[ADAPT_TAPS];
+static bool             touch_held[ADAPT_TAPS];
+static bool             button_was[MTOUCH_BUTTONS];
+static adapt_result_t   result;
+static int              failures;
+
+static void Adapt_Press(enum mtouch_button_names button, double now)
+{
+    uint8_t sensor = (uint8_t)MTOUCH_Button_Sensor_Get(button);
+    uint8_t i;
+
+    for(i = 0; i < ADAPT_TAPS; i++)
+    {
+        if(touch[i].sensor != sensor)
+            continue;
+        if(now < (double)touch[i].start_ms || now > (double)(touch[i].start_ms + touch[i].length_ms + ADAPT_LATE_MS))
+            continue;
+        if(touch_pressed[i])
+            break;                                  /* chatter */
+        touch_pressed[i] = true;
+        touch_held[i] = true;
+        result.presses++;
+        result.press_sum += now - (double)touch[i].start_ms;
+        if(now - (double)touch[i].start_ms > result.press_max)
+            result.press_max = now - (double)touch[i].start_ms;
+        return;
+    }
+    result.false_presses++;
+}
+
+static void Adapt_Release(enum mtouch_button_names button, double now)
+{
+    uint8_t sensor = (uint8_t)MTOUCH_Button_Sensor_Get(button);
+    uint8_t i;
+    double  latency;
+
+    for(i = 0; i < ADAPT_TAPS; i++)
+    {
+        if(touch[i].sensor != sensor || !touch_held[i])
+            continue;
+        touch_held[i] = false;
+        latency = now - (double)(touch[i].start_ms + touch[i].length_ms);
+        result.releases++;
+        result.release_sum += latency;
+        if(latency > result.release_max)
+            result.release_max = latency;
+        return;
+    }
+}
+
+static void Adapt_Mainloop(void)
+{
+    mtouch_gesture_event_t      gesture;
+    enum mtouch_button_names    button;
+    bool                        pressed;
+
+    if(MTOUCH_Service_Mainloop())
+    {
+        result.rounds++;
+        MTOUCH_BUTTON_FOREACH(button)
+        {
+            pressed = MTOUCH_Button_isPressed(button);
+            if(pressed && !button_was[button])
+                Adapt_Press(button, Model_Time_ms());
+            else if(!pressed && button_was[button])
+                Adapt_Release(button, Model_Time_ms());
+            button_was[button] = pressed;
+        }
+    }
+    while(MTOUCH_Gesture_Get(&gesture))
+        ;
+}
+
+static void Adapt_Simulate(double level)
+{
+    model_env_t env = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint32_t    run_ms = ADAPT_FIRST_MS + ADAPT_TAPS * (ADAPT_ON_MS + ADAPT_OFF_MS) + 500;
+    uint8_t     i;
+
+    for(i = 0; i < ADAPT_TAPS; i++)
+    {
+        touch[i].sensor    = (uint8_t)MTOUCH_Button_Sensor_Get((enum mtouch_button_names)(i % MTOUCH_BUTTONS));
+        touch[i].start_ms  = ADAPT_FIRST_MS + i * (ADAPT_ON_MS + ADAPT_OFF_MS);
+        touch[i].length_ms = ADAPT_ON_MS;
+        touch[i].delta_pf  = ADAPT_DELTA_PF;
+    }
+
+    env.white = level;
+    Model_Reset(&env, touch, ADAPT_TAPS, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(run_ms, Adapt_Mainloop);
+
+    for(i = 0; i < ADAPT_TAPS; i++)
+        if(!touch_pressed[i])
+            result.missed++;
+    result.scan_cycles = model_stats.scan_cycles;
+}
+
+/* The library keeps its state in statics, so every level gets a fresh process */
+static adapt_result_t Adapt_Run(double level)
+{
+    int             fd[2];
+    adapt_result_t  r;
+
+    memset(&r, 0, sizeof(r));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        Adapt_Simulate(level);
+        if(write(fd[1], &result, sizeof(result)) != sizeof(result))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &r, sizeof(r)) != sizeof(r))
+        r.missed = UINT8_MAX;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return r;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+#define LEVELS  (sizeof(levels) / sizeof(levels[0]))
+
+static double Adapt_Press_Mean(const adapt_result_t* r)
+{
+    return r->presses ? r->press_sum / r->presses : 0.0;
+}
+
+static double Adapt_Cost(const adapt_result_t* r)
+{
+    return r->rounds ? (double)r->scan_cycles / r->rounds : 0.0;
+}
+
+#if MTOUCH_SENSOR_ADAPTIVE
+/* Mean press time and scan cost of 32 sample packets, one line per level */
+static bool Adapt_Fixed(double* press, double* cost)
+{
+    FILE*   p = popen("./adapt_sim_fixed reference", "r");
+    uint8_t i;
+    bool    ok = p != NULL;
+
+    for(i = 0; ok && i < LEVELS; i++)
+        ok = fscanf(p, "%lf %lf", &press[i], &cost[i]) == 2;
+    if(p && pclose(p) != 0)
+        ok = false;
+    return ok;
+}
+#endif
+
+static void Adapt_Level(double level, double fixed_press, double fixed_cost)
+{
+    adapt_result_t  r = Adapt_Run(level);
+    double          cost = Adapt_Cost(&r);
+
+    printf("  noise %.1f: press %5.1f/%5.1f ms  release %5.1f/%5.1f ms (mean/max)  false %u  missed %u  scan cost %6.0f cycles/round\n",
+           level, Adapt_Press_Mean(&r), r.press_max,
+           r.releases ? r.release_sum / r.releases : 0.0, r.release_max,
+           r.false_presses, r.missed, cost);
+
+    Check(r.false_presses == 0 && r.missed == 0, "no false or missed presses");
+#if MTOUCH_SENSOR_ADAPTIVE
+    Check(r.press_max < ADAPT_ON_MS, "press reported while the finger is down");
+    Check(r.release_max < ADAPT_OFF_MS, "release reported before the next tap");
+    if(level < ADAPT_QUIET_NOISE)
+        Check(cost < ADAPT_FIXED_CYCLES / 2, "quiet board scans in under half the time of 32 samples");
+    printf("    32 samples: press %5.1f ms  scan cost %6.0f cycles/round\n", fixed_press, fixed_cost);
+    Check(Adapt_Press_Mean(&r) <= fixed_press * ADAPT_SLACK, "press no slower than 32 samples");
+    Check(cost <= fixed_cost * ADAPT_SLACK, "scan no costlier than 32 samples");
+#else
+    (void)fixed_press;
+    (void)fixed_cost;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    double  fixed_press[LEVELS] = { 0 };
+    double  fixed_cost[LEVELS] = { 0 };
+    uint8_t n;
+
+    alarm(300);
+    if(argc > 1 && strcmp(argv[1], "reference") == 0)
+    {
+        for(n = 0; n < LEVELS; n++)
+        {
+            adapt_result_t r = Adapt_Run(levels[n]);
+
+            printf("%.3f %.1f\n", Adapt_Press_Mean(&r), Adapt_Cost(&r));
+        }
+        return EXIT_SUCCESS;
+    }
+#if MTOUCH_SENSOR_ADAPTIVE
+    printf("mTouch against ADC noise, adaptive packets: %u keys, taps of %.2f pF\n", (unsigned)MTOUCH_SENSORS, ADAPT_DELTA_PF);
+    if(!Adapt_Fixed(fixed_press, fixed_cost))
+        failures++;
+#else
+    printf("mTouch against ADC noise, 32 sample packets: %u keys, taps of %.2f pF\n", (unsigned)MTOUCH_SENSORS, ADAPT_DELTA_PF);
+#endif
+    for(n = 0; n < LEVELS; n++)
+        Adapt_Level(levels[n], fixed_press[n], fixed_cost[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+/*
+ * Registers the blocking mbutton.X fork reads beyond xc.h, for
+ * one_key_bench.c. Forced into every fork source with -include.
+ */
+#ifndef BENCH_FORK_H
+#define BENCH_FORK_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    unsigned TMR2IF:1;
+    unsigned ADIF:1;
+} PIR1bits_t;
+
+typedef struct
+{
+    unsigned WPUC1:1;
+    unsigned ANSC1:1;
+    unsigned TRISC1:1;
+} PORTCbits_t;
+
+static volatile PORTCbits_t WPUCbits, ANSELCbits, TRISCbits;
+
+volatile PIR1bits_t* Bench_PIR1(void);
+uint16_t Model_Scan_Result(void);
+
+#define PIR1bits    (*Bench_PIR1())
+#define ADRES       Model_Scan_Result()
+
+#endif
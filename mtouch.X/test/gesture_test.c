@@ -0,0 +1,153 @@
+/*
+ * Host test of the gesture layer against scripted press traces.
+ *
+ * Only mtouch_gesture.c is linked: the test takes the button callbacks
+ * the layer registers and calls them itself, with MTOUCH_Gesture_Tick(1)
+ * for every millisecond in between, as the library's clock would. Each
+ * trace is a list of presses and releases; the events drained from the
+ * queue must match the trace's list exactly, in type, button and time
+ * from the start of the trace.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "mcc.h"
+
+#define TRACE_STEPS_MAX     8
+#define TRACE_EVENTS_MAX    8
+
+typedef enum
+{
+    TRACE_END = 0,
+    TRACE_PRESS,
+    TRACE_RELEASE
+} trace_action_t;
+
+typedef struct
+{
+    trace_action_t              action;
+    enum mtouch_button_names    button;
+    uint16_t                    wait_ms;        /* ticks after the action */
+} trace_step_t;
+
+typedef struct
+{
+    const char*                 name;
+    trace_step_t                steps[TRACE_STEPS_MAX];
+    uint8_t                     events;
+    mtouch_gesture_event_t      event[TRACE_EVENTS_MAX];
+} trace_t;
+
+static const trace_t traces[] =
+{
+    {   "tap",
+        { { TRACE_PRESS, Button0, 100 }, { TRACE_RELEASE, Button0, 500 } },
+        1, { { MTOUCH_GESTURE_tap, Button0, 100 } } },
+    {   "double tap",
+        { { TRACE_PRESS, Button0, 100 }, { TRACE_RELEASE, Button0, 100 },
+          { TRACE_PRESS, Button0, 100 }, { TRACE_RELEASE, Button0, 500 } },
+        1, { { MTOUCH_GESTURE_doubleTap, Button0, 300 } } },
+    {   "long press",
+        { { TRACE_PRESS, Button0, 1300 }, { TRACE_RELEASE, Button0, 500 } },
+        3, { { MTOUCH_GESTURE_longPress, Button0, 800 },
+             { MTOUCH_GESTURE_repeat,    Button0, 1000 },
+             { MTOUCH_GESTURE_repeat,    Button0, 1200 } } },
+    {   "swipe forward",
+        { { TRACE_PRESS, Button1, 100 }, { TRACE_RELEASE, Button1, 50 },
+          { TRACE_PRESS, Button2, 100 }, { TRACE_RELEASE, Button2, 50 },
+          { TRACE_PRESS, Button3, 100 }, { TRACE_RELEASE, Button3, 500 } },
+        1, { { MTOUCH_GESTURE_swipeForward, Button3, 300 } } },
+    {   "swipe back",
+        { { TRACE_PRESS, Button4, 100 },
+          { TRACE_PRESS, Button3, 0 }, { TRACE_RELEASE, Button4, 100 },
+          { TRACE_PRESS, Button2, 0 }, { TRACE_RELEASE, Button3, 100 },
+          { TRACE_RELEASE, Button2, 500 } },
+        1, { { MTOUCH_GESTURE_swipeBack, Button2, 200 } } },
+};
+
+static void (*callback_pressed)(enum mtouch_button_names button);
+static void (*callback_notPressed)(enum mtouch_button_names button);
+static mtouch_gesture_event_t   received[TRACE_EVENTS_MAX];
+static uint8_t                  received_count;
+static int                      failures;
+
+/* The gesture layer registers its callbacks here instead of with mtouch_button.c */
+void MTOUCH_Button_SetPressedCallback(void (*callback)(enum mtouch_button_names))
+{
+    callback_pressed = callback;
+}
+
+void MTOUCH_Button_SetNotPressedCallback(void (*callback)(enum mtouch_button_names))
+{
+    callback_notPressed = callback;
+}
+
+static void Trace_Wait(uint16_t ms, mtouch_gesture_time_t start)
+{
+    mtouch_gesture_event_t event;
+
+    while(ms--)
+    {
+        MTOUCH_Gesture_Tick(1);
+        while(MTOUCH_Gesture_Get(&event))
+        {
+            event.time -= start;
+            if(received_count < TRACE_EVENTS_MAX)
+                received[received_count] = event;
+            received_count++;
+        }
+    }
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Trace_Run(const trace_t* t)
+{
+    mtouch_gesture_time_t   start;
+    const trace_step_t*     step;
+    bool                    match;
+    uint8_t                 i;
+
+    MTOUCH_Gesture_Initialize();
+    start = MTOUCH_Gesture_Time_Get();
+    received_count = 0;
+    for(step = t->steps; step < t->steps + TRACE_STEPS_MAX && step->action != TRACE_END; step++)
+    {
+        if(step->action == TRACE_PRESS)
+            callback_pressed(step->button);
+        else
+            callback_notPressed(step->button);
+        Trace_Wait(step->wait_ms, start);
+    }
+
+    printf("  %s:", t->name);
+    for(i = 0; i < received_count && i < TRACE_EVENTS_MAX; i++)
+        printf(" %u/Button%u@%u", (unsigned)received[i].type, (unsigned)received[i].button, (unsigned)received[i].time);
+    printf("\n");
+
+    match = (received_count == t->events);
+    for(i = 0; match && i < t->events; i++)
+    {
+        match = received[i].type == t->event[i].type
+             && received[i].button == t->event[i].button
+             && received[i].time == t->event[i].time;
+    }
+    Check(match, "events as expected");
+    Check(MTOUCH_Gesture_Dropped_Get() == 0, "no events dropped");
+}
+
+int main(void)
+{
+    uint8_t n;
+
+    printf("mTouch gestures against press traces: %u buttons\n", (unsigned)MTOUCH_BUTTONS);
+    for(n = 0; n < sizeof(traces) / sizeof(traces[0]); n++)
+        Trace_Run(&traces[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+/*
+ * Frequency hopping against RF interference, on touch_model.c.
+ *
+ * Built twice from the same source: hop_sim with the library's noise
+ * hopping and hop_sim_fixed with MTOUCH_SENSOR_HOPPING=0, which scans at
+ * the fixed starting period. Taps run over all keys while an RF carrier
+ * sweeps 10 to 200 kHz, so some frequencies alias onto the scan rate of
+ * any fixed period. For each level the sweep reports:
+ *      false presses       a press with no finger on the key, per minute,
+ *                          mean over the sweep and the worst frequency
+ *      missed taps         taps never reported, summed over the sweep
+ *      scan cost           instruction cycles of acquisition per
+ *                          processed round, rounds dropped while hopping
+ *                          included, mean over the sweep
+ * The hopping build fails on any false press or missed tap; the fixed
+ * build only reports, as the reference.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define HOP_TAPS            48
+#define HOP_FIRST_MS        1000
+#define HOP_ON_MS           150
+#define HOP_OFF_MS          250
+#define HOP_LATE_MS         100         /* a press this long after the finger lifts still counts */
+
+#define HOP_SWEEP_STEPS     24
+#define HOP_SWEEP_FROM_HZ   10000.0
+#define HOP_SWEEP_TO_HZ     200000.0
+
+typedef struct
+{
+    uint32_t        false_presses;
+    uint32_t        missed;
+    uint32_t        rounds;
+    uint64_t        scan_cycles;
+    uint32_t        run_ms;
+} hop_result_t;
+
+typedef struct
+{
+    double          false_rate;         /* per minute */
+    double          false_worst;
+    double          false_worst_hz;
+    uint32_t        missed;
+    double          cost;               /* cycles per round */
+} hop_sweep_t;
+
+static const double     levels[] = { 20.0, 40.0 };     /* RF amplitude, ADC counts */
+
+static model_touch_t    touch[HOP_TAPS];
+static bool             touch_pressed[HOP_TAPS];
+static bool             button_was[MTOUCH_BUTTONS];
+static hop_result_t     result;
+static int              failures;
+
+static void Hop_Press(enum mtouch_button_names button, double now)
+{
+    uint8_t sensor = (uint8_t)MTOUCH_Button_Sensor_Get(button);
+    uint8_t i;
+
+    for(i = 0; i < HOP_TAPS; i++)
+    {
+        if(touch[i].sensor != sensor)
+            continue;
+        if(now < (double)touch[i].start_ms || now > (double)(touch[i].start_ms + touch[i].length_ms + HOP_LATE_MS))
+            continue;
+        if(!touch_pressed[i])
+        {
+            touch_pressed[i] = true;
+            return;
+        }
+        break;                                      /* chatter */
+    }
+    result.false_presses++;
+}
+
+static void Hop_Mainloop(void)
+{
+    mtouch_gesture_event_t      gesture;
+    enum mtouch_button_names    button;
+    bool                        pressed;
+
+    if(MTOUCH_Service_Mainloop())
+    {
+        result.rounds++;
+        MTOUCH_BUTTON_FOREACH(button)
+        {
+            pressed = MTOUCH_Button_isPressed(button);
+            if(pressed && !button_was[button])
+                Hop_Press(button, Model_Time_ms());
+            button_was[button] = pressed;
+        }
+    }
+    while(MTOUCH_Gesture_Get(&gesture))
+        ;
+}
+
+static void Hop_Simulate(const model_env_t* env)
+{
+    uint8_t i;
+
+    for(i = 0; i < HOP_TAPS; i++)
+    {
+        touch[i].sensor    = (uint8_t)MTOUCH_Button_Sensor_Get((enum mtouch_button_names)(i % MTOUCH_BUTTONS));
+        touch[i].start_ms  = HOP_FIRST_MS + i * (HOP_ON_MS + HOP_OFF_MS);
+        touch[i].length_ms = HOP_ON_MS;
+        touch[i].delta_pf  = 1.0;
+    }
+    result.run_ms = HOP_FIRST_MS + HOP_TAPS * (HOP_ON_MS + HOP_OFF_MS) + 500;
+
+    Model_Reset(env, touch, HOP_TAPS, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(result.run_ms, Hop_Mainloop);
+
+    for(i = 0; i < HOP_TAPS; i++)
+        if(!touch_pressed[i])
+            result.missed++;
+    result.scan_cycles = model_stats.scan_cycles;
+}
+
+/* The library keeps its state in statics, so every run gets a fresh process */
+static hop_result_t Hop_Run(const model_env_t* env)
+{
+    int             fd[2];
+    hop_result_t    r;
+
+    memset(&r, 0, sizeof(r));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        Hop_Simulate(env);
+        if(write(fd[1], &result, sizeof(result)) != sizeof(result))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &r, sizeof(r)) != sizeof(r))
+        r.missed = HOP_TAPS;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return r;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static hop_sweep_t Hop_Sweep(double level)
+{
+    model_env_t     env = { 1.0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    hop_sweep_t     s;
+    hop_result_t    r;
+    double          rate;
+    uint8_t         n;
+
+    memset(&s, 0, sizeof(s));
+    env.rf = level;
+    for(n = 0; n < HOP_SWEEP_STEPS; n++)
+    {
+        env.rf_hz = HOP_SWEEP_FROM_HZ * pow(HOP_SWEEP_TO_HZ / HOP_SWEEP_FROM_HZ, (n + 0.5) / HOP_SWEEP_STEPS);
+        r = Hop_Run(&env);
+        rate = 60000.0 * r.false_presses / r.run_ms;
+        s.false_rate += rate / HOP_SWEEP_STEPS;
+        if(rate > s.false_worst)
+        {
+            s.false_worst = rate;
+            s.false_worst_hz = env.rf_hz;
+        }
+        s.missed += r.missed;
+        s.cost += (r.rounds ? (double)r.scan_cycles / r.rounds : 0.0) / HOP_SWEEP_STEPS;
+    }
+    return s;
+}
+
+static void Hop_Level(double level)
+{
+    hop_sweep_t     s = Hop_Sweep(level);
+
+    printf("  RF sweep, %2.0f counts: false %5.1f/min (worst %5.1f at %3.0f kHz)  missed %3lu/%u  scan cost %6.0f cycles/round\n",
+           level, s.false_rate, s.false_worst, s.false_worst_hz / 1000.0,
+           (unsigned long)s.missed, HOP_SWEEP_STEPS * HOP_TAPS, s.cost);
+#if MTOUCH_SENSOR_HOPPING
+    Check(s.false_rate == 0.0, "no false presses");
+    Check(s.missed == 0, "no missed taps");
+#endif
+}
+
+int main(void)
+{
+    model_env_t     quiet = { 1.0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    hop_result_t    r;
+    uint8_t         n;
+
+    alarm(300);
+#if MTOUCH_SENSOR_HOPPING
+    printf("mTouch under RF interference, frequency hopping: %u keys\n", (unsigned)MTOUCH_SENSORS);
+#else
+    printf("mTouch under RF interference, fixed sample period: %u keys\n", (unsigned)MTOUCH_SENSORS);
+#endif
+    r = Hop_Run(&quiet);
+    printf("  no interference:        false %5.1f/min                        missed %3lu/%u  scan cost %6.0f cycles/round\n",
+           60000.0 * r.false_presses / r.run_ms, (unsigned long)r.missed, HOP_TAPS,
+           r.rounds ? (double)r.scan_cycles / r.rounds : 0.0);
+    Check(r.false_presses == 0 && r.missed == 0, "taps without interference");
+    for(n = 0; n < sizeof(levels) / sizeof(levels[0]); n++)
+        Hop_Level(levels[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,261 @@
+/*
+ * Counts the instructions a host test program executes in chosen
+ * functions, with ptrace(2).
+ *
+ *      insn_count [+name=addr] [name=addr | -name=addr]... -- program [args]
+ *
+ * name=addr        count the function's own instructions and its calls
+ * name=addr/flag   the same, but count apart those run while the byte at
+ *                  address flag is not zero, e.g. waiting for a timer
+ * -name=addr       leave them out: a model function the PIC does not run;
+ *                  counted functions it calls are still counted
+ * +name=addr       only count from the first call of this one on, so a
+ *                  program can settle at full speed first
+ *
+ * The addresses come from nm of a non-PIE build. An instruction counts
+ * to the innermost listed function it runs in; a function is left when
+ * the stack pointer rises above its value at the entry. Only counted
+ * functions are single-stepped; the rest runs at full speed between
+ * breakpoints on their entries. Prints one line per function after the
+ * program's output:
+ *      insn name calls instructions most-in-one-call instructions-flagged
+ */
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ptrace.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define COUNT_FUNCTIONS_MAX     24
+#define COUNT_DEPTH_MAX         64
+
+typedef struct
+{
+    const char*         name;
+    unsigned long       addr;
+    int                 counted;
+    unsigned long       flag;           /* 0, or the address of name=addr/flag */
+    long                text;           /* the word under the entry breakpoint */
+    unsigned long       calls;
+    unsigned long long  insns;
+    unsigned long long  max;
+    unsigned long long  flagged;
+} function_t;
+
+typedef struct
+{
+    function_t*         function;
+    unsigned long       sp;             /* at the entry, on the return address */
+    unsigned long long  insns;
+} frame_t;
+
+static pid_t            pid;
+static unsigned long    arm;            /* +name, 0 once counting */
+static long             arm_text;
+static function_t       functions[COUNT_FUNCTIONS_MAX];
+static int              function_count;
+static frame_t          stack[COUNT_DEPTH_MAX];
+static int              depth;
+
+static long Count_Break(unsigned long addr)
+{
+    long text = ptrace(PTRACE_PEEKTEXT, pid, (void*)addr, 0);
+
+    ptrace(PTRACE_POKETEXT, pid, (void*)addr, (void*)((text & ~0xFFL) | 0xCC));
+    return text;
+}
+
+static void Count_Restore(unsigned long addr, long text)
+{
+    ptrace(PTRACE_POKETEXT, pid, (void*)addr, (void*)text);
+}
+
+/* Stopped by SIGTRAP, or returns the exit status + 1 */
+static int Count_Wait(void)
+{
+    int status;
+
+    if(waitpid(pid, &status, 0) < 0)
+        return 3;
+    if(WIFEXITED(status))
+        return WEXITSTATUS(status) + 1;
+    if(WIFSIGNALED(status) || WSTOPSIG(status) != SIGTRAP)
+    {
+        fprintf(stderr, "insn_count: program stopped by signal %d\n",
+                WIFSIGNALED(status) ? WTERMSIG(status) : WSTOPSIG(status));
+        return 3;
+    }
+    return 0;
+}
+
+static function_t* Count_Function(unsigned long addr)
+{
+    int f;
+
+    for(f = 0; f < function_count; f++)
+        if(functions[f].addr == addr)
+            return &functions[f];
+    return NULL;
+}
+
+/* One instruction, stepping over the entry breakpoint if it is on one */
+static int Count_Step(unsigned long rip)
+{
+    function_t* f = Count_Function(rip);
+    int         exited;
+
+    if(f && f->counted)
+        Count_Restore(f->addr, f->text);
+    ptrace(PTRACE_SINGLESTEP, pid, 0, 0);
+    exited = Count_Wait();
+    if(f && f->counted && !exited)
+        Count_Break(f->addr);
+    return exited;
+}
+
+/* At full speed to a counted entry or out of the innermost frame */
+static int Count_Run(struct user_regs_struct* regs)
+{
+    unsigned long   ret = 0;
+    long            text = 0;
+    int             exited;
+
+    if(Count_Function(regs->rip))
+    {
+        exited = Count_Step(regs->rip);     /* off the entry breakpoint */
+        if(exited)
+            return exited;
+        ptrace(PTRACE_GETREGS, pid, 0, regs);
+        if(depth && regs->rsp > stack[depth - 1].sp)
+            return 0;
+    }
+    if(depth)
+    {
+        ret = (unsigned long)ptrace(PTRACE_PEEKDATA, pid, (void*)stack[depth - 1].sp, 0);
+        text = Count_Break(ret);
+    }
+    ptrace(PTRACE_CONT, pid, 0, 0);
+    exited = Count_Wait();
+    if(exited)
+        return exited;
+    if(depth)
+        Count_Restore(ret, text);
+    ptrace(PTRACE_GETREGS, pid, 0, regs);
+    regs->rip--;
+    ptrace(PTRACE_SETREGS, pid, 0, regs);
+    if(arm && regs->rip == arm)
+    {
+        int f;
+
+        Count_Restore(arm, arm_text);
+        arm = 0;
+        for(f = 0; f < function_count; f++)
+            if(functions[f].counted)
+                functions[f].text = Count_Break(functions[f].addr);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int     i, exited;
+
+    for(i = 1; i < argc && strcmp(argv[i], "--") != 0; i++)
+    {
+        function_t* f = &functions[function_count];
+        char*       eq = strchr(argv[i], '=');
+
+        if(!eq || function_count == COUNT_FUNCTIONS_MAX)
+        {
+            fprintf(stderr, "insn_count: bad function %s\n", argv[i]);
+            return 2;
+        }
+        *eq = '\0';
+        if(argv[i][0] == '+')
+        {
+            arm = strtoul(eq + 1, NULL, 16);
+            continue;
+        }
+        f->counted = argv[i][0] != '-';
+        f->name = argv[i] + !f->counted;
+        f->addr = strtoul(eq + 1, &eq, 16);
+        if(*eq == '/')
+            f->flag = strtoul(eq + 1, NULL, 16);
+        function_count++;
+    }
+    if(i + 1 >= argc)
+    {
+        fprintf(stderr, "usage: insn_count [+name=addr] [name=addr | -name=addr]... -- program [args]\n");
+        return 2;
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if(pid == 0)
+    {
+        ptrace(PTRACE_TRACEME, 0, 0, 0);
+        execv(argv[i + 1], &argv[i + 1]);
+        _exit(127);
+    }
+    if(Count_Wait())
+        return 2;
+    if(arm)
+        arm_text = Count_Break(arm);
+    else
+        for(i = 0; i < function_count; i++)
+            if(functions[i].counted)
+                functions[i].text = Count_Break(functions[i].addr);
+
+    for(;;)
+    {
+        struct user_regs_struct regs;
+        function_t*             f;
+
+        ptrace(PTRACE_GETREGS, pid, 0, &regs);
+        while(depth && regs.rsp > stack[depth - 1].sp)
+        {
+            frame_t* frame = &stack[--depth];
+
+            if(frame->insns > frame->function->max)
+                frame->function->max = frame->insns;
+        }
+        f = Count_Function(regs.rip);
+        if(f && !(depth && stack[depth - 1].function == f && stack[depth - 1].sp == regs.rsp))
+        {
+            if(depth == COUNT_DEPTH_MAX)
+                return 2;
+            f->calls++;
+            stack[depth].function = f;
+            stack[depth].sp = regs.rsp;
+            stack[depth].insns = 0;
+            depth++;
+        }
+
+        if(depth && stack[depth - 1].function->counted)
+        {
+            function_t* in = stack[depth - 1].function;
+
+            if(in->flag && (ptrace(PTRACE_PEEKDATA, pid, (void*)in->flag, 0) & 0xFF))
+                in->flagged++;
+            else
+            {
+                stack[depth - 1].insns++;
+                in->insns++;
+            }
+            exited = Count_Step(regs.rip);
+        }
+        else
+            exited = Count_Run(&regs);
+        if(exited)
+            break;
+    }
+
+    for(i = 0; i < function_count; i++)
+        printf("insn %s %lu %llu %llu %llu\n", functions[i].name, functions[i].calls,
+               functions[i].insns, functions[i].max, functions[i].flagged);
+    return exited - 1;
+}
@@ -0,0 +1,25 @@
+/*
+ * Host stand-in for mcc_generated_files/mcc.h: the clock and the calls
+ * the mTouch library makes into the MCC drivers.
+ */
+#ifndef MCC_H
+#define MCC_H
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "tmr2.h"
+#include "mtouch.h"
+
+#ifndef _XTAL_FREQ
+#define _XTAL_FREQ  32000000
+#endif
+
+void WDT_Initialize(void);
+void TMR0_SetInterruptHandler(void (* InterruptHandler)(void));
+
+/* telemetry TX pin, read by the receiver in touch_model.c */
+extern volatile uint8_t TX_LAT;
+#define TX_SetHigh()    do { TX_LAT = 1; } while(0)
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * One-key mTouch firmware on touch_model.c, for one_key_bench.py.
+ *
+ * Built twice: with the shared library in mbutton.X's configuration,
+ * and with -DBENCH_FORK against the sources of the blocking fork that
+ * mbutton.X carried before. The fork waits in MTOUCH_Service_Mainloop()
+ * for the ADC flag; reading it runs one TMR2 period, see Bench_PIR1().
+ *
+ * A key is tapped BENCH_TAPS times with a clean finger. Prints the
+ * rounds, the press latency and the taps seen, as "name value" lines.
+ * With "count" the run stops after the first tap and calls
+ * Bench_Count() shortly before it, where insn_count.c starts counting.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define BENCH_TAPS          6
+#define BENCH_FIRST_MS      3000        /* the fork's baseline takes ~3 s to settle */
+#define BENCH_TAP_MS        500
+#define BENCH_TOUCH_MS      200
+#define BENCH_TOUCH_PF      1.0
+#define BENCH_COUNT_MS      100         /* idle before and after the counted tap */
+
+#ifdef BENCH_FORK
+#include "bench_fork.h"
+
+static PIR1bits_t   pir1;
+
+/* The fork polls ADIF while TMR2 drives the conversions; one conversion a period */
+volatile PIR1bits_t* Bench_PIR1(void)
+{
+    if(!pir1.ADIF)
+    {
+        Model_Wait();
+        pir1.ADIF = 1;
+    }
+    return &pir1;
+}
+#endif
+
+static const model_env_t env = { 1.0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static uint32_t     rounds;
+static uint32_t     rounds_counted;     /* before Bench_Count() */
+static uint32_t     presses;
+static double       press_ms;
+static double       press_max_ms;
+static bool         pressed;
+
+void __attribute__((noinline)) Bench_Count(void)
+{
+    __asm__ volatile("");
+}
+
+static void Bench_Mainloop(void)
+{
+    bool    now;
+    double  since;
+
+#ifdef BENCH_FORK
+    MTOUCH_Service_Mainloop();          /* returns with the round done */
+    rounds++;
+#else
+    if(MTOUCH_Service_Mainloop())
+        rounds++;
+#endif
+    now = MTOUCH_Button_isPressed(Button0);
+    if(now && !pressed && Model_Finger(0) > 0.0)
+    {
+        since = Model_Time_ms() - BENCH_FIRST_MS;
+        while(since >= BENCH_TAP_MS)
+            since -= BENCH_TAP_MS;
+        presses++;
+        press_ms += since;
+        if(since > press_max_ms)
+            press_max_ms = since;
+    }
+    pressed = now;
+}
+
+int main(int argc, char** argv)
+{
+    model_touch_t   touch[BENCH_TAPS];
+    uint32_t        run_ms = BENCH_FIRST_MS + BENCH_TAPS * BENCH_TAP_MS;
+    uint8_t         i;
+
+    for(i = 0; i < BENCH_TAPS; i++)
+    {
+        touch[i].sensor    = 0;
+        touch[i].start_ms  = BENCH_FIRST_MS + i * BENCH_TAP_MS;
+        touch[i].length_ms = BENCH_TOUCH_MS;
+        touch[i].delta_pf  = BENCH_TOUCH_PF;
+    }
+    Model_Reset(&env, touch, BENCH_TAPS, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    if(argc > 1)
+    {
+        Model_Run(BENCH_FIRST_MS - BENCH_COUNT_MS, Bench_Mainloop);
+        rounds_counted = rounds;
+        Bench_Count();
+        run_ms = BENCH_FIRST_MS + BENCH_TOUCH_MS + BENCH_COUNT_MS;
+    }
+    Model_Run(run_ms, Bench_Mainloop);
+
+    printf("rounds %lu\n", (unsigned long)rounds);
+    printf("rounds_counted %lu\n", (unsigned long)(rounds - rounds_counted));
+    printf("run_ms %lu\n", (unsigned long)run_ms);
+    printf("isr_calls %lu\n", (unsigned long)model_stats.isr_calls);
+    printf("scan_cycles %llu\n", (unsigned long long)model_stats.scan_cycles);
+    printf("taps %u\n", (unsigned)BENCH_TAPS);
+    printf("presses %lu\n", (unsigned long)presses);
+    printf("press_ms %.2f\n", presses ? press_ms / presses : 0.0);
+    printf("press_max_ms %.2f\n", press_max_ms);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+#!/usr/bin/env python3
+"""Footprint and cycles of the one-key build against the fork it replaced.
+
+mbutton.X used to carry its own blocking copy of the mTouch library; it
+now builds the shared sources with MTOUCH_SENSORS=1 MTOUCH_BUTTONS=1.
+The fork's sources and its XC8 build (dist/default/production) are
+taken from git history, from before the commit that deleted them, and
+compared with the shared library in mbutton.X's configuration.
+
+XC8 does not run here, so the fork is measured and the shared build
+estimated from it:
+
+  flash, RAM    the fork's from its map. Both libraries are compiled for
+                the host as ram_budget.py does (gcc -m32 -Os, packed) and
+                linked from the same mainloop with unused sections
+                dropped; the shared library's words are the fork's library
+                words times the host ratio, plus the fork's other code,
+                which is the same in both builds.
+  stack         the fork's hardware stack levels from its map; each chain
+                of the shared build is the fork's plus the difference of
+                the two libraries' deepest static call chains, from gcc
+                -fcallgraph-info without inlining. Like XC8's, these count
+                every path, the round retry included, whether it runs or
+                not; calls out of the library count one level each.
+  cycles        the fork's hex runs on pic16_sim.py, which counts its
+                cycles exactly. Both libraries run the same tap on
+                touch_model.c under insn_count.c; the shared build's PIC
+                cycles are the fork's scaled by the ratio of host
+                instructions, for the TMR2 handler and for the mainloop's
+                work per round. The scan routines, the MCC interrupt
+                manager and the TMR2 driver are the same code in both and
+                are taken from the simulation as they are.
+
+    one_key_bench.py        report, exit 1 if the shared build does not fit
+                            or misses a tap
+"""
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(HERE))
+MTOUCH = os.path.join(ROOT, 'mtouch.X', 'mcc_generated_files', 'mtouch')
+sys.path.insert(0, os.path.join(ROOT, 'tools'))
+
+import footprint                # noqa: E402
+import pic16_sim                # noqa: E402
+import ram_budget               # noqa: E402
+
+FORK_SOURCE = 'mbutton.X/mcc_generated_files/mtouch'
+FORK_BUILD = 'mbutton.X/dist/default/production'
+FORK_LIBRARY = ['mtouch.c', 'mtouch_sensor.c', 'mtouch_button.c']
+
+FCY = 4000000                   # 16 MHz, both builds
+FOOTPRINT_CFLAGS = ram_budget.CFLAGS[:-2] + [
+    '-ffunction-sections', '-fdata-sections', '-fno-asynchronous-unwind-tables',
+    '-fno-pic', '-fno-stack-protector']
+BENCH_CFLAGS = ['-std=c99', '-w', '-no-pie', '-fno-pie', '-I' + HERE,
+                '-D_XTAL_FREQ=16000000', '-DMODEL_CYCLES_PER_MS=4000UL']
+SHARED_CFLAGS = ['-DMTOUCH_SENSOR_SCAN_EXTERNAL', '-DMTOUCH_SCAN_RESULT()=Model_Scan_Result()']
+
+ENTRY = '''#include <xc.h>
+#include "mtouch.h"
+volatile unsigned char led;
+void bench_main(void)
+{
+    MTOUCH_Initialize();
+    for(;;)
+    {
+        MTOUCH_Service_Mainloop();
+        led = MTOUCH_Button_isPressed(Button0);
+    }
+}
+'''
+
+# PIC simulation of the fork: a tap once the baseline is in, as in one_key_bench.c
+SIM_TOUCH_MS = 150
+SIM_END_MS = 200
+SIM_LED = (0x10E, 0x20)         # LATC5, set while the key is pressed
+SIM_TMR2 = ['_TMR2_StartTimer', '_TMR2_StopTimer', '_TMR2_LoadPeriodRegister',
+            '_TMR2_SetInterruptHandler']
+
+# host functions of the model the PIC does not run, and those the simulation times as they are
+MODEL = ['Model_Wait', 'Bench_PIR1', 'Model_Scan_Result', 'MTOUCH_CVD_ScanA_0',
+         'MTOUCH_CVD_ScanB_0', 'TMR2_StartTimer', 'TMR2_StopTimer',
+         'TMR2_LoadPeriodRegister', 'TMR2_SetInterruptHandler']
+
+
+def git(*args):
+    return subprocess.run(['git', '-C', ROOT] + list(args), check=True,
+                          capture_output=True).stdout
+
+
+def extract_fork(work):
+    """The fork's sources and XC8 build, from before the commit that deleted them."""
+    rev = git('log', '--diff-filter=D', '--format=%H', '-1', '--',
+              FORK_SOURCE + '/mtouch.c').decode().strip()
+    if not rev:
+        sys.exit('one_key_bench: the fork is not in the history')
+    tar = git('archive', rev + '^', FORK_SOURCE, FORK_BUILD)
+    subprocess.run(['tar', '-x', '-C', work], input=tar, check=True)
+    fork = os.path.join(work, 'mbutton.X')
+    for stand_in in ('mcc.h', 'tmr2.h'):      # the fork includes "../mcc.h" and "../tmr2.h"
+        shutil.copy(os.path.join(HERE, stand_in), os.path.join(fork, 'mcc_generated_files'))
+    return os.path.join(fork, 'mcc_generated_files', 'mtouch'), os.path.join(work, FORK_BUILD)
+
+
+def run(cmd, **kw):
+    return subprocess.run(cmd, check=True, capture_output=True, text=True, **kw).stdout
+
+
+def values(text, prefix=None):
+    """{name: [numbers]} of "name value..." lines, or of "prefix name value..." ones."""
+    out = {}
+    for line in text.splitlines():
+        f = line.split()
+        if prefix:
+            if len(f) < 3 or f[0] != prefix:
+                continue
+            f = f[1:]
+        if len(f) >= 2 and re.match(r'^[\d.]+$', f[1]):
+            out[f[0]] = [float(v) for v in f[1:]]
+    return out
+
+
+class Build(object):
+    """One library build: name, source directory, sources, compiler flags."""
+
+    def __init__(self, name, src, sources, cflags):
+        self.name = name
+        self.src = src
+        self.sources = [os.path.join(src, s) for s in sources]
+        self.cflags = cflags
+
+
+# --- flash and RAM --------------------------------------------------------
+
+def host_footprint(build, work):
+    """Flash-resident bytes (code, constants, initial data) and RAM bytes on the host."""
+    out = os.path.join(work, build.name + '_fp')
+    os.makedirs(out)
+    entry = os.path.join(out, 'entry.c')
+    with open(entry, 'w') as f:
+        f.write(ENTRY)
+    with open(os.path.join(out, 'stdlib.h'), 'w') as f:
+        f.write(ram_budget.STDLIB)
+    with open(os.path.join(out, 'string.h'), 'w') as f:    # the fork includes it
+        f.write('#include <stddef.h>\n')
+    objects = []
+    for src in [entry] + build.sources:
+        obj = os.path.join(out, os.path.basename(src) + '.o')
+        run(['gcc'] + FOOTPRINT_CFLAGS + ['-I' + out, '-I' + build.src] + build.cflags +
+            ['-c', src, '-o', obj])
+        objects.append(obj)
+    elf = os.path.join(out, 'bench.elf')
+    run(['ld', '-m', 'elf_i386', '--gc-sections', '-e', 'bench_main',
+         '--unresolved-symbols=ignore-all', '-o', elf] + objects)
+    flash = ram = 0
+    for line in run(['size', '-A', elf]).splitlines():
+        f = line.split()
+        if len(f) < 2 or not f[1].isdigit():
+            continue
+        if re.match(r'^\.(text|rodata|data)', f[0]):
+            flash += int(f[1])
+        if re.match(r'^\.(data|bss)', f[0]):
+            ram += int(f[1])
+    return flash, ram
+
+
+# --- host runs ----------------------------------------------------------
+
+def bench_binary(build, work, flags, tag):
+    exe = os.path.join(work, '%s_%s' % (build.name, tag))
+    run(['gcc'] + BENCH_CFLAGS + flags + ['-I' + build.src] + build.cflags + ['-o', exe,
+        os.path.join(HERE, 'one_key_bench.c'), os.path.join(HERE, 'touch_model.c')] +
+        build.sources + ['-lm'])
+    return exe
+
+
+def symbols(exe):
+    out = {}
+    for line in run(['nm', exe]).splitlines():
+        f = line.split()
+        if len(f) == 3:
+            out[f[2]] = f[0]
+    return out
+
+
+def host_run(build, work, counter, fork):
+    """Taps, rounds and host instructions of one library."""
+    exe = bench_binary(build, work, ['-Os'], 'run')
+    result = values(run([exe]))
+    sym = symbols(exe)
+    spec = ['+count=' + sym['Bench_Count'], 'isr=' + sym['Sensor_Acq_ExecuteScan'],
+            'main=' + sym['MTOUCH_Service_Mainloop'] + ('/' + sym['tmr2_on'] if fork else '')]
+    spec += ['-%s=%s' % (name, sym[name]) for name in MODEL if name in sym]
+    out = run([counter] + spec + ['--', exe, 'count'])
+    result['insn'] = values(out, 'insn')
+    result['rounds_counted'] = values(out)['rounds_counted'][0]
+    return result
+
+
+def call_depth(build, work):
+    """Deepest static call chain under the mainloop and under the TMR2 handler."""
+    out = os.path.join(work, build.name + '_cg')
+    os.makedirs(out)
+    names, calls = {}, {}
+    for src in build.sources:
+        base = os.path.join(out, os.path.basename(src))
+        run(['gcc', '-std=c99', '-w', '-O1', '-fno-inline', '-fcallgraph-info', '-I' + HERE,
+             '-I' + build.src] + build.cflags + ['-c', src, '-o', base + '.o'], cwd=out)
+        with open(base + '.ci') as f:
+            for line in f:
+                node = re.match(r'node: \{ title: "([^"]+)" label: "([^"\\]+)', line)
+                edge = re.match(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"', line)
+                if node:
+                    names[node.group(1)] = node.group(2)
+                elif edge:
+                    calls.setdefault(edge.group(1), set()).add(edge.group(2))
+    graph = {}
+    for caller, callees in calls.items():
+        graph.setdefault(names[caller], set()).update(names.get(c, c) for c in callees)
+
+    def depth(name, seen=()):
+        if name in seen:
+            sys.exit('one_key_bench: %s is recursive' % name)
+        return 1 + max([depth(c, seen + (name,)) for c in graph.get(name, ())] or [0])
+    return {'main': depth('MTOUCH_Service_Mainloop'), 'isr': depth('Sensor_Acq_ExecuteScan')}
+
+
+# --- the fork on the PIC ----------------------------------------------------
+
+def model_adc():
+    """Key and hold capacitance of sensor 0 in touch_model.c."""
+    with open(os.path.join(HERE, 'touch_model.c')) as f:
+        key = float(re.search(r'model_key_pf\[8\] = \{\s*([\d.]+)', f.read()).group(1))
+    with open(os.path.join(HERE, 'touch_model.h')) as f:
+        hold = float(re.search(r'MODEL_HOLD_PF\s+([\d.]+)', f.read()).group(1))
+    return key, hold
+
+
+def pic_run(build_dir):
+    """Cycles of the fork's XC8 build through a tap, attributed to its parts."""
+    words = pic16_sim.load_hex(os.path.join(build_dir, 'mbutton.X.production.hex'))
+    sym = {}
+    with open(os.path.join(build_dir, 'mbutton.X.production.sym')) as f:
+        for line in f:
+            v = line.split()
+            if len(v) >= 4:
+                sym[v[0]] = int(v[1], 16)
+    key, hold = model_adc()
+    finger = [0.0]
+
+    def adc(channel):
+        cs = key + finger[0]
+        if not sim.ram[sym['_packet_counter']] & 1:           # scanA on an even count
+            return int(1023.0 * hold / (hold + cs) + 0.5)
+        return int(1023.0 * cs / (hold + cs) + 0.5)
+
+    sim = pic16_sim.Pic16(words, adc)
+    tracked = {sym['_Sensor_Acq_ExecuteScan']: 'handler', sym['_MTOUCH_Service_Mainloop']: 'main',
+               sym['_MTOUCH_CVD_ScanA_0']: 'scan', sym['_MTOUCH_CVD_ScanB_0']: 'scan'}
+    tracked.update((sym[name], 'tmr2') for name in SIM_TMR2)
+    cycles = dict.fromkeys(['handler', 'main', 'scan', 'tmr2', 'wait', 'interrupt', None], 0)
+    frames = []
+    rounds = []
+    touch_at = SIM_TOUCH_MS * FCY // 1000
+    press = None
+    while sim.cycles < SIM_END_MS * FCY // 1000:
+        while frames and len(sim.stack) < frames[-1][1]:
+            frames.pop()
+        name = tracked.get(sim.pc)
+        if name and not (frames and frames[-1] == (name, len(sim.stack))):
+            frames.append((name, len(sim.stack)))
+            if name == 'main':
+                rounds.append(sim.cycles)
+        inner = frames[-1][0] if frames else None
+        if sim.isr_start is None and inner == 'main' and sim.ram[pic16_sim.T2CON] & 0x04:
+            inner = 'wait'
+        start, isr = sim.cycles, sim.isr_start
+        sim.step()
+        if isr is None and sim.isr_start is not None:
+            inner = 'interrupt'                 # vectoring
+        elif isr is not None and sim.isr_start is not None and inner not in ('handler', 'scan'):
+            inner = 'interrupt'                 # interrupt manager, TMR2_ISR
+        cycles[inner] += sim.cycles - start
+        if sim.cycles >= touch_at and not finger[0]:
+            finger[0] = 1.0
+        if press is None and finger[0] and sim.ram[SIM_LED[0]] & SIM_LED[1]:
+            press = sim.cycles - touch_at
+    # whole rounds from the third on, once the button has initialised
+    spans = [b - a for a, b in zip(rounds[2:], rounds[3:])]
+    calls = len(sim.isr_cycles)
+    return {
+        'isr_calls': calls,
+        'isr_mean': sum(sim.isr_cycles) / calls,
+        'isr_max': max(sim.isr_cycles),
+        'handler': cycles['handler'] / calls,
+        'fixed': (cycles['scan'] + cycles['interrupt']) / calls,
+        'main_round': cycles['main'] / len(rounds),
+        'round': sum(spans) / len(spans),
+        'press_ms': press * 1000.0 / FCY if press is not None else None,
+        'stack': sim.depth,
+    }
+
+
+# --- report ---------------------------------------------------------------
+
+def main():
+    work = tempfile.mkdtemp()
+    failed = []
+    try:
+        fork_src, fork_dist = extract_fork(work)
+        defines = ['-D' + d for d in ram_budget.project_defines('mbutton.X')]
+        fork = Build('fork', fork_src, FORK_LIBRARY,
+                     ['-DBENCH_FORK', '-include', os.path.join(HERE, 'bench_fork.h')])
+        shared = Build('shared', MTOUCH, ram_budget.SOURCES, defines + SHARED_CFLAGS)
+        xc8 = footprint.analyze(os.path.join(fork_dist, 'mbutton.X.production.map'))
+
+        counter = os.path.join(work, 'insn_count')
+        run(['gcc', '-std=c99', '-O2', '-o', counter, os.path.join(HERE, 'insn_count.c')])
+
+        fp = {b.name: host_footprint(b, work) for b in (fork, shared)}
+        host = {b.name: host_run(b, work, counter, b is fork) for b in (fork, shared)}
+        depth = {b.name: call_depth(b, work) for b in (fork, shared)}
+        pic = pic_run(fork_dist)
+    finally:
+        shutil.rmtree(work)
+
+    # flash and RAM
+    library = sum(xc8['module_code'][m] for m in FORK_LIBRARY)
+    other = xc8['program_used'] - library
+    flash_ratio = float(fp['shared'][0]) / fp['fork'][0]
+    shared_words = other + int(round(library * flash_ratio))
+    shared_data = xc8['data_used'] + fp['shared'][1] - fp['fork'][1]
+
+    # stack: main chain and interrupt chain
+    main_levels = xc8['call_depth']['main'] + depth['shared']['main'] - depth['fork']['main']
+    isr_levels = xc8['call_depth']['interrupt 1'] + depth['shared']['isr'] - depth['fork']['isr']
+
+    # cycles: PIC cycles per host instruction of the fork, for the handler and the mainloop
+    insn = {b: host[b]['insn'] for b in host}
+    rounds = {b: host[b]['rounds_counted'] for b in host}
+    handler_insns = {b: insn[b]['isr'][1] / insn[b]['isr'][0] for b in host}
+    main_insns = {b: insn[b]['main'][1] / rounds[b] for b in host}
+    k_handler = pic['handler'] / handler_insns['fork']
+    k_main = pic['main_round'] / main_insns['fork']
+    handler = handler_insns['shared'] * k_handler
+    isr_mean = pic['fixed'] + handler
+    isr_max = pic['isr_max'] + (insn['shared']['isr'][2] - insn['fork']['isr'][2]) * k_handler
+    main_round = main_insns['shared'] * k_main
+    main_call = insn['shared']['main'][2] * k_main
+    period = host['shared']['scan_cycles'][0] / host['shared']['isr_calls'][0]
+    # the interrupt outlasts the period, so the scans of a packet run back to back
+    scans = {b: insn[b]['isr'][0] / rounds[b] for b in host}
+    round_fork = scans['fork'] * max(period, pic['isr_mean']) + pic['main_round']
+    round_shared = scans['shared'] * max(period, isr_mean) + main_round
+
+    print('one-key build, mbutton.X (PIC16F1703, 16 MHz): fork from history against the shared library')
+    print('  %-34s %14s %14s' % ('', 'fork (XC8)', 'shared (est.)'))
+    print('  %-34s %14d %14d   of %d' % ('program words', xc8['program_used'], shared_words, xc8['program_size']))
+    print('    %-32s %14d %14d   host bytes %d / %d' % ('mTouch library', library, shared_words - other,
+          fp['fork'][0], fp['shared'][0]))
+    print('  %-34s %14d %14d   of %d, host bytes %d / %d' % ('data bytes', xc8['data_used'], shared_data,
+          xc8['data_size'], fp['fork'][1], fp['shared'][1]))
+    print('  %-34s %9d + %-2d %9d + %-2d of %d' % ('hardware stack, main + interrupt',
+          xc8['call_depth']['main'], xc8['call_depth']['interrupt 1'], main_levels, isr_levels,
+          xc8['hw_stack_limit']))
+    print('  %-34s %14.0f %14.0f   of a %.0f cycle TMR2 period' % ('interrupt cycles, mean',
+          pic['isr_mean'], isr_mean, period))
+    print('  %-34s %14.0f %14.0f' % ('interrupt cycles, longest', pic['isr_max'], isr_max))
+    print('  %-34s %14.0f %14.0f   host instructions %.1f / %.1f' % ('  of which the TMR2 handler',
+          pic['handler'], handler, handler_insns['fork'], handler_insns['shared']))
+    print('  %-34s %14.0f %14.0f   host instructions %.0f / %.0f, the model polls every interrupt' % (
+          'mainloop work cycles a round', pic['main_round'], main_round, main_insns['fork'],
+          main_insns['shared']))
+    print('  %-34s %14.0f %14.0f   the fork returns once the round is done' % (
+          'longest mainloop call, cycles', pic['round'], main_call))
+    print('  %-34s %14.0f %14.0f   %.0f scans x longer of period and interrupt, + mainloop' % (
+          'round, cycles', round_fork, round_shared, scans['shared']))
+    print('  %-34s %14.0f %14s' % ('  simulated', pic['round'], ''))
+    print('  %-34s %14.1f %14.1f   simulated / model, mean of %d taps' % ('press latency, ms',
+          pic['press_ms'] or 0.0, host['shared']['press_ms'][0], host['shared']['taps'][0]))
+    print('  %-34s %11d/%d %11d/%d   on the model' % ('taps seen', host['fork']['presses'][0],
+          host['fork']['taps'][0], host['shared']['presses'][0], host['shared']['taps'][0]))
+
+    if shared_words > xc8['program_size']:
+        failed.append('program words')
+    if shared_data > xc8['data_size']:
+        failed.append('data bytes')
+    if main_levels + isr_levels > xc8['hw_stack_limit']:
+        failed.append('hardware stack')
+    if host['shared']['presses'][0] < host['shared']['taps'][0]:
+        failed.append('taps')
+    print('%s: %s' % ('FAIL' if failed else 'PASS', ', '.join(failed) or 'the shared one-key build fits'))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,405 @@
+"""Instruction set simulator of the PIC16F1703 core, to count cycles.
+
+It runs an XC8 .hex as the device would, one instruction cycle at a
+time: the 49 instructions of the enhanced mid-range core with their
+flags and cycle counts, banked and linear data memory, FSR reads of
+program memory, the 16 level hardware stack, the automatic context save
+of an interrupt, TMR2 and the ADC. Other peripherals are plain memory.
+
+The ADC conversion takes ADC_TAD_CYCLES per TAD for ADC_CONVERSION_TAD
+TADs (FOSC/16 at 16 MHz, as mTouch sets ADCON1); its result is taken
+from the adc(channel) callback when GO is set, as the hold capacitor
+is. It is only used to measure; nothing
+here checks the code it runs against the datasheet's reset values.
+"""
+
+# core registers, in every bank
+INDF0, INDF1, PCL, STATUS, FSR0L, FSR0H, FSR1L, FSR1H, BSR, WREG, PCLATH, INTCON = range(12)
+C, DC, Z = 1, 2, 4
+SHADOWED = (STATUS, WREG, BSR, PCLATH, FSR0L, FSR0H, FSR1L, FSR1H)
+
+# peripherals, as absolute banked addresses
+PIR1, TMR2, PR2, T2CON = 0x011, 0x01A, 0x01B, 0x01C
+PIE1 = 0x091
+ADRESL, ADRESH, ADCON0, ADCON1 = 0x09B, 0x09C, 0x09D, 0x09E
+TMR2IF, ADIF = 0x02, 0x40
+GIE, PEIE = 0x80, 0x40
+
+ADC_TAD_CYCLES = 4
+ADC_CONVERSION_TAD = 12
+STACK_LEVELS = 16
+
+
+def load_hex(path):
+    """Program words of an Intel hex file, configuration words left out."""
+    words = [0x3FFF] * 2048
+    base = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(':'):
+                continue
+            data = bytes.fromhex(line[1:])
+            count, addr, kind = data[0], (data[1] << 8) | data[2], data[3]
+            if kind == 4:
+                base = ((data[4] << 8) | data[5]) << 16
+            elif kind == 0:
+                for i in range(0, count, 2):
+                    word = (base + addr + i) // 2
+                    if word < len(words):
+                        words[word] = data[4 + i] | (data[5 + i] << 8)
+    return words
+
+
+def signed(value, bits):
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+class Pic16(object):
+    def __init__(self, words, adc=lambda channel: 0):
+        self.rom = words
+        self.adc = adc
+        self.ram = bytearray(32 * 128)
+        self.core = [0] * 12
+        self.core[STATUS] = 0x18
+        self.shadow = None
+        self.stack = []
+        self.depth = 0                  # deepest the hardware stack got
+        self.pc = 0
+        self.extra = 0
+        self.cycles = 0
+        self.tmr2_prescale = 0
+        self.tmr2_postscale = 0
+        self.adc_left = 0
+        self.adc_result = 0
+        self.isr_start = None
+        self.isr_cycles = []            # length of each interrupt, vectoring included
+
+    # --- data memory --------------------------------------------------
+
+    def _banked(self, bank, f):
+        return f if f >= 0x70 else (bank << 7) | f
+
+    def _fsr(self, n):
+        return self.core[FSR0L + 2 * n] | (self.core[FSR0H + 2 * n] << 8)
+
+    def _set_fsr(self, n, value):
+        value &= 0xFFFF
+        self.core[FSR0L + 2 * n] = value & 0xFF
+        self.core[FSR0H + 2 * n] = value >> 8
+
+    def _indirect(self, fsr):
+        """(core index, None) or (None, ram address) or (None, -word) of an FSR value."""
+        if fsr >= 0x8000:
+            return None, -(fsr - 0x8000) - 1
+        if 0x2000 <= fsr < 0x29B0:
+            offset = fsr - 0x2000
+            return None, ((offset // 80) << 7) | (0x20 + offset % 80)
+        f = fsr & 0x7F
+        if f < 12:
+            return f, None
+        return None, self._banked((fsr >> 7) & 0x1F, f)
+
+    def _read_at(self, core, addr):
+        if core is not None:
+            return self.read(core)
+        if addr < 0:
+            return self.rom[-addr - 1] & 0xFF
+        return self.ram[addr]
+
+    def _write_at(self, core, addr, value):
+        if core is not None:
+            self.write(core, value)
+        elif addr >= 0:
+            self._store(addr, value)
+
+    def read(self, f):
+        if f < 12:
+            if f in (INDF0, INDF1):
+                return self._read_at(*self._indirect(self._fsr(f)))
+            if f == PCL:
+                return self.pc & 0xFF
+            return self.core[f]
+        return self.ram[self._banked(self.core[BSR], f)]
+
+    def write(self, f, value):
+        value &= 0xFF
+        if f < 12:
+            if f in (INDF0, INDF1):
+                self._write_at(*(self._indirect(self._fsr(f)) + (value,)))
+            elif f == PCL:
+                self.pc = (self.core[PCLATH] << 8) | value
+                self.extra += 1
+            else:
+                self.core[f] = value
+            return
+        self._store(self._banked(self.core[BSR], f), value)
+
+    def _store(self, addr, value):
+        if addr == ADCON0 and value & 0x03 == 0x03 and not self.ram[ADCON0] & 0x02:
+            self.adc_left = ADC_TAD_CYCLES * ADC_CONVERSION_TAD
+            self.adc_result = self.adc((value >> 2) & 0x1F) & 0x3FF     # sampled at GO
+        self.ram[addr] = value
+
+    # --- peripherals --------------------------------------------------
+
+    def _tick(self, cycles):
+        self.cycles += cycles
+        t2con = self.ram[T2CON]
+        if t2con & 0x04:
+            prescale = (1, 4, 16, 64)[t2con & 0x03]
+            self.tmr2_prescale += cycles
+            while self.tmr2_prescale >= prescale:
+                self.tmr2_prescale -= prescale
+                if self.ram[TMR2] == self.ram[PR2]:
+                    self.ram[TMR2] = 0
+                    self.tmr2_postscale += 1
+                    if self.tmr2_postscale > (t2con >> 3) & 0x0F:
+                        self.tmr2_postscale = 0
+                        self.ram[PIR1] |= TMR2IF
+                else:
+                    self.ram[TMR2] = (self.ram[TMR2] + 1) & 0xFF
+        if self.adc_left:
+            self.adc_left = max(0, self.adc_left - cycles)
+            if not self.adc_left:
+                result = self.adc_result
+                if self.ram[ADCON1] & 0x80:
+                    self.ram[ADRESH], self.ram[ADRESL] = result >> 8, result & 0xFF
+                else:
+                    self.ram[ADRESH], self.ram[ADRESL] = result >> 2, (result & 3) << 6
+                self.ram[ADCON0] &= ~0x02
+                self.ram[PIR1] |= ADIF
+
+    def _interrupt(self):
+        intcon = self.core[INTCON]
+        if not intcon & GIE:
+            return False
+        pending = intcon & (intcon >> 3) & 0x07
+        if intcon & PEIE and self.ram[PIR1] & self.ram[PIE1]:
+            pending = 1
+        if not pending:
+            return False
+        self.shadow = list(self.core)
+        self._push(self.pc)
+        self.pc = 0x0004
+        self.core[INTCON] &= ~GIE
+        self.isr_start = self.cycles
+        self._tick(3)                   # synchronous interrupt latency
+        return True
+
+    # --- execution ----------------------------------------------------
+
+    def _push(self, pc):
+        self.stack.append(pc)
+        self.depth = max(self.depth, len(self.stack))
+        if len(self.stack) > STACK_LEVELS:
+            raise RuntimeError('hardware stack overflow at 0x%03X' % pc)
+
+    def _flags(self, z=None, c=None, dc=None):
+        status = self.core[STATUS]
+        for bit, value in ((Z, z), (C, c), (DC, dc)):
+            if value is not None:
+                status = (status | bit) if value else (status & ~bit)
+        self.core[STATUS] = status
+
+    def _add(self, a, b, carry=0):
+        result = a + b + carry
+        self._flags(z=not result & 0xFF, c=result > 0xFF, dc=(a & 0xF) + (b & 0xF) + carry > 0xF)
+        return result & 0xFF
+
+    def _result(self, d, f, value):
+        if d:
+            self.write(f, value)
+        else:
+            self.core[WREG] = value & 0xFF
+
+    def run(self, until):
+        """Execute until the cycle count reaches until."""
+        while self.cycles < until:
+            self.step()
+
+    def step(self):
+        if self._interrupt():
+            return
+        op = self.rom[self.pc & 0x7FF]
+        self.pc = (self.pc + 1) & 0x7FFF
+        self.extra = 0
+        cycles = 1
+        w = self.core[WREG]
+        status = self.core[STATUS]
+        top = op >> 12
+
+        if top == 0:                                    # byte oriented, inherent
+            sub = (op >> 8) & 0x0F
+            d = (op >> 7) & 1
+            f = op & 0x7F
+            if sub == 0:
+                if d:
+                    self.write(f, w)                    # MOVWF
+                elif op == 0x0008:                      # RETURN
+                    self.pc = self.stack.pop()
+                    cycles = 2
+                elif op == 0x0009:                      # RETFIE
+                    self.pc = self.stack.pop()
+                    for r in SHADOWED:
+                        self.core[r] = self.shadow[r]
+                    self.core[INTCON] |= GIE
+                    cycles = 2
+                    if self.isr_start is not None:
+                        self._tick(cycles)
+                        self.isr_cycles.append(self.cycles - self.isr_start)
+                        self.isr_start = None
+                        return
+                elif op == 0x000A:                      # CALLW
+                    self._push(self.pc)
+                    self.pc = (self.core[PCLATH] << 8) | w
+                    cycles = 2
+                elif op == 0x000B:                      # BRW
+                    self.pc = (self.pc + w) & 0x7FFF
+                    cycles = 2
+                elif op & 0xFFE0 == 0x0020:             # MOVLB
+                    self.core[BSR] = op & 0x1F
+                elif op & 0xFFF0 == 0x0010:             # MOVIW / MOVWI ++/--
+                    n = (op >> 2) & 1
+                    mode = op & 3
+                    fsr = self._fsr(n)
+                    if mode == 0:
+                        fsr += 1
+                    elif mode == 1:
+                        fsr -= 1
+                    target = self._indirect(fsr & 0xFFFF) if mode < 2 else self._indirect(fsr)
+                    if op & 0x08:
+                        self._write_at(*(target + (w,)))
+                    else:
+                        value = self._read_at(*target)
+                        self.core[WREG] = value
+                        self._flags(z=not value)
+                    if mode == 2:
+                        fsr += 1
+                    elif mode == 3:
+                        fsr -= 1
+                    self._set_fsr(n, fsr)
+                elif op in (0x0064, 0x0062, 0x0063, 0x0001) or op & 0xFFF8 == 0x0060:
+                    pass                                # CLRWDT, OPTION, SLEEP, RESET, TRIS
+                # NOP otherwise
+            elif sub == 1:
+                if d:
+                    self.write(f, 0)                    # CLRF
+                else:
+                    self.core[WREG] = 0                 # CLRW
+                self._flags(z=True)
+            else:
+                value = self.read(f)
+                if sub == 2:                            # SUBWF
+                    self._result(d, f, self._add(value, ~w & 0xFF, 1))
+                elif sub == 3:                          # DECF
+                    value = (value - 1) & 0xFF
+                    self._flags(z=not value)
+                    self._result(d, f, value)
+                elif sub in (4, 5, 6):                  # IORWF ANDWF XORWF
+                    value = (value | w, value & w, value ^ w)[sub - 4]
+                    self._flags(z=not value)
+                    self._result(d, f, value)
+                elif sub == 7:                          # ADDWF
+                    self._result(d, f, self._add(value, w))
+                elif sub == 8:                          # MOVF
+                    self._flags(z=not value)
+                    self._result(d, f, value)
+                elif sub == 9:                          # COMF
+                    value = ~value & 0xFF
+                    self._flags(z=not value)
+                    self._result(d, f, value)
+                elif sub == 10:                         # INCF
+                    value = (value + 1) & 0xFF
+                    self._flags(z=not value)
+                    self._result(d, f, value)
+                elif sub in (11, 15):                   # DECFSZ INCFSZ
+                    value = (value + (1 if sub == 15 else -1)) & 0xFF
+                    self._result(d, f, value)
+                    if not value:
+                        self.pc += 1
+                        cycles = 2
+                elif sub == 12:                         # RRF
+                    self._result(d, f, (value >> 1) | ((status & C) << 7))
+                    self._flags(c=value & 1)
+                elif sub == 13:                         # RLF
+                    self._result(d, f, ((value << 1) | (status & C)) & 0xFF)
+                    self._flags(c=value & 0x80)
+                elif sub == 14:                         # SWAPF
+                    self._result(d, f, ((value << 4) | (value >> 4)) & 0xFF)
+
+        elif top == 1:                                  # bit oriented
+            kind = (op >> 10) & 3
+            bit = 1 << ((op >> 7) & 7)
+            f = op & 0x7F
+            value = self.read(f)
+            if kind == 0:
+                self.write(f, value & ~bit)             # BCF
+            elif kind == 1:
+                self.write(f, value | bit)              # BSF
+            elif (kind == 2) == (not value & bit):      # BTFSC clear, BTFSS set
+                self.pc += 1
+                cycles = 2
+
+        elif top == 2:                                  # CALL GOTO
+            target = ((self.core[PCLATH] & 0x78) << 8) | (op & 0x7FF)
+            if not op & 0x0800:
+                self._push(self.pc)
+            self.pc = target
+            cycles = 2
+
+        else:                                           # literal and control
+            k = op & 0xFF
+            sub = (op >> 8) & 0x0F
+            if sub == 0:
+                self.core[WREG] = k                     # MOVLW
+            elif sub == 1:
+                if op & 0x80:
+                    self.core[PCLATH] = op & 0x7F       # MOVLP
+                else:                                   # ADDFSR
+                    n = (op >> 6) & 1
+                    self._set_fsr(n, self._fsr(n) + signed(op & 0x3F, 6))
+            elif sub in (2, 3):                         # BRA
+                self.pc = (self.pc + signed(op & 0x1FF, 9)) & 0x7FFF
+                cycles = 2
+            elif sub == 4:                              # RETLW
+                self.core[WREG] = k
+                self.pc = self.stack.pop()
+                cycles = 2
+            elif sub in (5, 6, 7):                      # LSLF LSRF ASRF
+                d = (op >> 7) & 1
+                f = op & 0x7F
+                value = self.read(f)
+                if sub == 5:
+                    result = (value << 1) & 0xFF
+                    self._flags(c=value & 0x80)
+                else:
+                    result = (value >> 1) | (value & 0x80 if sub == 7 else 0)
+                    self._flags(c=value & 1)
+                self._flags(z=not result)
+                self._result(d, f, result)
+            elif sub in (8, 9, 10):                     # IORLW ANDLW XORLW
+                value = (w | k, w & k, w ^ k)[sub - 8]
+                self.core[WREG] = value
+                self._flags(z=not value)
+            elif sub in (11, 13):                       # SUBWFB ADDWFC
+                d = (op >> 7) & 1
+                f = op & 0x7F
+                value = self.read(f)
+                operand = (~w & 0xFF) if sub == 11 else w
+                self._result(d, f, self._add(value, operand, status & C))
+            elif sub == 12:                             # SUBLW
+                self.core[WREG] = self._add(k, ~w & 0xFF, 1)
+            elif sub == 14:                             # ADDLW
+                self.core[WREG] = self._add(w, k)
+            else:                                       # MOVIW / MOVWI k[n]
+                n = (op >> 6) & 1
+                target = self._indirect((self._fsr(n) + signed(op & 0x3F, 6)) & 0xFFFF)
+                if op & 0x80:
+                    self._write_at(*(target + (w,)))
+                else:
+                    value = self._read_at(*target)
+                    self.core[WREG] = value
+                    self._flags(z=not value)
+
+        self._tick(cycles + self.extra)
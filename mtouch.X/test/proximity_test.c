@@ -0,0 +1,317 @@
+/*
+ * Proximity against touch_model.c: a hand brought in and out of range.
+ *
+ * A hand is a small capacitance on the proximity sensor, well below
+ * a touch, that comes and goes over MODEL_CONTACT_MS. Each scenario
+ * runs the library's full-rate scan and compares MTOUCH_Proximity_isNear()
+ * with the hand:
+ *      near                hand in to isNear
+ *      far                 hand out to not near
+ *      recovery            hand out to a deviation back inside half the
+ *                          near threshold, which is the baseline having
+ *                          followed whatever the hand left behind
+ *      false near          near with no hand in range
+ *      missed              a hand never reported near
+ *      dropouts            near cleared while the hand is still in range,
+ *                          other than by MTOUCH_PROXIMITY_NEAR_TIMEOUT
+ *      presses             the hand must not press the key it is over
+ * against the scenario's limits. A hand left in range past
+ * MTOUCH_PROXIMITY_NEAR_TIMEOUT must be recalibrated away, and the next
+ * hand still be seen.
+ *
+ * Built without MTOUCH_LOWPOWER: asleep, the decimator gets one round a
+ * watchdog period, see mtouch_proximity.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+#include "mtouch_proximity.h"
+
+#define PROX_HANDS_MAX      24
+#define PROX_LATE_MS        200         /* near this long after the hand left still counts */
+#define PROX_RECOVERED      ((MTOUCH_PROXIMITY_THRESHOLD << MTOUCH_PROXIMITY_LEVEL_SHIFT) / 2)
+
+typedef struct
+{
+    const char*     name;
+    model_env_t     env;
+    uint8_t         hands;
+    uint32_t        first_ms;
+    uint32_t        on_ms;
+    uint32_t        off_ms;
+    double          delta_pf;
+    uint32_t        run_ms;             /* 0: the last hand + 1000 ms */
+    /* limits */
+    double          near_max_ms;
+    double          far_max_ms;
+    double          recover_max_ms;
+    uint8_t         false_max;
+    uint8_t         missed_max;
+    uint8_t         timeouts;           /* hands left long enough to be recalibrated away */
+} scenario_t;
+
+typedef struct
+{
+    uint8_t         nears;
+    double          near_sum, near_max;
+    uint8_t         fars;
+    double          far_sum, far_max;
+    uint8_t         recovered;
+    double          recover_sum, recover_max;
+    uint8_t         false_nears;
+    uint8_t         missed;
+    uint8_t         dropouts;
+    uint8_t         timeouts;
+    double          timeout_max;        /* hand in to the near state recalibrated away */
+    uint8_t         presses;
+    uint8_t         level_max;
+} result_t;
+
+/*
+ * A hand of 0.1 pF is about a tenth of a touch; the button sees it as a
+ * deviation of a few counts and the proximity sensor as several times
+ * its threshold. Limits are what a display waking on the hand needs:
+ * near in well under the ~100 ms a hand takes to reach the key, far
+ * and the baseline back within a few hundred ms.
+ */
+static const scenario_t scenarios[] =
+{
+    /*  name                       white  drift   film  at    ms     hum  Hz  rf  Hz      hands first on     off    pF    run    near  far  recover false missed timeouts */
+    {   "idle, no hand",         { 1.0,   0.002,  0,    0,    0,     0,   0,  0,  0   }, 0,    0,    0,     0,     0,    60000, 0,    0,   0,      0,    0,     0 },
+    {   "hand in and out",       { 1.0,   0,      0,    0,    0,     0,   0,  0,  0   }, 8,    2000, 1000,  2000,  0.1,  0,     150,  200, 400,    0,    0,     0 },
+    {   "distant hand",          { 1.0,   0,      0,    0,    0,     0,   0,  0,  0   }, 8,    2000, 1000,  2000,  0.04, 0,     200,  200, 400,    0,    0,     0 },
+    {   "noisy ADC",             { 2.0,   0,      0,    0,    0,     0,   0,  0,  0   }, 8,    2000, 1000,  2000,  0.1,  0,     200,  250, 400,    0,    0,     0 },
+    {   "drift, hand in and out",{ 1.0,   0.002,  0,    0,    0,     0,   0,  0,  0   }, 8,    2000, 1000,  2000,  0.1,  0,     150,  200, 400,    0,    0,     0 },
+    {   "humidity film",         { 1.0,   0,      0.2,  3000, 60000, 0,   0,  0,  0   }, 20,   2000, 1000,  2000,  0.1,  0,     150,  200, 400,    0,    0,     0 },
+    {   "hand left resting",     { 1.0,   0,      0,    0,    0,     0,   0,  0,  0   }, 2,    2000, 30000, 5000,  0.1,  0,     150,  0,   800,    0,    0,     2 },
+};
+
+static const scenario_t*    scenario;
+static model_touch_t        hand[PROX_HANDS_MAX];
+static bool                 hand_near[PROX_HANDS_MAX];
+static bool                 hand_timeout[PROX_HANDS_MAX];
+static bool                 hand_recovered[PROX_HANDS_MAX];
+static uint32_t             hand_left[PROX_HANDS_MAX];  /* round after the hand left, 0 while in range */
+static uint32_t             rounds;
+static bool                 was_near;
+static uint32_t             near_rounds;        /* rounds since near was reported */
+static bool                 was_pressed;
+static result_t             result;
+static int                  failures;
+
+/* The hand in range now, or the last one to leave within PROX_LATE_MS */
+static int8_t Prox_Hand(double now, double late_ms)
+{
+    uint8_t i;
+
+    for(i = 0; i < scenario->hands; i++)
+        if(now >= (double)hand[i].start_ms && now <= (double)(hand[i].start_ms + hand[i].length_ms) + late_ms)
+            return (int8_t)i;
+    return -1;
+}
+
+static void Prox_Near(double now)
+{
+    int8_t  i = Prox_Hand(now, PROX_LATE_MS);
+    double  latency;
+
+    if(i < 0 || hand_near[i])
+    {
+        result.false_nears++;                       /* no hand, or near again during one hand */
+        return;
+    }
+    hand_near[i] = true;
+    latency = now - (double)hand[i].start_ms;
+    result.nears++;
+    result.near_sum += latency;
+    if(latency > result.near_max)
+        result.near_max = latency;
+}
+
+static void Prox_Far(double now)
+{
+    int8_t  i = Prox_Hand(now, PROX_LATE_MS);
+    double  latency;
+
+    if(i < 0)
+        return;                                     /* a false near ending */
+    latency = now - (double)(hand[i].start_ms + hand[i].length_ms);
+    if(latency < -MODEL_CONTACT_MS)
+    {
+        /* Hand still in range: only the near timeout may clear it */
+        if(near_rounds < (uint32_t)MTOUCH_PROXIMITY_NEAR_TIMEOUT * MTOUCH_PROXIMITY_DECIMATION)
+        {
+            result.dropouts++;
+            return;
+        }
+        hand_timeout[i] = true;
+        result.timeouts++;
+        if(now - (double)hand[i].start_ms > result.timeout_max)
+            result.timeout_max = now - (double)hand[i].start_ms;
+        return;
+    }
+    result.fars++;
+    result.far_sum += latency;
+    if(latency > result.far_max)
+        result.far_max = latency;
+}
+
+/*
+ * Hand gone and the deviation back near zero: the baseline is where it
+ * was, or has followed the reading the hand left behind. Only counted
+ * once the decimator holds no round with the hand in it.
+ */
+static void Prox_Recovery(double now)
+{
+    mtouch_proximity_deviation_t    deviation = MTOUCH_Proximity_Deviation_Get();
+    bool                            back;
+    double                          latency;
+    uint8_t                         i;
+
+    back = (deviation <= PROX_RECOVERED && deviation >= -PROX_RECOVERED && !MTOUCH_Proximity_isNear());
+    for(i = 0; i < scenario->hands; i++)
+    {
+        latency = now - (double)(hand[i].start_ms + hand[i].length_ms);
+        if(latency < 0.0)
+            continue;
+        if(hand_left[i] == 0)
+            hand_left[i] = rounds;
+        if(!back || hand_recovered[i] || rounds - hand_left[i] < 2 * MTOUCH_PROXIMITY_DECIMATION)
+            continue;
+        if(!hand_near[i] && !hand_timeout[i])
+            continue;
+        hand_recovered[i] = true;
+        result.recovered++;
+        result.recover_sum += latency;
+        if(latency > result.recover_max)
+            result.recover_max = latency;
+    }
+}
+
+static void Prox_Mainloop(void)
+{
+    mtouch_gesture_event_t      gesture;
+    bool                        near, pressed;
+
+    if(MTOUCH_Service_Mainloop())
+    {
+        rounds++;
+        near = MTOUCH_Proximity_isNear();
+        near_rounds = (was_near) ? near_rounds + 1 : 0;
+        if(near && !was_near)
+            Prox_Near(Model_Time_ms());
+        else if(!near && was_near)
+            Prox_Far(Model_Time_ms());
+        was_near = near;
+        Prox_Recovery(Model_Time_ms());
+        if(MTOUCH_Proximity_Level_Get() > result.level_max)
+            result.level_max = MTOUCH_Proximity_Level_Get();
+
+        pressed = MTOUCH_Button_isPressed(Button0);
+        if(pressed && !was_pressed)
+            result.presses++;
+        was_pressed = pressed;
+    }
+    while(MTOUCH_Gesture_Get(&gesture))
+        ;
+}
+
+static void Prox_Simulate(void)
+{
+    uint32_t    period = scenario->on_ms + scenario->off_ms;
+    uint32_t    run_ms = scenario->run_ms;
+    uint8_t     i;
+
+    for(i = 0; i < scenario->hands; i++)
+    {
+        hand[i].sensor    = (uint8_t)MTOUCH_PROXIMITY_SENSOR;
+        hand[i].start_ms  = scenario->first_ms + i * period;
+        hand[i].length_ms = scenario->on_ms;
+        hand[i].delta_pf  = scenario->delta_pf;
+    }
+    if(run_ms == 0)
+        run_ms = scenario->first_ms + scenario->hands * period + 1000;
+
+    Model_Reset(&scenario->env, hand, scenario->hands, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(run_ms, Prox_Mainloop);
+
+    for(i = 0; i < scenario->hands; i++)
+        if(!hand_near[i])
+            result.missed++;
+}
+
+/* The library keeps its state in statics, so every scenario gets a fresh process */
+static result_t Prox_Run(const scenario_t* s)
+{
+    int         fd[2];
+    result_t    r;
+
+    memset(&r, 0, sizeof(r));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        scenario = s;
+        Prox_Simulate();
+        if(write(fd[1], &result, sizeof(result)) != sizeof(result))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &r, sizeof(r)) != sizeof(r))
+        r.missed = UINT8_MAX;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return r;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Prox_Scenario(const scenario_t* s)
+{
+    result_t    r = Prox_Run(s);
+
+    printf("  %s: %u hands of %.2f pF\n", s->name, s->hands, s->delta_pf);
+    printf("    near %5.1f/%5.1f ms  far %5.1f/%5.1f ms  recovery %5.1f/%5.1f ms (mean/max)\n",
+           r.nears ? r.near_sum / r.nears : 0.0, r.near_max,
+           r.fars ? r.far_sum / r.fars : 0.0, r.far_max,
+           r.recovered ? r.recover_sum / r.recovered : 0.0, r.recover_max);
+    printf("    false %u  missed %u  dropouts %u  timeouts %u (latest %.0f ms)  presses %u  peak level %u\n",
+           r.false_nears, r.missed, r.dropouts, r.timeouts, r.timeout_max, r.presses, r.level_max);
+
+    Check(r.near_max <= s->near_max_ms, "near latency within limit");
+    Check(r.far_max <= s->far_max_ms, "far latency within limit");
+    Check(r.recovered == s->hands && r.recover_max <= s->recover_max_ms, "baseline recovered after every hand");
+    Check(r.false_nears <= s->false_max, "false near within limit");
+    Check(r.missed <= s->missed_max, "missed hands within limit");
+    Check(r.dropouts == 0, "no near dropped while the hand is in range");
+    Check(r.timeouts == s->timeouts, "a hand left resting is recalibrated away");
+    Check(r.presses == 0, "the hand does not press the key");
+}
+
+int main(void)
+{
+    uint8_t n;
+
+    alarm(300);
+    printf("mTouch proximity against the sensor model: sensor %u, decimation %u\n",
+           (unsigned)MTOUCH_PROXIMITY_SENSOR, (unsigned)MTOUCH_PROXIMITY_DECIMATION);
+    for(n = 0; n < sizeof(scenarios) / sizeof(scenarios[0]); n++)
+        Prox_Scenario(&scenarios[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
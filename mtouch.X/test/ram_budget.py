@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Add up the static RAM of the mTouch library for each project configuration.
+
+XC8 does not run here. The library is compiled for the host instead,
+with gcc -m32, packed structs and one byte enums, which lays out its
+variables as XC8 does on the PIC16F1703 except for pointers: 4 bytes
+here, 2 on the PIC, so each callback or handler pointer counts 2 bytes
+high. The sum of .bss and .data is the library's static RAM.
+
+XC8 adds its compiled stack and the MCC drivers' variables. The only
+XC8 link in the tree with a readable map, the one-key project before it
+moved to the shared sources (mbutton.X, dist/default/production), used
+37 bytes of compiled stack. RESERVE keeps 48 for them, since a
+multi-key build has a few more loop counters in the same call chains.
+Calibrated against that link the same way, the host sum of its sources
+is 65 bytes where XC8 placed 51, the difference being the pointers.
+
+    ram_budget.py           report, exit 1 if a configuration does not fit
+    ram_budget.py -v        also list the variables of each configuration
+
+The projects' configurations are read from their nbproject files, so
+they are checked as they are built.
+"""
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(os.path.dirname(HERE))
+MTOUCH = os.path.join(ROOT, 'mtouch.X', 'mcc_generated_files', 'mtouch')
+
+DEVICE_RAM = 256                # PIC16F1703
+RESERVE = 48                    # compiled stack and MCC drivers
+
+SOURCES = ['mtouch.c', 'mtouch_sensor.c', 'mtouch_button.c', 'mtouch_slider.c',
+           'mtouch_gesture.c', 'mtouch_proximity.c', 'mtouch_telemetry.c']
+
+CFLAGS = ['-m32', '-ffreestanding', '-std=c99', '-Os', '-fpack-struct', '-fshort-enums',
+          '-fno-common', '-w', '-I' + HERE, '-I' + MTOUCH,
+          '-DMTOUCH_SENSOR_SCAN_EXTERNAL', '-DMTOUCH_SCAN_RESULT()=0']
+
+# only abs() is used from the C library; -m32 has no hosted headers here
+STDLIB = '#include <stddef.h>\nint abs(int);\n'
+
+# .data.rel.local holds the initialised pointers; const tables are in .data.rel.ro
+RAM_SECTION = re.compile(r'^\.(bss|data)(\.rel(\.local)?)?$')
+
+
+def project_defines(project):
+    """The define-macros of a project's XC8 configuration."""
+    path = os.path.join(ROOT, project, 'nbproject', 'configurations.xml')
+    with open(path) as f:
+        m = re.search(r'key="define-macros" value="([^"]*)"', f.read())
+    return [d for d in m.group(1).split(';') if d] if m else []
+
+
+CONFIGURATIONS = [
+    ('mtouch.X', project_defines('mtouch.X')),
+    ('mbutton.X', project_defines('mbutton.X')),
+    # mtouch.X on a 4x4 matrix, the build matrix_test runs
+    ('mtouch.X 4x4', project_defines('mtouch.X') + ['MTOUCH_SENSOR_MATRIX', 'MTOUCH_SENSOR_MATRIX_ROWS=4']),
+]
+
+
+def static_ram(defines, work):
+    """Return [(bytes, name)] of the library's RAM variables in this configuration."""
+    objects = []
+    for src in SOURCES:
+        obj = os.path.join(work, src.replace('.c', '.o'))
+        cmd = ['gcc'] + CFLAGS + ['-I' + work] + ['-D' + d for d in defines] + \
+              ['-c', os.path.join(MTOUCH, src), '-o', obj]
+        subprocess.run(cmd, check=True)
+        objects.append(obj)
+    dump = subprocess.run(['objdump', '-t'] + objects, check=True,
+                          capture_output=True, text=True).stdout
+    variables = []
+    for line in dump.splitlines():
+        f = line.split()
+        if len(f) >= 6 and f[-4] == 'O' and RAM_SECTION.match(f[-3]):
+            size = int(f[-2], 16)
+            if size:
+                variables.append((size, f[-1]))
+    return sorted(variables, reverse=True)
+
+
+def main():
+    verbose = '-v' in sys.argv[1:]
+    work = tempfile.mkdtemp()
+    failed = 0
+    try:
+        with open(os.path.join(work, 'stdlib.h'), 'w') as f:
+            f.write(STDLIB)
+        print('%-12s %6s %8s %6s  %s' % ('config', 'static', '+reserve', 'free', 'defines'))
+        for name, defines in CONFIGURATIONS:
+            variables = static_ram(defines, work)
+            total = sum(size for size, _ in variables)
+            free = DEVICE_RAM - RESERVE - total
+            print('%-12s %6d %8d %6d  %s%s' % (name, total, total + RESERVE, free,
+                  ' '.join(defines) or '(none)', '' if free >= 0 else '   DOES NOT FIT'))
+            if verbose:
+                for size, var in variables:
+                    print('    %4d  %s' % (size, var))
+            if free < 0:
+                failed += 1
+    finally:
+        shutil.rmtree(work)
+    print('%s: %d configurations over %d bytes' % ('FAIL' if failed else 'PASS', failed, DEVICE_RAM))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,170 @@
+/*
+ * Scan timing of the interrupt-driven mTouch acquisition, against
+ * touch_model.c.
+ *
+ * For a quiet, a noisy and an RF-disturbed board the library runs idle
+ * and reports:
+ *      round length        instruction cycles from one processed round
+ *                          to the next, and the packet length it settled on
+ *      time base           MTOUCH_Tick()'s count of the round cycles
+ *                          against the elapsed time; gesture timing uses it
+ *      mainloop gap        the longest the application waits for the CPU,
+ *                          against a whole round for the old blocking
+ *                          MTOUCH_Service_Mainloop()
+ * The model gives the interrupt no run time, so the gap is the TMR2
+ * period and the CPU taken by the handler itself is not measured here.
+ * Only full-rate scanning is timed; touch_test.c covers the wake from
+ * low power.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define TIMING_SETTLE_MS    300         /* packet lengths settle in a few rounds */
+#define TIMING_RUN_MS       1200        /* ends before a quiet board goes to low power */
+#define TIMING_GAP_MAX      256         /* cycles, one TMR2 period at most */
+#define TIMING_TICK_ERROR   2.0         /* %, time base against elapsed time */
+
+typedef struct
+{
+    const char*     name;
+    model_env_t     env;
+} condition_t;
+
+typedef struct
+{
+    uint32_t        rounds;
+    uint32_t        scans;
+    uint64_t        cycles;             /* elapsed over the window */
+    uint64_t        tick_cycles;        /* sum of MTOUCH_Sensor_RoundCycles_Get() */
+    uint64_t        gap_max;
+    uint64_t        round_max;
+} timing_t;
+
+static const condition_t conditions[] =
+{
+    /*  name                    white drift film at ms hum Hz rf  Hz */
+    {   "quiet board",         { 0.5, 0,    0,   0, 0, 0,  0, 0,  0      } },
+    {   "noisy ADC",           { 4.0, 0,    0,   0, 0, 0,  0, 0,  0      } },
+    {   "RF at the scan rate", { 1.0, 0,    0,   0, 0, 0,  0, 20, 166667 } },
+};
+
+static timing_t     timing;
+static bool         measuring;
+static uint64_t     last_pass;
+static uint64_t     last_round;
+static uint32_t     first_scans;
+static uint64_t     first_cycles;
+static int          failures;
+
+static void Timing_Mainloop(void)
+{
+    uint64_t now = Model_Cycles();
+
+    if(measuring && now - last_pass > timing.gap_max)
+        timing.gap_max = now - last_pass;
+    last_pass = now;
+
+    if(MTOUCH_Service_Mainloop())
+    {
+        if(!measuring && Model_Time_ms() >= TIMING_SETTLE_MS)
+        {
+            measuring = true;
+            first_scans = model_stats.scans;
+            first_cycles = now;
+        }
+        else if(measuring)
+        {
+            timing.rounds++;
+            timing.tick_cycles += MTOUCH_Sensor_RoundCycles_Get();
+            if(now - last_round > timing.round_max)
+                timing.round_max = now - last_round;
+            timing.scans = model_stats.scans - first_scans;
+            timing.cycles = now - first_cycles;
+        }
+        last_round = now;
+    }
+}
+
+static void Timing_Simulate(const condition_t* c)
+{
+    Model_Reset(&c->env, NULL, 0, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(TIMING_SETTLE_MS + TIMING_RUN_MS, Timing_Mainloop);
+}
+
+/* The library keeps its state in statics, so every condition gets a fresh process */
+static timing_t Timing_Run(const condition_t* c)
+{
+    int         fd[2];
+    timing_t    t;
+
+    memset(&t, 0, sizeof(t));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        Timing_Simulate(c);
+        if(write(fd[1], &timing, sizeof(timing)) != sizeof(timing))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &t, sizeof(t)) != sizeof(t))
+        t.rounds = 0;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return t;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Timing_Condition(const condition_t* c)
+{
+    timing_t    t = Timing_Run(c);
+    double      round, error;
+
+    if(t.rounds == 0)
+    {
+        printf("  %s: no rounds\n", c->name);
+        Check(false, "rounds processed");
+        return;
+    }
+    round = (double)t.cycles / t.rounds;
+    error = 100.0 * ((double)t.tick_cycles - (double)t.cycles) / (double)t.cycles;
+
+    printf("  %s:\n", c->name);
+    printf("    round %.0f cycles (%.2f ms, longest %.2f ms), %.1f samples a key with dropped rounds, %.0f rounds/s\n",
+           round, round / MODEL_CYCLES_PER_MS, (double)t.round_max / MODEL_CYCLES_PER_MS,
+           (double)t.scans / t.rounds / MTOUCH_SENSORS, 1000.0 * MODEL_CYCLES_PER_MS / round);
+    printf("    time base %+.2f%%  mainloop gap %lu cycles, blocking acquisition %.0f\n",
+           error, (unsigned long)t.gap_max, round);
+
+    Check(error > -TIMING_TICK_ERROR && error < TIMING_TICK_ERROR, "time base within limit");
+    Check(t.gap_max <= TIMING_GAP_MAX, "mainloop gap within one TMR2 period");
+}
+
+int main(void)
+{
+    uint8_t n;
+
+    alarm(120);
+    printf("mTouch scan timing: %u keys, Fcy %lu kHz\n", (unsigned)MTOUCH_SENSORS, MODEL_CYCLES_PER_MS);
+    for(n = 0; n < sizeof(conditions) / sizeof(conditions[0]); n++)
+        Timing_Condition(&conditions[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+/*
+ * Slider0 against touch_model.c: a finger swept along Button1..Button4.
+ *
+ * Built twice from the same source: slider_test with Slider0 as a
+ * slider and slider_test_wheel with MTOUCH_SLIDER_TYPE_Slider0 set to a
+ * wheel. The finger sits between two keys at a time: each key gets its
+ * share of the finger by distance, falling to nothing one key pitch
+ * away, around the ring on a wheel. It lands at one end, moves at a
+ * steady speed, holds and lifts, in both directions, at finger strengths
+ * from light to one that saturates the deviations and at two speeds.
+ * Each sweep reports
+ *      first/last          position when the slider first tracks and
+ *                          when the finger lifts
+ *      backward            steps against the sweep while the finger
+ *                          moves, and the largest
+ *      travel              sum of the steps, the short way round on a
+ *                          wheel
+ *      wraps               times the wheel position passed 255/0
+ *      velocity            mean of MTOUCH_Slider_Velocity_Get() while
+ *                          tracking, counts per 16 rounds
+ * A slider must not step backward and must reach both ends; a wheel must
+ * not step backward, wrap once per turn and travel 256 a turn.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define SLIDER_KEYS         4               /* Button1..Button4 */
+#define SLIDER_FIRST_MS     2000
+#define SLIDER_HOLD_MS      100             /* on the first key before moving */
+
+/* Slider0's type is an enum, so these are C expressions, not #if */
+#define SLIDER_WHEEL        (MTOUCH_SLIDER_TYPE_Slider0 == MTOUCH_SLIDER_TYPE_wheel)
+#define SLIDER_TURNS        2
+#define SLIDER_START        (SLIDER_WHEEL ? 0.5 : 0.0)  /* key pitches from Button1, so both turns of a wheel pass 255/0 */
+#define SLIDER_SPAN         (SLIDER_WHEEL ? SLIDER_TURNS * SLIDER_KEYS : SLIDER_KEYS - 1)    /* key pitches swept */
+#define SLIDER_TRAVEL_SLACK 32              /* counts, the ends of a wheel's sweep */
+#define SLIDER_END_SLACK    16              /* counts short of 0 or 255 on a slider */
+
+typedef struct
+{
+    double          pf;                     /* finger on one key */
+    uint32_t        move_ms;                /* over SLIDER_SPAN key pitches */
+    int8_t          direction;
+} sweep_t;
+
+typedef struct
+{
+    bool            tracked;
+    uint8_t         first, last;
+    uint16_t        backward;
+    int16_t         backward_max;
+    int32_t         travel;
+    uint8_t         wraps;
+    double          velocity_sum;
+    uint32_t        velocity_rounds;
+    uint32_t        active_rounds;
+} slider_result_t;
+
+static const sweep_t sweeps[] =
+{
+    /*  pF    ms    direction */
+    {   0.5,  2000,  1 },
+    {   0.5,  2000, -1 },
+    {   1.5,  2000,  1 },
+    {   1.5,  2000, -1 },
+    {   3.0,  2000,  1 },
+    {   1.0,  400,   1 },
+    {   1.0,  400,  -1 },
+};
+
+static const sweep_t*   sweep;
+static uint8_t          sensor[SLIDER_KEYS];
+static bool             was_tracking;
+static uint8_t          position_was;
+static slider_result_t  result;
+static int              failures;
+
+/* Finger in key pitches from Button1, or < 0 while lifted */
+static double Slider_Finger(double now)
+{
+    double  t = now - SLIDER_FIRST_MS;
+    double  x;
+
+    if(t < 0.0 || t > SLIDER_HOLD_MS + sweep->move_ms + SLIDER_HOLD_MS)
+        return -1.0;
+    t -= SLIDER_HOLD_MS;
+    x = SLIDER_SPAN * fmin(fmax(t, 0.0), (double)sweep->move_ms) / (double)sweep->move_ms;
+    return SLIDER_START + ((sweep->direction > 0) ? x : SLIDER_SPAN - x);
+}
+
+/* Landed and not yet lifted; the position settles while it holds still */
+static bool Slider_isMoving(double now)
+{
+    double t = now - SLIDER_FIRST_MS - SLIDER_HOLD_MS;
+
+    return (t > 0.0 && t <= (double)sweep->move_ms) ? true : false;
+}
+
+/* Each key's share of the finger, one key pitch wide either side */
+static void Slider_Finger_Place(double x)
+{
+    double  d;
+    uint8_t k;
+
+    for(k = 0; k < SLIDER_KEYS; k++)
+    {
+        d = fabs(x - k);
+        if(SLIDER_WHEEL)
+        {
+            d = fmod(d, SLIDER_KEYS);
+            d = fmin(d, SLIDER_KEYS - d);
+        }
+        Model_Finger_Set(sensor[k], (x < 0.0) ? 0.0 : sweep->pf * fmax(0.0, 1.0 - d));
+    }
+}
+
+static void Slider_Mainloop(void)
+{
+    mtouch_gesture_event_t  gesture;
+    double                  now = Model_Time_ms();
+    double                  x = Slider_Finger(now);
+    bool                    tracking;
+    uint8_t                 position;
+    int16_t                 step;
+
+    Slider_Finger_Place(x);
+    if(MTOUCH_Service_Mainloop() && x >= 0.0)
+    {
+        tracking = MTOUCH_Slider_isActive(Slider0);
+        position = MTOUCH_Slider_Position_Get(Slider0);
+        if(tracking)
+        {
+            result.active_rounds++;
+            if(!was_tracking && !result.tracked)
+            {
+                result.tracked = true;
+                result.first = position;
+            }
+            else if(was_tracking)
+            {
+                step = (int16_t)position - (int16_t)position_was;
+                if(SLIDER_WHEEL)
+                {
+                    step = (int16_t)(int8_t)(uint8_t)step;  /* the short way round */
+                    if(step * sweep->direction > 0 && (position < position_was) == (sweep->direction > 0))
+                        result.wraps++;
+                }
+                result.travel += step;
+                if(step * sweep->direction < 0 && Slider_isMoving(now))
+                {
+                    result.backward++;
+                    if(abs(step) > result.backward_max)
+                        result.backward_max = (int16_t)abs(step);
+                }
+            }
+            result.velocity_sum += MTOUCH_Slider_Velocity_Get(Slider0);
+            result.velocity_rounds++;
+            result.last = position;
+            position_was = position;
+        }
+        was_tracking = tracking;
+    }
+    while(MTOUCH_Gesture_Get(&gesture))
+        ;
+}
+
+static void Slider_Simulate(void)
+{
+    static const model_env_t    env = { 1.0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    uint8_t                     k;
+
+    for(k = 0; k < SLIDER_KEYS; k++)
+        sensor[k] = (uint8_t)MTOUCH_Button_Sensor_Get((enum mtouch_button_names)(Button1 + k));
+
+    Model_Reset(&env, NULL, 0, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(SLIDER_FIRST_MS + 2 * SLIDER_HOLD_MS + sweep->move_ms + 500, Slider_Mainloop);
+}
+
+/* The library keeps its state in statics, so every sweep gets a fresh process */
+static slider_result_t Slider_Run(const sweep_t* s)
+{
+    int             fd[2];
+    slider_result_t r;
+
+    memset(&r, 0, sizeof(r));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        sweep = s;
+        Slider_Simulate();
+        if(write(fd[1], &result, sizeof(result)) != sizeof(result))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &r, sizeof(r)) != sizeof(r))
+        r.tracked = false;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return r;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Slider_Sweep(const sweep_t* s)
+{
+    slider_result_t r = Slider_Run(s);
+    double          velocity = r.velocity_rounds ? r.velocity_sum / r.velocity_rounds : 0.0;
+
+    printf("  %s, %.1f pF over %u ms: first %3u  last %3u  backward %u (largest %d)  travel %+ld  wraps %u  velocity %+.1f/16 rounds\n",
+           s->direction > 0 ? "up  " : "down", s->pf, (unsigned)s->move_ms,
+           r.first, r.last, r.backward, r.backward_max, (long)r.travel, r.wraps, velocity);
+
+    Check(r.tracked, "slider tracks the finger");
+    Check(r.backward == 0, "position never steps against the sweep");
+    Check(velocity * s->direction > 0.0, "velocity has the sweep's sign");
+    if(SLIDER_WHEEL)
+    {
+        Check(r.wraps == SLIDER_TURNS, "position wraps once a turn");
+        Check(labs(r.travel - s->direction * SLIDER_TURNS * 256L) <= SLIDER_TRAVEL_SLACK, "travel is 256 a turn");
+    }
+    else if(s->direction > 0)
+        Check(r.first <= SLIDER_END_SLACK && r.last >= 255 - SLIDER_END_SLACK, "position runs from 0 to 255");
+    else
+        Check(r.first >= 255 - SLIDER_END_SLACK && r.last <= SLIDER_END_SLACK, "position runs from 255 to 0");
+}
+
+int main(void)
+{
+    uint8_t n;
+
+    alarm(300);
+    printf("mTouch %s on Button1..Button4 against the sensor model\n", SLIDER_WHEEL ? "wheel" : "slider");
+    for(n = 0; n < sizeof(sweeps) / sizeof(sweeps[0]); n++)
+        Slider_Sweep(&sweeps[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
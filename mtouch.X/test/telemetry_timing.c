@@ -0,0 +1,258 @@
+/*
+ * Scan rate with the telemetry stream on and off, against touch_model.c.
+ *
+ * Built twice from the same source: telemetry_timing with
+ * MTOUCH_TELEMETRY defined and telemetry_timing_off without it. For a
+ * quiet and a noisy board at full rate, and an idle board in low
+ * power, the library runs with no touch and reports:
+ *      scan rate           processed rounds per second over the window,
+ *                          and watchdog sleeps per second in low power
+ *      TX                  TMR0 interrupts per second, button records
+ *                          received per second and records left out
+ *                          because the ring buffer was full
+ *      CPU                 the share the TX interrupt takes, and the
+ *                          latest TX bit edge after its TMR0 overflow
+ * The telemetry build also decodes the TX pin and fails on a framing
+ * error, a record with a bad sync or checksum, fewer records than were
+ * queued, or a bit edge later than the half bit the receiver samples
+ * at. It runs "telemetry_timing_off rates" for the scan rate without
+ * telemetry and prints the difference. Both builds fail if the idle
+ * board does not sleep.
+ *
+ * The interrupts cost the cycles below, see Model_Interrupt_Cycles().
+ * They are host estimates, not XC8 counts: pic16_sim of the one-key
+ * fork's hex for the interrupt entry, one_key_bench.py for the TMR2
+ * interrupt, and Telemetry_TX_ISR()'s byte-fetch path of about 13
+ * host instructions at its 4.3 PIC cycles each for the TX handler.
+ */
+#define _POSIX_C_SOURCE 200809L         /* popen() under -std=c99 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define TELEMETRY_IN_FLIGHT 2           /* records still in the buffer or going out at the end */
+#define TELEMETRY_ENTRY     44          /* vectoring, context save and the interrupt manager */
+#define TELEMETRY_TMR2      291         /* the whole TMR2 interrupt, mean of the shared one-key build */
+#define TELEMETRY_TMR0      (TELEMETRY_ENTRY + 56)
+
+typedef struct
+{
+    const char*     name;
+    model_env_t     env;
+    uint32_t        settle_ms;
+    uint32_t        run_ms;
+} condition_t;
+
+typedef struct
+{
+    uint32_t        rounds;
+    uint32_t        sleeps;
+    uint32_t        tmr0_calls;
+    uint64_t        tmr0_cycles;
+    uint32_t        edge_max;           /* cycles, the whole run */
+    uint32_t        records;            /* decoded over the window */
+    uint32_t        skipped;
+    /* the whole run */
+    uint32_t        queued;
+    uint32_t        received;
+    uint32_t        bad_records;
+    uint32_t        framing;
+} telemetry_t;
+
+static const condition_t conditions[] =
+{
+    /*  name                   white drift film at ms hum Hz rf Hz    settle run */
+    {   "quiet board",       { 0.5, 0,    0,   0, 0, 0,  0, 0, 0 },   300,   1200 },
+    {   "noisy ADC",         { 4.0, 0,    0,   0, 0, 0,  0, 0, 0 },   300,   1200 },
+    {   "idle in low power", { 0.5, 0,    0,   0, 0, 0,  0, 0, 0 },   3000,  6000 },
+};
+
+static const condition_t*   condition;
+static telemetry_t          telemetry;
+static bool                 measuring;
+static uint32_t             rounds;
+static uint32_t             first_rounds;
+static uint8_t              record[MTOUCH_TELEMETRY_RECORD_SIZE];
+static uint8_t              record_length;
+static uint32_t             first_sleeps;
+static uint32_t             first_tmr0;
+static uint64_t             first_tmr0_cycles;
+static uint32_t             first_records;
+static uint16_t             first_skipped;
+static int                  failures;
+
+/* Splits the received bytes into records at the sync byte */
+static void Telemetry_Receive(void)
+{
+    uint8_t byte, sum, i;
+
+    while(Model_TX_Get(&byte))
+    {
+        if(record_length == 0 && byte != MTOUCH_TELEMETRY_SYNC)
+        {
+            telemetry.bad_records++;
+            continue;
+        }
+        record[record_length++] = byte;
+        if(record_length < MTOUCH_TELEMETRY_RECORD_SIZE)
+            continue;
+        record_length = 0;
+        for(sum = 0, i = 1; i < MTOUCH_TELEMETRY_RECORD_SIZE; i++)
+            sum += record[i];
+        if(sum != 0)
+            telemetry.bad_records++;
+        else
+            telemetry.received++;
+    }
+}
+
+static void Telemetry_Mainloop(void)
+{
+    if(MTOUCH_Service_Mainloop())
+    {
+        rounds++;
+        if(!measuring && Model_Time_ms() >= condition->settle_ms)
+        {
+            measuring = true;
+            first_rounds = rounds;
+            first_sleeps = model_stats.sleeps;
+            first_tmr0 = model_stats.tmr0_calls;
+            first_tmr0_cycles = model_stats.tmr0_cycles;
+            first_records = telemetry.received;
+            first_skipped = MTOUCH_Telemetry_Skipped_Get();
+        }
+    }
+    Telemetry_Receive();
+    MTOUCH_LowPower_Sleep();
+}
+
+static void Telemetry_Simulate(const condition_t* c)
+{
+    condition = c;
+    Model_Reset(&c->env, NULL, 0, 12345);
+    Model_Interrupt_Cycles(TELEMETRY_TMR2, TELEMETRY_TMR0, TELEMETRY_ENTRY);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(c->settle_ms + c->run_ms, Telemetry_Mainloop);
+
+    telemetry.rounds     = rounds - first_rounds;
+    telemetry.sleeps     = model_stats.sleeps - first_sleeps;
+    telemetry.tmr0_calls = model_stats.tmr0_calls - first_tmr0;
+    telemetry.tmr0_cycles = model_stats.tmr0_cycles - first_tmr0_cycles;
+    telemetry.edge_max   = (uint32_t)model_stats.tx_edge_max;
+    telemetry.records    = telemetry.received - first_records;
+    telemetry.skipped    = (uint16_t)(MTOUCH_Telemetry_Skipped_Get() - first_skipped);
+    telemetry.framing    = model_stats.tx_framing;
+    /* every processed round queues a record per button or counts it as left out */
+    telemetry.queued     = rounds * MTOUCH_BUTTONS - MTOUCH_Telemetry_Skipped_Get();
+}
+
+/* The library keeps its state in statics, so every condition gets a fresh process */
+static telemetry_t Telemetry_Run(const condition_t* c)
+{
+    int         fd[2];
+    telemetry_t t;
+
+    memset(&t, 0, sizeof(t));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        Telemetry_Simulate(c);
+        if(write(fd[1], &telemetry, sizeof(telemetry)) != sizeof(telemetry))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &t, sizeof(t)) != sizeof(t))
+        t.framing = UINT32_MAX;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return t;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+#ifdef MTOUCH_TELEMETRY
+/* Rounds/s of the build without telemetry, one line per condition */
+static bool Telemetry_Off(double* off, uint8_t n)
+{
+    FILE*   p = popen("./telemetry_timing_off rates", "r");
+    uint8_t i;
+    bool    ok = p != NULL;
+
+    for(i = 0; ok && i < n; i++)
+        ok = fscanf(p, "%lf", &off[i]) == 1;
+    if(p && pclose(p) != 0)
+        ok = false;
+    return ok;
+}
+#endif
+
+static void Telemetry_Condition(const condition_t* c, double off)
+{
+    telemetry_t t = Telemetry_Run(c);
+    double      s = c->run_ms / 1000.0;
+
+    printf("  %s:\n", c->name);
+    printf("    %.1f rounds/s, %.2f sleeps/s\n", t.rounds / s, t.sleeps / s);
+    printf("    TX %.0f interrupts/s, %.1f records/s, %.1f left out/s\n",
+           t.tmr0_calls / s, t.records / s, t.skipped / s);
+
+#ifdef MTOUCH_TELEMETRY
+    printf("    %.1f rounds/s off, %+.1f%% with telemetry\n", off, off > 0 ? (t.rounds / s - off) * 100.0 / off : 0.0);
+    printf("    TX takes %.1f%% of the CPU, bit edges up to %lu cycles late of %u\n",
+           t.tmr0_cycles * 100.0 / ((double)c->run_ms * MODEL_CYCLES_PER_MS),
+           (unsigned long)t.edge_max, (unsigned)(MODEL_TMR0_CYCLES / 2));
+    Check(t.framing == 0 && t.bad_records == 0, "records decode");
+    Check(t.received > 0 && t.received <= t.queued && t.received + TELEMETRY_IN_FLIGHT >= t.queued, "queued records received");
+    Check(t.edge_max <= MODEL_TMR0_CYCLES / 2, "bit edges inside half a bit");
+#else
+    Check(t.tmr0_calls == 0 && t.received == 0, "TX idle");
+#endif
+    if(c->settle_ms > 1000)
+        Check(t.sleeps > 0, "idle board sleeps");
+}
+
+#define CONDITIONS  (sizeof(conditions) / sizeof(conditions[0]))
+
+int main(int argc, char** argv)
+{
+    double  off[CONDITIONS] = { 0 };
+    uint8_t n;
+
+    alarm(120);
+    if(argc > 1 && strcmp(argv[1], "rates") == 0)
+    {
+        for(n = 0; n < CONDITIONS; n++)
+        {
+            telemetry_t t = Telemetry_Run(&conditions[n]);
+
+            printf("%.3f\n", t.rounds * 1000.0 / conditions[n].run_ms);
+        }
+        return EXIT_SUCCESS;
+    }
+#ifdef MTOUCH_TELEMETRY
+    printf("mTouch scan rate, telemetry on: %u keys, %lu baud\n", (unsigned)MTOUCH_SENSORS, MODEL_CYCLES_PER_MS * 1000 / MODEL_TMR0_CYCLES);
+    if(!Telemetry_Off(off, CONDITIONS))
+        failures++;
+#else
+    printf("mTouch scan rate, telemetry off: %u keys\n", (unsigned)MTOUCH_SENSORS);
+#endif
+    for(n = 0; n < CONDITIONS; n++)
+        Telemetry_Condition(&conditions[n], off[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
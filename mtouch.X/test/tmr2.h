@@ -0,0 +1,16 @@
+/*
+ * Host stand-in for mcc_generated_files/tmr2.h. touch_model.c runs the
+ * timer: while it is on, the handler is called every PR2+1 instruction
+ * cycles (1:1 prescaler and postscaler, as set by TMR2_Initialize()).
+ */
+#ifndef TMR2_H
+#define TMR2_H
+
+#include <stdint.h>
+
+void TMR2_StartTimer(void);
+void TMR2_StopTimer(void);
+void TMR2_LoadPeriodRegister(uint8_t periodVal);
+void TMR2_SetInterruptHandler(void (* InterruptHandler)(void));
+
+#endif
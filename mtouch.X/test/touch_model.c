@@ -0,0 +1,452 @@
+/*
+ * Sensor and noise model for the mTouch host tests, see touch_model.h.
+ */
+#include <math.h>
+#include <string.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MODEL_TOUCHES_MAX   64
+#define MODEL_TX_BUFFER     256         /* bytes received and not yet read */
+
+/* PIC16F1703 registers the library touches */
+volatile uint8_t        LATA, LATC, TRISA, TRISC, ANSELA, ANSELC, WPUA, WPUC;
+volatile uint8_t        ADCON0, ADCON1, ADCON2, WDTCON;
+volatile INTCONbits_t   INTCONbits;
+volatile uint8_t        GIE;
+volatile T2CONbits_t    T2CONbits;
+volatile uint8_t        TX_LAT = 1;
+
+model_stats_t           model_stats;
+
+#ifdef MTOUCH_SENSOR_MATRIX
+/* columns of the pad to ground, and the row to column coupling of each key */
+static const double     model_col_pf[MODEL_MATRIX_COLS] = { 15.0, 14.2, 16.1, 15.5 };
+static const double     model_key_pf[16] = { 2.0, 1.9, 2.1, 2.0, 1.8, 2.0, 2.2, 1.9,
+                                             2.1, 1.9, 2.0, 1.8, 2.0, 2.2, 1.9, 2.1 };
+#else
+/* keys of the board, spread as on a real layout */
+static const double     model_key_pf[8] = { 15.0, 14.2, 16.1, 15.5, 13.8, 14.9, 16.4, 15.2 };
+#endif
+
+static uint64_t         model_cycles;
+static model_env_t      model_env;
+static model_touch_t    model_touch[MODEL_TOUCHES_MAX];
+static uint8_t          model_touches;
+static double           model_moved_pf[16];     /* fingers the test moves itself, see Model_Finger_Set() */
+static uint32_t         model_seed;
+static double           model_phase_hum;
+static double           model_phase_rf;
+
+static bool             tmr2_on;
+static uint8_t          tmr2_period;
+static uint64_t         tmr2_match;         /* next period match while on */
+static void             (*tmr2_handler)(void);
+
+static uint64_t         tmr0_next;
+static void             (*tmr0_handler)(void);
+
+/* what the interrupts cost, see Model_Interrupt_Cycles() */
+static uint16_t         isr_tmr2_cycles;
+static uint16_t         isr_tmr0_cycles;
+static uint16_t         isr_entry_cycles;
+static uint64_t         cpu_free;           /* the interrupt running ends */
+
+static uint8_t          tx_bit;             /* 0 idle, 1..8 data bits, 9 stop bit */
+static uint8_t          tx_shift;
+static uint8_t          tx_buffer[MODEL_TX_BUFFER];
+static uint8_t          tx_head;
+static uint8_t          tx_tail;
+
+static uint16_t         adc_result;
+
+
+/*
+ * =======================================================================
+ * Random numbers, xorshift32 so a scenario replays exactly
+ * =======================================================================
+ */
+static uint32_t Model_Random(void)
+{
+    model_seed ^= model_seed << 13;
+    model_seed ^= model_seed >> 17;
+    model_seed ^= model_seed << 5;
+    return model_seed;
+}
+
+static double Model_Uniform(void)
+{
+    return ((double)(Model_Random() >> 8) + 0.5) / 16777216.0;
+}
+
+static double Model_Gauss(void)
+{
+    return sqrt(-2.0 * log(Model_Uniform())) * cos(2.0 * M_PI * Model_Uniform());
+}
+
+
+/*
+ * =======================================================================
+ * Environment
+ * =======================================================================
+ */
+static double Model_Seconds(void)
+{
+    return (double)model_cycles / (MODEL_CYCLES_PER_MS * 1000.0);
+}
+
+double Model_Time_ms(void)
+{
+    return (double)model_cycles / MODEL_CYCLES_PER_MS;
+}
+
+uint64_t Model_Cycles(void)
+{
+    return model_cycles;
+}
+
+/* Contact of the strongest finger on the key, 0..1 */
+static double Model_Contact(uint8_t sensor, double* delta_pf)
+{
+    double  now = Model_Time_ms();
+    double  best = 0.0;
+    uint8_t i;
+
+    *delta_pf = 0.0;
+    for(i = 0; i < model_touches; i++)
+    {
+        const model_touch_t*    t = &model_touch[i];
+        double                  on, off, contact;
+
+        if(t->sensor != sensor)
+            continue;
+        on  = (now - (double)t->start_ms) / MODEL_CONTACT_MS;
+        off = ((double)(t->start_ms + t->length_ms) - now) / MODEL_CONTACT_MS;
+        contact = fmin(fmin(on, off), 1.0);
+        if(contact > 0.0 && contact * t->delta_pf > best * *delta_pf)
+        {
+            best = contact;
+            *delta_pf = t->delta_pf;
+        }
+    }
+    return best;
+}
+
+double Model_Finger(uint8_t sensor)
+{
+    double delta_pf;
+
+    return Model_Contact(sensor, &delta_pf);
+}
+
+void Model_Finger_Set(uint8_t sensor, double pf)
+{
+    if(sensor < sizeof(model_moved_pf) / sizeof(model_moved_pf[0]))
+        model_moved_pf[sensor] = pf;
+}
+
+static double Model_Film(void)
+{
+    double since = Model_Time_ms() - (double)model_env.film_at_ms;
+
+    if(model_env.film_pf == 0.0 || since <= 0.0)
+        return 0.0;
+    if(model_env.film_ms == 0 || since >= (double)model_env.film_ms)
+        return model_env.film_pf;
+    return model_env.film_pf * since / (double)model_env.film_ms;
+}
+
+/* One conversion of a key, phase A or B */
+static void Model_Scan(uint8_t sensor, bool scanA)
+{
+    double  delta_pf, contact, cs, v, noise, t;
+#ifdef MTOUCH_SENSOR_MATRIX
+    double  cm, other_pf;
+    uint8_t key;
+#endif
+
+    model_stats.scans++;
+    contact = Model_Contact(sensor, &delta_pf);
+    t  = Model_Seconds();
+#ifdef MTOUCH_SENSOR_MATRIX
+    /* every finger on the column loads it, only the key's own takes coupling away */
+    cs = model_col_pf[sensor % MODEL_MATRIX_COLS] + model_env.drift_pf_s * t + Model_Film();
+    for(key = sensor % MODEL_MATRIX_COLS; key < 16; key += MODEL_MATRIX_COLS)
+        cs += Model_Contact(key, &other_pf) * other_pf;
+    cm = model_key_pf[sensor] - contact * delta_pf * MODEL_MATRIX_COUPLING;
+#else
+    cs = model_key_pf[sensor] + model_env.drift_pf_s * t + Model_Film() + contact * delta_pf + model_moved_pf[sensor];
+#endif
+
+    noise  = model_env.white * Model_Gauss();
+    noise += model_env.hum * contact * sin(2.0 * M_PI * model_env.hum_hz * t + model_phase_hum);
+    noise += model_env.rf * sin(2.0 * M_PI * model_env.rf_hz * t + model_phase_rf);
+
+#ifdef MTOUCH_SENSOR_MATRIX
+    if(scanA)
+        v = 1023.0 * (MODEL_HOLD_PF + cm) / (MODEL_HOLD_PF + cs + cm);
+    else
+        v = 1023.0 * (MODEL_HOLD_PF - cm) / (MODEL_HOLD_PF + cs + cm);
+#else
+    if(scanA)
+        v = 1023.0 * MODEL_HOLD_PF / (MODEL_HOLD_PF + cs);
+    else
+        v = 1023.0 * cs / (MODEL_HOLD_PF + cs);
+#endif
+    v = floor(v + noise + 0.5);
+    adc_result = (uint16_t)fmax(0.0, fmin(1023.0, v));
+}
+
+uint16_t Model_Scan_Result(void)
+{
+    return adc_result;
+}
+
+#define MODEL_SCAN_SENSOR(n)                                \
+    void MTOUCH_CVD_ScanA_##n(void) { Model_Scan(n, true); }  \
+    void MTOUCH_CVD_ScanB_##n(void) { Model_Scan(n, false); }
+
+MODEL_SCAN_SENSOR(0)
+MODEL_SCAN_SENSOR(1)
+MODEL_SCAN_SENSOR(2)
+MODEL_SCAN_SENSOR(3)
+MODEL_SCAN_SENSOR(4)
+MODEL_SCAN_SENSOR(5)
+MODEL_SCAN_SENSOR(6)
+MODEL_SCAN_SENSOR(7)
+#ifdef MTOUCH_SENSOR_MATRIX
+MODEL_SCAN_SENSOR(8)
+MODEL_SCAN_SENSOR(9)
+MODEL_SCAN_SENSOR(10)
+MODEL_SCAN_SENSOR(11)
+MODEL_SCAN_SENSOR(12)
+MODEL_SCAN_SENSOR(13)
+MODEL_SCAN_SENSOR(14)
+MODEL_SCAN_SENSOR(15)
+#endif
+
+
+/*
+ * =======================================================================
+ * PIC around the library
+ * =======================================================================
+ */
+void TMR2_StartTimer(void)
+{
+    if(!tmr2_on)
+        tmr2_match = model_cycles + (uint64_t)tmr2_period + 1;
+    tmr2_on = true;
+    T2CONbits.TMR2ON = 1;
+}
+
+void TMR2_StopTimer(void)
+{
+    tmr2_on = false;
+    T2CONbits.TMR2ON = 0;
+}
+
+void TMR2_LoadPeriodRegister(uint8_t periodVal)
+{
+    tmr2_period = periodVal;
+}
+
+void TMR2_SetInterruptHandler(void (* InterruptHandler)(void))
+{
+    tmr2_handler = InterruptHandler;
+}
+
+void TMR0_SetInterruptHandler(void (* InterruptHandler)(void))
+{
+    tmr0_handler = InterruptHandler;
+}
+
+/* The receiver samples the TX pin once per bit, half a bit after the overflow */
+static void Model_TX_Sample(uint8_t level)
+{
+
+    if(tx_bit == 0)
+    {
+        if(level == 0)
+            tx_bit = 1;                             /* start bit */
+    }
+    else if(tx_bit <= 8)
+    {
+        tx_shift = (uint8_t)(tx_shift >> 1 | level << 7);
+        tx_bit++;
+    }
+    else
+    {
+        tx_bit = 0;
+        if(level == 0)
+        {
+            model_stats.tx_framing++;
+            return;
+        }
+        model_stats.tx_bytes++;
+        if((uint8_t)(tx_head + 1) != tx_tail)
+            tx_buffer[tx_head++] = tx_shift;
+    }
+}
+
+bool Model_TX_Get(uint8_t* byte)
+{
+    if(tx_head == tx_tail)
+        return false;
+    *byte = tx_buffer[tx_tail++];
+    return true;
+}
+
+/*
+ * TMR0 runs free, so its overflows only depend on the time. Its
+ * interrupt waits for the one running and goes before a pending TMR2
+ * interrupt, as in the MCC interrupt manager. The handler drives the
+ * TX edge first thing, isr_entry_cycles in; an edge later than half a
+ * bit is missed by the receiver.
+ */
+static void Model_TMR0(uint64_t until)
+{
+    uint64_t    start, edge;
+    uint8_t     level;
+
+    while(tmr0_next <= until)
+    {
+        level = TX_LAT ? 1 : 0;
+        if(INTCONbits.GIE && INTCONbits.TMR0IE && tmr0_handler)
+        {
+            start = (cpu_free > tmr0_next) ? cpu_free : tmr0_next;
+            edge  = start + isr_entry_cycles - tmr0_next;
+            if(edge > model_stats.tx_edge_max)
+                model_stats.tx_edge_max = edge;
+            model_stats.tmr0_calls++;
+            model_stats.tmr0_cycles += isr_tmr0_cycles;
+            cpu_free = start + isr_tmr0_cycles;
+            tmr0_handler();
+            if(edge <= MODEL_TMR0_CYCLES / 2)
+                level = TX_LAT ? 1 : 0;
+        }
+        tmr0_next += MODEL_TMR0_CYCLES;
+        Model_TX_Sample(level);
+    }
+}
+
+void Model_Interrupt_Cycles(uint16_t tmr2, uint16_t tmr0, uint16_t entry)
+{
+    isr_tmr2_cycles  = tmr2;
+    isr_tmr0_cycles  = tmr0;
+    isr_entry_cycles = entry;
+}
+
+void WDT_Initialize(void)
+{
+    WDTCON = (uint8_t)0x16;                         /* WDTPS 1:65536, SWDTEN off */
+}
+
+/* Asleep for one watchdog period, 1 ms << WDTPS */
+void Model_Sleep(void)
+{
+    uint32_t ms = (uint32_t)1 << ((WDTCON >> 1) & 0x1F);
+
+    model_stats.sleeps++;
+    model_stats.sleep_ms += ms;
+    model_cycles += (uint64_t)ms * MODEL_CYCLES_PER_MS;
+    tmr0_next += (uint64_t)ms * MODEL_CYCLES_PER_MS;   /* no instruction clock in sleep */
+    cpu_free = model_cycles;
+}
+
+void Model_Reset(const model_env_t* env, const model_touch_t* touches, uint8_t count, uint32_t seed)
+{
+    memset(&model_stats, 0, sizeof(model_stats));
+    model_env = *env;
+    if(count > MODEL_TOUCHES_MAX)
+        count = MODEL_TOUCHES_MAX;
+    memcpy(model_touch, touches, count * sizeof(model_touch_t));
+    model_touches = count;
+    memset(model_moved_pf, 0, sizeof(model_moved_pf));
+    model_seed = seed ? seed : 1;
+    model_phase_hum = 2.0 * M_PI * Model_Uniform();
+    model_phase_rf  = 2.0 * M_PI * Model_Uniform();
+    model_cycles = 0;
+    cpu_free = 0;
+    tmr2_on = false;
+    tmr2_period = 0;
+    tmr0_next = MODEL_TMR0_CYCLES;
+    TX_LAT = 1;
+    tx_bit = 0;
+    tx_head = 0;
+    tx_tail = 0;
+    WDT_Initialize();
+}
+
+/*
+ * Up to the next TMR2 interrupt, or one mainloop pass while TMR2 is
+ * off. Firmware that busy-waits on a flag the interrupt sets calls it
+ * from the wait loop. A TMR2 interrupt that finds the CPU in another
+ * one runs when that ends; period matches while its flag is still set
+ * are lost. The mainloop pass takes MODEL_MAINLOOP_CYCLES of the CPU
+ * the interrupts leave it.
+ */
+void Model_Wait(void)
+{
+    uint64_t    start, need;
+
+    if(tmr2_on)
+    {
+        Model_TMR0(tmr2_match);
+        start = tmr2_match;
+        while(cpu_free > start)
+        {
+            start = cpu_free;
+            Model_TMR0(start);
+        }
+        model_stats.scan_cycles += start - model_cycles;
+        model_cycles = start;
+        while(tmr2_match <= start)
+            tmr2_match += (uint64_t)tmr2_period + 1;
+        if(INTCONbits.GIE && INTCONbits.PEIE && tmr2_handler)
+        {
+            model_stats.isr_calls++;
+            model_stats.tmr2_cycles += isr_tmr2_cycles;
+            cpu_free = start + isr_tmr2_cycles;
+            tmr2_handler();
+        }
+    }
+    else
+    {
+        start = (cpu_free > model_cycles) ? cpu_free : model_cycles;
+        need  = MODEL_MAINLOOP_CYCLES;
+        while(tmr0_next <= start + need)
+        {
+            need -= (tmr0_next > start) ? tmr0_next - start : 0;
+            Model_TMR0(tmr0_next);
+            if(cpu_free > start)
+                start = cpu_free;
+        }
+        model_cycles = start + need;
+    }
+}
+
+/* Moves the time on, for a test that runs its own timers around the library */
+void Model_Advance(uint32_t cycles)
+{
+    model_cycles += cycles;
+    Model_TMR0(model_cycles);
+}
+
+/*
+ * Runs the firmware until until_ms. The mainloop gets a pass after
+ * every TMR2 interrupt, as the PIC returns to it between period matches.
+ */
+void Model_Run(uint32_t until_ms, void (*mainloop)(void))
+{
+    uint64_t until = (uint64_t)until_ms * MODEL_CYCLES_PER_MS;
+
+    while(model_cycles < until)
+    {
+        Model_Wait();
+        mainloop();
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Sensor and noise model for the mTouch host tests.
+ *
+ * Each key is a capacitance to ground, Cs, measured by the CVD scans
+ * against the ADC hold capacitor, Ch. scanA charges the hold capacitor
+ * to Vdd and the key to Vss, scanB the other way round, then the two
+ * share charge:
+ *
+ *      scanA   ADC = 1023 * Ch/(Ch+Cs) + n(t)      inverted by the library
+ *      scanB   ADC = 1023 * Cs/(Ch+Cs) + n(t)
+ *
+ *      Cs(t) = key + drift*t + film(t) + finger(t) * touch + moved(t)
+ *
+ * moved(t) is a finger the test positions itself with Model_Finger_Set(),
+ * e.g. one sliding across several keys; it does not ramp. Self keys only.
+ *
+ * n(t) is the interference on the electrode when the conversion starts,
+ * so it is the same in both phases and cancels in an A/B pair unless it
+ * moves between the two scans of a key. It is the sum of
+ *      mains hum through the finger, scaled by the finger contact
+ *      conducted RF on every key
+ *      white ADC noise
+ * A finger contact ramps over MODEL_CONTACT_MS at both ends.
+ *
+ * Built with MTOUCH_SENSOR_MATRIX, a key is the coupling Cm from its
+ * row to its column, 4 columns of 4 rows. The column precharges as for
+ * scanA in both phases; the row rises as it is connected in scanA and
+ * falls in scanB:
+ *
+ *      scanA   ADC = 1023 * (Ch+Cm)/(Ch+Cs+Cm) + n(t)      inverted by the library
+ *      scanB   ADC = 1023 * (Ch-Cm)/(Ch+Cs+Cm) + n(t)
+ *
+ *      Cm(t) = key - finger(t) * touch * MODEL_MATRIX_COUPLING
+ *      Cs(t) = column + drift*t + film(t) + the fingers on the column
+ *
+ * so n(t) cancels as on a self key, the column's Cs only shows through
+ * the denominator, and a finger on another key of the column only
+ * through that small remainder.
+ *
+ * The model also runs the PIC around the library: TMR2 calls its
+ * handler every PR2+1 instruction cycles while on, the mainloop runs
+ * after every TMR2 interrupt, or every MODEL_MAINLOOP_CYCLES while TMR2
+ * is off, and SLEEP() lasts one watchdog period. Model_Wait() is one of
+ * those steps, for firmware that busy-waits on its own flag. TMR0 overflows every
+ * MODEL_TMR0_CYCLES and calls its handler while TMR0IE is set; a UART
+ * receiver at one bit per overflow reads the TX pin the telemetry
+ * handler drives, see Model_TX_Get().
+ *
+ * The interrupts take no time unless Model_Interrupt_Cycles() gives
+ * them a cost. Then they do not nest: each waits for the one running,
+ * TMR0 before TMR2, and the mainloop gets what is left; the receiver
+ * samples half a bit after each overflow, so a TX edge that late is
+ * lost.
+ */
+#ifndef TOUCH_MODEL_H
+#define TOUCH_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef MODEL_CYCLES_PER_MS
+#define MODEL_CYCLES_PER_MS         8000UL      /* Fosc/4 at 32 MHz */
+#endif
+#define MODEL_MAINLOOP_CYCLES       400UL       /* mainloop pass with no round running */
+#define MODEL_CONTACT_MS            10.0        /* finger contact ramp */
+#define MODEL_HOLD_PF               10.0        /* ADC hold and pin capacitance */
+#define MODEL_TMR0_CYCLES           1024UL      /* 8 bit TMR0, 1:4 prescaler */
+#define MODEL_MATRIX_COLS           4
+#define MODEL_MATRIX_COUPLING       0.5         /* Cm a finger takes away, per pF of finger */
+
+typedef struct
+{
+    uint8_t         sensor;
+    uint32_t        start_ms;
+    uint32_t        length_ms;
+    double          delta_pf;                   /* finger at full contact */
+} model_touch_t;
+
+typedef struct
+{
+    double          white;                      /* ADC noise, counts rms per conversion */
+    double          drift_pf_s;                 /* every key, e.g. temperature */
+    double          film_pf;                    /* water film on every key ... */
+    uint32_t        film_at_ms;                 /* ... growing from here ... */
+    uint32_t        film_ms;                    /* ... over this long */
+    double          hum;                        /* mains through the finger, counts peak at full contact */
+    double          hum_hz;
+    double          rf;                         /* conducted on every key, counts peak */
+    double          rf_hz;
+} model_env_t;
+
+typedef struct
+{
+    uint32_t        scans;                      /* conversions */
+    uint32_t        isr_calls;                  /* TMR2 interrupts */
+    uint64_t        scan_cycles;                /* instruction cycles with TMR2 on */
+    uint32_t        sleeps;
+    uint32_t        sleep_ms;
+    uint32_t        tmr0_calls;                 /* TMR0 interrupts */
+    uint32_t        tx_bytes;                   /* received on the TX pin */
+    uint32_t        tx_framing;                 /* bytes with no stop bit */
+    uint64_t        tmr2_cycles;                /* in TMR2 interrupts */
+    uint64_t        tmr0_cycles;                /* in TMR0 interrupts */
+    uint64_t        tx_edge_max;                /* latest TX edge after its overflow, cycles */
+} model_stats_t;
+
+extern model_stats_t    model_stats;
+
+void        Model_Reset         (const model_env_t* env, const model_touch_t* touches, uint8_t count, uint32_t seed);
+void        Model_Run           (uint32_t until_ms, void (*mainloop)(void));
+void        Model_Wait          (void);
+void        Model_Interrupt_Cycles(uint16_t tmr2, uint16_t tmr0, uint16_t entry);
+void        Model_Advance       (uint32_t cycles);
+double      Model_Time_ms       (void);
+uint64_t    Model_Cycles        (void);
+double      Model_Finger        (uint8_t sensor);
+void        Model_Finger_Set    (uint8_t sensor, double pf);
+uint16_t    Model_Scan_Result   (void);
+bool        Model_TX_Get        (uint8_t* byte);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * Host test of the mTouch sensor and button code against touch_model.c.
+ *
+ * The library sources are compiled unchanged with gcc. Each scenario
+ * lays a sequence of touches on the buttons in turn, runs the library
+ * with a mainloop like main.c's under one environment, and compares the
+ * button edges with the touches:
+ *      press latency       finger down to isPressed
+ *      release latency     finger up to not pressed
+ *      false presses       a press with no finger on the key, or a
+ *                          second press during one touch
+ *      missed presses      a touch never reported
+ *      dropouts            a release while the finger is still down
+ * against the scenario's limits.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "mcc.h"
+#include "touch_model.h"
+
+#define TEST_TOUCHES_MAX    64
+#define TEST_LATE_MS        100         /* a press this long after the finger lifts still counts */
+
+typedef struct
+{
+    const char*     name;
+    model_env_t     env;
+    uint8_t         touches;            /* rotating over the buttons */
+    uint32_t        first_ms;
+    uint32_t        on_ms;
+    uint32_t        off_ms;
+    double          delta_pf;
+    uint32_t        run_ms;             /* 0: the last touch + 500 ms */
+    /* limits */
+    double          press_max_ms;
+    double          release_max_ms;
+    uint8_t         false_max;
+    uint8_t         missed_max;
+    uint8_t         dropouts_max;
+} scenario_t;
+
+typedef struct
+{
+    uint8_t         presses;
+    double          press_sum, press_max;
+    uint8_t         releases;
+    double          release_sum, release_max;
+    uint8_t         false_presses;
+    uint8_t         missed;
+    uint8_t         dropouts;
+    uint32_t        rounds;
+    uint32_t        sleeps;
+    uint32_t        wakeups;
+} result_t;
+
+/*
+ * Limits are what a user would accept from the key, not the measured
+ * values: 30 ms to press and release on a quiet board, longer where the
+ * library lengthens the packets (noisy ADC), drops rounds while hopping
+ * (RF) or has to wake from its watchdog sleep first. A light touch sits
+ * near the threshold of the weakest key, where the noise sets when it
+ * crosses: its worst press runs 32 to 68 ms over seeds.
+ */
+static const scenario_t scenarios[] =
+{
+    /*  name                     white  drift   film  at    ms    hum  Hz  rf  Hz         touches first  on   off   pF    run    press release false missed dropouts */
+    {   "clean taps",          { 1.0,   0,      0,    0,    0,    0,   0,  0,  0      }, 24,     1000,  150, 350,  1.0,  0,     30,   30,     0,    0,     0 },
+    {   "light touches",       { 1.0,   0,      0,    0,    0,    0,   0,  0,  0      }, 24,     1000,  150, 350,  0.45, 0,     80,   40,     0,    0,     0 },
+    {   "noisy ADC",           { 4.0,   0,      0,    0,    0,    0,   0,  0,  0      }, 24,     1000,  150, 350,  1.0,  0,     60,   100,    0,    0,     0 },
+    {   "temperature drift",   { 1.0,   0.01,   0,    0,    0,    0,   0,  0,  0      }, 24,     1000,  150, 1500, 1.0,  0,     30,   30,     0,    0,     0 },
+    {   "humidity film",       { 1.0,   0,      0.2,  3000, 5000, 0,   0,  0,  0      }, 24,     1000,  150, 350,  1.0,  0,     30,   30,     0,    0,     0 },
+    {   "mains hum",           { 1.0,   0,      0,    0,    0,    60,  50, 0,  0      }, 24,     1000,  150, 350,  1.0,  0,     40,   40,     0,    0,     0 },
+    {   "RF at the scan rate", { 1.0,   0,      0,    0,    0,    0,   0,  20, 166667 }, 24,     1000,  150, 350,  1.0,  0,     60,   200,    0,    0,     0 },
+    {   "idle, no touch",      { 1.0,   0.002,  0,    0,    0,    0,   0,  0,  0      }, 0,      0,     0,   0,    0,    60000, 0,    0,      0,    0,     0 },
+    {   "wake from low power", { 1.0,   0,      0,    0,    0,    0,   0,  0,  0      }, 8,      5000,  250, 4750, 1.0,  0,     200,  40,     0,    0,     0 },
+};
+
+static const scenario_t*    scenario;
+static model_touch_t        touch[TEST_TOUCHES_MAX];
+static bool                 touch_pressed[TEST_TOUCHES_MAX];
+static bool                 touch_held[TEST_TOUCHES_MAX];
+static bool                 button_was[MTOUCH_BUTTONS];
+static result_t             result;
+static int                  failures;
+
+static void Test_Press(enum mtouch_button_names button, double now)
+{
+    uint8_t sensor = (uint8_t)MTOUCH_Button_Sensor_Get(button);
+    uint8_t i;
+
+    for(i = 0; i < scenario->touches; i++)
+    {
+        if(touch[i].sensor != sensor)
+            continue;
+        if(now < (double)touch[i].start_ms || now > (double)(touch[i].start_ms + touch[i].length_ms + TEST_LATE_MS))
+            continue;
+        if(touch_pressed[i])
+            break;                                  /* chatter */
+        touch_pressed[i] = true;
+        touch_held[i] = true;
+        result.presses++;
+        result.press_sum += now - (double)touch[i].start_ms;
+        if(now - (double)touch[i].start_ms > result.press_max)
+            result.press_max = now - (double)touch[i].start_ms;
+        return;
+    }
+    result.false_presses++;
+}
+
+static void Test_Release(enum mtouch_button_names button, double now)
+{
+    uint8_t sensor = (uint8_t)MTOUCH_Button_Sensor_Get(button);
+    uint8_t i;
+    double  latency;
+
+    for(i = 0; i < scenario->touches; i++)
+    {
+        if(touch[i].sensor != sensor || !touch_held[i])
+            continue;
+        touch_held[i] = false;
+        latency = now - (double)(touch[i].start_ms + touch[i].length_ms);
+        if(latency < -MODEL_CONTACT_MS)
+        {
+            result.dropouts++;
+            return;
+        }
+        result.releases++;
+        result.release_sum += latency;
+        if(latency > result.release_max)
+            result.release_max = latency;
+        return;
+    }
+}
+
+/* main.c's loop, with the button edges taken after every processed round */
+static void Test_Mainloop(void)
+{
+    mtouch_gesture_event_t      gesture;
+    enum mtouch_button_names    button;
+    bool                        pressed;
+
+    if(MTOUCH_Service_Mainloop())
+    {
+        result.rounds++;
+        MTOUCH_BUTTON_FOREACH(button)
+        {
+            pressed = MTOUCH_Button_isPressed(button);
+            if(pressed && !button_was[button])
+                Test_Press(button, Model_Time_ms());
+            else if(!pressed && button_was[button])
+                Test_Release(button, Model_Time_ms());
+            button_was[button] = pressed;
+        }
+    }
+    while(MTOUCH_Gesture_Get(&gesture))
+        ;
+    MTOUCH_LowPower_Sleep();
+}
+
+static void Test_Simulate(void)
+{
+    uint32_t    period = scenario->on_ms + scenario->off_ms;
+    uint32_t    run_ms = scenario->run_ms;
+    uint8_t     i;
+
+    for(i = 0; i < scenario->touches; i++)
+    {
+        touch[i].sensor    = (uint8_t)MTOUCH_Button_Sensor_Get((enum mtouch_button_names)(i % MTOUCH_BUTTONS));
+        touch[i].start_ms  = scenario->first_ms + i * period;
+        touch[i].length_ms = scenario->on_ms;
+        touch[i].delta_pf  = scenario->delta_pf;
+    }
+    if(run_ms == 0)
+        run_ms = scenario->first_ms + scenario->touches * period + 500;
+
+    Model_Reset(&scenario->env, touch, scenario->touches, 12345);
+    INTCONbits.GIE  = 1;
+    GIE             = 1;
+    INTCONbits.PEIE = 1;
+    MTOUCH_Initialize();
+    Model_Run(run_ms, Test_Mainloop);
+
+    for(i = 0; i < scenario->touches; i++)
+        if(!touch_pressed[i])
+            result.missed++;
+    result.sleeps  = model_stats.sleeps;
+#ifdef MTOUCH_LOWPOWER
+    result.wakeups = MTOUCH_LowPower_Stats_Get()->wakeups;
+#endif
+}
+
+/* The library keeps its state in statics, so every scenario gets a fresh process */
+static result_t Test_Run(const scenario_t* s)
+{
+    int         fd[2];
+    result_t    r;
+
+    memset(&r, 0, sizeof(r));
+    if(pipe(fd) || fflush(stdout))
+        exit(EXIT_FAILURE);
+    if(fork() == 0)
+    {
+        scenario = s;
+        Test_Simulate();
+        if(write(fd[1], &result, sizeof(result)) != sizeof(result))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    if(read(fd[0], &r, sizeof(r)) != sizeof(r))
+        r.missed = UINT8_MAX;
+    wait(0);
+    close(fd[0]);
+    close(fd[1]);
+    return r;
+}
+
+static void Check(bool ok, const char* what)
+{
+    printf("    %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if(!ok)
+        failures++;
+}
+
+static void Test_Scenario(const scenario_t* s)
+{
+    result_t    r = Test_Run(s);
+
+    printf("  %s: %u touches of %.2f pF\n", s->name, s->touches, s->delta_pf);
+    printf("    press %5.1f/%5.1f ms  release %5.1f/%5.1f ms (mean/max)  false %u  missed %u  dropouts %u\n",
+           r.presses ? r.press_sum / r.presses : 0.0, r.press_max,
+           r.releases ? r.release_sum / r.releases : 0.0, r.release_max,
+           r.false_presses, r.missed, r.dropouts);
+    printf("    %lu rounds, %lu sleeps, %lu wake-ups\n",
+           (unsigned long)r.rounds, (unsigned long)r.sleeps, (unsigned long)r.wakeups);
+
+    Check(r.press_max <= s->press_max_ms, "press latency within limit");
+    Check(r.release_max <= s->release_max_ms, "release latency within limit");
+    Check(r.false_presses <= s->false_max, "false presses within limit");
+    Check(r.missed <= s->missed_max, "missed presses within limit");
+    Check(r.dropouts <= s->dropouts_max, "dropouts within limit");
+}
+
+int main(void)
+{
+    uint8_t n;
+
+    alarm(300);
+    printf("mTouch buttons against the sensor model: %u keys, hold %.0f pF\n",
+           (unsigned)MTOUCH_SENSORS, MODEL_HOLD_PF);
+    for(n = 0; n < sizeof(scenarios) / sizeof(scenarios[0]); n++)
+        Test_Scenario(&scenarios[n]);
+
+    printf("%s: %d failure%s\n", failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
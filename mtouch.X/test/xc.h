@@ -0,0 +1,51 @@
+/*
+ * Host stand-in for the XC8 device header, PIC16F1703.
+ *
+ * The test Makefile puts this directory first on the include path, so
+ * the mTouch sources compile unchanged with gcc. Only the registers the
+ * library touches are modelled, as plain variables. SLEEP() hands the
+ * time asleep to the sensor model, see touch_model.c.
+ */
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+
+#define __XC8_VERSION               2000
+#define __interrupt(...)
+#define NOP()
+#define CLRWDT()
+#define SLEEP()                     Model_Sleep()
+#define _delay(cycles)
+
+void Model_Sleep(void);
+uint16_t Model_Scan_Result(void);
+
+/* sensor and guard pins */
+extern volatile uint8_t LATA, LATC, TRISA, TRISC, ANSELA, ANSELC, WPUA, WPUC;
+
+/* ADC, watchdog */
+extern volatile uint8_t ADCON0, ADCON1, ADCON2, WDTCON;
+
+typedef struct
+{
+    unsigned GIE:1;
+    unsigned PEIE:1;
+    unsigned TMR0IE:1;
+    unsigned TMR0IF:1;
+} INTCONbits_t;
+extern volatile INTCONbits_t INTCONbits;
+
+/* XC8's bit symbol; kept apart from INTCONbits.GIE, no interrupt can
+ * come in between on the host */
+extern volatile uint8_t GIE;
+
+typedef struct
+{
+    unsigned T2CKPS:2;
+    unsigned TMR2ON:1;
+    unsigned T2OUTPS:4;
+} T2CONbits_t;
+extern volatile T2CONbits_t T2CONbits;
+
+#endif
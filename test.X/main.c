@@ -25,66 +25,55 @@
 #pragma config LPBOR = OFF      // Low-Power Brown Out Reset (Low-Power BOR is disabled)
 #pragma config LVP = ON         // Low-Voltage Programming Enable (Low-voltage programming enabled)
 
-int waitOK = 0;
-int timebase;
-int times;
-void wait(int ms);
+#include "swtimer.h"
+
+// one LED pin cleared a step, then all set again
+static const unsigned char step_a[] = {0x01, 0x02, 0x00, 0x10, 0x00, 0x00, 0x00, 0x20};
+static const unsigned char step_c[] = {0x00, 0x00, 0x02, 0x00, 0x04, 0x10, 0x01, 0x00};
+static unsigned char step;
+static swtimer_t step_timer;
+
+static void next_step(void){
+    if(step < sizeof(step_a)){
+        LATA &= ~step_a[step];
+        LATC &= ~step_c[step];
+        step++;
+        swtimer_start(&step_timer, SWT_MS(250), 0);
+    }
+    else{
+        LATA = 0xFF;
+        LATC = 0xFF;
+        step = 0;
+        swtimer_start(&step_timer, SWT_MS(500), 0);
+    }
+}
+
 void main(void) {
-    GIE = 1;
+    OSCCON = 0b01110000;    // 8 MHz HFINTOSC, 4x PLL from the config word
     LATA = 0xFF;
     LATC = 0xFF;
     TRISC = 0;
     TRISA = 0;
-    wait(500);
-    while(1){
-    LATA0 = 0;
-    wait(250);
-    LATA1 = 0;
-    wait(250);
-    LATC1 = 0;
-    wait(250);
-    LATA4 = 0;
-    wait(250);
-    LATC2 = 0;
-    wait(250);
-    LATC4 = 0;
-    wait(250);
-    LATC0 = 0;
-    wait(250);
-    LATA5 = 0;
-    wait(250);
 
-    LATA = 0xFF;
-    LATC = 0xFF;
-    wait(500);
+    // swtimer tick: Fosc/4 = 8 MHz, TMR2 1:64, PR2 124, postscale 1:10
+    PR2 = 124;
+    T2CON = 0b01001111;
+    TMR2IF = 0;
+    TMR2IE = 1;
+    PEIE = 1;
+    GIE = 1;
+
+    swtimer_init(&step_timer, next_step);
+    swtimer_start(&step_timer, SWT_MS(500), 0);
+    while(1){
+        swtimer_service();
     }
-    while(1);
 }
 
-void wait(int ms){
-    waitOK = 0;
-    T0CS = 0;
-    PSA = 1;
-    T0IF = 0;
-    T0IE = 1;
-    timebase = 0xAA;
-    times = ms;
-    TMR0 = timebase;
-    while(!waitOK);
-}
 void __interrupt() isr(void)
 {
-    static int n = 0;
-    if(T0IF){
-        if(n<times){
-            n++;
-            T0IF = 0;
-            T0IE = 1;
-            TMR0 = timebase;
-        }
-        else{
-            n = 0;
-            waitOK = 1;
-        }
+    if(TMR2IF){
+        TMR2IF = 0;
+        swtimer_tick();
     }
-}
\ No newline at end of file
+}
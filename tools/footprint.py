@@ -0,0 +1,464 @@
+#!/usr/bin/env python3
+"""Report flash, RAM and stack use of the XC8 builds and check them against a baseline.
+
+Reads what MPLAB X leaves in each <project>.X/dist/<conf>/<image>/: the
+linker .map, memoryfile.xml and the -msummary output (.mum). For every
+build it reports:
+
+  - program and data space used, from memoryfile.xml
+  - code size of each function and module, from the map's module
+    information
+  - RAM of each module: the compiled stack of its functions, summed
+    as if they did not overlap, and its static locals; globals cannot be
+    told apart by module in a whole-program build and are listed together
+  - compiled stack (the cstack psects) and software data stack
+  - hardware stack depth: the deepest call chain from main plus the
+    deepest chain of each interrupt level, as that is what can be on the
+    stack at once. Calls through function pointers are in the map's call
+    graph, so the state machine tables are counted. Each chain is the
+    larger of XC8's own figure and the one worked out from the call
+    graph, which also counts the calls into assembly routines.
+
+    footprint.py                        report every build found
+    footprint.py -o budget.json         also write the budget
+    footprint.py --check                fail if a build grew past the baseline
+    footprint.py --update-baseline      store the present numbers as the baseline
+
+The baseline is tools/footprint_baseline.json unless --baseline is given.
+The exit status is 1 on a regression, a build missing from the baseline
+under --check, a build past its device limits, or a build whose map
+cannot be trusted: one with no call graph or module information, so the
+stack depth and code sizes are unknown, or one whose functions do not
+add up to the linker's program total, which means the map and
+memoryfile.xml are from different builds. Such builds are never stored
+in the baseline. The builds in EXCLUDED are known not to be readable and
+are left out, with a note once they are.
+"""
+import argparse
+import glob
+import json
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BASELINE = os.path.join(ROOT, 'tools', 'footprint_baseline.json')
+
+HW_STACK_LEVELS = {'16F1703': 16, '16F1936': 16, '16F1937': 16}
+HW_STACK_DEFAULT = 16
+
+# build totals that may not grow
+TRACKED = ['program_used', 'data_used', 'compiled_stack', 'data_stack', 'hw_stack']
+
+# the module information sizes are XC8's estimates, a little over the linker total
+MAP_SLACK = 0.05
+
+# builds whose map cannot be read, and why
+EXCLUDED = {
+    'mtouch.X/production': 'the map and listing are of an older build than the hex: no call '
+                           'graph, and functions overlapping to 2202 words against 845',
+}
+
+DATA_PSECT = re.compile(r'^(bss|data|nv|idata)')
+STARTUP = 'Startup code after reset'
+INTERRUPT = re.compile(r'Interrupt level (\d+)')
+
+
+def parse_psects(lines):
+    """Return {psect: (class, address, length)} from the map's TOTAL section."""
+    psects = {}
+    cls = None
+    inside = False
+    for line in lines:
+        if line.startswith('TOTAL'):
+            inside = True
+            continue
+        if not inside:
+            continue
+        if line.startswith('SEGMENTS'):
+            break
+        f = line.split()
+        if len(f) == 2 and f[0] == 'CLASS':
+            cls = f[1]
+        elif len(f) == 5 and cls:
+            psects[f[0]] = (cls, int(f[1], 16), int(f[3], 16))
+    return psects
+
+
+def parse_symbols(lines):
+    """Return [(name, psect, address)] from the map's symbol table."""
+    symbols = []
+    inside = False
+    for line in lines:
+        if line.strip() == 'Symbol Table':
+            inside = True
+            continue
+        if not inside:
+            continue
+        if line.startswith('FUNCTION INFORMATION'):
+            break
+        f = line.split()
+        if len(f) == 3:
+            try:
+                symbols.append((f[0], f[1], int(f[2], 16)))
+            except ValueError:
+                pass
+    return symbols
+
+
+def parse_functions(lines):
+    """Return {function: info} from the map's function information."""
+    functions = {}
+    fn = None
+    section = None
+    for line in lines:
+        m = re.match(r'\s*\*+ function (\S+) \*+', line)
+        if m:
+            fn = {'file': None, 'ram': 0, 'calls': [], 'callers': [],
+                  'levels_used': None, 'levels_required': None}
+            functions[m.group(1)] = fn
+            section = None
+            continue
+        if fn is None:
+            continue
+        if line.startswith('MODULE INFORMATION'):
+            break
+        s = line.strip()
+        m = re.match(r'line \d+ in file "(.+)"', s)
+        if m:
+            fn['file'] = m.group(1).replace('\\', '/')
+        elif s.startswith('Total ram usage:'):
+            fn['ram'] = int(s.split(':')[1].split()[0])
+        elif s.startswith('Hardware stack levels used:'):
+            fn['levels_used'] = int(s.split(':')[1])
+        elif s.startswith('Hardware stack levels required when called:'):
+            fn['levels_required'] = int(s.split(':')[1])
+        elif s == 'This function calls:':
+            section = 'calls'
+        elif s == 'This function is called by:':
+            section = 'callers'
+        elif s.startswith('This function uses'):
+            section = None
+        elif section and s and s != 'Nothing':
+            fn[section].append(s)
+    return functions
+
+
+def parse_modules(lines):
+    """Return {module: {function: words}} from the map's module information."""
+    modules = {}
+    module = None
+    inside = False
+    for line in lines:
+        if line.startswith('MODULE INFORMATION'):
+            inside = True
+            continue
+        if not inside or not line.strip() or line.startswith('Module'):
+            continue
+        if 'estimated size' in line:
+            continue
+        if not line.startswith('\t'):
+            module = line.strip().replace('\\', '/')
+            modules[module] = {}
+            continue
+        f = line.split()
+        if module and len(f) >= 5:
+            modules[module][f[0]] = int(f[-1])
+    return modules
+
+
+def symbol_sizes(symbols, psects, match):
+    """Return {name: bytes} for the symbols in psects whose name matches,
+    each sized up to the next symbol in its psect or the psect end."""
+    sizes = {}
+    by_psect = {}
+    for name, psect, addr in symbols:
+        if psect not in psects or not match(psect):
+            continue
+        # C objects only, not the linker's __L/__H/__p psect bounds
+        if name.startswith('__') or not (name.startswith('_') or '@' in name):
+            continue
+        start = psects[psect][1]
+        if start <= addr < start + psects[psect][2]:
+            by_psect.setdefault(psect, []).append((addr, name))
+    for psect, entries in by_psect.items():
+        entries.sort()
+        end = psects[psect][1] + psects[psect][2]
+        for i, (addr, name) in enumerate(entries):
+            nxt = end
+            for later, _ in entries[i + 1:]:
+                if later > addr:
+                    nxt = later
+                    break
+            sizes[name] = nxt - addr
+    return sizes
+
+
+def call_depth(functions, root, active=None, known=None):
+    """Hardware stack levels taken by calling root, a leaf taking one.
+    A callee without function information, an assembly routine, is a leaf."""
+    active = active or set()
+    known = {} if known is None else known
+    if root in known:
+        return known[root]
+    if root in active:
+        raise ValueError('recursion through %s' % root)
+    fn = functions.get(root)
+    if fn is None:
+        return 1
+    below = [call_depth(functions, c, active | {root}, known) for c in fn['calls']]
+    known[root] = 1 + max(below, default=0)
+    return known[root]
+
+
+def read_memoryfile(path):
+    """Return {memory: (used, length)} from memoryfile.xml."""
+    result = {}
+    for mem in ET.parse(path).getroot().iter('memory'):
+        result[mem.get('name')] = (int(mem.findtext('used')), int(mem.findtext('length')))
+    return result
+
+
+def read_summary(path):
+    """Return {space: (used, length)} from the -msummary output."""
+    result = {}
+    for line in open(path, encoding='latin-1'):
+        m = re.match(r'\s*(.+?)\s+used\s+\w+h \(\s*(\d+)\) of\s+(\w+)h', line)
+        if m:
+            result[m.group(1)] = (int(m.group(2)), int(m.group(3), 16))
+    return result
+
+
+def analyze(map_path):
+    """Return the budget of one build."""
+    lines = open(map_path, encoding='latin-1').read().splitlines()
+    folder = os.path.dirname(map_path)
+    text = '\n'.join(lines[:60])
+    m = re.search(r'Machine type is (\S+)', text)
+    device = m.group(1) if m else '?'
+
+    psects = parse_psects(lines)
+    symbols = parse_symbols(lines)
+    functions = parse_functions(lines)
+    modules = parse_modules(lines)
+
+    # code size per function, from the module information if there is one
+    code = {}
+    owner = {}
+    for module, entries in modules.items():
+        for name, words in entries.items():
+            code[name] = words
+            owner[name] = module
+    for name, fn in functions.items():
+        if fn['file'] and name not in owner:
+            owner[name] = fn['file']
+
+    # RAM per module: compiled stack of its functions and their static locals
+    ram = {}
+    for name, fn in functions.items():
+        module = os.path.basename(owner.get(name) or '(unknown)')
+        ram[module] = ram.get(module, 0) + fn['ram']
+    data = symbol_sizes(symbols, psects, DATA_PSECT.match)
+    for name, size in data.items():
+        if '@' in name:
+            fn = '_' + name.split('@')[0]
+            module = os.path.basename(owner.get(fn) or '(unknown)')
+        elif name.startswith('_'):
+            module = '(globals)'
+        else:
+            continue
+        ram[module] = ram.get(module, 0) + size
+
+    compiled_stack = sum(length for name, (cls, addr, length) in psects.items()
+                         if name.startswith('cstack'))
+
+    # main and one chain per interrupt level can be on the stack together
+    roots = {'main': []}
+    for name, fn in functions.items():
+        for caller in fn['callers']:
+            m = INTERRUPT.match(caller)
+            if m:
+                roots.setdefault('interrupt %s' % m.group(1), []).append(name)
+            elif caller == STARTUP:
+                roots['main'].append(name)
+    depth = {}
+    recursion = None
+    for level, names in roots.items():
+        if not names:
+            continue
+        try:
+            depth[level] = max(max(call_depth(functions, n),
+                                   functions[n]['levels_required'] or 0) for n in names)
+        except ValueError as e:
+            recursion = str(e)
+
+    budget = {
+        'device': device,
+        'hw_stack_limit': HW_STACK_LEVELS.get(device, HW_STACK_DEFAULT),
+        'compiled_stack': compiled_stack,
+        'hw_stack': sum(depth.values()),
+        'call_depth': depth,
+        'call_graph': bool(functions),
+        'map_code': sum(code.values()),
+        'functions': dict(sorted(code.items(), key=lambda i: -i[1])),
+        'module_code': {},
+        'module_ram': dict(sorted(ram.items())),
+    }
+    if recursion:
+        budget['recursion'] = recursion
+    for name, words in code.items():
+        module = os.path.basename(owner.get(name) or '(unknown)')
+        budget['module_code'][module] = budget['module_code'].get(module, 0) + words
+    budget['module_code'] = dict(sorted(budget['module_code'].items()))
+
+    memfile = os.path.join(folder, 'memoryfile.xml')
+    summaries = glob.glob(os.path.join(folder, '*.mum'))
+    memory = read_memoryfile(memfile) if os.path.exists(memfile) else {}
+    summary = read_summary(summaries[0]) if summaries else {}
+    program = memory.get('program') or summary.get('Program space') or (0, 0)
+    ram_total = memory.get('data') or summary.get('Data space') or (0, 0)
+    budget['program_used'], budget['program_size'] = program
+    budget['data_used'], budget['data_size'] = ram_total
+    budget['data_stack'] = summary.get('Data stack space', (0, 0))[0]
+    return budget
+
+
+def find_builds(root, conf):
+    """Return {'<project>/<image>': map path} for every build under root."""
+    builds = {}
+    pattern = os.path.join(root, '*.X', 'dist', conf, '*', '*.map')
+    for path in sorted(glob.glob(pattern)):
+        parts = os.path.relpath(path, root).split(os.sep)
+        builds['%s/%s' % (parts[0], parts[3])] = path
+    return builds
+
+
+def limits(name, b):
+    """Return the ways a build is past its device."""
+    problems = []
+    if b['hw_stack'] > b['hw_stack_limit']:
+        problems.append('%s: hardware stack %d of %d levels' % (name, b['hw_stack'], b['hw_stack_limit']))
+    if b['program_size'] and b['program_used'] > b['program_size']:
+        problems.append('%s: program space %d of %d' % (name, b['program_used'], b['program_size']))
+    if b.get('recursion'):
+        problems.append('%s: %s' % (name, b['recursion']))
+    return problems
+
+
+def unreadable(name, b):
+    """Return the ways a build's map cannot be trusted."""
+    problems = []
+    if not b['call_graph']:
+        problems.append('%s: no call graph in the map, hardware stack unknown' % name)
+    if not b['functions']:
+        problems.append('%s: no module information in the map, code sizes unknown' % name)
+    elif b['program_used'] and abs(b['map_code'] - b['program_used']) > MAP_SLACK * b['program_used']:
+        problems.append('%s: map functions total %d words, linker %d: stale map' % (
+            name, b['map_code'], b['program_used']))
+    return problems
+
+
+def compare(budgets, baseline, tolerance):
+    """Return (regressions, notes) against the baseline."""
+    regressions = []
+    notes = []
+    for name, b in budgets.items():
+        base = baseline.get(name)
+        if base is None:
+            regressions.append('%s: not in the baseline' % name)
+            continue
+        for key in TRACKED:
+            if b[key] > base.get(key, 0) + tolerance:
+                regressions.append('%s: %s %d -> %d' % (name, key, base.get(key, 0), b[key]))
+        for fn, words in b['functions'].items():
+            was = base.get('functions', {}).get(fn)
+            if was is not None and words > was:
+                notes.append('%s: %s %d -> %d words' % (name, fn, was, words))
+    for name in baseline:
+        if name not in budgets:
+            notes.append('%s: no build found' % name)
+    return regressions, notes
+
+
+def report(name, b, top, out):
+    print('%s (%s)' % (name, b['device']), file=out)
+    if b['program_size']:
+        print('  program         %5d of %5d words  %5.1f%%' % (
+            b['program_used'], b['program_size'], 100.0 * b['program_used'] / b['program_size']), file=out)
+    if b['data_size']:
+        print('  data            %5d of %5d bytes  %5.1f%%' % (
+            b['data_used'], b['data_size'], 100.0 * b['data_used'] / b['data_size']), file=out)
+    print('  functions       %5d words in the map' % b['map_code'], file=out)
+    print('  compiled stack  %5d bytes' % b['compiled_stack'], file=out)
+    print('  data stack      %5d bytes' % b['data_stack'], file=out)
+    chains = ' + '.join('%s %d' % i for i in b['call_depth'].items()) or 'no call graph'
+    print('  hardware stack  %5d of %d levels (%s)' % (b['hw_stack'], b['hw_stack_limit'], chains), file=out)
+    for module in sorted(set(b['module_code']) | set(b['module_ram'])):
+        print('    %-28s %5d words %4d bytes' % (
+            module, b['module_code'].get(module, 0), b['module_ram'].get(module, 0)), file=out)
+    for fn, words in list(b['functions'].items())[:top]:
+        print('    %-28s %5d words' % (fn, words), file=out)
+    print(file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--root', default=ROOT, help='folder holding the *.X projects')
+    parser.add_argument('--conf', default='default', help='MPLAB X configuration')
+    parser.add_argument('-o', '--output', help='write the budget as JSON')
+    parser.add_argument('--baseline', default=BASELINE)
+    parser.add_argument('--check', action='store_true', help='fail on growth past the baseline')
+    parser.add_argument('--update-baseline', action='store_true')
+    parser.add_argument('--tolerance', type=int, default=0, help='growth allowed in each total')
+    parser.add_argument('--top', type=int, default=10, help='largest functions listed per build')
+    parser.add_argument('-q', '--quiet', action='store_true', help='no report, problems only')
+    args = parser.parse_args()
+
+    builds = find_builds(args.root, args.conf)
+    if not builds:
+        sys.exit('no builds under %s' % args.root)
+    budgets = {name: analyze(path) for name, path in builds.items()}
+    for name in sorted(set(budgets) & set(EXCLUDED)):
+        if unreadable(name, budgets.pop(name)):
+            print('note: %s: excluded, %s' % (name, EXCLUDED[name]), file=sys.stderr)
+        else:
+            print('note: %s: excluded but readable now, drop it from EXCLUDED' % name,
+                  file=sys.stderr)
+
+    if not args.quiet:
+        for name, b in budgets.items():
+            report(name, b, args.top, sys.stdout)
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(budgets, f, indent=1, sort_keys=True)
+            f.write('\n')
+
+    problems = []
+    trusted = {}
+    for name, b in budgets.items():
+        problems += limits(name, b)
+        if unreadable(name, b):
+            problems += unreadable(name, b)
+        else:
+            trusted[name] = b
+    if args.update_baseline:
+        for name in sorted(set(budgets) - set(trusted)):
+            print('note: %s: left out of the baseline' % name, file=sys.stderr)
+        with open(args.baseline, 'w') as f:
+            json.dump(trusted, f, indent=1, sort_keys=True)
+            f.write('\n')
+    if args.check:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions, notes = compare(budgets, baseline, args.tolerance)
+        for note in notes:
+            print('note: ' + note, file=sys.stderr)
+        problems += regressions
+    for problem in problems:
+        print('FAIL: ' + problem, file=sys.stderr)
+    sys.exit(1 if problems else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Decode the mTouch telemetry stream into CSV.
+
+The record format is described in
+mtouch.X/mcc_generated_files/mtouch/mtouch_telemetry.h. Input is either a
+serial port (needs pyserial) or a file of captured bytes, '-' for stdin.
+
+    mtouch_telemetry.py /dev/ttyUSB0 > touch.csv
+    mtouch_telemetry.py capture.bin -o touch.csv
+
+A record with a bad checksum is dropped and the decoder hunts for the
+next sync byte. The counts of records and dropped bytes go to stderr.
+"""
+import argparse
+import csv
+import struct
+import sys
+import time
+
+SYNC = 0xA5
+RECORD_SIZE = 11
+BAUD = 7812             # Fosc/4/1024 at 32 MHz
+
+STATE_ACTIVE = 0x01
+STATE_PRESSED = 0x02
+STATE_INITIALIZED = 0x04
+
+FIELDS = ['time', 'round', 'button', 'sensor', 'raw', 'baseline',
+          'deviation', 'noise', 'active', 'pressed', 'initialized']
+
+
+def decode(record):
+    """Return a dict for an 11-byte record, or None if the checksum fails."""
+    if record[0] != SYNC or sum(record[1:]) & 0xFF:
+        return None
+    ids, rnd, raw, base, dev, noise, state = struct.unpack('<BBHHbBB', record[1:10])
+    return {
+        'round': rnd,
+        'button': ids & 0x0F,
+        'sensor': ids >> 4,
+        'raw': raw,
+        'baseline': base,
+        'deviation': dev,
+        'noise': noise / 4.0,
+        'active': int(bool(state & STATE_ACTIVE)),
+        'pressed': int(bool(state & STATE_PRESSED)),
+        'initialized': int(bool(state & STATE_INITIALIZED)),
+    }
+
+
+class Decoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.records = 0
+        self.dropped = 0
+
+    def feed(self, data):
+        """Yield the records completed by data."""
+        self.buffer += data
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                self.dropped += len(self.buffer)
+                self.buffer.clear()
+                return
+            if start:
+                self.dropped += start
+                del self.buffer[:start]
+            if len(self.buffer) < RECORD_SIZE:
+                return
+            row = decode(self.buffer[:RECORD_SIZE])
+            if row is None:
+                self.dropped += 1           # not a real sync byte, hunt on
+                del self.buffer[:1]
+                continue
+            del self.buffer[:RECORD_SIZE]
+            self.records += 1
+            yield row
+
+
+def open_input(name, baud):
+    if name == '-':
+        return sys.stdin.buffer
+    if name.startswith('/dev/') or name.upper().startswith('COM'):
+        import serial
+        return serial.Serial(name, baud, timeout=0.1)
+    return open(name, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('input', help="serial port, capture file or '-'")
+    parser.add_argument('-o', '--output', help='CSV file, stdout by default')
+    parser.add_argument('-b', '--baud', type=int, default=BAUD)
+    args = parser.parse_args()
+
+    source = open_input(args.input, args.baud)
+    sink = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.DictWriter(sink, FIELDS)
+    writer.writeheader()
+
+    decoder = Decoder()
+    start = time.monotonic()
+    try:
+        while True:
+            data = source.read(256)
+            if not data:
+                if hasattr(source, 'in_waiting'):
+                    continue                # serial timeout, keep listening
+                break
+            now = round(time.monotonic() - start, 3)
+            for row in decoder.feed(data):
+                row['time'] = now
+                writer.writerow(row)
+            sink.flush()
+    except KeyboardInterrupt:
+        pass
+    print('%d records, %d bytes dropped' % (decoder.records, decoder.dropped),
+          file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()